@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <bit>
 #include <cstdint>
+#include <memory>
 #include <new>
 #include <optional>
 #include <span>
@@ -34,6 +35,8 @@ private:
   static constexpr std::uint16_t element_size = sizeof(ElementType);
   static constexpr std::uint32_t byte_length =
       std::max(alignment, element_size) * length;
+  // false if memory was passed to the constructor
+  const bool owns_memory;
   ElementType* const memory_pointer;
   // data used by dequeueing thread
   const std::span<ElementType, length> dequeue_span;
@@ -55,10 +58,17 @@ private:
     QueueReader &operator=(QueueReader &&) = delete;
     std::optional<ContentType_> read_next_entry() noexcept;
   };
+  static ElementType* construct_elements(void*) noexcept;
 
 public:
   using ContentType = ContentType_;
+  // size and alignment of memory passed to the constructor taking a pointer
+  static constexpr std::size_t required_bytes = sizeof(ElementType) * length;
+  static constexpr std::size_t required_alignment = alignof(ElementType);
   explicit SeqLockQueue();
+  // constructs elements in memory provided by the caller (e.g. huge pages),
+  // memory must outlive the queue and is not freed by it
+  explicit SeqLockQueue(void*);
   ~SeqLockQueue();
   SeqLockQueue(const SeqLockQueue &) = delete;
   SeqLockQueue &operator=(const SeqLockQueue &) = delete;
@@ -84,12 +94,32 @@ public:
 
 TEMPLATE_PARAMS
 SEQ_LOCK_QUEUE::SeqLockQueue()
-    :memory_pointer{new(std::align_val_t{cacheline}) ElementType[length]},
+    :owns_memory{true},
+     memory_pointer{new(std::align_val_t{cacheline}) ElementType[length]},
      dequeue_span{this->memory_pointer, length},
      enqueue_span{this->memory_pointer, length} {};
 
 TEMPLATE_PARAMS
-SEQ_LOCK_QUEUE::~SeqLockQueue() { delete[] this->memory_pointer; };
+SEQ_LOCK_QUEUE::SeqLockQueue(void* memory)
+    :owns_memory{false},
+     memory_pointer{construct_elements(memory)},
+     dequeue_span{this->memory_pointer, length},
+     enqueue_span{this->memory_pointer, length} {};
+
+TEMPLATE_PARAMS
+SEQ_LOCK_QUEUE::~SeqLockQueue() {
+  if (this->owns_memory)
+    delete[] this->memory_pointer;
+  else
+    std::destroy_n(this->memory_pointer, length);
+};
+
+TEMPLATE_PARAMS
+typename SEQ_LOCK_QUEUE::ElementType* SEQ_LOCK_QUEUE::construct_elements(void* memory) noexcept {
+  ElementType* elements = static_cast<ElementType*>(memory);
+  std::uninitialized_default_construct_n(elements, length);
+  return elements;
+};
 
 TEMPLATE_PARAMS
 SEQ_LOCK_QUEUE::ReadReturnType SEQ_LOCK_QUEUE::read_element(std::int64_t read_index, std::int64_t prev_version) const noexcept {
@@ -8,6 +8,7 @@
 #include <exception>
 #include <fstream>
 #include <iostream>
+#include <optional>
 #include <span>
 #include <sstream>
 #include <string>
@@ -95,6 +96,16 @@ bool is_negative(Sint sint) {
     return (std::make_unsigned_t<Sint>)sint << shift_by == 1;
 }
 
+// reads a plain field via a relaxed atomic load, for seqlock readers racing a
+// single writer that modifies the field without atomics
+template <typename T>
+requires std::is_trivially_copyable_v<T>
+T relaxed_load(const T& field) noexcept {
+  static_assert(std::atomic_ref<T>::is_always_lock_free);
+  return std::atomic_ref<T>(const_cast<T&>(field))
+      .load(std::memory_order_relaxed);
+};
+
 // concept to enforce a socket wrapper can be called essentially like a POSIX
 // socket, via a recv-method
 template <typename socketType>
@@ -103,6 +114,27 @@ concept readableAsSocket = requires(socketType socket, void* buffer_ptr,
   { socket.recv(buffer_ptr, n_bytes) } -> std::same_as<std::int32_t>;
 };
 
+// concept to enforce a stage hands out parsed messages one at a time, e.g.
+// FIXSocketHandler::fixSocketHandler, returning an empty optional if there was
+// no valid message
+template <typename handlerType, typename msgClassVariant>
+concept readableAsMessages = requires(handlerType handler) {
+  { handler.readNextMessage() } -> std::same_as<std::optional<msgClassVariant>>;
+};
+
+// concept to enforce a queue reader hands out entries one at a time, returning
+// an empty optional once the queue is drained
+template <typename readerType, typename contentType>
+concept readableAsQueue = requires(readerType reader) {
+  { reader.read_next_entry() } -> std::same_as<std::optional<contentType>>;
+};
+
+// concept to enforce a queue accepts entries one at a time
+template <typename queueType, typename contentType>
+concept writableAsQueue = requires(queueType queue, contentType content) {
+  queue.enqueue(content);
+};
+
 template <typename Tuple,
           template <typename tuple_element> class validate_element, int index>
 struct validate_tuple_element {
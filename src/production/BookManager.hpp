@@ -0,0 +1,145 @@
+// owns the order books of any number of instruments, all of them placed in a
+// single memory arena, routes messages to books via their instrument ID
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <variant>
+
+#include "FIXmsgTypeChecks.hpp"
+#include "MemoryArena.hpp"
+#include "TopOfBook.hpp"
+
+namespace BookManager {
+template <typename bookType_>
+requires MsgTypeChecks::InstrumentMsgVariant<
+    typename bookType_::msgClassVariant>::value struct bookManager {
+ private:
+  static constexpr std::size_t cacheline = 64;
+  using msgClassVariant = typename bookType_::msgClassVariant;
+  using orderResponse = typename bookType_::orderResponseType;
+  std::uint32_t nBooks;
+  MemoryArena::memoryArena arena;
+  // copies of the packed top of book of every book, all words in consecutive
+  // cachelines so queries for many instruments only
+  // touch a few cachelines instead of one book object each
+  std::span<std::atomic<std::uint64_t>> topOfBook;
+  // book objects placed next to each other, followed by their buckets
+  std::span<bookType_> books;
+  void updateTopOfBook(std::uint32_t) noexcept;
+
+ public:
+  using bookType = bookType_;
+  // arena memory required to hold given number of books
+  static constexpr std::size_t arenaBytes(std::uint32_t nBooks_) noexcept {
+    return MemoryArena::memoryArena::footprint(
+               cacheline, nBooks_ * sizeof(std::atomic<std::uint64_t>)) +
+           MemoryArena::memoryArena::footprint(alignof(bookType_),
+                                               nBooks_ * sizeof(bookType_)) +
+           nBooks_ * bookType_::arenaBytes;
+  };
+  // constructs one book per base price, instrument ID of a book is its index
+  explicit bookManager(std::span<const std::uint32_t>);
+  ~bookManager();
+  bookManager(const bookManager&) = delete;
+  bookManager& operator=(const bookManager&) = delete;
+  bookManager(bookManager&&) = delete;
+  bookManager& operator=(bookManager&&) = delete;
+  // processes order in book of its instrument, response contains error code 4
+  // if instrument ID is unknown
+  orderResponse processOrder(msgClassVariant) noexcept;
+  // reads packed top of book, does not touch the book itself
+  std::tuple<std::optional<std::uint32_t>, std::optional<std::uint32_t>>
+  bestBidAsk(std::uint32_t) const noexcept;
+  bookType_& book(std::uint32_t) noexcept;
+  std::uint32_t size() const noexcept;
+  std::size_t arenaUsed() const noexcept;
+};
+};  // namespace BookManager
+
+#define BOOK_MANAGER_TEMPLATE_DECLARATION       \
+  template <typename bookType_>                 \
+  requires MsgTypeChecks::InstrumentMsgVariant< \
+      typename bookType_::msgClassVariant>::value
+
+#define BOOK_MANAGER BookManager::bookManager<bookType_>
+
+namespace BookManager {
+BOOK_MANAGER_TEMPLATE_DECLARATION
+BOOK_MANAGER::bookManager(std::span<const std::uint32_t> basePrices)
+    : nBooks{static_cast<std::uint32_t>(basePrices.size())},
+      arena{arenaBytes(nBooks)},
+      // fall back to std::aligned_alloc if mapping the arena failed
+      topOfBook{reinterpret_cast<std::atomic<std::uint64_t>*>(
+                    MemoryArena::allocate(
+                        &arena, cacheline,
+                        nBooks * sizeof(std::atomic<std::uint64_t>))),
+                nBooks},
+      books{reinterpret_cast<bookType_*>(MemoryArena::allocate(
+                &arena, alignof(bookType_), nBooks * sizeof(bookType_))),
+            nBooks} {
+  for (std::uint32_t i = 0; i < this->nBooks; ++i) {
+    std::construct_at(&this->topOfBook[i], TopOfBook::empty);
+    std::construct_at(&this->books[i], basePrices[i], &this->arena);
+  }
+};
+
+BOOK_MANAGER_TEMPLATE_DECLARATION
+BOOK_MANAGER::~bookManager() {
+  for (std::uint32_t i = 0; i < this->nBooks; ++i) {
+    std::destroy_at(&this->books[i]);
+    std::destroy_at(&this->topOfBook[i]);
+  }
+  // arena memory is freed by arena member (RAII), fallback memory is freed here
+  MemoryArena::release(&this->arena, this->books.data());
+  MemoryArena::release(&this->arena, this->topOfBook.data());
+};
+
+BOOK_MANAGER_TEMPLATE_DECLARATION
+typename BOOK_MANAGER::orderResponse BOOK_MANAGER::processOrder(
+    msgClassVariant order) noexcept {
+  const std::uint32_t instrumentID = std::visit(
+      [](const auto& msg) -> std::uint32_t { return msg.instrumentID; },
+      order);
+  if (instrumentID >= this->nBooks) {
+    return orderResponse{0, 0, 0, 4};
+  }
+  auto ret = this->books[instrumentID].processOrder(order);
+  this->updateTopOfBook(instrumentID);
+  return ret;
+};
+
+BOOK_MANAGER_TEMPLATE_DECLARATION
+void BOOK_MANAGER::updateTopOfBook(std::uint32_t instrumentID) noexcept {
+  this->topOfBook[instrumentID].store(
+      this->books[instrumentID].packedBestBidAsk(), std::memory_order_release);
+};
+
+BOOK_MANAGER_TEMPLATE_DECLARATION
+std::tuple<std::optional<std::uint32_t>, std::optional<std::uint32_t>>
+BOOK_MANAGER::bestBidAsk(std::uint32_t instrumentID) const noexcept {
+  return TopOfBook::unpack(
+      this->topOfBook[instrumentID].load(std::memory_order_acquire));
+};
+
+BOOK_MANAGER_TEMPLATE_DECLARATION
+bookType_& BOOK_MANAGER::book(std::uint32_t instrumentID) noexcept {
+  return this->books[instrumentID];
+};
+
+BOOK_MANAGER_TEMPLATE_DECLARATION
+std::uint32_t BOOK_MANAGER::size() const noexcept { return this->nBooks; };
+
+BOOK_MANAGER_TEMPLATE_DECLARATION
+std::size_t BOOK_MANAGER::arenaUsed() const noexcept {
+  return this->arena.used();
+};
+};  // namespace BookManager
+
+#undef BOOK_MANAGER_TEMPLATE_DECLARATION
+#undef BOOK_MANAGER
@@ -0,0 +1,274 @@
+// writes the state of an order book (base price, stats and buckets) to a
+// memory mapped file, on demand or at an interval, and restores a book from
+// it after a restart without replaying messages
+// the file holds two slots written alternately, a slot is only marked valid
+// once its contents are synced to disk, a crash while writing thus leaves the
+// previous snapshot intact
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <thread>
+
+#include "AtomicGuards.hpp"
+#include "MemoryArena.hpp"
+#include "OrderBook.hpp"
+#include "TopOfBook.hpp"
+
+namespace BookSnapshot {
+// "OBSNAP01" in little endian
+static constexpr std::uint64_t magic = 0x31305041'4E53424F;
+static constexpr std::size_t pageSize = 4096;
+
+// first page of every slot, buckets follow on the next page, prices absent
+// from the book are stored as TopOfBook::noPrice
+struct snapshotHeader {
+  std::uint64_t magic = 0;
+  // zero while the slot is being written or has never been written
+  std::uint64_t sequence = 0;
+  // layout of the book, checked before restoring
+  std::uint64_t stateBytes = 0;
+  std::uint32_t bookLength = 0;
+  std::uint32_t basePrice = 0;
+  std::uint32_t bestBid = TopOfBook::noPrice;
+  std::uint32_t lowestBid = TopOfBook::noPrice;
+  std::uint32_t bestOffer = TopOfBook::noPrice;
+  std::uint32_t highestOffer = TopOfBook::noPrice;
+};
+
+// bytes of a single slot for a given book type
+template <typename bookType>
+static constexpr std::size_t slotBytes =
+    pageSize + (bookType::stateBytes + pageSize - 1) / pageSize * pageSize;
+
+template <typename bookType_>
+requires bookType_::copyableState && bookType_::lockPolicy::enabled
+struct snapshotWriter {
+ private:
+  static constexpr std::size_t slotBytes_ = slotBytes<bookType_>;
+  bookType_* book;
+  int fd = -1;
+  void* mapping = MAP_FAILED;
+  // book state is copied here first, the lock of the book is only held for
+  // this copy
+  std::byte* staging = nullptr;
+  std::uint64_t sequence = 0;
+  // serializes snapshots on demand and those of the interval thread
+  std::atomic_flag writeLock = false;
+  std::jthread intervalThread;
+  snapshotHeader* header(std::uint32_t) const noexcept;
+
+ public:
+  // opens or creates file at path, numbering continues after the newest
+  // valid snapshot found in an existing file, not valid if the file could not
+  // be mapped or the staging buffer not be allocated
+  snapshotWriter(bookType_*, const char*);
+  ~snapshotWriter();
+  snapshotWriter(const snapshotWriter&) = delete;
+  snapshotWriter& operator=(const snapshotWriter&) = delete;
+  snapshotWriter(snapshotWriter&&) = delete;
+  snapshotWriter& operator=(snapshotWriter&&) = delete;
+  bool valid() const noexcept;
+  // copies the book and writes the copy to the older slot, returns false if
+  // writer is not valid or syncing failed
+  bool snapshot() noexcept;
+  // takes a snapshot every interval on a background thread until stopped,
+  // restarts thread if already running
+  void startInterval(std::chrono::milliseconds);
+  void stopInterval() noexcept;
+  // sequence number of the last snapshot written
+  std::uint64_t lastSequence() const noexcept;
+};
+
+// restores book from the newest valid snapshot in the file at path, returns
+// its sequence number, nullopt if there is none, the layout does not match
+// the book or the restored book would violate its invariants, book is left
+// unchanged in that case
+template <typename bookType>
+requires bookType::copyableState
+std::optional<std::uint64_t> restore(bookType&, const char*);
+};  // namespace BookSnapshot
+
+#define SNAPSHOT_WRITER_TEMPLATE_DECLARATION \
+  template <typename bookType_>              \
+  requires bookType_::copyableState && bookType_::lockPolicy::enabled
+
+#define SNAPSHOT_WRITER BookSnapshot::snapshotWriter<bookType_>
+
+namespace BookSnapshot {
+SNAPSHOT_WRITER_TEMPLATE_DECLARATION
+SNAPSHOT_WRITER::snapshotWriter(bookType_* book_, const char* path)
+    : book{book_} {
+  this->fd = open(path, O_RDWR | O_CREAT, 0644);
+  const bool sized =
+      this->fd >= 0 && ftruncate(this->fd, 2 * slotBytes_) == 0;
+  this->mapping = sized ? mmap(nullptr, 2 * slotBytes_, PROT_READ | PROT_WRITE,
+                               MAP_SHARED, this->fd, 0)
+                        : MAP_FAILED;
+  this->staging = static_cast<std::byte*>(
+      MemoryArena::allocate(nullptr, pageSize, bookType_::stateBytes));
+  if (!this->valid()) {
+    return;
+  }
+  // prefault staging buffer, first copy would otherwise stall the writer
+  std::memset(this->staging, 0, bookType_::stateBytes);
+  for (std::uint32_t i = 0; i < 2; ++i) {
+    const snapshotHeader* slot = this->header(i);
+    this->sequence = slot->magic == magic
+                         ? std::max(this->sequence, slot->sequence)
+                         : this->sequence;
+  }
+};
+
+SNAPSHOT_WRITER_TEMPLATE_DECLARATION
+SNAPSHOT_WRITER::~snapshotWriter() {
+  this->stopInterval();
+  this->mapping != MAP_FAILED ? void(munmap(this->mapping, 2 * slotBytes_))
+                              : void();
+  this->fd >= 0 ? void(close(this->fd)) : void();
+  MemoryArena::release(nullptr, this->staging);
+};
+
+SNAPSHOT_WRITER_TEMPLATE_DECLARATION
+snapshotHeader* SNAPSHOT_WRITER::header(std::uint32_t slot) const noexcept {
+  return reinterpret_cast<snapshotHeader*>(
+      static_cast<std::byte*>(this->mapping) + slot * slotBytes_);
+};
+
+SNAPSHOT_WRITER_TEMPLATE_DECLARATION
+bool SNAPSHOT_WRITER::valid() const noexcept {
+  return this->mapping != MAP_FAILED && this->staging != nullptr;
+};
+
+SNAPSHOT_WRITER_TEMPLATE_DECLARATION
+bool SNAPSHOT_WRITER::snapshot() noexcept {
+  if (!this->valid()) {
+    return false;
+  }
+  auto guard = AtomicGuards::AtomicFlagGuard(&this->writeLock);
+  guard.lock();
+  const OrderBook::bookStats stats = this->book->copyState(
+      std::span<std::byte>(this->staging, bookType_::stateBytes));
+  // slot of the newer snapshot is left untouched
+  const std::uint64_t next = this->sequence + 1;
+  snapshotHeader* slot = this->header(next % 2);
+  std::byte* body = reinterpret_cast<std::byte*>(slot) + pageSize;
+  // invalidate slot on disk before overwriting it
+  slot->sequence = 0;
+  bool synced = msync(slot, pageSize, MS_SYNC) == 0;
+  std::memcpy(body, this->staging, bookType_::stateBytes);
+  slot->magic = magic;
+  slot->stateBytes = bookType_::stateBytes;
+  slot->bookLength = bookType_::bookLength;
+  slot->basePrice = stats.basePrice;
+  slot->bestBid = stats.bestBid.value_or(TopOfBook::noPrice);
+  slot->lowestBid = stats.lowestBid.value_or(TopOfBook::noPrice);
+  slot->bestOffer = stats.bestOffer.value_or(TopOfBook::noPrice);
+  slot->highestOffer = stats.highestOffer.value_or(TopOfBook::noPrice);
+  synced = synced && msync(body, slotBytes_ - pageSize, MS_SYNC) == 0;
+  // slot only becomes valid once its contents are on disk
+  slot->sequence = synced ? next : 0;
+  synced = synced && msync(slot, pageSize, MS_SYNC) == 0;
+  this->sequence = synced ? next : this->sequence;
+  return synced;
+};
+
+SNAPSHOT_WRITER_TEMPLATE_DECLARATION
+void SNAPSHOT_WRITER::startInterval(std::chrono::milliseconds interval) {
+  this->stopInterval();
+  this->intervalThread = std::jthread([this, interval](std::stop_token stop) {
+    std::mutex mutex;
+    std::condition_variable_any wakeUp;
+    std::unique_lock lock(mutex);
+    // wait returns early once stop is requested
+    while (!wakeUp.wait_for(lock, stop, interval, [] { return false; }) &&
+           !stop.stop_requested()) {
+      this->snapshot();
+    }
+  });
+};
+
+SNAPSHOT_WRITER_TEMPLATE_DECLARATION
+void SNAPSHOT_WRITER::stopInterval() noexcept {
+  this->intervalThread.joinable()
+      ? void((this->intervalThread.request_stop(), this->intervalThread.join()))
+      : void();
+};
+
+SNAPSHOT_WRITER_TEMPLATE_DECLARATION
+std::uint64_t SNAPSHOT_WRITER::lastSequence() const noexcept {
+  return this->sequence;
+};
+
+template <typename bookType>
+requires bookType::copyableState
+std::optional<std::uint64_t> restore(bookType& book, const char* path) {
+  static constexpr std::size_t slotBytes_ = slotBytes<bookType>;
+  const int fd = open(path, O_RDONLY);
+  struct stat fileStat;
+  const bool sized = fd >= 0 && fstat(fd, &fileStat) == 0 &&
+                     static_cast<std::size_t>(fileStat.st_size) >=
+                         2 * slotBytes_;
+  void* mapping = sized ? mmap(nullptr, 2 * slotBytes_, PROT_READ,
+                               MAP_PRIVATE | MAP_POPULATE, fd, 0)
+                        : MAP_FAILED;
+  fd >= 0 ? void(close(fd)) : void();
+  if (mapping == MAP_FAILED) {
+    return std::nullopt;
+  }
+  // newest slot written completely for a book of the same layout
+  const snapshotHeader* newest = nullptr;
+  for (std::uint32_t i = 0; i < 2; ++i) {
+    const snapshotHeader* slot = reinterpret_cast<const snapshotHeader*>(
+        static_cast<const std::byte*>(mapping) + i * slotBytes_);
+    const bool usable = slot->magic == magic && slot->sequence != 0 &&
+                        slot->stateBytes == bookType::stateBytes &&
+                        slot->bookLength == bookType::bookLength;
+    newest = usable && (newest == nullptr || slot->sequence > newest->sequence)
+                 ? slot
+                 : newest;
+  }
+  const auto toOptional = [](std::uint32_t price) {
+    return price != TopOfBook::noPrice ? std::make_optional(price)
+                                       : std::nullopt;
+  };
+  // snapshot is checked on a scratch book first, book passed is left
+  // untouched unless the snapshot is valid
+  const auto restoreValid = [&]() {
+    const OrderBook::bookStats stats{
+        newest->basePrice, toOptional(newest->bestBid),
+        toOptional(newest->lowestBid), toOptional(newest->bestOffer),
+        toOptional(newest->highestOffer)};
+    const auto state = std::span<const std::byte>(
+        reinterpret_cast<const std::byte*>(newest) + pageSize,
+        bookType::stateBytes);
+    const auto candidate = std::make_unique<bookType>(newest->basePrice);
+    return candidate->restoreState(stats, state) &&
+           candidate->__invariantsCheck(0) == 0 &&
+           book.restoreState(stats, state);
+  };
+  const bool restored = newest != nullptr && restoreValid();
+  const std::optional<std::uint64_t> ret =
+      restored ? std::make_optional(newest->sequence) : std::nullopt;
+  munmap(mapping, 2 * slotBytes_);
+  return ret;
+};
+};  // namespace BookSnapshot
+
+#undef SNAPSHOT_WRITER_TEMPLATE_DECLARATION
+#undef SNAPSHOT_WRITER
@@ -0,0 +1,154 @@
+// validates the FIX checksum of a message: sum of all bytes in front of the
+// trailer modulo 256, trailer holding the sum as three ASCII digits
+// SSE2 and AVX2 versions of the byte sum are compiled alongside the scalar
+// one, the version used for messages of arbitrary length is picked once at
+// runtime depending on the CPU, messages of a length known at compile time are
+// summed by a fixed sequence of SSE2 loads (part of x86-64)
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace Checksum {
+// length of the trailer holding the checksum
+static constexpr std::uint32_t trailerLength = 3;
+
+// arguments: pointer to first byte, number of bytes, returns sum of all bytes
+// (not yet reduced modulo 256)
+using byteSumFunc = std::uint32_t (*)(const std::uint8_t*,
+                                      std::uint32_t) noexcept;
+
+inline std::uint32_t byteSumScalar(const std::uint8_t* bytes,
+                                   std::uint32_t len) noexcept {
+  std::uint32_t ret = 0;
+  for (std::uint32_t i = 0; i < len; ++i) {
+    ret += bytes[i];
+  }
+  return ret;
+};
+
+#if defined(__x86_64__)
+// psadbw against zero sums 8 bytes into each 64 bit half
+inline std::uint32_t reduceSSE2(__m128i sums) noexcept {
+  return _mm_cvtsi128_si64(sums) +
+         _mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums));
+};
+
+// 16 bytes per load, remainder summed by the scalar version
+inline std::uint32_t byteSumSSE2(const std::uint8_t* bytes,
+                                 std::uint32_t len) noexcept {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i sums = zero;
+  std::uint32_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    const __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+    sums = _mm_add_epi64(sums, _mm_sad_epu8(block, zero));
+  }
+  return reduceSSE2(sums) + byteSumScalar(bytes + i, len - i);
+};
+
+// 32 bytes per load, remainder handed to the SSE2 version
+__attribute__((target("avx2"))) inline std::uint32_t byteSumAVX2(
+    const std::uint8_t* bytes, std::uint32_t len) noexcept {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i sums = zero;
+  std::uint32_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    const __m256i block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i));
+    sums = _mm256_add_epi64(sums, _mm256_sad_epu8(block, zero));
+  }
+  const __m128i halves = _mm_add_epi64(_mm256_castsi256_si128(sums),
+                                       _mm256_extracti128_si256(sums, 1));
+  return reduceSSE2(halves) + byteSumSSE2(bytes + i, len - i);
+};
+#endif
+
+// widest version supported by the CPU
+inline byteSumFunc selectByteSum() noexcept {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return byteSumAVX2;
+  }
+  return byteSumSSE2;
+#endif
+  return byteSumScalar;
+};
+
+// dispatches to the version selected on first use
+inline std::uint32_t byteSum(const std::uint8_t* bytes,
+                             std::uint32_t len) noexcept {
+  static const byteSumFunc selected = selectByteSum();
+  return selected(bytes, len);
+};
+
+// byte sum of a length known at compile time, never reads outside of the
+// bytes summed: whole 16 (or 8) byte blocks, the remainder via a load
+// overlapping the preceding block, shifting out the bytes already summed
+template <std::uint32_t len_>
+std::uint32_t byteSumFixed(const std::uint8_t* bytes) noexcept {
+#if defined(__x86_64__)
+  if constexpr (len_ <= 8) {
+    return byteSumScalar(bytes, len_);
+  } else if constexpr (len_ < 16) {
+    std::uint64_t head, tail;
+    std::memcpy(&head, bytes, 8);
+    std::memcpy(&tail, bytes + len_ - 8, 8);
+    tail >>= 8 * (16 - len_);
+    const __m128i block = _mm_set_epi64x(static_cast<std::int64_t>(tail),
+                                         static_cast<std::int64_t>(head));
+    return reduceSSE2(_mm_sad_epu8(block, _mm_setzero_si128()));
+  } else {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sums = zero;
+    for (std::uint32_t i = 0; i + 16 <= len_; i += 16) {
+      const __m128i block =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+      sums = _mm_add_epi64(sums, _mm_sad_epu8(block, zero));
+    }
+    if constexpr (len_ % 16 != 0) {
+      const __m128i last = _mm_srli_si128(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + len_ - 16)),
+          16 - len_ % 16);
+      sums = _mm_add_epi64(sums, _mm_sad_epu8(last, zero));
+    }
+    return reduceSSE2(sums);
+  }
+#else
+  return byteSumScalar(bytes, len_);
+#endif
+};
+
+// value of the three ASCII digits of a trailer, -1 if any of them is not a
+// digit
+inline std::int32_t trailerValue(const std::uint8_t* trailer) noexcept {
+  const std::uint32_t d0 = trailer[0] - std::uint32_t{'0'};
+  const std::uint32_t d1 = trailer[1] - std::uint32_t{'0'};
+  const std::uint32_t d2 = trailer[2] - std::uint32_t{'0'};
+  // wraps around for bytes below '0'
+  const bool digits = d0 <= 9 && d1 <= 9 && d2 <= 9;
+  return digits ? static_cast<std::int32_t>(d0 * 100 + d1 * 10 + d2) : -1;
+};
+
+// message of any length including its trailer
+inline bool validate(const std::uint8_t* msg,
+                     std::uint32_t msgLength) noexcept {
+  return msgLength >= trailerLength &&
+         std::int32_t(byteSum(msg, msgLength - trailerLength) % 256) ==
+             trailerValue(msg + msgLength - trailerLength);
+};
+
+// message of a length known at compile time including its trailer
+template <std::uint32_t msgLength_>
+requires(msgLength_ >= trailerLength) bool validateFixed(
+    const std::uint8_t* msg) noexcept {
+  return std::int32_t(byteSumFixed<msgLength_ - trailerLength>(msg) % 256) ==
+         trailerValue(msg + msgLength_ - trailerLength);
+};
+};  // namespace Checksum
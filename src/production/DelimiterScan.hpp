@@ -0,0 +1,94 @@
+// finds the two byte delimiter of the Simple Open Framing Header in a run of
+// bytes, used to resynchronize on a corrupt or misaligned stream
+// SSE2 and AVX2 versions compare 16/32 positions against both delimiter bytes
+// at once and extract matches via movemask, the version used is picked once
+// at runtime depending on the CPU
+#pragma once
+
+#include <cstdint>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace DelimiterScan {
+// arguments: pointer to first byte, number of bytes, delimiter as stored in
+// memory (little-endian), returns offset of the first byte of the first
+// occurrence lying completely within the bytes, number of bytes if none
+using findFunc = std::uint32_t (*)(const std::uint8_t*, std::uint32_t,
+                                   std::uint16_t) noexcept;
+
+inline std::uint32_t findScalar(const std::uint8_t* bytes, std::uint32_t len,
+                                std::uint16_t delimiter) noexcept {
+  const std::uint8_t first = delimiter & 0xFF;
+  const std::uint8_t second = delimiter >> 8;
+  for (std::uint32_t i = 0; i + 1 < len; ++i) {
+    if (bytes[i] == first && bytes[i + 1] == second) {
+      return i;
+    }
+  }
+  return len;
+};
+
+#if defined(__x86_64__)
+// bit i of the mask is set if the delimiter starts at position i of the block,
+// second load is offset by one byte
+inline std::uint32_t findSSE2(const std::uint8_t* bytes, std::uint32_t len,
+                              std::uint16_t delimiter) noexcept {
+  const __m128i first = _mm_set1_epi8(static_cast<char>(delimiter & 0xFF));
+  const __m128i second = _mm_set1_epi8(static_cast<char>(delimiter >> 8));
+  std::uint32_t i = 0;
+  for (; i + 17 <= len; i += 16) {
+    const __m128i lo =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+    const __m128i hi =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i + 1));
+    const std::uint32_t mask = _mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(lo, first), _mm_cmpeq_epi8(hi, second)));
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return i + findScalar(bytes + i, len - i, delimiter);
+};
+
+__attribute__((target("avx2"))) inline std::uint32_t findAVX2(
+    const std::uint8_t* bytes, std::uint32_t len,
+    std::uint16_t delimiter) noexcept {
+  const __m256i first = _mm256_set1_epi8(static_cast<char>(delimiter & 0xFF));
+  const __m256i second = _mm256_set1_epi8(static_cast<char>(delimiter >> 8));
+  std::uint32_t i = 0;
+  for (; i + 33 <= len; i += 32) {
+    const __m256i lo =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i));
+    const __m256i hi =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i + 1));
+    const std::uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(
+        _mm256_cmpeq_epi8(lo, first), _mm256_cmpeq_epi8(hi, second)));
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return i + findSSE2(bytes + i, len - i, delimiter);
+};
+#endif
+
+// widest version supported by the CPU
+inline findFunc selectFind() noexcept {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return findAVX2;
+  }
+  return findSSE2;
+#endif
+  return findScalar;
+};
+
+// dispatches to the version selected on first use
+inline std::uint32_t find(const std::uint8_t* bytes, std::uint32_t len,
+                          std::uint16_t delimiter) noexcept {
+  static const findFunc selected = selectFind();
+  return selected(bytes, len, delimiter);
+};
+};  // namespace DelimiterScan
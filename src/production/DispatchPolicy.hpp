@@ -0,0 +1,18 @@
+// policies deciding how an order book passes a message contained in a variant
+// on to the handler of its type
+#pragma once
+
+namespace DispatchPolicy {
+// runs the handlers of all order types for every message, all but the actual
+// type are fed blank orders, no branches depending on the type of message
+struct runAll {
+  static constexpr bool runAllHandlers = true;
+};
+
+// only runs the handler of the actual type, dispatched via std::visit (usually
+// compiled to a jump table), avoids the dummy work of the blank orders at the
+// cost of an indirect branch
+struct jumpTable {
+  static constexpr bool runAllHandlers = false;
+};
+};  // namespace DispatchPolicy
@@ -1,16 +1,25 @@
 // class for handling a single socket, retrieving FIX SBE messages that come
 // with Simple Open Framing Header, constructing an object representing one of
 // multiple types of messages in a std::variant and emplacing it in some data
-// structure to be consumed elsewhere
+// structure to be consumed elsewhere, optionally streams bytes into a ring
+// buffer and decodes many messages per recv
+// message types are told apart via a dense table indexed by the template ID of
+// the SBE message header if all of them carry one, by message length otherwise
+// resynchronizes on corrupt streams by searching for the delimiter, accepting
+// a header found that way only if it belongs to a message type and the message
+// passes the checksum
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <bit>
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <functional>
+#include <limits>
 #include <numeric>
 #include <optional>
 #include <ranges>
@@ -18,14 +27,25 @@
 #include <span>
 
 #include "Auxil.hpp"
+#include "Checksum.hpp"
+#include "DelimiterScan.hpp"
+#include "FIXmsgClasses.hpp"
 #include "FIXmsgTypeChecks.hpp"
+#include "MemoryArena.hpp"
 
 namespace FIXSocketHandler {
-template <typename msgClassVariant_, typename socketType_>
+// streamBufferSize_ is the size of the ring buffer used by readMessages, zero
+// disables streaming mode
+template <typename msgClassVariant_, typename socketType_,
+          std::uint32_t streamBufferSize_ = 0>
 requires Auxil::readableAsSocket<socketType_> &&
     MsgTypeChecks::consistencyChecksAcrossMsgTypes<msgClassVariant_>::value &&
-    MsgTypeChecks::alternativesDefaultConstructible<
-        msgClassVariant_>::value struct fixSocketHandler {
+    MsgTypeChecks::alternativesDefaultConstructible<msgClassVariant_>::value &&
+    (streamBufferSize_ == 0 ||
+     (std::has_single_bit(streamBufferSize_) &&
+      streamBufferSize_ >=
+          MsgTypeChecks::determineMaxMsgLen<
+              msgClassVariant_>::value)) struct fixSocketHandler {
  private:
   // static data about byte layout of FIX messages
   static constexpr std::uint32_t delimitOffset =
@@ -42,36 +62,143 @@ requires Auxil::readableAsSocket<socketType_> &&
       MsgTypeChecks::determineMaxMsgLen<msgClassVariant_>::value;
   static constexpr std::uint32_t shortestMsgSize =
       MsgTypeChecks::determineMinMsgLen<msgClassVariant_>::value;
-  static_assert(shortestMsgSize > headerLength);
+  // message types are told apart by template ID if all of them carry an SBE
+  // message header, which then has to be read as well
+  static constexpr bool sbeHeader =
+      MsgTypeChecks::SBEMsgVariant<msgClassVariant_>::value;
+  static constexpr std::uint32_t dispatchHeaderLength = [] {
+    if constexpr (sbeHeader) {
+      return std::variant_alternative_t<0, msgClassVariant_>::versionOffset + 2;
+    } else {
+      return headerLength;
+    }
+  }();
+  static_assert(shortestMsgSize > dispatchHeaderLength);
   // index sequence used to generate static "loop" over message types
   static constexpr auto indexSeq =
       std::make_index_sequence<std::variant_size_v<msgClassVariant_>>();
+  // checksum of message of the type at index, summed over the length of that
+  // type known at compile time
+  template <std::size_t msgTypeIndex>
+  static bool validateChecksum(const std::uint8_t*) noexcept;
+  static bool rejectChecksum(const std::uint8_t*) noexcept;
+  template <std::size_t msgTypeIndex>
+  static msgClassVariant_ constructVariant(std::span<std::uint8_t>) noexcept;
+  static msgClassVariant_ constructDefault(std::span<std::uint8_t>) noexcept;
+  // entry of the dispatch table, index -1 if the key belongs to no message
+  // type, functions of such an entry reject every checksum and construct a
+  // default constructed variant
+  struct dispatchEntry {
+    std::int16_t msgTypeIndex = -1;
+    std::uint16_t blockLength = 0;
+    std::uint32_t msgLength = 0;
+    bool (*validate)(const std::uint8_t*) noexcept = &rejectChecksum;
+    msgClassVariant_ (*construct)(std::span<std::uint8_t>) noexcept =
+        &constructDefault;
+  };
+  // keys are template IDs or message lengths
+  static constexpr std::uint32_t dispatchKeys = [] {
+    if constexpr (sbeHeader) {
+      return MsgTypeChecks::determineMaxTemplateId<msgClassVariant_>::value + 1;
+    } else {
+      return bufferSize + 1;
+    }
+  }();
+  static_assert(std::variant_size_v<msgClassVariant_> <=
+                std::numeric_limits<std::int16_t>::max());
+  static constexpr std::array<dispatchEntry, dispatchKeys> dispatchTable =
+      []<std::size_t... Is>(std::index_sequence<Is...>) {
+        std::array<dispatchEntry, dispatchKeys> ret{};
+        (
+            [&]() {
+              using alt = std::variant_alternative_t<Is, msgClassVariant_>;
+              if constexpr (sbeHeader) {
+                ret[alt::templateId] = {Is, alt::blockLength, alt::msgLength,
+                                        &validateChecksum<Is>,
+                                        &constructVariant<Is>};
+              } else {
+                ret[alt::msgLength] = {Is, 0, alt::msgLength,
+                                       &validateChecksum<Is>,
+                                       &constructVariant<Is>};
+              }
+            }(),
+            ...);
+        return ret;
+      }(indexSeq);
+  static constexpr dispatchEntry noMsgType{};
+  // read buffer followed by bytes read ahead while resynchronizing
   void* readBuffer = nullptr;
   // span used to access buffer
   std::span<std::uint8_t, bufferSize> bufferSpan;
+  // bytes in [carryBegin, carryEnd) are handed out by receive before any
+  // further bytes from the socket
+  std::span<std::uint8_t, bufferSize> carrySpan;
+  std::uint32_t carryBegin = 0;
+  std::uint32_t carryEnd = 0;
+  // bytes skipped searching for a valid header
+  std::uint64_t discarded = 0;
+  // streaming mode: set from an invalid header until a message is accepted
+  bool resyncing = false;
   socketType_* socketPtr;
-  __attribute__((flatten)) bool validateChecksum(
-      std::uint32_t, const std::span<std::uint8_t, bufferSize>&) noexcept;
-  // finds delimiter of next message if it isn't found in the expected place
-  __attribute__((noinline)) int scanForDelimiter() noexcept;
+  MemoryArena::memoryArena* arena;
+  // length of the last message returned, zero if the last read failed
+  std::uint32_t lastLength = 0;
+  // ring buffer of streaming mode, positions only ever grow and are masked on
+  // access, bytes in [ringHead, ringTail) are yet to be decoded
+  void* streamBuffer = nullptr;
+  std::uint8_t* ring = nullptr;
+  std::uint64_t ringHead = 0;
+  std::uint64_t ringTail = 0;
+  // bytes of an oversized message still to be dropped from the stream
+  std::uint64_t pendingDiscard = 0;
+  static constexpr std::uint64_t ringMask = streamBufferSize_ - 1;
+  // recv serving bytes read ahead first, returns number of bytes received
+  std::int32_t receive(void*, std::uint32_t) noexcept;
+  // bytes of the read buffer in the range passed are handed out again by
+  // receive, ahead of those read ahead already
+  void pushBack(std::uint32_t, std::uint32_t) noexcept;
+  // finds next valid message if the header isn't found in the expected place,
+  // takes number of bytes in the read buffer, returns number of bytes of the
+  // message in the read buffer (zero if the socket delivers no more bytes)
+  __attribute__((noinline)) int scanForDelimiter(std::uint32_t) noexcept;
+  // streaming mode: advances ringHead by at least one byte to the next
+  // position holding the delimiter in its place or as far as bytes are buffered
+  void skipToDelimiter() noexcept;
   // safely discards excess bytes if an incoming message is longer than any of
   // the message types passed to buffer (and hence longer than buffer) returns
   // size of buffer for caller to assign to message-length variable so all
   // remaining bytes can be read within regular program logic
   __attribute__((noinline)) std::uint32_t discardLongMsg(std::uint32_t,
                                                          void*) noexcept;
+  // single recv into the contiguous free space of the ring buffer, returns
+  // number of bytes received
+  std::uint32_t refill() noexcept;
+  // message starting at position of ring buffer, copied to the read buffer if
+  // it straddles the wrap point
+  std::span<std::uint8_t> frameAt(std::uint64_t, std::uint32_t) noexcept;
+  // streaming mode: calls func(entry, bytes) with the dispatch table entry of
+  // the message for up to the number of valid messages passed, returns number
+  // of messages passed to func
+  template <typename funcType>
+  std::size_t decodeStream(std::size_t, funcType&&) noexcept;
+  // passes view of message type at index over bytes to target
+  template <std::size_t msgTypeIndex, typename targetType>
+  static void visitView(std::span<const std::uint8_t>, targetType&) noexcept;
 
-  // member function templates to generate "loop" over all message types to find
-  // and construct the correct one
-  template <std::size_t... Is>
-  int determineMsgType(int, std::index_sequence<Is...>) noexcept;
-
-  template <std::size_t... Is>
-  msgClassVariant_ constructVariant(int, std::span<std::uint8_t>,
-                                    std::index_sequence<Is...>) noexcept;
+  // dispatch table entry of the message length and header bytes passed
+  // (dispatchHeaderLength of them), entry with index -1 if none matches, a
+  // single lookup independent of the number of message types
+  const dispatchEntry& determineMsgType(std::uint32_t,
+                                        const std::uint8_t*) noexcept;
 
  public:
-  explicit fixSocketHandler(socketType_*);
+  // upper bound for memory taken from an arena passed to the constructor
+  static constexpr std::size_t arenaBytes =
+      MemoryArena::memoryArena::footprint(64, 2 * bufferSize) +
+      MemoryArena::memoryArena::footprint(64, streamBufferSize_);
+  static constexpr std::uint32_t streamBufferSize = streamBufferSize_;
+  // read buffer and ring buffer are taken from arena if one is passed
+  explicit fixSocketHandler(socketType_*, MemoryArena::memoryArena* = nullptr);
   ~fixSocketHandler();
   fixSocketHandler(const fixSocketHandler&) = delete;
   fixSocketHandler(fixSocketHandler&&) = delete;
@@ -82,23 +209,50 @@ requires Auxil::readableAsSocket<socketType_> &&
   // public interface for reading FIX messages from socket
   __attribute__((flatten)) std::optional<msgClassVariant>
   readNextMessage() noexcept;
+  // raw bytes of the message last returned by readNextMessage, empty if it
+  // returned no message, valid until the next read
+  std::span<const std::uint8_t> lastMessage() const noexcept;
+  // number of bytes skipped while searching for a valid header, messages of a
+  // type not contained in msgClassVariant and oversized messages are not
+  // counted
+  std::uint64_t discardedBytes() const noexcept;
+  // streaming mode: decodes complete messages from the ring buffer into msgs,
+  // calls recv only once no complete message is left and none has been
+  // decoded yet, returns number of messages decoded (zero if recv delivered
+  // nothing), not to be mixed with readNextMessage
+  std::size_t readMessages(std::span<msgClassVariant>) noexcept
+      requires(streamBufferSize_ > 0);
+  // streaming mode: passes a FIXmsgClasses::msgView of every complete message
+  // in the ring buffer to target, via target.processView(view) if target
+  // provides it (e.g. OrderBook::orderBook) or target(view) otherwise, views
+  // are only valid during the call, recv is called like in readMessages,
+  // returns number of messages passed
+  template <typename targetType>
+  std::size_t poll(targetType&) noexcept requires(streamBufferSize_ > 0);
 };
 };  // namespace FIXSocketHandler
 
-#define TEMPL_TYPES                                          \
-  template <typename msgClassVariant_, typename socketType_> \
-  requires Auxil::readableAsSocket<socketType_> &&           \
-      MsgTypeChecks::consistencyChecksAcrossMsgTypes<        \
-          msgClassVariant_>::value &&                        \
-      MsgTypeChecks::alternativesDefaultConstructible<msgClassVariant_>::value
+#define TEMPL_TYPES                                                            \
+  template <typename msgClassVariant_, typename socketType_,                   \
+            std::uint32_t streamBufferSize_>                                   \
+  requires Auxil::readableAsSocket<socketType_> &&                             \
+      MsgTypeChecks::consistencyChecksAcrossMsgTypes<                          \
+          msgClassVariant_>::value &&                                          \
+      MsgTypeChecks::alternativesDefaultConstructible<                         \
+          msgClassVariant_>::value &&                                          \
+      (streamBufferSize_ == 0 ||                                               \
+       (std::has_single_bit(streamBufferSize_) &&                              \
+        streamBufferSize_ >=                                                   \
+            MsgTypeChecks::determineMaxMsgLen<msgClassVariant_>::value))
 
-#define SOCK_HANDLER \
-  FIXSocketHandler::fixSocketHandler<msgClassVariant_, socketType_>
+#define SOCK_HANDLER                                               \
+  FIXSocketHandler::fixSocketHandler<msgClassVariant_, socketType_, \
+                                     streamBufferSize_>
 
 TEMPL_TYPES
 std::optional<msgClassVariant_> SOCK_HANDLER::readNextMessage() noexcept {
   // read length-of-header bytes into buffer
-  std::int32_t bytesRead = this->socketPtr->recv(readBuffer, headerLength);
+  std::int32_t bytesRead = this->receive(readBuffer, headerLength);
 
   // verifiy that header is valid by checking whether delimeter sequence is in
   // expected place
@@ -107,149 +261,402 @@ std::optional<msgClassVariant_> SOCK_HANDLER::readNextMessage() noexcept {
       reinterpret_cast<const std::uint8_t*>(&delimitValLocal), 2};
 
   // determine if bytes read are a valid header, find valid header if they are
-  // not
-  const bool validHeader = std::ranges::equal(
-      this->bufferSpan.subspan(delimitOffset, 2), delimitSpan);
-  bytesRead = validHeader ? bytesRead : scanForDelimiter();
+  // not, lengths too short for any message type are treated like an invalid
+  // header as the rest of the message could not be read otherwise
+  std::uint32_t msgLength =
+      *(std::uint32_t*)(reinterpret_cast<void*>(&bufferSpan[lengthOffset]));
+  const bool validHeader =
+      std::ranges::equal(this->bufferSpan.subspan(delimitOffset, 2),
+                         delimitSpan) &&
+      msgLength >= shortestMsgSize;
+  bytesRead = validHeader ? bytesRead : scanForDelimiter(bytesRead);
 
   // extract message length from message header
-  int msgLength =
+  msgLength =
       *(std::uint32_t*)(reinterpret_cast<void*>(&bufferSpan[lengthOffset]));
-  msgLength = msgLength <= bufferSize
-                  ? msgLength
-                  : this->discardLongMsg(msgLength, this->readBuffer);
+  const bool oversized = msgLength > bufferSize;
+  msgLength = !oversized ? msgLength
+                         : this->discardLongMsg(msgLength, this->readBuffer);
 
   // read rest of message into buffer
   void* recvDest = reinterpret_cast<void*>(&this->bufferSpan[bytesRead]);
-  this->socketPtr->recv(recvDest, msgLength - bytesRead);
+  this->receive(recvDest, msgLength - bytesRead);
 
-  // determine type of received message by checking all types in variant
-  static constexpr auto variantIndexSeq =
-      std::make_index_sequence<std::variant_size_v<msgClassVariant_>>();
-  int msgTypeIndex = determineMsgType(msgLength, variantIndexSeq);
+  // determine type of received message via the dispatch table
+  const dispatchEntry& entry =
+      determineMsgType(msgLength, this->bufferSpan.data());
 
   // validate message via checksum, if invalid message is discarded by setting
-  // type-index to -1, indicating cold path
-  msgTypeIndex = validateChecksum(msgLength, bufferSpan) ? msgTypeIndex : -1;
+  // type-index to -1, indicating cold path, bytes after the header are
+  // searched for the next message by the following read as the message may
+  // have been cut short
+  const bool validChecksum = entry.validate(this->bufferSpan.data());
+  if (!oversized && entry.msgTypeIndex >= 0 && !validChecksum) [[unlikely]] {
+    ++this->discarded;
+    this->pushBack(1, msgLength);
+  }
+  const int msgTypeIndex = validChecksum ? entry.msgTypeIndex : -1;
 
   // enqueue message to buffer
-  const auto returnVariant =
-      this->constructVariant(msgTypeIndex, this->bufferSpan, variantIndexSeq);
+  const auto returnVariant = entry.construct(this->bufferSpan);
   std::optional<msgClassVariant> ret =
       msgTypeIndex >= 0 ? std::make_optional(returnVariant) : std::nullopt;
+  this->lastLength = msgLength * (msgTypeIndex >= 0);
   return ret;
 };
 
 TEMPL_TYPES
-bool SOCK_HANDLER::validateChecksum(
-    std::uint32_t msgLength,
-    const std::span<std::uint8_t, bufferSize>& buffer) noexcept {
-  auto checkSumSubspan = buffer.subspan(0, msgLength - 3);
-  std::uint8_t byteSum = 0;
-  byteSum =
-      std::accumulate(checkSumSubspan.begin(), checkSumSubspan.end(), byteSum);
-  // convert three ASCII characters at the end of FIX msg to unsigned 8 bit int
-  // to compare to checksum computed above
-  std::uint8_t msgChecksum = ((this->bufferSpan[msgLength - 3]) - 48) * 100 +
-                             ((bufferSpan[msgLength - 2]) - 48) * 10 +
-                             ((bufferSpan[msgLength - 1]) - 48);
-  return byteSum == msgChecksum;
+std::span<const std::uint8_t> SOCK_HANDLER::lastMessage() const noexcept {
+  return this->bufferSpan.first(this->lastLength);
 };
 
 TEMPL_TYPES
-int SOCK_HANDLER::scanForDelimiter() noexcept {
-  static constexpr int bytesToKeep{headerLength - 1};
-  // discard first byte
-  auto searchSpan = this->bufferSpan.subspan(0, shortestMsgSize);
-  std::shift_left(searchSpan.begin(), searchSpan.end(), 1);
-  void* recvDest = reinterpret_cast<void*>(&searchSpan[bytesToKeep]);
-  this->socketPtr->recv(recvDest, shortestMsgSize - bytesToKeep);
-  const std::uint16_t delimitValLocal = delimitValue;
-  const auto delimitValSpan = std::span<const std::uint8_t, 2>{
-      reinterpret_cast<const std::uint8_t*>(&delimitValLocal), 2};
-  auto searchResult = std::ranges::search(searchSpan, delimitValSpan);
-  bool delimiterFound = !searchResult.empty();
-  while (!delimiterFound) {
-    std::shift_left(searchSpan.begin(), searchSpan.end(),
-                    shortestMsgSize - bytesToKeep);
-    this->socketPtr->recv(recvDest, shortestMsgSize - bytesToKeep);
-    searchResult = std::ranges::search(searchSpan, delimitValSpan);
-    delimiterFound = !searchResult.empty();
+std::uint64_t SOCK_HANDLER::discardedBytes() const noexcept {
+  return this->discarded;
+};
+
+TEMPL_TYPES
+std::size_t SOCK_HANDLER::readMessages(std::span<msgClassVariant> msgs) noexcept
+    requires(streamBufferSize_ > 0) {
+  this->lastLength = 0;
+  std::size_t nDecoded = 0;
+  return this->decodeStream(
+      msgs.size(), [&](const dispatchEntry& entry,
+                       std::span<std::uint8_t> frame) {
+        msgs[nDecoded++] = entry.construct(frame);
+      });
+};
+
+TEMPL_TYPES
+template <typename targetType>
+std::size_t SOCK_HANDLER::poll(targetType& target) noexcept
+    requires(streamBufferSize_ > 0) {
+  // per target type counterpart of the construct functions of the dispatch
+  // table, indexed by message type
+  using visitFunc = void (*)(std::span<const std::uint8_t>, targetType&);
+  static constexpr auto visitTable =
+      []<std::size_t... Is>(std::index_sequence<Is...>) {
+        return std::array<visitFunc, sizeof...(Is)>{
+            &visitView<Is, targetType>...};
+      }(indexSeq);
+  this->lastLength = 0;
+  return this->decodeStream(
+      std::numeric_limits<std::size_t>::max(),
+      [&](const dispatchEntry& entry, std::span<std::uint8_t> frame) {
+        visitTable[entry.msgTypeIndex](frame, target);
+      });
+};
+
+TEMPL_TYPES
+template <typename funcType>
+std::size_t SOCK_HANDLER::decodeStream(std::size_t maxMsgs,
+                                       funcType&& func) noexcept {
+  static constexpr std::uint16_t delimitValLocal = delimitValue;
+  std::size_t nDecoded = 0;
+  while (nDecoded < maxMsgs) {
+    // drop what has arrived of an oversized message
+    const std::uint64_t dropped =
+        std::min(this->pendingDiscard, this->ringTail - this->ringHead);
+    this->ringHead += dropped;
+    this->pendingDiscard -= dropped;
+    const std::uint64_t buffered = this->ringTail - this->ringHead;
+    bool incomplete =
+        this->pendingDiscard > 0 || buffered < dispatchHeaderLength;
+    std::uint32_t msgLength = 0;
+    const dispatchEntry* entry = &noMsgType;
+    if (!incomplete) {
+      // header may straddle the wrap point, gathered byte by byte
+      std::uint8_t header[dispatchHeaderLength];
+      for (std::uint32_t i = 0; i < dispatchHeaderLength; ++i) {
+        header[i] = this->ring[(this->ringHead + i) & ringMask];
+      }
+      std::memcpy(&msgLength, &header[lengthOffset], lengthLen);
+      entry = &determineMsgType(msgLength, header);
+      // resynchronize if delimiter is not in its place, lengths too short for
+      // any message type are treated like an invalid header, while
+      // resynchronizing only lengths of a message type are accepted
+      if (std::memcmp(&header[delimitOffset], &delimitValLocal, 2) != 0 ||
+          msgLength < shortestMsgSize ||
+          (this->resyncing && entry->msgTypeIndex < 0)) {
+        this->resyncing = true;
+        this->skipToDelimiter();
+        continue;
+      }
+      // oversized messages are dropped as they arrive
+      if (msgLength > bufferSize) {
+        this->pendingDiscard = msgLength;
+        continue;
+      }
+      incomplete = buffered < msgLength;
+    }
+    if (incomplete) {
+      // return messages decoded so far rather than block on the socket
+      if (nDecoded > 0 || this->refill() == 0) {
+        break;
+      }
+      continue;
+    }
+    const auto frame = this->frameAt(this->ringHead, msgLength);
+    const bool valid = entry->validate(frame.data());
+    // bytes after the header of a message of known type failing the checksum
+    // are searched for the next message as it may have been cut short
+    if (!valid && entry->msgTypeIndex >= 0) {
+      this->resyncing = true;
+      this->skipToDelimiter();
+      continue;
+    }
+    this->resyncing = false;
+    valid ? func(*entry, frame) : void();
+    nDecoded += valid;
+    this->ringHead += msgLength;
+  }
+  return nDecoded;
+};
+
+TEMPL_TYPES
+template <std::size_t msgTypeIndex, typename targetType>
+void SOCK_HANDLER::visitView(std::span<const std::uint8_t> frame,
+                             targetType& target) noexcept {
+  using viewType = FIXmsgClasses::msgView<
+      std::variant_alternative_t<msgTypeIndex, msgClassVariant_>>;
+  if constexpr (requires { target.processView(viewType(frame)); }) {
+    target.processView(viewType(frame));
+  } else {
+    target(viewType(frame));
+  }
+};
+
+TEMPL_TYPES
+std::uint32_t SOCK_HANDLER::refill() noexcept {
+  const std::uint64_t begin = this->ringTail & ringMask;
+  const std::uint64_t free =
+      streamBufferSize_ - (this->ringTail - this->ringHead);
+  const std::uint32_t len =
+      std::min<std::uint64_t>(free, streamBufferSize_ - begin);
+  const std::int32_t received =
+      len > 0 ? this->socketPtr->recv(&this->ring[begin], len) : 0;
+  this->ringTail += std::max(received, 0);
+  return std::max(received, 0);
+};
+
+TEMPL_TYPES
+std::span<std::uint8_t> SOCK_HANDLER::frameAt(std::uint64_t pos,
+                                              std::uint32_t len) noexcept {
+  const std::uint64_t begin = pos & ringMask;
+  if (begin + len <= streamBufferSize_) {
+    return std::span<std::uint8_t>{&this->ring[begin], len};
+  }
+  const std::uint32_t firstPart = streamBufferSize_ - begin;
+  std::memcpy(this->bufferSpan.data(), &this->ring[begin], firstPart);
+  std::memcpy(&this->bufferSpan[firstPart], this->ring, len - firstPart);
+  return this->bufferSpan.first(len);
+};
+
+TEMPL_TYPES
+template <std::size_t msgTypeIndex>
+bool SOCK_HANDLER::validateChecksum(const std::uint8_t* msg) noexcept {
+  return Checksum::validateFixed<
+      std::variant_alternative_t<msgTypeIndex, msgClassVariant_>::msgLength>(
+      msg);
+};
+
+// messages not matching any type are not summed
+TEMPL_TYPES
+bool SOCK_HANDLER::rejectChecksum(const std::uint8_t*) noexcept {
+  return false;
+};
+
+TEMPL_TYPES
+std::int32_t SOCK_HANDLER::receive(void* dest, std::uint32_t len) noexcept {
+  if (this->carryBegin == this->carryEnd) [[likely]] {
+    return this->socketPtr->recv(dest, len);
   }
-  const std::uint32_t positionOfHeader =
-      std::distance(searchSpan.begin(), std::ranges::get<0>(searchResult)) -
-      delimitOffset;
-  std::shift_left(searchSpan.begin(), searchSpan.end(), positionOfHeader);
-  return shortestMsgSize - positionOfHeader;
+  const std::uint32_t fromCarry =
+      std::min(len, this->carryEnd - this->carryBegin);
+  std::memcpy(dest, &this->carrySpan[this->carryBegin], fromCarry);
+  this->carryBegin += fromCarry;
+  const std::int32_t received =
+      fromCarry < len
+          ? this->socketPtr->recv(
+                reinterpret_cast<std::uint8_t*>(dest) + fromCarry,
+                len - fromCarry)
+          : 0;
+  return fromCarry + std::max(received, 0);
+};
+
+// bytes read ahead are never more than fit in the read buffer: bytes beyond a
+// message are only read while checking a candidate header, which reads no
+// further than the longest message
+TEMPL_TYPES
+void SOCK_HANDLER::pushBack(std::uint32_t begin, std::uint32_t end) noexcept {
+  const std::uint32_t len = end - begin;
+  const std::uint32_t carried = this->carryEnd - this->carryBegin;
+  std::memmove(&this->carrySpan[len], &this->carrySpan[this->carryBegin],
+               carried);
+  std::memcpy(this->carrySpan.data(), &this->bufferSpan[begin], len);
+  this->carryBegin = 0;
+  this->carryEnd = len + carried;
+};
+
+TEMPL_TYPES
+int SOCK_HANDLER::scanForDelimiter(std::uint32_t bytesRead) noexcept {
+  // bytes in read buffer, header at position 0 is invalid
+  std::uint8_t* window = this->bufferSpan.data();
+  std::uint32_t n = bytesRead;
+  std::uint32_t pos = 1;
+  // tops read buffer up to len bytes, false if the socket delivers fewer
+  auto fill = [&](std::uint32_t len) {
+    while (n < len) {
+      const std::int32_t received = this->receive(window + n, len - n);
+      if (received <= 0) {
+        return false;
+      }
+      n += received;
+    }
+    return true;
+  };
+  // moves header candidate at position to the front of the read buffer
+  auto drop = [&](std::uint32_t count) {
+    std::memmove(window, window + count, n - count);
+    n -= count;
+    this->discarded += count;
+  };
+  while (true) {
+    const std::uint32_t searchBegin = pos + delimitOffset;
+    const std::uint32_t searchLen = n > searchBegin ? n - searchBegin : 0;
+    const std::uint32_t found =
+        DelimiterScan::find(window + searchBegin, searchLen, delimitValue);
+    if (found == searchLen) {
+      // last byte may be the first of a delimiter, no more bytes are read than
+      // the shortest message holds to never read beyond the next message
+      drop(searchLen > 0 ? n - 1 - delimitOffset : std::min(pos, n));
+      pos = 0;
+      if (!fill(shortestMsgSize)) {
+        break;
+      }
+      continue;
+    }
+    drop(searchBegin + found - delimitOffset);
+    std::uint32_t msgLength = 0;
+    const bool headerRead = fill(dispatchHeaderLength);
+    std::memcpy(&msgLength, window + lengthOffset, lengthLen);
+    const dispatchEntry& entry =
+        headerRead ? determineMsgType(msgLength, window) : noMsgType;
+    // header of a message type and valid checksum, bytes read beyond the
+    // message are handed out by the following reads
+    if (entry.msgTypeIndex >= 0 && fill(msgLength) && entry.validate(window)) {
+      this->pushBack(msgLength, n);
+      return msgLength;
+    }
+    pos = 1;
+  }
+  // socket delivers no more bytes, zero length makes the caller return no
+  // message
+  this->discarded += n;
+  std::memset(window + lengthOffset, 0, lengthLen);
+  return 0;
+};
+
+TEMPL_TYPES
+void SOCK_HANDLER::skipToDelimiter() noexcept {
+  // contiguous part of the buffered bytes up to the wrap point
+  const std::uint64_t searchBegin = this->ringHead + 1 + delimitOffset;
+  const std::uint64_t begin = searchBegin & ringMask;
+  const std::uint32_t len =
+      this->ringTail > searchBegin
+          ? std::min<std::uint64_t>(this->ringTail - searchBegin,
+                                    streamBufferSize_ - begin)
+          : 0;
+  const std::uint32_t found =
+      DelimiterScan::find(&this->ring[begin], len, delimitValue);
+  // header starts in front of the delimiter found, otherwise the last byte
+  // searched may be the first of a delimiter (possibly across the wrap point)
+  const std::uint64_t next =
+      found < len ? searchBegin + found - delimitOffset
+                  : std::max(this->ringHead + 1,
+                             searchBegin + len - 1 - delimitOffset);
+  this->discarded += next - this->ringHead;
+  this->ringHead = next;
 };
 
 TEMPL_TYPES
 std::uint32_t SOCK_HANDLER::discardLongMsg(std::uint32_t msgLength,
                                            void* bufferPtr) noexcept {
-  int excessBytes = msgLength - bufferSize;
-  const int availableBuffer = bufferSize - headerLength;
-  std::uint32_t bytesRead{0};
+  std::uint32_t excessBytes = msgLength - bufferSize;
+  const std::uint32_t availableBuffer = bufferSize - headerLength;
   while (excessBytes > 0) {
-    bytesRead = this->socketPtr->recv(
+    const std::int32_t bytesRead = this->receive(
         reinterpret_cast<void*>(&this->bufferSpan[headerLength]),
         std::min(availableBuffer, excessBytes));
-    excessBytes -= bytesRead;
+    // gives up if the socket delivers no more bytes
+    excessBytes = bytesRead > 0 ? excessBytes - bytesRead : 0;
   }
   return this->bufferSize;
 };
 
-// returns index of matching alternative, -1 if no match found
-// argument var not needed for logic at runtime, but necessary to allow implicit
-// decution of variant type Variant_  and implicit template specialization this
-// allows the compiler to deduce all the indices in Is
-TEMPL_TYPES
-template <std::size_t... Is>
-int SOCK_HANDLER::determineMsgType(int compareTo,
-                                   std::index_sequence<Is...>) noexcept {
-  int ret = -1;
-  // lambda needs to be invoked with trailing "()" to work within fold
-  // expression
-  (
-      [&]() {
-        if (compareTo ==
-            std::variant_alternative_t<Is, msgClassVariant>::msgLength) {
-          ret = Is;
-        }
-      }(),
-      ...);
-  return ret;
+// SBE message header: schema ID and version are the same for all message
+// types (checked at compile time) and compared to constants, only the current
+// layout of each message type is decoded: a message encoded under an older
+// version of the schema is accepted only if that version left block length and
+// message length of its type unchanged, a type whose block length differed in
+// older versions is rejected under those versions
+TEMPL_TYPES
+const typename SOCK_HANDLER::dispatchEntry& SOCK_HANDLER::determineMsgType(
+    std::uint32_t msgLength, const std::uint8_t* header) noexcept {
+  if constexpr (sbeHeader) {
+    using first = std::variant_alternative_t<0, msgClassVariant_>;
+    std::uint16_t blockLength, templateId, schemaId, version;
+    std::memcpy(&blockLength, header + first::blockLengthOffset, 2);
+    std::memcpy(&templateId, header + first::templateIdOffset, 2);
+    std::memcpy(&schemaId, header + first::schemaIdOffset, 2);
+    std::memcpy(&version, header + first::versionOffset, 2);
+    const dispatchEntry& entry =
+        templateId < dispatchKeys ? dispatchTable[templateId] : noMsgType;
+    const bool valid = entry.msgLength == msgLength &&
+                       entry.blockLength == blockLength &&
+                       schemaId == first::schemaId &&
+                       version <= first::schemaVersion;
+    return valid ? entry : noMsgType;
+  } else {
+    return msgLength < dispatchKeys ? dispatchTable[msgLength] : noMsgType;
+  }
 };
 
-// returns variant containing message class specified by index argument, default
-// constructed variant if index is not valid for variant
-TEMPL_TYPES
-template <std::size_t... Is>
-typename SOCK_HANDLER::msgClassVariant SOCK_HANDLER::constructVariant(
-    int variantIndex, std::span<std::uint8_t> argument,
-    std::index_sequence<Is...>) noexcept {
-  msgClassVariant ret;
-  (
-      [&]() {
-        if (Is == variantIndex) {
-          ret.template emplace<
-              std::variant_alternative_t<Is, msgClassVariant_>>(argument);
-        }
-      }(),
-      ...);
-  return ret;
+// returns variant containing message class specified by index argument
+TEMPL_TYPES
+template <std::size_t msgTypeIndex>
+msgClassVariant_ SOCK_HANDLER::constructVariant(
+    std::span<std::uint8_t> argument) noexcept {
+  return msgClassVariant_{std::in_place_index<msgTypeIndex>, argument};
 };
 
+// default constructed variant for messages not matching any type
 TEMPL_TYPES
-SOCK_HANDLER::fixSocketHandler(socketType* socketPtrArg)
-    : socketPtr{socketPtrArg},
-      bufferSpan{reinterpret_cast<std::uint8_t*>(readBuffer), bufferSize} {
-  this->readBuffer = std::aligned_alloc(64, bufferSize);
-  this->bufferSpan = std::span<std::uint8_t, bufferSize>{
-      reinterpret_cast<std::uint8_t*>(readBuffer), bufferSize};
+msgClassVariant_ SOCK_HANDLER::constructDefault(
+    std::span<std::uint8_t>) noexcept {
+  return msgClassVariant_{};
 };
 
 TEMPL_TYPES
-SOCK_HANDLER::~fixSocketHandler() { std::free(this->readBuffer); };
+SOCK_HANDLER::fixSocketHandler(socketType* socketPtrArg,
+                               MemoryArena::memoryArena* arena_)
+    : readBuffer{MemoryArena::allocate(arena_, 64, 2 * bufferSize)},
+      bufferSpan{reinterpret_cast<std::uint8_t*>(readBuffer), bufferSize},
+      carrySpan{reinterpret_cast<std::uint8_t*>(readBuffer) + bufferSize,
+                bufferSize},
+      socketPtr{socketPtrArg},
+      arena{arena_},
+      streamBuffer{streamBufferSize_ > 0
+                       ? MemoryArena::allocate(arena_, 64, streamBufferSize_)
+                       : nullptr},
+      ring{reinterpret_cast<std::uint8_t*>(streamBuffer)} {};
+
+TEMPL_TYPES
+SOCK_HANDLER::~fixSocketHandler() {
+  MemoryArena::release(this->arena, this->readBuffer);
+  streamBufferSize_ > 0 ? MemoryArena::release(this->arena, this->streamBuffer)
+                        : void();
+};
 
 #undef TEMPL_TYPES
 #undef SOCK_HANDLER
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 #include <span>
 
 namespace FIXmsgClasses {
@@ -37,6 +38,44 @@ struct withdrawLimitOrder {
   explicit withdrawLimitOrder();
 };
 
+// limit order messages carrying an order ID, required by order level books
+struct addLimitOrderL3 {
+ public:
+  static constexpr std::uint32_t msgLength{25};
+  static constexpr std::uint32_t lengthOffset{0};
+  static constexpr std::uint32_t headerLength{6};
+  static constexpr std::uint32_t delimiterOffset{4};
+  static constexpr std::uint32_t delimiterValue{0xEB50};
+  static constexpr std::uint32_t volumeOffset{6};
+  static constexpr std::uint32_t priceOffset{10};
+  static constexpr std::uint32_t orderIDOffset{14};
+  std::int32_t orderVolume;
+  std::uint32_t orderPrice;
+  std::uint64_t orderID;
+  explicit addLimitOrderL3(std::int32_t, std::uint32_t, std::uint64_t = 0);
+  explicit addLimitOrderL3(const std::span<std::uint8_t>&);
+  explicit addLimitOrderL3();
+};
+
+struct withdrawLimitOrderL3 {
+ public:
+  static constexpr std::uint32_t msgLength{26};
+  static constexpr std::uint32_t lengthOffset{0};
+  static constexpr std::uint32_t headerLength{6};
+  static constexpr std::uint32_t delimiterOffset{4};
+  static constexpr std::uint32_t delimiterValue{0xEB50};
+  static constexpr std::uint32_t volumeOffset{6};
+  static constexpr std::uint32_t priceOffset{10};
+  static constexpr std::uint32_t orderIDOffset{14};
+  std::int32_t orderVolume;
+  std::uint32_t orderPrice;
+  std::uint64_t orderID;
+  explicit withdrawLimitOrderL3(std::int32_t, std::uint32_t,
+                                std::uint64_t = 0);
+  explicit withdrawLimitOrderL3(const std::span<std::uint8_t>&);
+  explicit withdrawLimitOrderL3();
+};
+
 struct marketOrder {
  public:
   static constexpr std::uint32_t msgLength{13};
@@ -50,6 +89,113 @@ struct marketOrder {
   explicit marketOrder(const std::span<std::uint8_t>&);
   explicit marketOrder();
 };
+
+// extends any of the classes above by a 32-bit instrument ID placed right in
+// front of the checksum, used to route messages to the book of an instrument
+template <typename baseMsg>
+struct instrumentMsg : baseMsg {
+ public:
+  static constexpr std::uint32_t msgLength{baseMsg::msgLength + 4};
+  static constexpr std::uint32_t instrumentIDOffset{baseMsg::msgLength - 3};
+  std::uint32_t instrumentID = 0;
+  using baseMsg::baseMsg;
+  explicit instrumentMsg(const std::span<std::uint8_t>&);
+  explicit instrumentMsg(const baseMsg&, std::uint32_t);
+  explicit instrumentMsg();
+};
+
+// offsets of optional fields moved by shift bytes, declared only if baseMsg
+// has the field, hide those of baseMsg
+template <typename baseMsg, std::uint32_t shift>
+struct shiftPriceOffset : baseMsg {
+  using baseMsg::baseMsg;
+};
+
+template <typename baseMsg, std::uint32_t shift>
+requires requires { baseMsg::priceOffset; }
+struct shiftPriceOffset<baseMsg, shift> : baseMsg {
+  static constexpr std::uint32_t priceOffset{baseMsg::priceOffset + shift};
+  using baseMsg::baseMsg;
+};
+
+template <typename baseMsg, std::uint32_t shift>
+struct shiftOrderIDOffset : shiftPriceOffset<baseMsg, shift> {
+  using shiftPriceOffset<baseMsg, shift>::shiftPriceOffset;
+};
+
+template <typename baseMsg, std::uint32_t shift>
+requires requires { baseMsg::orderIDOffset; }
+struct shiftOrderIDOffset<baseMsg, shift> : shiftPriceOffset<baseMsg, shift> {
+  static constexpr std::uint32_t orderIDOffset{baseMsg::orderIDOffset + shift};
+  using shiftPriceOffset<baseMsg, shift>::shiftPriceOffset;
+};
+
+template <typename baseMsg, std::uint32_t shift>
+struct shiftFieldOffsets : shiftOrderIDOffset<baseMsg, shift> {
+  using shiftOrderIDOffset<baseMsg, shift>::shiftOrderIDOffset;
+};
+
+template <typename baseMsg, std::uint32_t shift>
+requires requires { baseMsg::instrumentIDOffset; }
+struct shiftFieldOffsets<baseMsg, shift> : shiftOrderIDOffset<baseMsg, shift> {
+  static constexpr std::uint32_t instrumentIDOffset{
+      baseMsg::instrumentIDOffset + shift};
+  using shiftOrderIDOffset<baseMsg, shift>::shiftOrderIDOffset;
+};
+
+// extends any of the classes above (instrumentMsg included, sbeMsg outermost)
+// by the SBE message header placed right after the framing header: block
+// length (bytes of fields between header and checksum), template ID, schema ID
+// and schema version, 16 bits each, moves all fields back by its length
+// message types of a variant carrying it are told apart by template ID
+template <typename baseMsg, std::uint16_t templateId_,
+          std::uint16_t schemaId_ = 1, std::uint16_t schemaVersion_ = 0>
+struct sbeMsg : shiftFieldOffsets<baseMsg, 8> {
+ public:
+  static constexpr std::uint32_t sbeHeaderLength{8};
+  static constexpr std::uint32_t msgLength{baseMsg::msgLength +
+                                           sbeHeaderLength};
+  static constexpr std::uint32_t volumeOffset{baseMsg::volumeOffset +
+                                              sbeHeaderLength};
+  static constexpr std::uint32_t blockLengthOffset{baseMsg::headerLength};
+  static constexpr std::uint32_t templateIdOffset{blockLengthOffset + 2};
+  static constexpr std::uint32_t schemaIdOffset{blockLengthOffset + 4};
+  static constexpr std::uint32_t versionOffset{blockLengthOffset + 6};
+  // fields only, framing header and 3 byte checksum excluded
+  static constexpr std::uint16_t blockLength{baseMsg::msgLength -
+                                             baseMsg::headerLength - 3};
+  static constexpr std::uint16_t templateId{templateId_};
+  static constexpr std::uint16_t schemaId{schemaId_};
+  static constexpr std::uint16_t schemaVersion{schemaVersion_};
+  using shiftFieldOffsets<baseMsg, 8>::shiftFieldOffsets;
+  explicit sbeMsg(const std::span<std::uint8_t>&);
+  explicit sbeMsg(const baseMsg&);
+  explicit sbeMsg();
+};
+
+// read-only view over the bytes of a received message of type msgClass, loads
+// fields from the bytes on access instead of copying them into a message
+// object, valid as long as the bytes it was constructed from
+template <typename msgClass>
+struct msgView {
+ private:
+  const std::uint8_t* bytes;
+  template <typename fieldType>
+  fieldType load(std::uint32_t) const noexcept;
+
+ public:
+  using msgType = msgClass;
+  explicit msgView(std::span<const std::uint8_t>) noexcept;
+  std::int32_t orderVolume() const noexcept;
+  std::uint32_t orderPrice() const noexcept
+      requires requires { msgClass::priceOffset; };
+  std::uint64_t orderID() const noexcept
+      requires requires { msgClass::orderIDOffset; };
+  std::uint32_t instrumentID() const noexcept
+      requires requires { msgClass::instrumentIDOffset; };
+  // copies the message into a message object
+  msgClass materialize() const noexcept;
+};
 };  // namespace FIXmsgClasses
 
 namespace FIXmsgClasses {
@@ -80,6 +226,39 @@ withdrawLimitOrder::withdrawLimitOrder(std::int32_t orderVolume_,
 
 withdrawLimitOrder::withdrawLimitOrder() : orderVolume{0}, orderPrice{0} {};
 
+addLimitOrderL3::addLimitOrderL3(const std::span<std::uint8_t>& bufferSpan) {
+  this->orderVolume =
+      *reinterpret_cast<std::int32_t*>(&bufferSpan[volumeOffset]);
+  this->orderPrice =
+      *reinterpret_cast<std::uint32_t*>(&bufferSpan[priceOffset]);
+  this->orderID = *reinterpret_cast<std::uint64_t*>(&bufferSpan[orderIDOffset]);
+};
+
+addLimitOrderL3::addLimitOrderL3(std::int32_t orderVolume_,
+                                 std::uint32_t orderPrice_,
+                                 std::uint64_t orderID_)
+    : orderVolume{orderVolume_}, orderPrice{orderPrice_}, orderID{orderID_} {};
+
+addLimitOrderL3::addLimitOrderL3()
+    : orderVolume{0}, orderPrice{0}, orderID{0} {};
+
+withdrawLimitOrderL3::withdrawLimitOrderL3(
+    const std::span<std::uint8_t>& bufferSpan) {
+  this->orderVolume =
+      *reinterpret_cast<std::int32_t*>(&bufferSpan[volumeOffset]);
+  this->orderPrice =
+      *reinterpret_cast<std::uint32_t*>(&bufferSpan[priceOffset]);
+  this->orderID = *reinterpret_cast<std::uint64_t*>(&bufferSpan[orderIDOffset]);
+};
+
+withdrawLimitOrderL3::withdrawLimitOrderL3(std::int32_t orderVolume_,
+                                           std::uint32_t orderPrice_,
+                                           std::uint64_t orderID_)
+    : orderVolume{orderVolume_}, orderPrice{orderPrice_}, orderID{orderID_} {};
+
+withdrawLimitOrderL3::withdrawLimitOrderL3()
+    : orderVolume{0}, orderPrice{0}, orderID{0} {};
+
 marketOrder::marketOrder(const std::span<std::uint8_t>& bufferSpan) {
   this->orderVolume =
       *reinterpret_cast<std::int32_t*>(&bufferSpan[volumeOffset]);
@@ -89,4 +268,79 @@ marketOrder::marketOrder(std::int32_t orderVolume_)
     : orderVolume{orderVolume_} {};
 
 marketOrder::marketOrder() : orderVolume{0} {};
-};  // namespace FIXmsgClasses
\ No newline at end of file
+
+template <typename baseMsg>
+instrumentMsg<baseMsg>::instrumentMsg(const std::span<std::uint8_t>& bufferSpan)
+    : baseMsg(bufferSpan) {
+  this->instrumentID =
+      *reinterpret_cast<std::uint32_t*>(&bufferSpan[instrumentIDOffset]);
+};
+
+template <typename baseMsg>
+instrumentMsg<baseMsg>::instrumentMsg(const baseMsg& msg,
+                                      std::uint32_t instrumentID_)
+    : baseMsg(msg), instrumentID{instrumentID_} {};
+
+template <typename baseMsg>
+instrumentMsg<baseMsg>::instrumentMsg() : baseMsg() {};
+
+// fields are read by baseMsg at its own offsets past the SBE message header
+template <typename baseMsg, std::uint16_t templateId_, std::uint16_t schemaId_,
+          std::uint16_t schemaVersion_>
+sbeMsg<baseMsg, templateId_, schemaId_, schemaVersion_>::sbeMsg(
+    const std::span<std::uint8_t>& bufferSpan)
+    : shiftFieldOffsets<baseMsg, 8>(bufferSpan.subspan(sbeHeaderLength)) {};
+
+template <typename baseMsg, std::uint16_t templateId_, std::uint16_t schemaId_,
+          std::uint16_t schemaVersion_>
+sbeMsg<baseMsg, templateId_, schemaId_, schemaVersion_>::sbeMsg(
+    const baseMsg& msg) {
+  static_cast<baseMsg&>(*this) = msg;
+};
+
+template <typename baseMsg, std::uint16_t templateId_, std::uint16_t schemaId_,
+          std::uint16_t schemaVersion_>
+sbeMsg<baseMsg, templateId_, schemaId_, schemaVersion_>::sbeMsg()
+    : shiftFieldOffsets<baseMsg, 8>() {};
+// unaligned loads, fields are not aligned within messages
+template <typename msgClass>
+template <typename fieldType>
+fieldType msgView<msgClass>::load(std::uint32_t offset) const noexcept {
+  fieldType ret;
+  std::memcpy(&ret, this->bytes + offset, sizeof(fieldType));
+  return ret;
+};
+
+template <typename msgClass>
+msgView<msgClass>::msgView(std::span<const std::uint8_t> bytes_) noexcept
+    : bytes{bytes_.data()} {};
+
+template <typename msgClass>
+std::int32_t msgView<msgClass>::orderVolume() const noexcept {
+  return this->load<std::int32_t>(msgClass::volumeOffset);
+};
+
+template <typename msgClass>
+std::uint32_t msgView<msgClass>::orderPrice() const noexcept
+    requires requires { msgClass::priceOffset; } {
+  return this->load<std::uint32_t>(msgClass::priceOffset);
+};
+
+template <typename msgClass>
+std::uint64_t msgView<msgClass>::orderID() const noexcept
+    requires requires { msgClass::orderIDOffset; } {
+  return this->load<std::uint64_t>(msgClass::orderIDOffset);
+};
+
+template <typename msgClass>
+std::uint32_t msgView<msgClass>::instrumentID() const noexcept
+    requires requires { msgClass::instrumentIDOffset; } {
+  return this->load<std::uint32_t>(msgClass::instrumentIDOffset);
+};
+
+template <typename msgClass>
+msgClass msgView<msgClass>::materialize() const noexcept {
+  return msgClass(std::span<std::uint8_t>(
+      const_cast<std::uint8_t*>(this->bytes), msgClass::msgLength));
+};
+};  // namespace FIXmsgClasses
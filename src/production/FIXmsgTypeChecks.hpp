@@ -1,8 +1,10 @@
 #pragma once
 
 #include <algorithm>
+#include <concepts>
 #include <cstdint>
 #include <limits>
+#include <variant>
 
 #include "Auxil.hpp"
 
@@ -41,6 +43,54 @@ concept OrderBookLimitOrderInterfaceConcept =
   { LimitOrderClass(i32, ui32) } -> std::same_as<LimitOrderClass>;
 };
 
+// defines interface for limit order class required by order level book
+template <typename LimitOrderClass>
+concept OrderBookL3LimitOrderInterfaceConcept =
+    OrderBookLimitOrderInterfaceConcept<LimitOrderClass> &&
+    requires(LimitOrderClass limitOrder, std::int32_t i32, std::uint32_t ui32,
+             std::uint64_t ui64) {
+  { limitOrder.orderID } -> std::same_as<std::uint64_t&>;
+  { LimitOrderClass(i32, ui32, ui64) } -> std::same_as<LimitOrderClass>;
+};
+
+// defines interface of views over received messages (FIXmsgClasses::msgView)
+// accepted by order book class, fields are loaded on access
+template <typename viewType, typename msgClass>
+concept OrderBookOrderViewConcept =
+    std::same_as<typename viewType::msgType, msgClass> &&
+    requires(const viewType view) {
+  { view.orderVolume() } -> std::same_as<std::int32_t>;
+};
+
+// fields of message objects and message views alike, used by order book class
+// to process both
+template <typename orderType>
+std::int32_t volumeOf(const orderType& order) noexcept {
+  if constexpr (requires { order.orderVolume(); }) {
+    return order.orderVolume();
+  } else {
+    return order.orderVolume;
+  }
+};
+
+template <typename orderType>
+std::uint32_t priceOf(const orderType& order) noexcept {
+  if constexpr (requires { order.orderPrice(); }) {
+    return order.orderPrice();
+  } else {
+    return order.orderPrice;
+  }
+};
+
+template <typename orderType>
+std::uint64_t orderIDOf(const orderType& order) noexcept {
+  if constexpr (requires { order.orderID(); }) {
+    return order.orderID();
+  } else {
+    return order.orderID;
+  }
+};
+
 // wrapper class to make OrderBookMarketOrderInterface_ concept suitalbe for
 // classic TMP
 template <typename MarketOrderClass>
@@ -57,6 +107,14 @@ struct OrderBookLimitOrderInterfaceMetafunc {
       OrderBookLimitOrderInterfaceConcept<LimitOrderClass>;
 };
 
+// wrapper class to make OrderBookL3LimitOrderInterfaceConcept suitable for
+// classic TMP
+template <typename LimitOrderClass>
+struct OrderBookL3LimitOrderInterfaceMetafunc {
+  static constexpr bool value =
+      OrderBookL3LimitOrderInterfaceConcept<LimitOrderClass>;
+};
+
 template <typename MsgClassVariant, size_t... Indeces>
 struct OrderBookMarketOrderInterface {
   static constexpr bool value = Auxil::Variant::validate_variant_at_indeces<
@@ -70,6 +128,30 @@ struct OrderBookLimitOrderInterface {
       MsgClassVariant, OrderBookLimitOrderInterfaceMetafunc, Indeces...>::value;
 };
 
+template <typename MsgClassVariant, size_t... Indeces>
+struct OrderBookL3LimitOrderInterface {
+  static constexpr bool value = Auxil::Variant::validate_variant_at_indeces<
+      MsgClassVariant, OrderBookL3LimitOrderInterfaceMetafunc,
+      Indeces...>::value;
+};
+
+// defines interface for message classes routed to books by instrument ID
+template <typename msgClass>
+concept InstrumentMsgConcept = requires(msgClass msg) {
+  { msg.instrumentID } -> std::same_as<std::uint32_t&>;
+};
+
+// true iff all alternatives of variant carry an instrument ID
+template <typename MsgClassVariant>
+struct InstrumentMsgVariant {
+  static constexpr bool value = false;
+};
+
+template <typename... MsgClasses>
+struct InstrumentMsgVariant<std::variant<MsgClasses...>> {
+  static constexpr bool value = (InstrumentMsgConcept<MsgClasses> && ...);
+};
+
 // check to ensure no two messages in variant have the same message length
 template <typename FixMsg1, typename FixMsg2>
 struct msgLenNotEqual {
@@ -80,6 +162,56 @@ template <typename Variant>
 using checkMsgLenNotEqual =
     Auxil::Variant::validate_variant<Variant, msgLenNotEqual>;
 
+// defines interface for message classes carrying an SBE message header
+// (FIXmsgClasses::sbeMsg)
+template <typename msgClass>
+concept SBEMsgConcept = requires {
+  { msgClass::templateId } -> std::same_as<const std::uint16_t&>;
+  { msgClass::schemaId } -> std::same_as<const std::uint16_t&>;
+  { msgClass::schemaVersion } -> std::same_as<const std::uint16_t&>;
+  { msgClass::blockLength } -> std::same_as<const std::uint16_t&>;
+  { msgClass::templateIdOffset } -> std::same_as<const std::uint32_t&>;
+};
+
+// true iff all alternatives of variant carry an SBE message header
+template <typename MsgClassVariant>
+struct SBEMsgVariant {
+  static constexpr bool value = false;
+};
+
+template <typename... MsgClasses>
+struct SBEMsgVariant<std::variant<MsgClasses...>> {
+  static constexpr bool value = (SBEMsgConcept<MsgClasses> && ...);
+};
+
+// check to ensure no two messages in variant have the same template ID
+template <typename FixMsg1, typename FixMsg2>
+struct templateIdNotEqual {
+  static constexpr bool value = FixMsg1::templateId != FixMsg2::templateId;
+};
+
+// check to ensure all messages in variant are defined by the same version of
+// the same schema, allows header fields to be compared to a single constant
+template <typename FixMsg1, typename FixMsg2>
+struct schemaEqual {
+  static constexpr bool value = FixMsg1::schemaId == FixMsg2::schemaId &&
+                                FixMsg1::schemaVersion == FixMsg2::schemaVersion;
+};
+
+// message types are told apart by template ID if all of them carry an SBE
+// message header (messages of equal length allowed), by length otherwise
+template <typename Variant, bool sbe = SBEMsgVariant<Variant>::value>
+struct checkMsgTypesDistinct {
+  static constexpr bool value = checkMsgLenNotEqual<Variant>::value;
+};
+
+template <typename Variant>
+struct checkMsgTypesDistinct<Variant, true> {
+  static constexpr bool value =
+      Auxil::Variant::validate_variant<Variant, templateIdNotEqual>::value &&
+      Auxil::Variant::validate_variant<Variant, schemaEqual>::value;
+};
+
 // check to ensure postion of message length in byte stream is the same across
 // all message types in variant
 template <typename FixMsg1, typename FixMsg2>
@@ -146,7 +278,7 @@ using checkVolOffsetEqual =
 // combines all the checks specified above
 template <typename msgClassVariant>
 struct consistencyChecksAcrossMsgTypes {
-  static constexpr bool value = checkMsgLenNotEqual<msgClassVariant>::value &&
+  static constexpr bool value = checkMsgTypesDistinct<msgClassVariant>::value &&
                                 checkLenOffsetEqual<msgClassVariant>::value &&
                                 checkHeaderLenEqual<msgClassVariant>::value &&
                                 checkDelimOffsetEqual<msgClassVariant>::value &&
@@ -180,6 +312,17 @@ using determineMinMsgLen = Auxil::Variant::aggregate_over_variant<
     Variant, std::uint32_t, std::numeric_limits<std::uint32_t>::max(),
     UInt32Min, retrieveMsgLen>;
 
+// determine highest template ID across all message types in variant
+template <typename FixMsg>
+struct retrieveTemplateId {
+  static constexpr std::uint32_t value = FixMsg::templateId;
+};
+
+template <typename Variant>
+using determineMaxTemplateId =
+    Auxil::Variant::aggregate_over_variant<Variant, std::uint32_t, 0, UInt32Max,
+                                           retrieveTemplateId>;
+
 // ensure all message classes are default constructible
 template <bool b1, bool b2>
 struct andAggregator {
@@ -0,0 +1,152 @@
+// receivers of the per-level fills generated while an order runs through the
+// book, one record per price level (partially) consumed, no memory is
+// allocated, bufferSink writes records directly into their final location
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "Auxil.hpp"
+
+namespace FillSink {
+// side of the order taking liquidity
+static constexpr std::uint8_t buy = 0;
+static constexpr std::uint8_t sell = 1;
+
+// volume is the absolute volume traded at price, sequence increases by one
+// with every record so consumers can detect gaps or dropped records
+template <typename entryType>
+struct fillRecord {
+  std::uint64_t sequence = 0;
+  entryType volume = 0;
+  std::uint32_t price = 0;
+  std::uint8_t aggressorSide = buy;
+};
+
+// default of the order book, no fills are reported and no code is generated
+// for reporting them
+struct noFills {
+  static constexpr bool enabled = false;
+  template <typename entryType>
+  void fill(std::uint32_t, entryType, std::uint8_t) noexcept {};
+};
+
+// writes records to consecutive elements of a buffer owned by the caller,
+// records not fitting the buffer are counted and dropped, consumers read
+// them in place and call clear before the buffer is reused
+template <typename entryType_>
+struct bufferSink {
+ private:
+  std::span<fillRecord<entryType_>> buffer;
+  std::size_t nRecords = 0;
+  std::uint64_t sequence = 0;
+  std::uint64_t dropped = 0;
+
+ public:
+  static constexpr bool enabled = true;
+  using record = fillRecord<entryType_>;
+  explicit bufferSink(std::span<fillRecord<entryType_>>) noexcept;
+  bufferSink(const bufferSink&) = delete;
+  bufferSink& operator=(const bufferSink&) = delete;
+  bufferSink(bufferSink&&) = delete;
+  bufferSink& operator=(bufferSink&&) = delete;
+  // arguments: price, absolute volume, aggressor side
+  void fill(std::uint32_t, entryType_, std::uint8_t) noexcept;
+  // records written since the last call to clear
+  std::span<const fillRecord<entryType_>> records() const noexcept;
+  void clear() noexcept;
+  // number of records that did not fit the buffer
+  std::uint64_t droppedCount() const noexcept;
+  // sequence number of the last record generated (written or dropped)
+  std::uint64_t lastSequence() const noexcept;
+};
+
+// pushes every record onto a queue, e.g. Queue::SeqLockQueue, the record is
+// built as the argument of enqueue and copied into the queue's slot once,
+// the queue offers no way of constructing it in place
+template <typename entryType_, typename queueType_>
+requires Auxil::writableAsQueue<queueType_, fillRecord<entryType_>>
+struct queueSink {
+ private:
+  queueType_* queue;
+  std::uint64_t sequence = 0;
+
+ public:
+  static constexpr bool enabled = true;
+  using record = fillRecord<entryType_>;
+  explicit queueSink(queueType_*) noexcept;
+  queueSink(const queueSink&) = delete;
+  queueSink& operator=(const queueSink&) = delete;
+  queueSink(queueSink&&) = delete;
+  queueSink& operator=(queueSink&&) = delete;
+  // arguments: price, absolute volume, aggressor side
+  void fill(std::uint32_t, entryType_, std::uint8_t) noexcept;
+  // sequence number of the last record pushed
+  std::uint64_t lastSequence() const noexcept;
+};
+};  // namespace FillSink
+
+namespace FillSink {
+template <typename entryType_>
+bufferSink<entryType_>::bufferSink(
+    std::span<fillRecord<entryType_>> buffer_) noexcept
+    : buffer{buffer_} {};
+
+template <typename entryType_>
+void bufferSink<entryType_>::fill(std::uint32_t price, entryType_ volume,
+                                  std::uint8_t side) noexcept {
+  ++this->sequence;
+  if (this->nRecords == this->buffer.size()) [[unlikely]] {
+    ++this->dropped;
+    return;
+  }
+  fillRecord<entryType_>& slot = this->buffer[this->nRecords++];
+  slot.sequence = this->sequence;
+  slot.volume = volume;
+  slot.price = price;
+  slot.aggressorSide = side;
+};
+
+template <typename entryType_>
+std::span<const fillRecord<entryType_>> bufferSink<entryType_>::records()
+    const noexcept {
+  return this->buffer.first(this->nRecords);
+};
+
+template <typename entryType_>
+void bufferSink<entryType_>::clear() noexcept {
+  this->nRecords = 0;
+};
+
+template <typename entryType_>
+std::uint64_t bufferSink<entryType_>::droppedCount() const noexcept {
+  return this->dropped;
+};
+
+template <typename entryType_>
+std::uint64_t bufferSink<entryType_>::lastSequence() const noexcept {
+  return this->sequence;
+};
+
+template <typename entryType_, typename queueType_>
+requires Auxil::writableAsQueue<queueType_, fillRecord<entryType_>>
+queueSink<entryType_, queueType_>::queueSink(queueType_* queue_) noexcept
+    : queue{queue_} {};
+
+template <typename entryType_, typename queueType_>
+requires Auxil::writableAsQueue<queueType_, fillRecord<entryType_>>
+void queueSink<entryType_, queueType_>::fill(std::uint32_t price,
+                                             entryType_ volume,
+                                             std::uint8_t side) noexcept {
+  this->queue->enqueue(
+      fillRecord<entryType_>{++this->sequence, volume, price, side});
+};
+
+template <typename entryType_, typename queueType_>
+requires Auxil::writableAsQueue<queueType_, fillRecord<entryType_>>
+std::uint64_t queueSink<entryType_, queueType_>::lastSequence()
+    const noexcept {
+  return this->sequence;
+};
+};  // namespace FillSink
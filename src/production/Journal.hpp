@@ -0,0 +1,463 @@
+// write-ahead journal of the raw bytes of accepted messages, appended to
+// preallocated, memory mapped segment files of fixed size by the thread
+// reading the socket, a background thread syncs the active segment to disk,
+// retires full segments and prepares the next one so the reading thread
+// neither blocks on IO nor faults in pages
+// records are replayed through a socket handler to rebuild an order book after
+// a restart
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include "FIXSocketHandler.hpp"
+
+namespace Journal {
+static constexpr std::size_t pageSize = 4096;
+static constexpr std::size_t defaultSegmentBytes = 64 * 1024 * 1024;
+
+// precedes the bytes of every record, records are padded to multiples of 8
+// bytes, a zero sequence number marks the end of the records in a segment,
+// torn records left by a crash are caught by the checksum of the message
+struct recordHeader {
+  std::uint64_t sequence = 0;
+  // time stamp counter when the record was appended
+  std::uint64_t timestamp = 0;
+  std::uint32_t length = 0;
+  std::uint32_t padding = 0;
+};
+
+// record as handed out by journalReader, bytes point into the mapped segment
+struct journalRecord {
+  std::uint64_t sequence = 0;
+  std::uint64_t timestamp = 0;
+  std::span<const std::uint8_t> bytes;
+};
+
+// path of segment file with index in directory
+inline std::filesystem::path segmentPath(const std::filesystem::path& directory,
+                                         std::uint64_t index) {
+  return directory / ("journal_" + std::to_string(index) + ".seg");
+};
+
+inline std::uint64_t timestamp() noexcept {
+#if defined(__x86_64__)
+  return __rdtsc();
+#else
+  return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+};
+
+// reads records of all segments in a directory in order of their sequence
+// numbers, stops at the first gap
+struct journalReader {
+ private:
+  std::filesystem::path directory;
+  std::uint64_t segmentIndex = 0;
+  std::byte* memory = nullptr;
+  std::size_t segmentBytes = 0;
+  std::size_t offset = 0;
+  std::uint64_t sequence = 0;
+  std::optional<std::uint64_t> lastSegment_;
+  bool openSegment() noexcept;
+  void closeSegment() noexcept;
+
+ public:
+  explicit journalReader(const char*);
+  ~journalReader();
+  journalReader(const journalReader&) = delete;
+  journalReader& operator=(const journalReader&) = delete;
+  journalReader(journalReader&&) = delete;
+  journalReader& operator=(journalReader&&) = delete;
+  // next record, nullopt at the end of the journal, bytes stay valid until
+  // the reader moves on to the next segment
+  std::optional<journalRecord> next() noexcept;
+  // sequence number of the last record handed out, zero if there was none
+  std::uint64_t lastSequence() const noexcept;
+  // index of the segment containing the last record handed out
+  std::optional<std::uint64_t> lastSegment() const noexcept;
+};
+
+struct journalWriter {
+ private:
+  struct segment {
+    int fd = -1;
+    std::byte* memory = nullptr;
+    std::uint64_t index = 0;
+  };
+  // states of the segment not being written to
+  static constexpr std::uint8_t ready = 0;
+  static constexpr std::uint8_t retired = 1;
+  static constexpr std::uint8_t failed = 2;
+  std::filesystem::path directory;
+  std::size_t segmentBytes;
+  std::chrono::milliseconds syncInterval;
+  segment segments[2];
+  // data used by appending thread
+  std::uint32_t activeSlot = 0;
+  std::size_t offset = 0;
+  std::uint64_t sequence = 0;
+  std::uint64_t rolloverWaits_ = 0;
+  // data shared with background thread
+  alignas(64) std::atomic<std::uint32_t> publishedSlot = 0;
+  std::atomic<std::size_t> publishedOffset = 0;
+  std::atomic<std::uint8_t> spareState = ready;
+  std::jthread syncThread;
+  bool prepare(segment&, std::uint64_t) noexcept;
+  void retire(segment&) noexcept;
+  // switches to the spare segment, waits for the background thread if it is
+  // not ready yet, returns false if it could not be prepared
+  bool rollover() noexcept;
+
+ public:
+  // continues the journal in directory (created if missing) after its last
+  // record, in a new segment, segment size is rounded up to whole pages, not
+  // valid if the first two segments could not be mapped
+  explicit journalWriter(
+      const char*, std::size_t = defaultSegmentBytes,
+      std::chrono::milliseconds = std::chrono::milliseconds(10));
+  ~journalWriter();
+  journalWriter(const journalWriter&) = delete;
+  journalWriter& operator=(const journalWriter&) = delete;
+  journalWriter(journalWriter&&) = delete;
+  journalWriter& operator=(journalWriter&&) = delete;
+  bool valid() const noexcept;
+  // appends record containing bytes passed, returns its sequence number, zero
+  // if the writer is not valid or the record exceeds a segment
+  std::uint64_t append(std::span<const std::uint8_t>) noexcept;
+  std::uint64_t lastSequence() const noexcept;
+  // number of rollovers that had to wait for the background thread
+  std::uint64_t rolloverWaits() const noexcept;
+};
+
+// sits between a socket handler and the consumer of its messages, appends the
+// raw bytes of every message returned to the journal before handing it on
+template <typename handlerType_>
+struct journalingStage {
+ private:
+  handlerType_* handler;
+  journalWriter* writer;
+
+ public:
+  using msgClassVariant = typename handlerType_::msgClassVariant;
+  journalingStage(handlerType_* handler_, journalWriter* writer_) noexcept
+      : handler{handler_}, writer{writer_} {};
+  std::optional<msgClassVariant> readNextMessage() noexcept {
+    auto ret = this->handler->readNextMessage();
+    ret.has_value() ? void(this->writer->append(this->handler->lastMessage()))
+                    : void();
+    return ret;
+  };
+};
+
+// socket handing out the bytes of consecutive records, used to feed a journal
+// back through a socket handler
+struct replaySocket {
+ private:
+  journalReader* reader;
+  std::span<const std::uint8_t> pending;
+
+ public:
+  explicit replaySocket(journalReader* reader_) noexcept : reader{reader_} {};
+  // copies bytes of consecutive records, fewer than requested if the journal
+  // ends
+  std::int32_t recv(void*, std::uint32_t) noexcept;
+  // true if all records have been handed out
+  bool exhausted() noexcept;
+};
+
+// feeds all records of the journal in directory through a socket handler into
+// book (at full speed), returns number of messages processed
+template <typename bookType>
+std::uint64_t replay(const char* directory, bookType& book) noexcept {
+  journalReader reader(directory);
+  replaySocket socket(&reader);
+  FIXSocketHandler::fixSocketHandler<typename bookType::msgClassVariant,
+                                     replaySocket>
+      handler(&socket);
+  std::uint64_t nMessages = 0;
+  while (!socket.exhausted()) {
+    const auto msg = handler.readNextMessage();
+    msg.has_value() ? void(book.processOrder(msg.value())) : void();
+    nMessages += msg.has_value();
+  }
+  return nMessages;
+};
+};  // namespace Journal
+
+namespace Journal {
+inline journalReader::journalReader(const char* directory_)
+    : directory{directory_} {};
+
+inline journalReader::~journalReader() { this->closeSegment(); };
+
+inline bool journalReader::openSegment() noexcept {
+  const std::string path = segmentPath(this->directory, this->segmentIndex);
+  const int fd = open(path.c_str(), O_RDONLY);
+  struct stat fileStat;
+  const bool sized = fd >= 0 && fstat(fd, &fileStat) == 0 &&
+                     fileStat.st_size >= static_cast<off_t>(pageSize);
+  void* mapping = sized ? mmap(nullptr, fileStat.st_size, PROT_READ,
+                               MAP_SHARED | MAP_POPULATE, fd, 0)
+                        : MAP_FAILED;
+  fd >= 0 ? void(close(fd)) : void();
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+  this->memory = static_cast<std::byte*>(mapping);
+  this->segmentBytes = fileStat.st_size;
+  this->offset = 0;
+  return true;
+};
+
+inline void journalReader::closeSegment() noexcept {
+  this->memory != nullptr ? void(munmap(this->memory, this->segmentBytes))
+                          : void();
+  this->memory = nullptr;
+};
+
+inline std::optional<journalRecord> journalReader::next() noexcept {
+  while (this->memory != nullptr || this->openSegment()) {
+    const bool headerFits =
+        this->offset + sizeof(recordHeader) <= this->segmentBytes;
+    const recordHeader* header =
+        reinterpret_cast<const recordHeader*>(this->memory + this->offset);
+    const std::uint64_t recordSequence =
+        headerFits ? std::atomic_ref<std::uint64_t>(
+                         const_cast<std::uint64_t&>(header->sequence))
+                         .load(std::memory_order_acquire)
+                   : 0;
+    const bool valid =
+        recordSequence != 0 &&
+        (this->sequence == 0 || recordSequence == this->sequence + 1) &&
+        this->offset + sizeof(recordHeader) + header->length <=
+            this->segmentBytes;
+    if (valid) {
+      const std::uint8_t* bytes = reinterpret_cast<const std::uint8_t*>(
+          this->memory + this->offset + sizeof(recordHeader));
+      this->offset +=
+          (sizeof(recordHeader) + header->length + 7) & ~std::size_t{7};
+      this->sequence = recordSequence;
+      this->lastSegment_ = this->segmentIndex;
+      return journalRecord{recordSequence, header->timestamp,
+                           std::span<const std::uint8_t>(bytes,
+                                                         header->length)};
+    }
+    // segment without records ends the journal, otherwise continue with the
+    // next segment
+    const bool emptySegment = this->offset == 0;
+    this->closeSegment();
+    if (emptySegment) {
+      return std::nullopt;
+    }
+    ++this->segmentIndex;
+  }
+  return std::nullopt;
+};
+
+inline std::uint64_t journalReader::lastSequence() const noexcept {
+  return this->sequence;
+};
+
+inline std::optional<std::uint64_t> journalReader::lastSegment()
+    const noexcept {
+  return this->lastSegment_;
+};
+
+inline journalWriter::journalWriter(const char* directory_,
+                                    std::size_t segmentBytes_,
+                                    std::chrono::milliseconds syncInterval_)
+    : directory{directory_},
+      segmentBytes{(segmentBytes_ + pageSize - 1) / pageSize * pageSize},
+      syncInterval{syncInterval_} {
+  std::error_code error;
+  std::filesystem::create_directories(this->directory, error);
+  // continue numbering after the last record of an existing journal
+  std::uint64_t firstSegment = 0;
+  {
+    journalReader reader(directory_);
+    while (reader.next().has_value()) {
+    }
+    this->sequence = reader.lastSequence();
+    firstSegment = reader.lastSegment().value_or(
+                       std::numeric_limits<std::uint64_t>::max()) +
+                   1;
+  }
+  if (!this->prepare(this->segments[0], firstSegment) ||
+      !this->prepare(this->segments[1], firstSegment + 1)) {
+    return;
+  }
+  this->syncThread = std::jthread([this](std::stop_token stop) {
+    std::mutex mutex;
+    std::condition_variable_any wakeUp;
+    std::unique_lock lock(mutex);
+    while (!stop.stop_requested()) {
+      // wait returns early once stop is requested
+      wakeUp.wait_for(lock, stop, this->syncInterval, [] { return false; });
+      const std::size_t synced =
+          this->publishedOffset.load(std::memory_order_acquire);
+      const std::uint32_t slot =
+          this->publishedSlot.load(std::memory_order_acquire);
+      msync(this->segments[slot].memory,
+            (synced + pageSize - 1) / pageSize * pageSize, MS_SYNC);
+      // active slot can not change while the spare is retired
+      if (this->spareState.load(std::memory_order_acquire) == retired) {
+        segment& spare =
+            this->segments[this->publishedSlot.load(std::memory_order_acquire) ^
+                           1];
+        const std::uint64_t nextIndex = spare.index + 2;
+        this->retire(spare);
+        this->spareState.store(
+            this->prepare(spare, nextIndex) ? ready : failed,
+            std::memory_order_release);
+      }
+    }
+  });
+};
+
+inline journalWriter::~journalWriter() {
+  this->syncThread.joinable()
+      ? void((this->syncThread.request_stop(), this->syncThread.join()))
+      : void();
+  for (segment& seg : this->segments) {
+    this->retire(seg);
+  }
+};
+
+inline bool journalWriter::prepare(segment& seg, std::uint64_t index) noexcept {
+  const std::string path = segmentPath(this->directory, index);
+  seg.index = index;
+  seg.fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  // reserve blocks up front, writes to the mapping can not fail for lack of
+  // space later on
+  const bool allocated =
+      seg.fd >= 0 && posix_fallocate(seg.fd, 0, this->segmentBytes) == 0;
+  void* mapping =
+      allocated ? mmap(nullptr, this->segmentBytes, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, seg.fd, 0)
+                : MAP_FAILED;
+  seg.memory = mapping != MAP_FAILED ? static_cast<std::byte*>(mapping)
+                                     : nullptr;
+  if (seg.memory == nullptr) {
+    return false;
+  }
+  // write to every page so appending never faults
+  volatile std::byte* bytes = seg.memory;
+  for (std::size_t i = 0; i < this->segmentBytes; i += pageSize) {
+    bytes[i] = std::byte{0};
+  }
+  return true;
+};
+
+inline void journalWriter::retire(segment& seg) noexcept {
+  if (seg.memory != nullptr) {
+    msync(seg.memory, this->segmentBytes, MS_SYNC);
+    munmap(seg.memory, this->segmentBytes);
+  }
+  seg.fd >= 0 ? void(close(seg.fd)) : void();
+  seg.memory = nullptr;
+  seg.fd = -1;
+};
+
+inline bool journalWriter::valid() const noexcept {
+  return this->syncThread.joinable();
+};
+
+inline bool journalWriter::rollover() noexcept {
+  std::uint8_t state = this->spareState.load(std::memory_order_acquire);
+  this->rolloverWaits_ += state != ready;
+  while (state == retired) {
+    std::this_thread::yield();
+    state = this->spareState.load(std::memory_order_acquire);
+  }
+  if (state == failed) {
+    return false;
+  }
+  this->activeSlot ^= 1;
+  this->offset = 0;
+  this->publishedOffset.store(0, std::memory_order_release);
+  this->publishedSlot.store(this->activeSlot, std::memory_order_release);
+  this->spareState.store(retired, std::memory_order_release);
+  return true;
+};
+
+inline std::uint64_t journalWriter::append(
+    std::span<const std::uint8_t> bytes) noexcept {
+  const std::size_t recordBytes =
+      (sizeof(recordHeader) + bytes.size() + 7) & ~std::size_t{7};
+  if (!this->valid() || recordBytes > this->segmentBytes) [[unlikely]] {
+    return 0;
+  }
+  if (this->offset + recordBytes > this->segmentBytes) [[unlikely]] {
+    if (!this->rollover()) {
+      return 0;
+    }
+  }
+  std::byte* dest = this->segments[this->activeSlot].memory + this->offset;
+  recordHeader* header = reinterpret_cast<recordHeader*>(dest);
+  std::memcpy(dest + sizeof(recordHeader), bytes.data(), bytes.size());
+  header->timestamp = timestamp();
+  header->length = bytes.size();
+  // sequence number last, record becomes visible to readers of the mapping
+  std::atomic_ref<std::uint64_t>(header->sequence)
+      .store(++this->sequence, std::memory_order_release);
+  this->offset += recordBytes;
+  this->publishedOffset.store(this->offset, std::memory_order_release);
+  return this->sequence;
+};
+
+inline std::uint64_t journalWriter::lastSequence() const noexcept {
+  return this->sequence;
+};
+
+inline std::uint64_t journalWriter::rolloverWaits() const noexcept {
+  return this->rolloverWaits_;
+};
+
+inline std::int32_t replaySocket::recv(void* dest,
+                                       std::uint32_t len) noexcept {
+  std::uint32_t copied = 0;
+  while (copied < len && !this->exhausted()) {
+    const std::uint32_t n =
+        std::min<std::size_t>(len - copied, this->pending.size());
+    std::memcpy(static_cast<std::uint8_t*>(dest) + copied,
+                this->pending.data(), n);
+    this->pending = this->pending.subspan(n);
+    copied += n;
+  }
+  return copied;
+};
+
+inline bool replaySocket::exhausted() noexcept {
+  while (this->pending.empty()) {
+    const auto record = this->reader->next();
+    if (!record.has_value()) {
+      return true;
+    }
+    this->pending = record->bytes;
+  }
+  return false;
+};
+};  // namespace Journal
@@ -0,0 +1,98 @@
+// policies deciding how an order book serializes its writers, every policy is
+// the lock type held by the book, locked for each write access via lock() and
+// unlock()
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace LockPolicy {
+// hint to the core that the thread is spinning, frees resources for the
+// sibling hyperthread and avoids a memory order violation when leaving the
+// spin loop
+inline void pause() noexcept {
+#if defined(__x86_64__)
+  _mm_pause();
+#endif
+};
+
+// compiles the lock out, only for books with a single writing thread (e.g.
+// profiling_single_threaded or a shard of Pipeline::shardedPipeline), readers
+// only protected by the lock (drainChangedLevels and copyState, hence
+// MBPPublisher and BookSnapshot::snapshotWriter) are not available
+struct noLock {
+  static constexpr bool enabled = false;
+  void lock() noexcept {};
+  void unlock() noexcept {};
+};
+
+// spins on test and set of an atomic flag, every failed attempt is a write to
+// the cacheline of the lock
+struct flagSpin {
+ private:
+  std::atomic_flag flag = false;
+
+ public:
+  static constexpr bool enabled = true;
+  void lock() noexcept {
+    while (this->flag.test_and_set(std::memory_order_acquire)) {
+    }
+  };
+  void unlock() noexcept { this->flag.clear(std::memory_order_release); };
+};
+
+// writers are served in order of arrival, no writer starves however many
+// others contend, waiting writers only read the cacheline of the lock
+struct ticketLock {
+ private:
+  std::atomic<std::uint32_t> nextTicket = 0;
+  std::atomic<std::uint32_t> nowServing = 0;
+
+ public:
+  static constexpr bool enabled = true;
+  void lock() noexcept {
+    const std::uint32_t ticket =
+        this->nextTicket.fetch_add(1, std::memory_order_relaxed);
+    while (this->nowServing.load(std::memory_order_acquire) != ticket) {
+      pause();
+    }
+  };
+  // only the holder writes nowServing, no read-modify-write needed
+  void unlock() noexcept {
+    this->nowServing.store(
+        this->nowServing.load(std::memory_order_relaxed) + 1,
+        std::memory_order_release);
+  };
+};
+
+// test and test and set, waiting writers read the lock until it appears free
+// before attempting to take it, after every failed attempt they pause for
+// twice as long as before, up to maxPauses_ pause instructions
+template <std::uint32_t maxPauses_ = 1024>
+requires(maxPauses_ > 0) struct backoffLock {
+ private:
+  std::atomic<bool> locked = false;
+
+ public:
+  static constexpr bool enabled = true;
+  static constexpr std::uint32_t maxPauses = maxPauses_;
+  void lock() noexcept {
+    std::uint32_t pauses = 1;
+    while (this->locked.load(std::memory_order_relaxed) ||
+           this->locked.exchange(true, std::memory_order_acquire)) {
+      for (std::uint32_t i = 0; i < pauses; ++i) {
+        pause();
+      }
+      pauses = std::min(2 * pauses, maxPauses_);
+    }
+  };
+  void unlock() noexcept {
+    this->locked.store(false, std::memory_order_release);
+  };
+};
+};  // namespace LockPolicy
@@ -0,0 +1,107 @@
+// turns price levels changed in an order book into market by price delta
+// records and pushes them onto a queue, consumers rebuild a mirror of the book
+// by applying the records in sequence
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include "Auxil.hpp"
+
+namespace MBPPublisher {
+// kinds of delta records, a reset record tells consumers to empty their
+// mirror, it is followed by all non-empty levels of the book
+static constexpr std::uint8_t bid = 0;
+static constexpr std::uint8_t offer = 1;
+static constexpr std::uint8_t emptied = 2;
+static constexpr std::uint8_t reset = 3;
+
+// new volume of a single price level, volume is negative for bids, sequence
+// increases by one with every record so consumers can detect gaps
+template <typename entryType>
+struct mbpDelta {
+  std::uint64_t sequence = 0;
+  entryType volume = 0;
+  std::uint32_t price = 0;
+  std::uint8_t side = emptied;
+};
+
+template <typename bookType_, typename queueType_>
+requires bookType_::trackChanges && bookType_::lockPolicy::enabled &&
+    Auxil::writableAsQueue<queueType_,
+                           mbpDelta<typename bookType_::entryType>>
+struct mbpPublisher {
+ private:
+  using entryType = typename bookType_::entryType;
+  using deltaType = mbpDelta<entryType>;
+  bookType_* book;
+  queueType_* queue;
+  std::uint64_t sequence = 0;
+  std::atomic<bool> snapshotRequested;
+
+ public:
+  using delta = deltaType;
+  // first call to publish sends a snapshot so consumers start from a full book
+  mbpPublisher(bookType_*, queueType_*);
+  mbpPublisher(const mbpPublisher&) = delete;
+  mbpPublisher& operator=(const mbpPublisher&) = delete;
+  mbpPublisher(mbpPublisher&&) = delete;
+  mbpPublisher& operator=(mbpPublisher&&) = delete;
+  // pushes one record for every level changed since the last call, to be
+  // called after processing an order or a batch of orders, returns number of
+  // records pushed
+  std::uint32_t publish() noexcept;
+  // next call to publish sends a snapshot (reset record followed by all
+  // non-empty levels), may be called by consumers having detected a gap
+  void requestSnapshot() noexcept;
+  // sequence number of the last record pushed
+  std::uint64_t lastSequence() const noexcept;
+};
+};  // namespace MBPPublisher
+
+#define MBP_PUBLISHER_TEMPLATE_DECLARATION               \
+  template <typename bookType_, typename queueType_>     \
+  requires bookType_::trackChanges &&                    \
+      bookType_::lockPolicy::enabled &&                  \
+      Auxil::writableAsQueue<queueType_,                 \
+                             mbpDelta<typename bookType_::entryType>>
+
+#define MBP_PUBLISHER MBPPublisher::mbpPublisher<bookType_, queueType_>
+
+namespace MBPPublisher {
+MBP_PUBLISHER_TEMPLATE_DECLARATION
+MBP_PUBLISHER::mbpPublisher(bookType_* book_, queueType_* queue_)
+    : book{book_}, queue{queue_}, snapshotRequested{true} {};
+
+MBP_PUBLISHER_TEMPLATE_DECLARATION
+std::uint32_t MBP_PUBLISHER::publish() noexcept {
+  std::uint32_t nRecords = 0;
+  this->book->drainChangedLevels(
+      this->snapshotRequested.exchange(false, std::memory_order_relaxed),
+      [&]() {
+        this->queue->enqueue(deltaType{++this->sequence, 0, 0, reset});
+        ++nRecords;
+      },
+      [&](std::uint32_t price, entryType volume) {
+        const std::uint8_t side =
+            volume < 0 ? bid : (volume > 0 ? offer : emptied);
+        this->queue->enqueue(deltaType{++this->sequence, volume, price, side});
+        ++nRecords;
+      });
+  return nRecords;
+};
+
+MBP_PUBLISHER_TEMPLATE_DECLARATION
+void MBP_PUBLISHER::requestSnapshot() noexcept {
+  this->snapshotRequested.store(true, std::memory_order_relaxed);
+};
+
+MBP_PUBLISHER_TEMPLATE_DECLARATION
+std::uint64_t MBP_PUBLISHER::lastSequence() const noexcept {
+  return this->sequence;
+};
+};  // namespace MBPPublisher
+
+#undef MBP_PUBLISHER_TEMPLATE_DECLARATION
+#undef MBP_PUBLISHER
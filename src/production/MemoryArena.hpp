@@ -0,0 +1,187 @@
+// contiguous block of memory handed out to order books, queues and socket
+// handlers by bumping an offset, mapped once during construction, aligned to
+// and sized in multiples of 2MB, backed by huge pages if possible, optionally
+// bound to a NUMA node, prefaulted and locked so no page faults occur once
+// messages are being processed
+#pragma once
+
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+
+namespace MemoryArena {
+// number of nodes covered by the node mask passed to mbind, the largest
+// number of nodes supported by the kernel (MAX_NUMNODES)
+static constexpr int maxNumaNodes = 1024;
+
+// how the memory of an arena is backed, every step is best effort, memory is
+// usable regardless of the outcome
+struct arenaOptions {
+  // write to every page during construction
+  bool prefault = true;
+  // keep all pages resident, limited by RLIMIT_MEMLOCK
+  bool lock = true;
+  // bind memory to a NUMA node, first touch decides if empty, nodes outside
+  // [0, maxNumaNodes) are not bound
+  std::optional<int> numaNode = std::nullopt;
+};
+
+struct memoryArena {
+ private:
+  static constexpr std::size_t hugePageSize = 2 * 1024 * 1024;
+  static constexpr std::size_t pageSize = 4096;
+  std::size_t capacity_;
+  // mapping may be larger than capacity to align memory to huge pages
+  void* mappedPointer;
+  std::size_t mappedBytes;
+  void* memoryPointer;
+  std::size_t offset = 0;
+  bool hugeTLB_ = false, numaBound_ = false, locked_ = false;
+
+ public:
+  // capacity is rounded up to a multiple of the huge page size, tries
+  // explicit huge pages (MAP_HUGETLB) first and falls back to transparent huge
+  // pages, capacity is zero if no memory could be mapped at all
+  explicit memoryArena(std::size_t, arenaOptions = arenaOptions{});
+  ~memoryArena();
+  memoryArena(const memoryArena&) = delete;
+  memoryArena& operator=(const memoryArena&) = delete;
+  memoryArena(memoryArena&&) = delete;
+  memoryArena& operator=(memoryArena&&) = delete;
+  // returns nullptr if the remaining memory is insufficient, alignment must be
+  // a power of two
+  void* allocate(std::size_t, std::size_t) noexcept;
+  bool contains(const void*) const noexcept;
+  std::size_t capacity() const noexcept;
+  std::size_t used() const noexcept;
+  // outcome of the steps taken during construction
+  bool hugeTLB() const noexcept;
+  bool numaBound() const noexcept;
+  bool locked() const noexcept;
+  // upper bound for the memory consumed by an allocation of given alignment and
+  // size
+  static constexpr std::size_t footprint(std::size_t alignment,
+                                         std::size_t size) noexcept {
+    return size + alignment - 1;
+  };
+};
+
+// allocates from arena if one is passed and has sufficient memory left, falls
+// back to std::aligned_alloc otherwise
+void* allocate(memoryArena*, std::size_t, std::size_t) noexcept;
+// frees memory unless it belongs to the arena passed
+void release(memoryArena*, void*) noexcept;
+};  // namespace MemoryArena
+
+namespace MemoryArena {
+inline memoryArena::memoryArena(std::size_t capacity, arenaOptions options)
+    : capacity_{((capacity + hugePageSize - 1) / hugePageSize) * hugePageSize},
+      mappedPointer{mmap(nullptr, capacity_, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0)},
+      mappedBytes{capacity_},
+      memoryPointer{mappedPointer} {
+  this->hugeTLB_ = this->mappedPointer != MAP_FAILED;
+  if (!this->hugeTLB_) {
+    // regular pages, mapping one huge page more to align to its size
+    this->mappedBytes = this->capacity_ + hugePageSize;
+    this->mappedPointer =
+        mmap(nullptr, this->mappedBytes, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    const std::uintptr_t mapped =
+        reinterpret_cast<std::uintptr_t>(this->mappedPointer);
+    this->memoryPointer = reinterpret_cast<void*>(
+        (mapped + hugePageSize - 1) & ~(hugePageSize - 1));
+    // hint only, memory is usable regardless of the kernel's decision
+    this->mappedPointer != MAP_FAILED
+        ? void(madvise(this->memoryPointer, this->capacity_, MADV_HUGEPAGE))
+        : void();
+  }
+  if (this->mappedPointer == MAP_FAILED) {
+    // allocations fail, components fall back to std::aligned_alloc
+    this->capacity_ = 0;
+    this->mappedBytes = 0;
+    this->memoryPointer = nullptr;
+    return;
+  }
+  // policy needs to be in place before pages are touched for the first time
+  const int numaNode = options.numaNode.value_or(-1);
+  if (numaNode >= 0 && numaNode < maxNumaNodes) {
+    static constexpr int wordBits = sizeof(unsigned long) * 8;
+    std::array<unsigned long, maxNumaNodes / wordBits> nodeMask{};
+    nodeMask[numaNode / wordBits] = 1ul << (numaNode % wordBits);
+    // kernel only reads maxnode - 1 bits
+    this->numaBound_ =
+        syscall(SYS_mbind, this->memoryPointer, this->capacity_, MPOL_BIND,
+                nodeMask.data(), maxNumaNodes + 1, 0) == 0;
+  }
+  if (options.prefault) {
+    volatile std::uint8_t* bytes =
+        reinterpret_cast<volatile std::uint8_t*>(this->memoryPointer);
+    for (std::size_t i = 0; i < this->capacity_; i += pageSize) {
+      bytes[i] = 0;
+    }
+  }
+  this->locked_ =
+      options.lock && mlock(this->memoryPointer, this->capacity_) == 0;
+};
+
+inline memoryArena::~memoryArena() {
+  // unmapping also unlocks
+  this->mappedBytes != 0 ? void(munmap(this->mappedPointer, this->mappedBytes))
+                         : void();
+};
+
+inline void* memoryArena::allocate(std::size_t alignment,
+                                   std::size_t size) noexcept {
+  const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(memoryPointer);
+  const std::uintptr_t aligned =
+      (base + this->offset + alignment - 1) & ~(alignment - 1);
+  const std::size_t newOffset = aligned - base + size;
+  const bool sufficient = newOffset <= this->capacity_;
+  this->offset = sufficient ? newOffset : this->offset;
+  return sufficient ? reinterpret_cast<void*>(aligned) : nullptr;
+};
+
+inline bool memoryArena::contains(const void* pointer) const noexcept {
+  const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(memoryPointer);
+  const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(pointer);
+  return address >= base && address < base + this->capacity_;
+};
+
+inline std::size_t memoryArena::capacity() const noexcept {
+  return this->capacity_;
+};
+
+inline std::size_t memoryArena::used() const noexcept { return this->offset; };
+
+inline bool memoryArena::hugeTLB() const noexcept { return this->hugeTLB_; };
+
+inline bool memoryArena::numaBound() const noexcept {
+  return this->numaBound_;
+};
+
+inline bool memoryArena::locked() const noexcept { return this->locked_; };
+
+inline void* allocate(memoryArena* arena, std::size_t alignment,
+                      std::size_t size) noexcept {
+  void* ret = arena != nullptr ? arena->allocate(alignment, size) : nullptr;
+  // std::aligned_alloc requires size to be a multiple of alignment
+  return ret != nullptr
+             ? ret
+             : std::aligned_alloc(alignment,
+                                  ((size + alignment - 1) / alignment) *
+                                      alignment);
+};
+
+inline void release(memoryArena* arena, void* pointer) noexcept {
+  const bool fromArena = arena != nullptr && arena->contains(pointer);
+  fromArena ? void() : std::free(pointer);
+};
+};  // namespace MemoryArena
@@ -0,0 +1,228 @@
+// hierarchical bitmap marking non-empty price buckets, allows finding the
+// closest non-empty bucket in either direction with a handful of bit scans
+// instead of walking the order book one bucket at a time
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <span>
+
+#include "Auxil.hpp"
+#include "MemoryArena.hpp"
+
+namespace OccupancyBitmap {
+template <std::uint32_t length_>
+requires(length_ > 0) struct occupancyBitmap {
+ private:
+  static constexpr std::uint32_t wordBits = 64;
+  static constexpr std::uint32_t cacheline = 64;
+  // every bit in a word of a higher level marks a non-zero word in the level
+  // below, three levels cover 262144 entries with a single top level word,
+  // longer bitmaps scan the (short) top level linearly
+  static constexpr std::uint32_t leafWords =
+      (length_ + wordBits - 1) / wordBits;
+  static constexpr std::uint32_t midWords =
+      (leafWords + wordBits - 1) / wordBits;
+  static constexpr std::uint32_t topWords =
+      (midWords + wordBits - 1) / wordBits;
+  static constexpr std::uint32_t totalWords = leafWords + midWords + topWords;
+  static constexpr std::uint64_t allSet = ~std::uint64_t{0};
+  MemoryArena::memoryArena* arena;
+  void* memoryPointer;
+  std::span<std::uint64_t, leafWords> leaves;
+  std::span<std::uint64_t, midWords> mids;
+  std::span<std::uint64_t, topWords> tops;
+
+ public:
+  static constexpr std::uint32_t length = length_;
+  static constexpr std::uint32_t byteLength =
+      ((totalWords * sizeof(std::uint64_t) + cacheline - 1) / cacheline) *
+      cacheline;
+  // memory is taken from arena if one is passed
+  explicit occupancyBitmap(MemoryArena::memoryArena* = nullptr);
+  ~occupancyBitmap();
+  occupancyBitmap(const occupancyBitmap&) = delete;
+  occupancyBitmap& operator=(const occupancyBitmap&) = delete;
+  occupancyBitmap(occupancyBitmap&&) = delete;
+  occupancyBitmap& operator=(occupancyBitmap&&) = delete;
+  // sets bit at index if argument is true, clears it otherwise
+  void assign(std::uint32_t, bool) noexcept;
+  bool test(std::uint32_t) const noexcept;
+  void clear() noexcept;
+  // clears all bits in [from, to], touches each affected word once
+  void clearRange(std::uint32_t, std::uint32_t) noexcept;
+  // return smallest set index in [from, to] / largest set index in [to, from],
+  // words are read via relaxed atomic loads as seqlock readers of the book
+  // scan the bitmap while it is updated
+  std::optional<std::uint32_t> findNext(std::uint32_t,
+                                        std::uint32_t) const noexcept;
+  std::optional<std::uint32_t> findPrev(std::uint32_t,
+                                        std::uint32_t) const noexcept;
+};
+};  // namespace OccupancyBitmap
+
+#define OCCUPANCY_BITMAP OccupancyBitmap::occupancyBitmap<length_>
+
+namespace OccupancyBitmap {
+template <std::uint32_t length_>
+requires(length_ > 0) OCCUPANCY_BITMAP::occupancyBitmap(
+    MemoryArena::memoryArena* arena_)
+    : arena{arena_},
+      memoryPointer{MemoryArena::allocate(arena, cacheline, byteLength)},
+      leaves{reinterpret_cast<std::uint64_t*>(memoryPointer), leafWords},
+      mids{leaves.data() + leafWords, midWords},
+      tops{mids.data() + midWords, topWords} {
+  this->clear();
+};
+
+template <std::uint32_t length_>
+requires(length_ > 0) OCCUPANCY_BITMAP::~occupancyBitmap() {
+  MemoryArena::release(this->arena, this->memoryPointer);
+};
+
+template <std::uint32_t length_>
+requires(length_ > 0) void OCCUPANCY_BITMAP::assign(std::uint32_t index,
+                                                    bool set) noexcept {
+  const std::uint32_t leafIndex = index / wordBits;
+  const std::uint32_t midIndex = leafIndex / wordBits;
+  const std::uint64_t leafBit = std::uint64_t{1} << (index % wordBits);
+  const std::uint64_t midBit = std::uint64_t{1} << (leafIndex % wordBits);
+  const std::uint64_t topBit = std::uint64_t{1} << (midIndex % wordBits);
+  // branchless update, a word in a higher level is marked iff the word it
+  // represents is non-zero after the update
+  this->leaves[leafIndex] =
+      (this->leaves[leafIndex] & ~leafBit) | (leafBit * set);
+  this->mids[midIndex] = (this->mids[midIndex] & ~midBit) |
+                         (midBit * (this->leaves[leafIndex] != 0));
+  this->tops[midIndex / wordBits] =
+      (this->tops[midIndex / wordBits] & ~topBit) |
+      (topBit * (this->mids[midIndex] != 0));
+};
+
+template <std::uint32_t length_>
+requires(length_ > 0) bool OCCUPANCY_BITMAP::test(
+    std::uint32_t index) const noexcept {
+  return (Auxil::relaxed_load(this->leaves[index / wordBits]) >>
+          (index % wordBits)) &
+         1;
+};
+
+template <std::uint32_t length_>
+requires(length_ > 0) void OCCUPANCY_BITMAP::clear() noexcept {
+  std::ranges::fill(this->leaves, 0);
+  std::ranges::fill(this->mids, 0);
+  std::ranges::fill(this->tops, 0);
+};
+
+template <std::uint32_t length_>
+requires(length_ > 0) void OCCUPANCY_BITMAP::clearRange(
+    std::uint32_t from, std::uint32_t to) noexcept {
+  static constexpr std::uint32_t maxBit = wordBits - 1;
+  const std::uint32_t firstLeaf = from / wordBits;
+  const std::uint32_t lastLeaf = to / wordBits;
+  for (std::uint32_t leafIndex = firstLeaf; leafIndex <= lastLeaf;
+       ++leafIndex) {
+    const std::uint32_t low = leafIndex == firstLeaf ? from % wordBits : 0;
+    const std::uint32_t high = leafIndex == lastLeaf ? to % wordBits : maxBit;
+    const std::uint64_t mask = (allSet << low) & (allSet >> (maxBit - high));
+    const std::uint32_t midIndex = leafIndex / wordBits;
+    const std::uint64_t midBit = std::uint64_t{1} << (leafIndex % wordBits);
+    const std::uint64_t topBit = std::uint64_t{1} << (midIndex % wordBits);
+    this->leaves[leafIndex] &= ~mask;
+    this->mids[midIndex] = (this->mids[midIndex] & ~midBit) |
+                           (midBit * (this->leaves[leafIndex] != 0));
+    this->tops[midIndex / wordBits] =
+        (this->tops[midIndex / wordBits] & ~topBit) |
+        (topBit * (this->mids[midIndex] != 0));
+  }
+};
+
+template <std::uint32_t length_>
+requires(length_ > 0) std::optional<std::uint32_t> OCCUPANCY_BITMAP::findNext(
+    std::uint32_t from, std::uint32_t to) const noexcept {
+  // look for set bit in leaf word containing start index
+  const std::uint32_t leafIndex = from / wordBits;
+  std::uint64_t word = Auxil::relaxed_load(this->leaves[leafIndex]) &
+                       (allSet << (from % wordBits));
+  if (word != 0) {
+    const std::uint32_t ret = leafIndex * wordBits + std::countr_zero(word);
+    return ret <= to ? std::make_optional(ret) : std::nullopt;
+  }
+  // look for next non-empty leaf word in the same mid level word
+  const std::uint32_t nextLeaf = leafIndex + 1;
+  if (nextLeaf >= leafWords) return std::nullopt;
+  const std::uint32_t midIndex = nextLeaf / wordBits;
+  word = Auxil::relaxed_load(this->mids[midIndex]) &
+         (allSet << (nextLeaf % wordBits));
+  std::uint32_t leafFound = midIndex * wordBits + std::countr_zero(word);
+  if (word == 0) {
+    // scan top level for next non-empty mid level word
+    const std::uint32_t nextMid = midIndex + 1;
+    if (nextMid >= midWords) return std::nullopt;
+    std::uint32_t topIndex = nextMid / wordBits;
+    word = Auxil::relaxed_load(this->tops[topIndex]) &
+           (allSet << (nextMid % wordBits));
+    while (word == 0 && ++topIndex < topWords) {
+      word = Auxil::relaxed_load(this->tops[topIndex]);
+    }
+    if (word == 0) return std::nullopt;
+    const std::uint32_t midFound =
+        topIndex * wordBits + std::countr_zero(word);
+    leafFound = midFound * wordBits +
+                std::countr_zero(Auxil::relaxed_load(this->mids[midFound]));
+  }
+  const std::uint32_t ret =
+      leafFound * wordBits +
+      std::countr_zero(Auxil::relaxed_load(this->leaves[leafFound]));
+  return ret <= to ? std::make_optional(ret) : std::nullopt;
+};
+
+template <std::uint32_t length_>
+requires(length_ > 0) std::optional<std::uint32_t> OCCUPANCY_BITMAP::findPrev(
+    std::uint32_t from, std::uint32_t to) const noexcept {
+  static constexpr std::uint32_t maxBit = wordBits - 1;
+  // look for set bit in leaf word containing start index
+  const std::uint32_t leafIndex = from / wordBits;
+  std::uint64_t word = Auxil::relaxed_load(this->leaves[leafIndex]) &
+                       (allSet >> (maxBit - from % wordBits));
+  if (word != 0) {
+    const std::uint32_t ret =
+        leafIndex * wordBits + maxBit - std::countl_zero(word);
+    return ret >= to ? std::make_optional(ret) : std::nullopt;
+  }
+  // look for previous non-empty leaf word in the same mid level word
+  if (leafIndex == 0) return std::nullopt;
+  const std::uint32_t prevLeaf = leafIndex - 1;
+  const std::uint32_t midIndex = prevLeaf / wordBits;
+  word = Auxil::relaxed_load(this->mids[midIndex]) &
+         (allSet >> (maxBit - prevLeaf % wordBits));
+  std::uint32_t leafFound =
+      midIndex * wordBits + maxBit - std::countl_zero(word);
+  if (word == 0) {
+    // scan top level for previous non-empty mid level word
+    if (midIndex == 0) return std::nullopt;
+    const std::uint32_t prevMid = midIndex - 1;
+    std::uint32_t topIndex = prevMid / wordBits;
+    word = Auxil::relaxed_load(this->tops[topIndex]) &
+           (allSet >> (maxBit - prevMid % wordBits));
+    while (word == 0 && topIndex-- > 0) {
+      word = Auxil::relaxed_load(this->tops[topIndex]);
+    }
+    if (word == 0) return std::nullopt;
+    const std::uint32_t midFound =
+        topIndex * wordBits + maxBit - std::countl_zero(word);
+    leafFound = midFound * wordBits + maxBit -
+                std::countl_zero(Auxil::relaxed_load(this->mids[midFound]));
+  }
+  const std::uint32_t ret =
+      leafFound * wordBits + maxBit -
+      std::countl_zero(Auxil::relaxed_load(this->leaves[leafFound]));
+  return ret >= to ? std::make_optional(ret) : std::nullopt;
+};
+};  // namespace OccupancyBitmap
+
+#undef OCCUPANCY_BITMAP
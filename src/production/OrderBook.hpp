@@ -7,37 +7,121 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <exception>
 #include <iostream>
 #include <limits>
+#include <mutex>
 #include <optional>
 #include <span>
 #include <tuple>
+#include <type_traits>
 #include <utility>
+#include <variant>
 
-#include "AtomicGuards.hpp"
 #include "Auxil.hpp"
+#include "DispatchPolicy.hpp"
 #include "FIXmsgTypeChecks.hpp"
+#include "FillSink.hpp"
+#include "LockPolicy.hpp"
+#include "MemoryArena.hpp"
+#include "OccupancyBitmap.hpp"
 #include "OrderBookBucket.hpp"
+#include "OrderBookStorage.hpp"
+#include "OrderIDMap.hpp"
+#include "OrderPool.hpp"
+#include "RecenterPolicy.hpp"
+#include "SweepKernel.hpp"
+#include "TopOfBook.hpp"
 
 namespace OrderBook {
+// single price level as copied by orderBook::depthSnapshot, volume is negative
+// for bids
+template <typename entryType>
+struct depthLevel {
+  std::uint32_t price = 0;
+  entryType volume = 0;
+};
+
+// price range and stats as copied by orderBook::copyState, together with a
+// copy of the buckets sufficient to restore a book
+struct bookStats {
+  std::uint32_t basePrice = 0;
+  std::optional<std::uint32_t> bestBid, lowestBid, bestOffer, highestOffer;
+};
+
+// read APIs of orderBook whose retries are counted, index passed to
+// orderBook::readRetryCounts
+static constexpr std::uint32_t volumeRead = 0;
+static constexpr std::uint32_t volumesRead = 1;
+static constexpr std::uint32_t metadataRead = 2;
+static constexpr std::uint32_t depthRead = 3;
+static constexpr std::uint32_t statsRead = 4;
+static constexpr std::uint32_t nReadAPIs = 5;
+
 template <typename msgClassVariant_, typename entryType_,
           std::uint32_t bookLength_, bool exclusiveCacheline_,
           size_t newLimitOrderIndex_, size_t withdrawLimitOrderIndex_,
-          size_t marketOrderIndex_>
+          size_t marketOrderIndex_, bool occupancyBitmap_ = true,
+          template <typename, std::uint32_t> class storage_ =
+              OrderBookStorage::denseStorage,
+          typename recenterPolicy_ = RecenterPolicy::noRecentering,
+          std::uint32_t maxOrders_ = 0,
+          typename dispatchPolicy_ = DispatchPolicy::runAll,
+          bool trackChanges_ = false,
+          typename fillSink_ = FillSink::noFills,
+          typename lockPolicy_ = LockPolicy::flagSpin>
 requires std::signed_integral<entryType_> &&
     MsgTypeChecks::OrderBookLimitOrderInterface<
         msgClassVariant_, newLimitOrderIndex_,
         withdrawLimitOrderIndex_>::value &&
     MsgTypeChecks::OrderBookMarketOrderInterface<
-        msgClassVariant_, marketOrderIndex_>::value struct orderBook {
+        msgClassVariant_, marketOrderIndex_>::value &&
+    (maxOrders_ == 0 || MsgTypeChecks::OrderBookL3LimitOrderInterface<
+                            msgClassVariant_, newLimitOrderIndex_,
+                            withdrawLimitOrderIndex_>::value) struct orderBook {
  private:
   // static members and member types
   static constexpr size_t cacheline = 64;
+  // order level mode, buckets additionally hold head and tail of their queue
+  static constexpr bool orderLevel_ = maxOrders_ > 0;
+  static constexpr size_t bucketSize =
+      sizeof(entryType_) + 2 * sizeof(std::uint32_t) * orderLevel_;
   static constexpr std::uint32_t alignment =
-      std::max(Auxil::divisible_or_ceil(sizeof(entryType_), cacheline),
+      std::max(Auxil::divisible_or_ceil(bucketSize, cacheline),
                cacheline* exclusiveCacheline_);
-  using bucketType = OrderBookBucket::orderBookBucket<entryType_, alignment>;
+  using bucketType = std::conditional_t<
+      orderLevel_, OrderBookBucket::orderQueueBucket<entryType_, alignment>,
+      OrderBookBucket::orderBookBucket<entryType_, alignment>>;
+  using nodeType = OrderBookBucket::orderNode<entryType_>;
+  // pool of order nodes and order ID index only exist in order level mode
+  struct noMember {
+    explicit noMember(MemoryArena::memoryArena*){};
+    static constexpr std::size_t byteLength = 0;
+  };
+  static constexpr std::uint32_t poolCapacity = std::max(maxOrders_, 1u);
+  using poolType =
+      std::conditional_t<orderLevel_,
+                         OrderPool::orderPool<nodeType, poolCapacity>,
+                         noMember>;
+  using orderIDMapType =
+      std::conditional_t<orderLevel_, OrderIDMap::orderIDMap<poolCapacity>,
+                         noMember>;
+  // price range includes both base price and base price + book length
+  using storageType = storage_<bucketType, bookLength_ + 1>;
+  // recentering shifts the book while an order holds write access, storage
+  // moving all buckets with a shift would add a full copy of the price range
+  // to that order's latency
+  static_assert(!recenterPolicy_::enabled || !storageType::shiftMovesBuckets);
+  // occupancy is tracked per slot, unaffected by shifts of the ring buffer
+  using bitmapType = OccupancyBitmap::occupancyBitmap<storageType::capacity>;
+  // sweeps across many buckets are handed to SweepKernel, requires volumes to
+  // be plain 64 bit integers next to each other in memory, volume changes and
+  // fills are not reported per level by the kernel
+  static constexpr bool vectorSweep =
+      storageType::contiguous && std::same_as<entryType_, std::int64_t> &&
+      !orderLevel_ && sizeof(bucketType) == sizeof(entryType_) &&
+      !trackChanges_ && !fillSink_::enabled;
   static constexpr size_t newLimitOrderIndex = newLimitOrderIndex_;
   static constexpr size_t withdrawLimitOrderIndex = withdrawLimitOrderIndex_;
   static constexpr size_t marketOrderIndex = marketOrderIndex_;
@@ -50,47 +134,166 @@ requires std::signed_integral<entryType_> &&
   using orderClassTuple =
       std::tuple<newLimitOrderClass, withdrawLimitOrderClass, marketOrderClass>;
   // contains: marginal execution price, filled volume, total revenue
-  // generated(price*volume), 1 if price is out of bounds of the orderbook
+  // generated(price*volume), 1 if price is out of bounds of the orderbook, 2 if
+  // order was rejected by order level book (unknown or duplicate order ID,
+  // no node available) or by paged storage (no page available), volume filled
+  // before the remainder of a new limit order is rejected is still reported
   using orderResponse =
       std::tuple<std::uint32_t, entryType_, entryType_, std::uint8_t>;
 
+  // marks slots whose volume changed since changed levels were last drained
+  using dirtyBitmapType =
+      std::conditional_t<trackChanges_, bitmapType, noMember>;
+
   // non static member variables
   std::uint32_t basePrice;
-  std::optional<std::uint32_t> bestBid, lowestBid, bestOffer, highestOffer;
-  alignas(64) std::atomic_flag modifyLock = false;
-  alignas(64) std::int64_t versionCounter = 0;
-  // points to memory location of the actual orderbook entries
-  alignas(64) void* memoryPointer;
-  std::span<OrderBookBucket::orderBookBucket<entryType_, alignment>> memSpan;
+  // aligned to their size, seqlock readers load them via std::atomic_ref
+  alignas(8) std::optional<std::uint32_t> bestBid, lowestBid, bestOffer,
+      highestOffer;
+  // serializes writers, compiled out by LockPolicy::noLock
+  alignas(64) lockPolicy_ modifyLock;
+  // seqlock: odd while the book is modified, advanced by two per write access,
+  // readers retry if it was odd or changed while they read
+  alignas(64) std::atomic<std::int64_t> versionCounter = 0;
+  // per read API: reads retried due to concurrent writes and retries in total,
+  // only touched by readers that had to retry, own cacheline
+  alignas(64) mutable std::atomic<std::uint64_t> readCollisions[nReadAPIs]{};
+  mutable std::atomic<std::uint64_t> readRetries[nReadAPIs]{};
+  // best bid and best offer packed by TopOfBook::pack, published once per
+  // write access, own cacheline so polling readers only share this line with
+  // the writer
+  alignas(64) std::atomic<std::uint64_t> topOfBook = TopOfBook::empty;
+  // owns memory of the actual orderbook entries
+  alignas(64) storageType buckets;
+  // mark buckets containing demand and supply respectively
+  bitmapType bidOccupancy, offerOccupancy;
+  // only modified while holding write access, atomic to allow for reads from
+  // other threads
+  std::atomic<std::uint64_t> shiftsPerformed = 0, outOfRangeOrders = 0;
+  // nodes of all resting orders and index to locate them by order ID
+  [[no_unique_address]] poolType orderPool;
+  [[no_unique_address]] orderIDMapType orderIndex;
+  // changed levels only tracked if trackChanges_ is set, set flag means
+  // dirty slots no longer map to their prices and all levels need to be
+  // reported
+  [[no_unique_address]] dirtyBitmapType dirtyLevels;
+  bool levelsReset = false;
+  // receives a record for every level orders are filled at, only called if
+  // fillSink_ is not FillSink::noFills
+  fillSink_* fillSubscriber = nullptr;
 
   // private member functions
   bool priceInRange(std::uint32_t) noexcept;
-  // searches for closest buckets containing non-zero volume
+  // performs shift of the price range, requires write access to be held
+  bool performShift(std::int32_t) noexcept;
+  // brings occupancy bitmaps in line with volume of bucket at index
+  void updateOccupancy(std::uint32_t) noexcept;
+  // updates occupancy, informs storage, marks level at index as changed if
+  // second argument is true and changes are tracked
+  void bucketChanged(std::uint32_t, bool) noexcept;
+  // search occupancy bitmap between two indices, taking into account that
+  // slots may wrap around
+  std::optional<std::uint32_t> nextOccupied(const bitmapType&, std::uint32_t,
+                                            std::uint32_t) const noexcept;
+  std::optional<std::uint32_t> prevOccupied(const bitmapType&, std::uint32_t,
+                                            std::uint32_t) const noexcept;
+  // takes volume from bucket at index, in order level mode volume is taken from
+  // the queued orders in order of their arrival, filled orders are released
+  entryType_ consumeBucket(std::uint32_t, entryType_) noexcept;
+  // takes volume from bucket at index, in order level mode only from the order
+  // whose node index is passed
+  entryType_ withdrawFromBucket(std::uint32_t, entryType_,
+                                std::uint32_t) noexcept;
+  // order level mode only: rests volume as order at the back of the queue at
+  // price, unlinks order from its queue and returns its node to the pool
+  void enqueueOrder(std::uint64_t, entryType_, std::uint32_t) noexcept;
+  void releaseOrder(std::uint32_t) noexcept;
+  // searches for closest buckets containing non-zero volume on bid/offer side
   // to be used when updating stats
   __attribute__((flatten)) std::optional<std::uint32_t> findLiquidBucket(
-      std::uint32_t, std::int32_t) noexcept;
+      std::uint32_t, std::int32_t, bool) const noexcept;
+  // copies non-empty levels moving away from the touch on one side, indices
+  // are clamped to the book so reads racing a writer stay within bounds
+  std::uint32_t collectLevels(std::span<depthLevel<entryType_>>,
+                              std::optional<std::uint32_t>, std::uint32_t,
+                              bool) const noexcept;
   __attribute__((flatten))
   // iterates over portion of the order book to withdraw liquidity/ fill volume
   // to be used for market orders and limit orders that can be filled
   // immediately
   orderResponse runThroughBook(entryType_, std::int32_t) noexcept;
-  // inserts limt order, fills limt order if possible
+  // inserts limt order, fills limt order if possible, handlers take message
+  // objects as well as views over received messages
+  template <typename orderType>
   __attribute__((flatten)) orderResponse handleNewLimitOrder(
-      const newLimitOrderClass&) noexcept;
+      const orderType&) noexcept;
+  template <typename orderType>
   __attribute__((flatten)) orderResponse handleWithdrawLimitOrder(
-      const withdrawLimitOrderClass&) noexcept;
+      const orderType&) noexcept;
+  template <typename orderType>
   __attribute__((flatten)) orderResponse handleMarketOrder(
-      const marketOrderClass&) noexcept;
+      const orderType&) noexcept;
+  // runs handlers and recentering policy for a single order, requires write
+  // access to be held
+  __attribute__((flatten)) orderResponse applyOrder(
+      const msgClassVariant_&) noexcept;
+  // runs recentering policy, requires write access to be held
+  void recenter() noexcept;
+  // stores best bid and best offer to packed top of book, requires write
+  // access to be held
+  void publishTopOfBook() noexcept;
+  // acquires write access, invalidates reads while running the callable
+  // passed, releases write access
+  template <typename funcType>
+  orderResponse underWriteAccess(funcType&&) noexcept;
+  // set version counter to an odd value before and back to an even value
+  // after modifying the book, require write access to be held
+  void beginWrite() noexcept;
+  void endWrite() noexcept;
+  // runs the callable until it read the book without a concurrent write,
+  // returns its result and the number of retries, counts retries for the read
+  // API passed
+  template <typename funcType>
+  std::tuple<std::invoke_result_t<funcType>, std::uint32_t> consistentRead(
+      std::uint32_t, funcType&&) const noexcept;
 
  public:
   // static members and member types
   using entryType = entryType_;
   using msgClassVariant = msgClassVariant_;
+  using orderResponseType = orderResponse;
+  using level = depthLevel<entryType_>;
   static constexpr std::uint32_t bookLength = bookLength_;
-  static constexpr std::uint32_t byteLength = bookLength * alignment;
+  static constexpr std::size_t byteLength = storageType::byteLength;
+  static constexpr bool occupancyBitmap = occupancyBitmap_;
+  using recenterPolicy = recenterPolicy_;
+  static constexpr std::uint32_t maxOrders = maxOrders_;
+  static constexpr bool orderLevel = orderLevel_;
+  using dispatchPolicy = dispatchPolicy_;
+  static constexpr bool trackChanges = trackChanges_;
+  using fillSink = fillSink_;
+  using lockPolicy = lockPolicy_;
+  // state of the book can be copied and restored as a single block of memory,
+  // requires buckets stored in order of their prices and no individual orders
+  static constexpr bool copyableState =
+      storageType::contiguous && !orderLevel_;
+  // bytes of bucket memory copied by copyState
+  static constexpr std::size_t stateBytes = storageType::byteLength;
+  // upper bound for memory taken from an arena passed to the constructor, not
+  // including the object itself
+  static constexpr std::size_t arenaBytes =
+      MemoryArena::memoryArena::footprint(alignment, storageType::byteLength) +
+      2 * MemoryArena::memoryArena::footprint(cacheline,
+                                              bitmapType::byteLength) +
+      MemoryArena::memoryArena::footprint(cacheline, poolType::byteLength) +
+      MemoryArena::memoryArena::footprint(cacheline,
+                                          orderIDMapType::byteLength) +
+      MemoryArena::memoryArena::footprint(cacheline,
+                                          dirtyBitmapType::byteLength);
 
   // 5 special members
-  explicit orderBook(std::uint32_t);
+  // all memory is taken from arena if one is passed
+  explicit orderBook(std::uint32_t, MemoryArena::memoryArena* = nullptr);
   ~orderBook();
   // delete copying and moving, avoid checks for unspecified state
   orderBook(const orderBook&) = delete;
@@ -100,10 +303,94 @@ requires std::signed_integral<entryType_> &&
 
   // public member functions
   __attribute__((flatten)) orderResponse processOrder(msgClassVariant) noexcept;
+  // entry points for callers aware of the type of order, skip dispatching
+  // regardless of dispatchPolicy_
+  orderResponse addLimit(const newLimitOrderClass&) noexcept;
+  orderResponse withdrawLimit(const withdrawLimitOrderClass&) noexcept;
+  orderResponse marketOrder(const marketOrderClass&) noexcept;
+  // entry point for views over received messages (FIXmsgClasses::msgView) of
+  // any of the three order types, fields are loaded straight from the receive
+  // buffer, dispatched by the type of view regardless of dispatchPolicy_
+  template <typename viewType>
+  requires MsgTypeChecks::OrderBookOrderViewConcept<
+               viewType, std::variant_alternative_t<newLimitOrderIndex_,
+                                                    msgClassVariant_>> ||
+      MsgTypeChecks::OrderBookOrderViewConcept<
+          viewType, std::variant_alternative_t<withdrawLimitOrderIndex_,
+                                               msgClassVariant_>> ||
+      MsgTypeChecks::OrderBookOrderViewConcept<
+          viewType,
+          std::variant_alternative_t<marketOrderIndex_, msgClassVariant_>>
+  orderResponse processView(const viewType&) noexcept;
+  // processes orders in sequence while holding write access once, readers see
+  // a single version bump for the whole batch, response for each order is
+  // written to the respective index of the second argument, returns number of
+  // orders processed (limited by the shorter span)
+  std::size_t processOrders(std::span<const msgClassVariant>,
+                            std::span<orderResponse>) noexcept;
+  // reads entries from a queue reader until it runs empty or the buffer is
+  // full, then processes all of them as one batch, batch size thus adapts to
+  // the backlog, returns number of orders processed
+  template <typename readerType>
+  requires Auxil::readableAsQueue<readerType, msgClassVariant_>
+  std::size_t drainQueue(readerType&, std::span<msgClassVariant>,
+                         std::span<orderResponse>) noexcept;
+  // wait-free, reads packed top of book published by the writer
   std::tuple<std::optional<std::uint32_t>, std::optional<std::uint32_t>>
   bestBidAsk() const noexcept;
+  // best bid and best offer as packed by TopOfBook::pack
+  std::uint64_t packedBestBidAsk() const noexcept;
   entryType volumeAtPrice(std::uint32_t) const noexcept;
+  // volumes at several prices read at a single version, volume of each price
+  // is written to the same index of the second span, returns number of prices
+  // read (limited by the shorter span)
+  std::size_t volumesAtPrices(std::span<const std::uint32_t>,
+                              std::span<entryType>) const noexcept;
+  // base price and stats read at a single version
+  bookStats stats() const noexcept;
+  // storage policies keeping metadata per level only: number of orders added
+  // since the level was last empty and sequence number of its last update
+  std::tuple<std::uint32_t, std::uint64_t> levelMetadata(
+      std::uint32_t) const noexcept requires storageType::levelMetadata;
+  // copies best levels of both sides (best first) in a single consistent read,
+  // without allocating, returns number of bid levels, number of ask levels and
+  // number of retries caused by concurrent writes
+  std::tuple<std::uint32_t, std::uint32_t, std::uint32_t> depthSnapshot(
+      std::span<level>, std::span<level>) const noexcept;
+  // reports levels changed since the last call while holding write access,
+  // the level callable is invoked with price and current volume (zero if
+  // emptied) of every changed level, if the first argument is true or the
+  // book has been shifted with changes pending the reset callable is invoked
+  // first and all non-empty levels are reported instead, only protected by the
+  // lock, not available with LockPolicy::noLock
+  template <typename resetFuncType, typename levelFuncType>
+  requires trackChanges_ && lockPolicy_::enabled
+  void drainChangedLevels(bool, resetFuncType&&, levelFuncType&&) noexcept;
+  // copies stats and buckets to the memory passed while holding the lock
+  // (without invalidating reads), writers stall for a single memcpy, span
+  // must hold at least stateBytes bytes, not available with
+  // LockPolicy::noLock
+  bookStats copyState(std::span<std::byte>) noexcept
+      requires copyableState && lockPolicy_::enabled;
+  // replaces stats and buckets by a copy taken via copyState and rebuilds the
+  // occupancy bitmaps, returns false if the span is too small, validity of the
+  // restored book is to be checked via __invariantsCheck
+  bool restoreState(const bookStats&, std::span<const std::byte>) noexcept
+      requires copyableState;
+  // sink receiving fill records from now on, nullptr to unsubscribe, to be
+  // called from the writing thread or while no orders are processed
+  void subscribeFills(fillSink_*) noexcept requires fillSink_::enabled;
   bool shiftBook(std::int32_t) noexcept;
+  // number of successful shifts of the price range, manual or by policy
+  std::uint64_t shiftCount() const noexcept;
+  // number of new and withdraw limit orders rejected due to out of range price
+  std::uint64_t outOfRangeCount() const noexcept;
+  // even unless a write access is under way, advanced by two per write access
+  std::int64_t version() const noexcept;
+  // reads of a read API (OrderBook::volumeRead, ...) that had to be retried
+  // due to a concurrent write and number of retries in total
+  std::tuple<std::uint64_t, std::uint64_t> readRetryCounts(
+      std::uint32_t) const noexcept;
 
   // checks coherence of stats among each other and with liquidty in order book
   // intended for debugging purposes
@@ -115,122 +402,518 @@ requires std::signed_integral<entryType_> &&
   template <typename msgClassVariant_, typename entryType_,              \
             std::uint32_t bookLength_, bool exclusiveCacheline_,         \
             size_t newLimitOrderIndex_, size_t withdrawLimitOrderIndex_, \
-            size_t marketOrderIndex_>                                    \
+            size_t marketOrderIndex_, bool occupancyBitmap_,             \
+            template <typename, std::uint32_t> class storage_,           \
+            typename recenterPolicy_, std::uint32_t maxOrders_,          \
+            typename dispatchPolicy_, bool trackChanges_,                \
+            typename fillSink_, typename lockPolicy_>                    \
   requires std::signed_integral<entryType_> &&                           \
       MsgTypeChecks::OrderBookLimitOrderInterface<                       \
           msgClassVariant_, newLimitOrderIndex_,                         \
           withdrawLimitOrderIndex_>::value &&                            \
-      MsgTypeChecks::OrderBookMarketOrderInterface<msgClassVariant_,     \
-                                                   marketOrderIndex_>::value
+      MsgTypeChecks::OrderBookMarketOrderInterface<                      \
+          msgClassVariant_, marketOrderIndex_>::value &&                 \
+      (maxOrders_ == 0 || MsgTypeChecks::OrderBookL3LimitOrderInterface< \
+                              msgClassVariant_, newLimitOrderIndex_,     \
+                              withdrawLimitOrderIndex_>::value)
 
-#define ORDER_BOOK                                                \
-  OrderBook::orderBook<msgClassVariant_, entryType_, bookLength_, \
-                       exclusiveCacheline_, newLimitOrderIndex_,  \
-                       withdrawLimitOrderIndex_, marketOrderIndex_>
+#define ORDER_BOOK                                                 \
+  OrderBook::orderBook<msgClassVariant_, entryType_, bookLength_,  \
+                       exclusiveCacheline_, newLimitOrderIndex_,   \
+                       withdrawLimitOrderIndex_, marketOrderIndex_, \
+                       occupancyBitmap_, storage_, recenterPolicy_, \
+                       maxOrders_, dispatchPolicy_, trackChanges_, \
+                       fillSink_, lockPolicy_>
 
 // namespace OrderBook {
 
 ORDER_BOOK_TEMPLATE_DECLARATION
-ORDER_BOOK::orderBook(std::uint32_t basePrice_) : basePrice{basePrice_} {
-  // set initial values for prices
-  // allocate memory for the order book array, initialize span to access memory,
-  // fill array with zeros
-  this->memoryPointer = std::aligned_alloc(alignment, this->byteLength);
-  this->memSpan =
-      std::span<bucketType>{(bucketType*)this->memoryPointer, this->bookLength};
-  // initialize all bucket objects
-  std::ranges::fill(memSpan, bucketType());
+ORDER_BOOK::orderBook(std::uint32_t basePrice_,
+                      MemoryArena::memoryArena* arena)
+    : basePrice{basePrice_},
+      buckets{arena},
+      bidOccupancy{arena},
+      offerOccupancy{arena},
+      orderPool{arena},
+      orderIndex{arena},
+      dirtyLevels{arena} {
+  // memory for the order book array is allocated and filled with zeros by
+  // storage member
 };
 
 ORDER_BOOK_TEMPLATE_DECLARATION
 ORDER_BOOK::~orderBook() {
-  // free allocated memory (RAII)
-  std::free(this->memoryPointer);
+  // memory is freed by storage member (RAII)
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+template <typename funcType>
+typename ORDER_BOOK::orderResponse ORDER_BOOK::underWriteAccess(
+    funcType&& func) noexcept {
+  // acquire write access to order book, set version counter to odd value to
+  // invlaidate reads while order book is manipulated
+  const std::lock_guard guard(this->modifyLock);
+  this->beginWrite();
+
+  const orderResponse ret = func();
+  this->publishTopOfBook();
+
+  // set counter to even value, lock is released on return
+  this->endWrite();
+
+  return ret;
 };
 
 ORDER_BOOK_TEMPLATE_DECLARATION
 typename ORDER_BOOK::orderResponse ORDER_BOOK::processOrder(
     msgClassVariant order) noexcept {
-  const std::uint8_t index = order.index();
+  return this->underWriteAccess([&]() { return this->applyOrder(order); });
+};
 
-  // create tuple of blank orders for each type and insert the order to be
-  // processed in correct spot
-  auto orders =
-      orderClassTuple{newLimitOrderClass(0, 0), withdrawLimitOrderClass(0, 0),
-                      marketOrderClass(0)};
-  std::get<0>(orders) = index == 0 ? std::get<0>(order) : std::get<0>(orders);
-  std::get<1>(orders) = index == 1 ? std::get<1>(order) : std::get<1>(orders);
-  std::get<2>(orders) = index == 2 ? std::get<2>(order) : std::get<2>(orders);
+ORDER_BOOK_TEMPLATE_DECLARATION
+typename ORDER_BOOK::orderResponse ORDER_BOOK::addLimit(
+    const newLimitOrderClass& order) noexcept {
+  return this->underWriteAccess([&]() {
+    const auto ret = this->handleNewLimitOrder(order);
+    this->recenter();
+    return ret;
+  });
+};
 
-  // acquire write access to order book, set version counter to odd value to
-  // invlaidate reads while order book is manipulated
-  auto guard = AtomicGuards::AtomicFlagGuard(&this->modifyLock);
-  guard.lock();
-  ++this->versionCounter;
-  std::atomic_signal_fence(std::memory_order_acq_rel);
+ORDER_BOOK_TEMPLATE_DECLARATION
+typename ORDER_BOOK::orderResponse ORDER_BOOK::withdrawLimit(
+    const withdrawLimitOrderClass& order) noexcept {
+  return this->underWriteAccess([&]() {
+    const auto ret = this->handleWithdrawLimitOrder(order);
+    this->recenter();
+    return ret;
+  });
+};
 
-  // call handler for all order types, use blank orders for irrelevant types
-  auto ret = this->handleNewLimitOrder(std::get<0>(orders));
-  Auxil::add_to_tuple(ret, this->handleWithdrawLimitOrder(std::get<1>(orders)));
-  Auxil::add_to_tuple(ret, this->handleMarketOrder(std::get<2>(orders)));
+ORDER_BOOK_TEMPLATE_DECLARATION
+typename ORDER_BOOK::orderResponse ORDER_BOOK::marketOrder(
+    const marketOrderClass& order) noexcept {
+  return this->underWriteAccess([&]() {
+    const auto ret = this->handleMarketOrder(order);
+    this->recenter();
+    return ret;
+  });
+};
 
-  // release lock, set increment counter to even value
-  std::atomic_signal_fence(std::memory_order_acq_rel);
-  ++this->versionCounter;
-  guard.unlock();
+ORDER_BOOK_TEMPLATE_DECLARATION
+template <typename viewType>
+requires MsgTypeChecks::OrderBookOrderViewConcept<
+             viewType, std::variant_alternative_t<newLimitOrderIndex_,
+                                                  msgClassVariant_>> ||
+    MsgTypeChecks::OrderBookOrderViewConcept<
+        viewType, std::variant_alternative_t<withdrawLimitOrderIndex_,
+                                             msgClassVariant_>> ||
+    MsgTypeChecks::OrderBookOrderViewConcept<
+        viewType,
+        std::variant_alternative_t<marketOrderIndex_, msgClassVariant_>>
+typename ORDER_BOOK::orderResponse ORDER_BOOK::processView(
+    const viewType& view) noexcept {
+  return this->underWriteAccess([&]() {
+    using msgType = typename viewType::msgType;
+    orderResponse ret;
+    if constexpr (std::is_same_v<msgType, newLimitOrderClass>) {
+      ret = this->handleNewLimitOrder(view);
+    } else if constexpr (std::is_same_v<msgType, withdrawLimitOrderClass>) {
+      ret = this->handleWithdrawLimitOrder(view);
+    } else {
+      ret = this->handleMarketOrder(view);
+    }
+    this->recenter();
+    return ret;
+  });
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+std::size_t ORDER_BOOK::processOrders(
+    std::span<const msgClassVariant> orders,
+    std::span<orderResponse> responses) noexcept {
+  const std::size_t nOrders = std::min(orders.size(), responses.size());
+  // lock and version counter are touched once for the entire batch
+  const std::lock_guard guard(this->modifyLock);
+  this->beginWrite();
+
+  for (std::size_t i = 0; i < nOrders; ++i) {
+    responses[i] = this->applyOrder(orders[i]);
+  }
+  this->publishTopOfBook();
+
+  this->endWrite();
+
+  return nOrders;
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+template <typename readerType>
+requires Auxil::readableAsQueue<readerType, msgClassVariant_>
+std::size_t ORDER_BOOK::drainQueue(
+    readerType& reader, std::span<msgClassVariant> buffer,
+    std::span<orderResponse> responses) noexcept {
+  const std::size_t capacity = std::min(buffer.size(), responses.size());
+  std::size_t nRead = 0;
+  std::optional<msgClassVariant> entry;
+  // entries are read before acquiring write access, keeps queue reads out of
+  // the critical section
+  while (nRead < capacity && (entry = reader.read_next_entry()).has_value()) {
+    buffer[nRead] = entry.value();
+    ++nRead;
+  }
+  return nRead > 0 ? this->processOrders(buffer.first(nRead), responses) : 0;
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+typename ORDER_BOOK::orderResponse ORDER_BOOK::applyOrder(
+    const msgClassVariant& order) noexcept {
+  orderResponse ret;
+  if constexpr (dispatchPolicy::runAllHandlers) {
+    const std::uint8_t index = order.index();
+
+    // create tuple of blank orders for each type and insert the order to be
+    // processed in correct spot
+    auto orders =
+        orderClassTuple{newLimitOrderClass(0, 0), withdrawLimitOrderClass(0, 0),
+                        marketOrderClass(0)};
+    std::get<0>(orders) = index == 0 ? std::get<0>(order) : std::get<0>(orders);
+    std::get<1>(orders) = index == 1 ? std::get<1>(order) : std::get<1>(orders);
+    std::get<2>(orders) = index == 2 ? std::get<2>(order) : std::get<2>(orders);
 
+    // call handler for all order types, use blank orders for irrelevant types
+    ret = this->handleNewLimitOrder(std::get<0>(orders));
+    Auxil::add_to_tuple(ret,
+                        this->handleWithdrawLimitOrder(std::get<1>(orders)));
+    Auxil::add_to_tuple(ret, this->handleMarketOrder(std::get<2>(orders)));
+  } else {
+    // only call handler for actual type of order, alternatives not handled by
+    // the book result in the same response as blank orders
+    ret = std::visit(
+        [this](const auto& msg) -> orderResponse {
+          using msgType = std::decay_t<decltype(msg)>;
+          if constexpr (std::is_same_v<msgType, newLimitOrderClass>) {
+            return this->handleNewLimitOrder(msg);
+          } else if constexpr (std::is_same_v<msgType,
+                                              withdrawLimitOrderClass>) {
+            return this->handleWithdrawLimitOrder(msg);
+          } else if constexpr (std::is_same_v<msgType, marketOrderClass>) {
+            return this->handleMarketOrder(msg);
+          } else {
+            return orderResponse{0, 0, 0, 0};
+          }
+        },
+        order);
+  }
+
+  this->recenter();
   return ret;
 };
 
+ORDER_BOOK_TEMPLATE_DECLARATION
+void ORDER_BOOK::recenter() noexcept {
+  // move price range towards the touch before it reaches either edge
+  if constexpr (recenterPolicy::enabled) {
+    const std::int32_t recenterBy = recenterPolicy::shiftBy(
+        this->basePrice, bookLength, this->bestBid, this->bestOffer);
+    recenterBy != 0 ? static_cast<void>(this->performShift(recenterBy))
+                    : void();
+  }
+};
+
 ORDER_BOOK_TEMPLATE_DECLARATION
 std::tuple<std::optional<std::uint32_t>, std::optional<std::uint32_t>>
 ORDER_BOOK::bestBidAsk() const noexcept {
-  // safe version before reading
-  std::int64_t initVersion{this->versionCounter}, finVersion{0};
-  std::atomic_signal_fence(std::memory_order_acq_rel);
-  auto ret =
-      std::tuple<std::optional<std::uint32_t>, std::optional<std::uint32_t>>();
+  // single load, never retries or waits for the writer
+  return TopOfBook::unpack(this->packedBestBidAsk());
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+std::uint64_t ORDER_BOOK::packedBestBidAsk() const noexcept {
+  return this->topOfBook.load(std::memory_order_acquire);
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+void ORDER_BOOK::publishTopOfBook() noexcept {
+  this->topOfBook.store(TopOfBook::pack(this->bestBid, this->bestOffer),
+                        std::memory_order_release);
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+void ORDER_BOOK::beginWrite() noexcept {
+  // writers are serialized, no read-modify-write needed, release fence keeps
+  // the following writes to the book from becoming visible before the odd
+  // version
+  this->versionCounter.store(
+      this->versionCounter.load(std::memory_order_relaxed) + 1,
+      std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+void ORDER_BOOK::endWrite() noexcept {
+  this->versionCounter.store(
+      this->versionCounter.load(std::memory_order_relaxed) + 1,
+      std::memory_order_release);
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+template <typename funcType>
+std::tuple<std::invoke_result_t<funcType>, std::uint32_t>
+ORDER_BOOK::consistentRead(std::uint32_t readAPI,
+                           funcType&& func) const noexcept {
+  std::int64_t initVersion, finVersion;
+  std::invoke_result_t<funcType> ret;
+  std::uint32_t retries{0};
+  bool retry;
   do {
-    ret =
-        std::tuple<std::optional<std::uint32_t>, std::optional<std::uint32_t>>{
-            this->bestBid, this->bestOffer};
-    finVersion = this->versionCounter;
-    std::atomic_signal_fence(std::memory_order_acq_rel);
-  } while (initVersion % 2 || initVersion != finVersion);
-  return ret;
+    initVersion = this->versionCounter.load(std::memory_order_acquire);
+    ret = func();
+    // keeps the reads of the book from moving past the final version load
+    std::atomic_thread_fence(std::memory_order_acquire);
+    finVersion = this->versionCounter.load(std::memory_order_relaxed);
+    retry = initVersion % 2 != 0 || initVersion != finVersion;
+    retries += retry;
+  } while (retry);
+  retries > 0
+      ? void((this->readCollisions[readAPI].fetch_add(
+                  1, std::memory_order_relaxed),
+              this->readRetries[readAPI].fetch_add(
+                  retries, std::memory_order_relaxed)))
+      : void();
+  return {ret, retries};
 };
 
 ORDER_BOOK_TEMPLATE_DECLARATION
 typename ORDER_BOOK::entryType ORDER_BOOK::volumeAtPrice(
     std::uint32_t price) const noexcept {
-  std::int64_t initVersion, finVersion;
-  bool inRange;
-  std::uint32_t accessAtIndex;
-  entryType ret;
-  do {
-    initVersion = this->versionCounter;
-    std::atomic_signal_fence(std::memory_order_acq_rel);
-    inRange =
-        price >= this->basePrice && price <= (this->basePrice + bookLength);
-    accessAtIndex = price - this->basePrice * inRange + 0 * !inRange;
+  return std::get<0>(this->consistentRead(volumeRead, [&]() -> entryType {
+    // fields of the book are read via relaxed atomic loads while the writer
+    // may modify them, a torn result is discarded by the version check
+    const std::uint32_t base = Auxil::relaxed_load(this->basePrice);
+    const bool inRange = price >= base && price <= (base + bookLength);
     // avoid out of bounds memory access if volume is read while book is in the
     // process of shifting
-    accessAtIndex = std::min(accessAtIndex, bookLength);
-    ret = inRange ? this->memSpan[accessAtIndex].getVolume() : 0;
-    std::atomic_signal_fence(std::memory_order_acq_rel);
-    finVersion = this->versionCounter;
-  } while (!initVersion % 2 || initVersion != finVersion);
-  return ret;
+    const std::uint32_t accessAtIndex =
+        std::min(price - base * inRange, bookLength);
+    return inRange ? this->buckets[accessAtIndex].getVolume() : 0;
+  }));
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+std::size_t ORDER_BOOK::volumesAtPrices(
+    std::span<const std::uint32_t> prices,
+    std::span<entryType> volumes) const noexcept {
+  const std::size_t nPrices = std::min(prices.size(), volumes.size());
+  return std::get<0>(this->consistentRead(volumesRead, [&]() {
+    const std::uint32_t base = Auxil::relaxed_load(this->basePrice);
+    for (std::size_t i = 0; i < nPrices; ++i) {
+      const bool inRange = prices[i] >= base && prices[i] <= base + bookLength;
+      const std::uint32_t accessAtIndex =
+          std::min(prices[i] - base * inRange, bookLength);
+      volumes[i] = inRange ? this->buckets[accessAtIndex].getVolume() : 0;
+    }
+    return nPrices;
+  }));
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+OrderBook::bookStats ORDER_BOOK::stats() const noexcept {
+  return std::get<0>(this->consistentRead(statsRead, [&]() {
+    return bookStats{Auxil::relaxed_load(this->basePrice),
+                     Auxil::relaxed_load(this->bestBid),
+                     Auxil::relaxed_load(this->lowestBid),
+                     Auxil::relaxed_load(this->bestOffer),
+                     Auxil::relaxed_load(this->highestOffer)};
+  }));
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+std::tuple<std::uint32_t, std::uint64_t> ORDER_BOOK::levelMetadata(
+    std::uint32_t price) const noexcept requires storageType::levelMetadata {
+  return std::get<0>(this->consistentRead(metadataRead, [&]() {
+    const std::uint32_t base = Auxil::relaxed_load(this->basePrice);
+    const bool inRange = price >= base && price <= (base + bookLength);
+    const std::uint32_t accessAtIndex =
+        std::min(price - base * inRange, bookLength);
+    return inRange ? std::make_tuple(this->buckets.orderCount(accessAtIndex),
+                                     this->buckets.lastUpdate(accessAtIndex))
+                   : std::make_tuple(0u, std::uint64_t{0});
+  }));
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+std::tuple<std::uint32_t, std::uint32_t, std::uint32_t>
+ORDER_BOOK::depthSnapshot(std::span<level> bids,
+                          std::span<level> asks) const noexcept {
+  const auto [counts, retries] = this->consistentRead(depthRead, [&]() {
+    const std::uint32_t base = Auxil::relaxed_load(this->basePrice);
+    return std::make_tuple(
+        this->collectLevels(bids, Auxil::relaxed_load(this->bestBid), base,
+                            true),
+        this->collectLevels(asks, Auxil::relaxed_load(this->bestOffer), base,
+                            false));
+  });
+  return {std::get<0>(counts), std::get<1>(counts), retries};
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+std::uint32_t ORDER_BOOK::collectLevels(std::span<level> levels,
+                                        std::optional<std::uint32_t> touch,
+                                        std::uint32_t base,
+                                        bool bidSide) const noexcept {
+  const std::int64_t touchIndex =
+      static_cast<std::int64_t>(touch.value_or(base)) - base;
+  std::uint32_t index = std::clamp<std::int64_t>(touchIndex, 0, bookLength);
+  const std::uint32_t endIndex = bidSide ? 0 : bookLength;
+  const std::int32_t step = bidSide ? -1 : 1;
+  std::uint32_t nLevels{0};
+  bool done = !touch.has_value() || levels.empty();
+  while (!done) {
+    std::optional<std::uint32_t> found;
+    if constexpr (occupancyBitmap) {
+      const bitmapType& occupancy =
+          bidSide ? this->bidOccupancy : this->offerOccupancy;
+      found = bidSide ? this->prevOccupied(occupancy, index, endIndex)
+                      : this->nextOccupied(occupancy, index, endIndex);
+    } else {
+      // book is never crossed, any non-empty bucket away from the touch
+      // belongs to the side being collected
+      bool endReached{false};
+      while (!found.has_value() && !endReached) {
+        found = this->buckets[index].getVolume() != 0
+                    ? std::make_optional(index)
+                    : std::nullopt;
+        endReached = index == endIndex;
+        index += step;
+      }
+    }
+    // bitmap may name an index beyond the book while a shift is under way
+    const std::uint32_t foundIndex = std::min(found.value_or(0), bookLength);
+    levels[nLevels] = level{base + foundIndex,
+                            this->buckets[foundIndex].getVolume()};
+    nLevels += found.has_value();
+    done = !found.has_value() || nLevels == levels.size() ||
+           foundIndex == endIndex;
+    index = foundIndex + step;
+  }
+  return nLevels;
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+template <typename resetFuncType, typename levelFuncType>
+requires trackChanges_ && lockPolicy_::enabled
+void ORDER_BOOK::drainChangedLevels(bool fullRefresh, resetFuncType&& resetFunc,
+                                    levelFuncType&& levelFunc) noexcept {
+  // no version bump, nothing visible to readers is modified
+  const std::lock_guard guard(this->modifyLock);
+  if (fullRefresh || this->levelsReset) {
+    resetFunc();
+    this->dirtyLevels.clear();
+    for (std::uint32_t i = 0; i < storageType::length; ++i) {
+      this->buckets[i].getVolume() != 0
+          ? this->dirtyLevels.assign(this->buckets.slot(i), true)
+          : void();
+    }
+    this->levelsReset = false;
+  }
+  // slots ascend with prices except for a wrapped ring buffer, order of
+  // reported levels is not guaranteed
+  auto slot = this->dirtyLevels.findNext(0, storageType::capacity - 1);
+  while (slot.has_value()) {
+    const std::uint32_t index = this->buckets.index(slot.value());
+    levelFunc(this->basePrice + index, this->buckets[index].getVolume());
+    this->dirtyLevels.assign(slot.value(), false);
+    slot = slot.value() + 1 < storageType::capacity
+               ? this->dirtyLevels.findNext(slot.value() + 1,
+                                            storageType::capacity - 1)
+               : std::nullopt;
+  }
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+OrderBook::bookStats ORDER_BOOK::copyState(std::span<std::byte> dest) noexcept
+    requires copyableState && lockPolicy_::enabled {
+  // nothing is modified, version counter stays untouched
+  const std::lock_guard guard(this->modifyLock);
+  std::memcpy(dest.data(), &this->buckets[0],
+              std::min(dest.size(), stateBytes));
+  return bookStats{this->basePrice, this->bestBid, this->lowestBid,
+                   this->bestOffer, this->highestOffer};
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+bool ORDER_BOOK::restoreState(const bookStats& stats,
+                              std::span<const std::byte> src) noexcept
+    requires copyableState {
+  if (src.size() < stateBytes) {
+    return false;
+  }
+  const std::lock_guard guard(this->modifyLock);
+  this->beginWrite();
+  std::memcpy(&this->buckets[0], src.data(), stateBytes);
+  this->basePrice = stats.basePrice;
+  this->bestBid = stats.bestBid;
+  this->lowestBid = stats.lowestBid;
+  this->bestOffer = stats.bestOffer;
+  this->highestOffer = stats.highestOffer;
+  for (std::uint32_t i = 0; i < storageType::length; ++i) {
+    this->updateOccupancy(i);
+  }
+  if constexpr (trackChanges_) {
+    // consumers of changed levels need a full refresh
+    this->levelsReset = true;
+  }
+  this->publishTopOfBook();
+  this->endWrite();
+  return true;
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+void ORDER_BOOK::subscribeFills(fillSink_* sink) noexcept
+    requires fillSink_::enabled {
+  this->fillSubscriber = sink;
 };
 
 ORDER_BOOK_TEMPLATE_DECLARATION
 bool ORDER_BOOK::shiftBook(std::int32_t shiftBy) noexcept {
+  // acquire exclusive/write access to order book
+  const std::lock_guard guard(this->modifyLock);
+  // odd version invalidates reads while the book is shifted
+  this->beginWrite();
+  const bool shiftPossible = this->performShift(shiftBy);
+  this->publishTopOfBook();
+  this->endWrite();
+  return shiftPossible;
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+std::uint64_t ORDER_BOOK::shiftCount() const noexcept {
+  return this->shiftsPerformed.load(std::memory_order_relaxed);
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+std::uint64_t ORDER_BOOK::outOfRangeCount() const noexcept {
+  return this->outOfRangeOrders.load(std::memory_order_relaxed);
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+std::int64_t ORDER_BOOK::version() const noexcept {
+  return this->versionCounter.load(std::memory_order_acquire);
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+std::tuple<std::uint64_t, std::uint64_t> ORDER_BOOK::readRetryCounts(
+    std::uint32_t readAPI) const noexcept {
+  return {this->readCollisions[readAPI].load(std::memory_order_relaxed),
+          this->readRetries[readAPI].load(std::memory_order_relaxed)};
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+bool ORDER_BOOK::performShift(std::int32_t shiftBy) noexcept {
   const bool shiftUp = shiftBy >= 0;
   const bool posBasePrice =
       (static_cast<std::int32_t>(this->basePrice) + shiftBy) >= 0;
-  // acquire exclusive/write access to order book
-  auto guard = AtomicGuards::AtomicFlagGuard(&this->modifyLock);
-  guard.lock();
   // check if there are enough empty buckets to spare when book is shifted so no
   // information is lost, negative shift
   const std::int32_t maxPrice = this->basePrice + bookLength;
@@ -252,16 +935,36 @@ bool ORDER_BOOK::shiftBook(std::int32_t shiftBy) noexcept {
   const bool shiftPossible = (sufficientDistanceShiftUp ||
                               sufficientDistanceShiftDown || zeroVolume) &&
                              posBasePrice;
-  // no need to perform actual shift if book is empty, just adjust basePrice
-  const std::int32_t memShift = shiftBy * shiftPossible * !zeroVolume;
+  // no need to perform actual shift if book is empty, just adjust basePrice,
+  // unless storage keeps metadata of levels dropping out of range
+  const std::int32_t memShift =
+      shiftBy * shiftPossible * (!zeroVolume || storageType::levelMetadata);
   std::atomic_signal_fence(std::memory_order_acq_rel);
-  std::shift_left(this->memSpan.begin(), this->memSpan.end(),
-                  shiftUp * memShift);
-  std::shift_right(this->memSpan.begin(), this->memSpan.end(),
-                   (-1) * !shiftUp * memShift);
+  // dirty slots no longer match their prices once basePrice moves, even if
+  // no bucket is moved in memory
+  if constexpr (trackChanges_) {
+    this->levelsReset =
+        this->levelsReset ||
+        (shiftPossible && shiftBy != 0 &&
+         this->dirtyLevels.findNext(0, storageType::capacity - 1).has_value());
+  }
+  this->buckets.shift(memShift);
   this->basePrice += shiftBy * shiftPossible;
-  std::atomic_signal_fence(std::memory_order_acq_rel);
-  ++this->versionCounter;
+  // volume changed position in memory, occupancy needs to be rebuilt
+  if constexpr (occupancyBitmap && storageType::shiftMovesBuckets) {
+    if (memShift != 0) {
+      this->bidOccupancy.clear();
+      this->offerOccupancy.clear();
+      for (std::uint32_t i = 0; i < storageType::length; ++i) {
+        this->updateOccupancy(i);
+      }
+    }
+  }
+  // single writer, no need for atomic read-modify-write
+  this->shiftsPerformed.store(
+      this->shiftsPerformed.load(std::memory_order_relaxed) +
+          (shiftPossible && shiftBy != 0),
+      std::memory_order_relaxed);
   return shiftPossible;
 };
 
@@ -270,25 +973,148 @@ bool ORDER_BOOK::priceInRange(std::uint32_t price) noexcept {
   return price <= (this->basePrice + bookLength) && price >= this->basePrice;
 };
 
+ORDER_BOOK_TEMPLATE_DECLARATION
+void ORDER_BOOK::updateOccupancy(std::uint32_t index) noexcept {
+  if constexpr (occupancyBitmap) {
+    const entryType volume = this->buckets[index].getVolume();
+    const std::uint32_t slot = this->buckets.slot(index);
+    this->bidOccupancy.assign(slot, volume < 0);
+    this->offerOccupancy.assign(slot, volume > 0);
+  }
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+void ORDER_BOOK::bucketChanged(std::uint32_t index, bool changed) noexcept {
+  this->updateOccupancy(index);
+  this->buckets.updated(index);
+  if constexpr (trackChanges_) {
+    changed ? this->dirtyLevels.assign(this->buckets.slot(index), true)
+            : void();
+  }
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+std::optional<std::uint32_t> ORDER_BOOK::nextOccupied(
+    const bitmapType& occupancy, std::uint32_t fromIndex,
+    std::uint32_t toIndex) const noexcept {
+  const std::uint32_t fromSlot = this->buckets.slot(fromIndex);
+  const std::uint32_t toSlot = this->buckets.slot(toIndex);
+  const bool wraps = fromSlot > toSlot;
+  auto found = occupancy.findNext(
+      fromSlot, wraps ? storageType::capacity - 1 : toSlot);
+  found = found.has_value() || !wraps ? found : occupancy.findNext(0, toSlot);
+  return found.transform(
+      [&](std::uint32_t slot) { return this->buckets.index(slot); });
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+std::optional<std::uint32_t> ORDER_BOOK::prevOccupied(
+    const bitmapType& occupancy, std::uint32_t fromIndex,
+    std::uint32_t toIndex) const noexcept {
+  const std::uint32_t fromSlot = this->buckets.slot(fromIndex);
+  const std::uint32_t toSlot = this->buckets.slot(toIndex);
+  const bool wraps = fromSlot < toSlot;
+  auto found = occupancy.findPrev(fromSlot, wraps ? 0 : toSlot);
+  found = found.has_value() || !wraps
+              ? found
+              : occupancy.findPrev(storageType::capacity - 1, toSlot);
+  return found.transform(
+      [&](std::uint32_t slot) { return this->buckets.index(slot); });
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+typename ORDER_BOOK::entryType ORDER_BOOK::consumeBucket(
+    std::uint32_t index, entryType fillVolume) noexcept {
+  const entryType volumeFilled =
+      this->buckets[index].consumeLiquidity(fillVolume);
+  if constexpr (orderLevel) {
+    // all orders queued in a bucket are on the same side as its volume,
+    // filled volume hence is distributed among them front to back
+    entryType openVol = volumeFilled;
+    while (openVol != 0) {
+      const std::uint32_t nodeIndex = this->buckets[index].front();
+      nodeType& node = this->orderPool[nodeIndex];
+      const bool exhausted = std::abs(node.volume) <= std::abs(openVol);
+      const entryType nodeFill = exhausted ? node.volume : openVol;
+      node.volume -= nodeFill;
+      openVol -= nodeFill;
+      exhausted ? this->releaseOrder(nodeIndex) : void();
+    }
+  }
+  return volumeFilled;
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+typename ORDER_BOOK::entryType ORDER_BOOK::withdrawFromBucket(
+    std::uint32_t index, entryType volume, std::uint32_t nodeIndex) noexcept {
+  if constexpr (orderLevel) {
+    // withdraw no more than what is left of the order
+    nodeType& node = this->orderPool[nodeIndex];
+    const bool exhausted = std::abs(node.volume) <= std::abs(volume);
+    const entryType volumeWithdrawn = exhausted ? node.volume : volume;
+    node.volume -= volumeWithdrawn;
+    this->buckets[index].consumeLiquidity(volumeWithdrawn);
+    exhausted ? this->releaseOrder(nodeIndex) : void();
+    return volumeWithdrawn;
+  }
+  return this->buckets[index].consumeLiquidity(volume);
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+void ORDER_BOOK::enqueueOrder(std::uint64_t orderID, entryType volume,
+                              std::uint32_t price) noexcept {
+  if constexpr (orderLevel) {
+    // availability of a node has been checked before the order was matched
+    const std::uint32_t nodeIndex = this->orderPool.allocate().value();
+    this->orderPool[nodeIndex] = nodeType{orderID, volume, price};
+    this->buckets[price - this->basePrice].pushBack(
+        nodeIndex, this->orderPool.nodeSpan());
+    this->orderIndex.insert(orderID, nodeIndex);
+  }
+};
+
+ORDER_BOOK_TEMPLATE_DECLARATION
+void ORDER_BOOK::releaseOrder(std::uint32_t nodeIndex) noexcept {
+  if constexpr (orderLevel) {
+    const nodeType& node = this->orderPool[nodeIndex];
+    this->buckets[node.price - this->basePrice].unlink(
+        nodeIndex, this->orderPool.nodeSpan());
+    this->orderIndex.erase(node.orderID);
+    this->orderPool.release(nodeIndex);
+  }
+};
+
 // return std::optional with index of first non empty price bucket from
 // startIndex to endIndex returns optional containing the price (NOT INDEX!) of
 // liquid bucket, empty optional if search is unsuccesful returns empty optional
 // if negative endIndex is passed
 ORDER_BOOK_TEMPLATE_DECLARATION
 std::optional<std::uint32_t> ORDER_BOOK::findLiquidBucket(
-    std::uint32_t startPrice, std::int32_t endPrice) noexcept {
+    std::uint32_t startPrice, std::int32_t endPrice,
+    bool bidSide) const noexcept {
   const std::int32_t startIndex{startPrice -
                                 static_cast<std::int32_t>(this->basePrice)};
   const std::int32_t endIndex =
       endPrice >= 0 ? endPrice - static_cast<std::int32_t>(this->basePrice)
                     : startIndex;
+  if constexpr (occupancyBitmap) {
+    // bit scans over occupancy of the relevant side replace linear search
+    const bitmapType& occupancy =
+        bidSide ? this->bidOccupancy : this->offerOccupancy;
+    const auto foundIndex =
+        startIndex <= endIndex
+            ? this->nextOccupied(occupancy, startIndex, endIndex)
+            : this->prevOccupied(occupancy, startIndex, endIndex);
+    return foundIndex.transform(
+        [&](std::uint32_t index) { return this->basePrice + index; });
+  }
   const std::int8_t increment = 1 - 2 * (startIndex > endIndex);
   // skip loop if negative/dummy index was passed
   std::int32_t retPrice{0}, index{startIndex};
   bool endIndexReached{false};
   bool success{false};
   while (!success && !endIndexReached) {
-    success = this->memSpan[index].getVolume() != 0;
+    success = this->buckets[index].getVolume() != 0;
     retPrice += success * (this->basePrice + index);
     endIndexReached = index == endIndex;
     index += increment;
@@ -309,8 +1135,48 @@ typename ORDER_BOOK::orderResponse ORDER_BOOK::runThroughBook(
   entryType openVol{volume * !dummyRun}, filledVol{0}, orderRevenue{0};
   std::int32_t index{startPrice - static_cast<std::int32_t>(this->basePrice)};
   std::int32_t transactionIndex{0};
+  if constexpr (vectorSweep) {
+    // only worth it if the order reaches beyond the first bucket, buckets
+    // consumed entirely are zeroed by the kernel, the loop below takes care of
+    // the remaining partially filled bucket
+    const std::int32_t available =
+        buyOrder ? static_cast<std::int32_t>(storageType::length) - index
+                 : index + 1;
+    const std::int32_t count = std::min(nIterations + 1, available);
+    if (count >= static_cast<std::int32_t>(SweepKernel::minLevels) &&
+        openVol != 0 && index >= 0 &&
+        std::abs(this->buckets[index].getVolume()) < std::abs(openVol)) {
+      const auto swept = SweepKernel::sweep(
+          reinterpret_cast<std::int64_t*>(&this->buckets[index]), count,
+          buyOrder, std::abs(openVol), this->basePrice + index);
+      const std::int32_t consumed = swept.consumed;
+      if constexpr (occupancyBitmap) {
+        consumed > 0 ? buyOrder ? this->offerOccupancy.clearRange(
+                                      index, index + consumed - 1)
+                                : this->bidOccupancy.clearRange(
+                                      index - consumed + 1, index)
+                     : void();
+      }
+      transactionIndex = swept.lastFilled >= 0
+                             ? index + increment * swept.lastFilled
+                             : transactionIndex;
+      openVol += increment * swept.liquidity;
+      orderRevenue -= increment * swept.revenue;
+      index += increment * consumed;
+      nIterations -= consumed;
+    }
+  }
   while (nIterations >= 0 && openVol != 0 && index >= 0) {
-    filledVol = this->memSpan[index].consumeLiquidity(-openVol);
+    filledVol = this->consumeBucket(index, -openVol);
+    this->bucketChanged(index, filledVol != 0);
+    if constexpr (fillSink_::enabled) {
+      filledVol != 0 && this->fillSubscriber != nullptr
+          ? this->fillSubscriber->fill(
+                this->basePrice + index,
+                static_cast<entryType_>(buyOrder ? filledVol : -filledVol),
+                buyOrder ? FillSink::buy : FillSink::sell)
+          : void();
+    }
     transactionIndex = filledVol != 0 ? index : transactionIndex;
     orderRevenue -= filledVol * (index + this->basePrice);
     // open volume and filled volume will have opposite signs, addition hence
@@ -318,6 +1184,23 @@ typename ORDER_BOOK::orderResponse ORDER_BOOK::runThroughBook(
     openVol += filledVol;
     index += increment;
     --nIterations;
+    if constexpr (occupancyBitmap) {
+      // skip empty buckets by jumping straight to the next bucket containing
+      // liquidity within range, end loop if there is none
+      const bool searchOn = nIterations >= 0 && openVol != 0;
+      const auto nextIndex =
+          !searchOn  ? std::nullopt
+          : buyOrder ? this->nextOccupied(this->offerOccupancy, index,
+                                          index + nIterations)
+                     : this->prevOccupied(this->bidOccupancy, index,
+                                          index - nIterations);
+      nIterations -=
+          nextIndex.has_value()
+              ? (static_cast<std::int32_t>(nextIndex.value()) - index) *
+                    increment
+              : nIterations + 1;
+      index = nextIndex.value_or(index);
+    }
   };
   // update stats for bestBid/bestOffer
   const std::int32_t flbEndPrice =
@@ -326,7 +1209,8 @@ typename ORDER_BOOK::orderResponse ORDER_BOOK::runThroughBook(
 
   this->bestOffer = this->bestOffer.and_then([&](std::uint32_t arg) {
     return buyOrder
-               ? this->findLiquidBucket(this->bestOffer.value(), flbEndPrice)
+               ? this->findLiquidBucket(this->bestOffer.value(), flbEndPrice,
+                                        false)
                : arg;
   });
   this->highestOffer = this->highestOffer.and_then([&](std::uint32_t arg) {
@@ -335,7 +1219,8 @@ typename ORDER_BOOK::orderResponse ORDER_BOOK::runThroughBook(
 
   this->bestBid = this->bestBid.and_then([&](std::uint32_t arg) {
     return !buyOrder
-               ? this->findLiquidBucket(this->bestBid.value(), flbEndPrice)
+               ? this->findLiquidBucket(this->bestBid.value(), flbEndPrice,
+                                        true)
                : arg;
   });
   this->lowestBid = this->lowestBid.and_then([&](std::uint32_t arg) {
@@ -347,16 +1232,25 @@ typename ORDER_BOOK::orderResponse ORDER_BOOK::runThroughBook(
 };
 
 ORDER_BOOK_TEMPLATE_DECLARATION
+template <typename orderType>
 typename ORDER_BOOK::orderResponse ORDER_BOOK::handleNewLimitOrder(
-    const newLimitOrderClass& order) noexcept {
-  std::uint32_t price = order.orderPrice;
+    const orderType& order) noexcept {
+  std::uint32_t price = MsgTypeChecks::priceOf(order);
+  const std::int32_t orderVolume = MsgTypeChecks::volumeOf(order);
 
   // check if price is out of range, if so set order volume to 0
   // and price to base price to avoid out of bounds memory access, then proceed
   // regularly
-  const bool priceInRange = order.orderVolume == 0 || this->priceInRange(price);
+  const bool priceInRange = orderVolume == 0 || this->priceInRange(price);
   price = price * priceInRange + this->basePrice * !priceInRange;
-  const std::int32_t volume = order.orderVolume * priceInRange;
+  // order level book rejects orders whose ID is already resting
+  bool accepted = true;
+  if constexpr (orderLevel) {
+    accepted = orderVolume == 0 ||
+               !this->orderIndex.find(MsgTypeChecks::orderIDOf(order))
+                    .has_value();
+  }
+  const std::int32_t volume = orderVolume * priceInRange * accepted;
   const bool dummyOrder = volume == 0;
   const bool buyOrder = volume < 0;
 
@@ -373,14 +1267,37 @@ typename ORDER_BOOK::orderResponse ORDER_BOOK::handleNewLimitOrder(
                      !buyOrder * this->lowestBid.value_or(-1));
   ret = this->runThroughBook(volume, runEndPrice);
 
-  // insert error code if price is out of range
-  std::get<3>(ret) += 1 * !priceInRange;
+  // volume left after matching is dropped if the book cannot hold it: order
+  // level book without a free node to keep track of the order, paged storage
+  // without a page for its price while the pool is exhausted (pages are
+  // returned while running through the book), SoA storage if it might not fit
+  // the narrow volume type while the overflow table is full
+  const entryType openVol = volume - std::get<1>(ret);
+  bool restable = this->buckets.reservable(price - this->basePrice, openVol);
+  if constexpr (orderLevel) {
+    restable = restable && this->orderPool.available() != 0;
+  }
+  accepted = accepted && (openVol == 0 || restable);
+
+  // insert error code if price is out of range or order (or its remainder) was
+  // rejected
+  std::get<3>(ret) += 1 * !priceInRange + 2 * (priceInRange && !accepted);
+  this->outOfRangeOrders.store(
+      this->outOfRangeOrders.load(std::memory_order_relaxed) + !priceInRange,
+      std::memory_order_relaxed);
 
   // enter liquidity into order book
-  const entryType unfilledVol = volume - std::get<1>(ret);
+  const entryType unfilledVol = openVol * accepted;
   const bool liqAdded = unfilledVol != 0;
-  !dummyOrder ? this->memSpan[price - basePrice].addLiquidity(unfilledVol)
+  liqAdded ? this->buckets.reserve(price - basePrice) : void();
+  !dummyOrder ? this->buckets[price - basePrice].addLiquidity(unfilledVol)
               : void();
+  !dummyOrder ? this->bucketChanged(price - basePrice, liqAdded) : void();
+  if constexpr (orderLevel) {
+    liqAdded ? this->enqueueOrder(MsgTypeChecks::orderIDOf(order),
+                                  unfilledVol, price)
+             : void();
+  }
 
   // check which statistic (if any) needs to be updated
   const bool updateLowestBid =
@@ -409,77 +1326,105 @@ typename ORDER_BOOK::orderResponse ORDER_BOOK::handleNewLimitOrder(
 };
 
 ORDER_BOOK_TEMPLATE_DECLARATION
+template <typename orderType>
 typename ORDER_BOOK::orderResponse ORDER_BOOK::handleWithdrawLimitOrder(
-    const withdrawLimitOrderClass& order) noexcept {
-  std::uint32_t price = order.orderPrice;
+    const orderType& order) noexcept {
+  std::uint32_t price = MsgTypeChecks::priceOf(order);
+  std::int32_t orderVolume = MsgTypeChecks::volumeOf(order);
+  std::uint32_t nodeIndex = OrderBookBucket::noNode;
+  bool accepted = true;
+  if constexpr (orderLevel) {
+    // volume can only be withdrawn from the order with matching ID and on the
+    // same side, price is taken from the resting order
+    const auto found =
+        orderVolume != 0
+            ? this->orderIndex.find(MsgTypeChecks::orderIDOf(order))
+            : std::nullopt;
+    nodeIndex = found.value_or(OrderBookBucket::noNode);
+    price = found.has_value() ? this->orderPool[nodeIndex].price : price;
+    accepted = orderVolume == 0 ||
+               (found.has_value() &&
+                (this->orderPool[nodeIndex].volume < 0) == (orderVolume < 0));
+    orderVolume *= accepted;
+  }
 
   // check if price is out of range, if so set order volume to 0 but proceed
   // set priceInRange to true for volume == 0 to avoid error code in order
   // response for default/dummy withdraw messages
-  const bool hasVolume = order.orderVolume != 0;
+  const bool hasVolume = orderVolume != 0;
   const bool priceInRange = !hasVolume || this->priceInRange(price);
   price = price * priceInRange + this->basePrice * !priceInRange;
-  const std::int32_t volume = order.orderVolume * priceInRange;
+  const std::int32_t volume = orderVolume * priceInRange;
   const bool withdrawSupply = volume > 0;
+  this->outOfRangeOrders.store(
+      this->outOfRangeOrders.load(std::memory_order_relaxed) + !priceInRange,
+      std::memory_order_relaxed);
 
   // perform actual withdrawel
   const std::int32_t volumeWithdrawn =
-      hasVolume
-          ? this->memSpan[price - this->basePrice].consumeLiquidity(volume)
-          : 0;
+      hasVolume ? this->withdrawFromBucket(price - this->basePrice, volume,
+                                           nodeIndex)
+                : 0;
+  hasVolume ? this->bucketChanged(price - this->basePrice, volumeWithdrawn != 0)
+            : void();
 
   // upate stats if necessary
   const bool liquidityExhausted =
-      !hasVolume || this->memSpan[price - this->basePrice].getVolume() == 0;
+      !hasVolume || this->buckets[price - this->basePrice].getVolume() == 0;
   this->bestBid = this->bestBid.and_then([&](std::uint32_t arg) {
     return (price != arg || !liquidityExhausted)
                ? std::make_optional(arg)
-               : this->findLiquidBucket(price, this->lowestBid.value());
+               : this->findLiquidBucket(price, this->lowestBid.value(), true);
   });
   this->lowestBid = this->lowestBid.and_then([&](std::uint32_t arg) {
     return (price != arg || !liquidityExhausted)
                ? std::make_optional(arg)
-               : this->findLiquidBucket(price, this->bestBid.value_or(-1));
+               : this->findLiquidBucket(price, this->bestBid.value_or(-1),
+                                        true);
   });
   this->bestOffer = this->bestOffer.and_then([&](std::uint32_t arg) {
     return (price != arg || !liquidityExhausted)
                ? std::make_optional(arg)
-               : this->findLiquidBucket(price, this->highestOffer.value());
+               : this->findLiquidBucket(price, this->highestOffer.value(),
+                                        false);
   });
   this->highestOffer = this->highestOffer.and_then([&](std::uint32_t arg) {
     return (price != arg || !liquidityExhausted)
                ? std::make_optional(arg)
-               : this->findLiquidBucket(price, this->bestOffer.value_or(-1));
+               : this->findLiquidBucket(price, this->bestOffer.value_or(-1),
+                                        false);
   });
-  return orderResponse{0, volumeWithdrawn, 0, 1 * !priceInRange};
+  return orderResponse{0, volumeWithdrawn, 0,
+                       1 * !priceInRange + 2 * !accepted};
 };
 
 ORDER_BOOK_TEMPLATE_DECLARATION
+template <typename orderType>
 typename ORDER_BOOK::orderResponse ORDER_BOOK::handleMarketOrder(
-    const marketOrderClass& order) noexcept {
-  const std::int32_t volume = order.orderVolume;
+    const orderType& order) noexcept {
+  const std::int32_t volume = MsgTypeChecks::volumeOf(order);
   const std::int32_t runEndPrice =
       -1 * (volume == 0) + (volume < 0) * (this->highestOffer.value_or(-1)) +
       (volume > 0) * (this->lowestBid.value_or(-1));
-  return this->runThroughBook(order.orderVolume, runEndPrice);
+  return this->runThroughBook(volume, runEndPrice);
 };
 
 ORDER_BOOK_TEMPLATE_DECLARATION
 std::uint64_t ORDER_BOOK::__invariantsCheck(int nIt) const {
   std::uint64_t errorCode{0};
-  auto isPositive = [](bucketType b) { return b.getVolume() >= 0; };
-  auto isNegative = [](bucketType b) { return b.getVolume() <= 0; };
-  auto isZero = [](bucketType b) { return b.getVolume() == 0; };
+  auto isPositive = [](const auto& b) { return b.getVolume() >= 0; };
+  auto isNegative = [](const auto& b) { return b.getVolume() <= 0; };
+  auto isZero = [](const auto& b) { return b.getVolume() == 0; };
   auto invalidStat = [&](std::optional<std::uint32_t> stat) {
     return stat.has_value() &&
-           memSpan[stat.value() - basePrice].getVolume() == 0;
+           buckets[stat.value() - basePrice].getVolume() == 0;
   };
 
   if (bestBid.has_value() && lowestBid.has_value()) {
     std::uint32_t lbIndex = lowestBid.value() - basePrice;
     std::uint32_t bbIndex = bestBid.value() - basePrice;
-    auto lbSubspan = memSpan.subspan(0, lbIndex);
-    auto bbSubspan = memSpan.subspan(bbIndex + 1, bookLength_ - bbIndex - 1);
+    auto lbSubspan = buckets.subrange(0, lbIndex);
+    auto bbSubspan = buckets.subrange(bbIndex + 1, bookLength_ - bbIndex);
     bool wrongBelow = !std::ranges::all_of(lbSubspan, isZero);
     bool wrongAbove = !std::ranges::all_of(bbSubspan, isPositive);
     if (wrongAbove) {
@@ -495,8 +1440,8 @@ std::uint64_t ORDER_BOOK::__invariantsCheck(int nIt) const {
   if (bestOffer.has_value() && highestOffer.has_value()) {
     std::uint32_t hoIndex = highestOffer.value() - basePrice;
     std::uint32_t boIndex = bestOffer.value() - basePrice;
-    auto boSubspan = memSpan.subspan(0, boIndex);
-    auto hoSubspan = memSpan.subspan(hoIndex + 1, bookLength_ - hoIndex - 1);
+    auto boSubspan = buckets.subrange(0, boIndex);
+    auto hoSubspan = buckets.subrange(hoIndex + 1, bookLength_ - hoIndex);
     bool wrongAbove = !std::ranges::all_of(hoSubspan, isZero);
     bool wrongBelow = !std::ranges::all_of(boSubspan, isNegative);
     if (wrongAbove) {
@@ -555,6 +1500,24 @@ std::uint64_t ORDER_BOOK::__invariantsCheck(int nIt) const {
     errorCode += 1000000000000;
   }
 
+  if constexpr (orderLevel) {
+    // aggregate volume of each bucket has to match the orders in its queue
+    bool queueMismatch = false;
+    for (std::uint32_t i = 0; i <= bookLength_; ++i) {
+      entryType queuedVolume{0};
+      for (std::uint32_t node = buckets[i].front();
+           node != OrderBookBucket::noNode; node = orderPool[node].next) {
+        queuedVolume += orderPool[node].volume;
+        queueMismatch = queueMismatch || orderPool[node].price != basePrice + i;
+      }
+      queueMismatch = queueMismatch || queuedVolume != buckets[i].getVolume();
+    }
+    if (queueMismatch) {
+      std::cout << "order queues don't match aggregate volume: " << nIt << "\n";
+      errorCode += 10000000000000;
+    }
+  }
+
   return errorCode;
 };
 
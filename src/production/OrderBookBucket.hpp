@@ -2,6 +2,8 @@
 
 #include <concepts>
 #include <cstdint>
+#include <limits>
+#include <span>
 
 #include "Auxil.hpp"
 
@@ -13,9 +15,50 @@ struct alignas(alignment) orderBookBucket {
   EntryType volume = 0;
 
  public:
+  using entryType = EntryType;
   EntryType consumeLiquidity(EntryType) noexcept;
   void addLiquidity(EntryType) noexcept;
-  EntryType getVolume() noexcept;
+  EntryType getVolume() const noexcept;
+};
+
+// marks end of a queue/ absence of a node
+static constexpr std::uint32_t noNode =
+    std::numeric_limits<std::uint32_t>::max();
+
+// resting order of an order level book, linked into the queue of the bucket at
+// its price via indices into a pool of nodes
+template <typename EntryType>
+requires std::signed_integral<EntryType>
+struct orderNode {
+  std::uint64_t orderID = 0;
+  EntryType volume = 0;
+  std::uint32_t price = 0;
+  std::uint32_t prev = noNode;
+  std::uint32_t next = noNode;
+};
+
+// bucket keeping aggregate volume as well as an intrusive FIFO queue of all
+// orders resting at its price
+template <typename EntryType, std::uint32_t alignment>
+requires std::signed_integral<EntryType>
+struct alignas(alignment) orderQueueBucket {
+ private:
+  orderBookBucket<EntryType, alignof(EntryType)> aggregate;
+  std::uint32_t head = noNode;
+  std::uint32_t tail = noNode;
+
+ public:
+  using entryType = EntryType;
+  using nodeType = orderNode<EntryType>;
+  EntryType consumeLiquidity(EntryType) noexcept;
+  void addLiquidity(EntryType) noexcept;
+  EntryType getVolume() const noexcept;
+  // index of oldest order in queue, noNode if queue is empty
+  std::uint32_t front() const noexcept;
+  // appends node to queue, does not alter aggregate volume
+  void pushBack(std::uint32_t, std::span<nodeType>) noexcept;
+  // removes node from anywhere in the queue, does not alter aggregate volume
+  void unlink(std::uint32_t, std::span<nodeType>) noexcept;
 };
 };  // namespace OrderBookBucket
 
@@ -46,7 +89,62 @@ void orderBookBucket<EntryType, alignment>::addLiquidity(
 
 template <typename EntryType, std::uint32_t alignment>
 requires std::signed_integral<EntryType>
-EntryType orderBookBucket<EntryType, alignment>::getVolume() noexcept {
-  return this->volume;
+EntryType orderBookBucket<EntryType, alignment>::getVolume() const noexcept {
+  // read by seqlock readers of the book while the writer modifies it
+  return Auxil::relaxed_load(this->volume);
+};
+};  // namespace OrderBookBucket
+
+#define ORDER_QUEUE_BUCKET \
+  OrderBookBucket::orderQueueBucket<EntryType, alignment>
+
+namespace OrderBookBucket {
+template <typename EntryType, std::uint32_t alignment>
+requires std::signed_integral<EntryType>
+EntryType ORDER_QUEUE_BUCKET::consumeLiquidity(EntryType fillVolume) noexcept {
+  return this->aggregate.consumeLiquidity(fillVolume);
+};
+
+template <typename EntryType, std::uint32_t alignment>
+requires std::signed_integral<EntryType>
+void ORDER_QUEUE_BUCKET::addLiquidity(EntryType addVolume) noexcept {
+  this->aggregate.addLiquidity(addVolume);
+};
+
+template <typename EntryType, std::uint32_t alignment>
+requires std::signed_integral<EntryType>
+EntryType ORDER_QUEUE_BUCKET::getVolume() const noexcept {
+  return this->aggregate.getVolume();
+};
+
+template <typename EntryType, std::uint32_t alignment>
+requires std::signed_integral<EntryType>
+std::uint32_t ORDER_QUEUE_BUCKET::front() const noexcept {
+  return this->head;
+};
+
+template <typename EntryType, std::uint32_t alignment>
+requires std::signed_integral<EntryType>
+void ORDER_QUEUE_BUCKET::pushBack(std::uint32_t nodeIndex,
+                                  std::span<nodeType> nodes) noexcept {
+  nodes[nodeIndex].prev = this->tail;
+  nodes[nodeIndex].next = noNode;
+  this->tail != noNode ? void(nodes[this->tail].next = nodeIndex) : void();
+  this->head = this->head == noNode ? nodeIndex : this->head;
+  this->tail = nodeIndex;
+};
+
+template <typename EntryType, std::uint32_t alignment>
+requires std::signed_integral<EntryType>
+void ORDER_QUEUE_BUCKET::unlink(std::uint32_t nodeIndex,
+                                std::span<nodeType> nodes) noexcept {
+  const std::uint32_t prev = nodes[nodeIndex].prev;
+  const std::uint32_t next = nodes[nodeIndex].next;
+  prev != noNode ? void(nodes[prev].next = next) : void(this->head = next);
+  next != noNode ? void(nodes[next].prev = prev) : void(this->tail = prev);
+  nodes[nodeIndex].prev = noNode;
+  nodes[nodeIndex].next = noNode;
 };
 };  // namespace OrderBookBucket
+
+#undef ORDER_QUEUE_BUCKET
@@ -0,0 +1,698 @@
+// storage policies for the price buckets of an order book, mapping the index
+// of a bucket relative to the base price (logical index) to its position in
+// memory (slot)
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <ranges>
+#include <span>
+
+#include "Auxil.hpp"
+#include "MemoryArena.hpp"
+
+namespace OrderBookStorage {
+// buckets stored contiguously in order of price, shifting the book moves every
+// bucket in memory
+template <typename bucketType, std::uint32_t length_>
+struct denseStorage {
+ private:
+  MemoryArena::memoryArena* arena;
+  void* memoryPointer;
+  std::span<bucketType, length_> memSpan;
+
+ public:
+  // number of buckets addressable via logical index
+  static constexpr std::uint32_t length = length_;
+  // number of slots in memory
+  static constexpr std::uint32_t capacity = length_;
+  // if true, slots of all buckets change when the book is shifted
+  static constexpr bool shiftMovesBuckets = true;
+  // if true, logical index and slot coincide and buckets are stored in order
+  // of their prices without gaps
+  static constexpr bool contiguous = true;
+  // if true, number of orders and last update are kept per level and reset
+  // with every shift, even of an empty book
+  static constexpr bool levelMetadata = false;
+  // bytes of memory allocated
+  static constexpr std::size_t byteLength = capacity * sizeof(bucketType);
+  // memory is taken from arena if one is passed
+  explicit denseStorage(MemoryArena::memoryArena* = nullptr);
+  ~denseStorage();
+  denseStorage(const denseStorage&) = delete;
+  denseStorage& operator=(const denseStorage&) = delete;
+  denseStorage(denseStorage&&) = delete;
+  denseStorage& operator=(denseStorage&&) = delete;
+  bucketType& operator[](std::uint32_t) noexcept;
+  const bucketType& operator[](std::uint32_t) const noexcept;
+  std::uint32_t slot(std::uint32_t) const noexcept;
+  std::uint32_t index(std::uint32_t) const noexcept;
+  // moves volume at logical index i to logical index i - shiftBy, empties
+  // buckets that are vacated
+  void shift(std::int32_t) noexcept;
+  // view of buckets in logical order
+  auto subrange(std::uint32_t, std::uint32_t) const noexcept;
+  // all buckets are always backed by memory, no need to reserve or release
+  // anything when volume is added or removed
+  bool reservable(std::uint32_t, std::int64_t) const noexcept {
+    return true;
+  };
+  void reserve(std::uint32_t) noexcept {};
+  void updated(std::uint32_t) noexcept {};
+};
+
+// buckets stored in a ring buffer of power-of-two size, the base price
+// corresponds to a moving offset into the buffer, shifting the book only
+// touches the buckets that wrap around
+template <typename bucketType, std::uint32_t length_>
+struct ringStorage {
+ private:
+  static constexpr std::uint32_t mask = std::bit_ceil(length_) - 1;
+  MemoryArena::memoryArena* arena;
+  void* memoryPointer;
+  std::span<bucketType, mask + 1> memSpan;
+  std::uint32_t offset = 0;
+
+ public:
+  static constexpr std::uint32_t length = length_;
+  static constexpr std::uint32_t capacity = mask + 1;
+  static constexpr bool shiftMovesBuckets = false;
+  static constexpr bool contiguous = false;
+  static constexpr bool levelMetadata = false;
+  static constexpr std::size_t byteLength = capacity * sizeof(bucketType);
+  explicit ringStorage(MemoryArena::memoryArena* = nullptr);
+  ~ringStorage();
+  ringStorage(const ringStorage&) = delete;
+  ringStorage& operator=(const ringStorage&) = delete;
+  ringStorage(ringStorage&&) = delete;
+  ringStorage& operator=(ringStorage&&) = delete;
+  bucketType& operator[](std::uint32_t) noexcept;
+  const bucketType& operator[](std::uint32_t) const noexcept;
+  std::uint32_t slot(std::uint32_t) const noexcept;
+  std::uint32_t index(std::uint32_t) const noexcept;
+  void shift(std::int32_t) noexcept;
+  auto subrange(std::uint32_t, std::uint32_t) const noexcept;
+  bool reservable(std::uint32_t, std::int64_t) const noexcept {
+    return true;
+  };
+  void reserve(std::uint32_t) noexcept {};
+  void updated(std::uint32_t) noexcept {};
+};
+
+// slots arranged like in ringStorage, but memory is split into pages of
+// pageLength_ buckets taken from a pool of poolPages_ pages allocated during
+// construction, a directory maps every page of slots to a page of the pool,
+// pages are taken once volume is added to one of their buckets and returned
+// once all of their buckets are empty, pages not taken map to a single page
+// that always remains empty, lookups hence never branch. Wide price ranges
+// only occupy memory for the parts actually holding volume. Memory for buckets
+// is (poolPages_ + 1) * pageLength_ * sizeof(bucketType) bytes, independent of
+// length_, the default pool covers the whole range up to 64 pages and is
+// capped at 64 pages beyond that (16384 buckets with the default page length)
+template <typename bucketType, std::uint32_t length_,
+          std::uint32_t pageLength_ = 256,
+          std::uint32_t poolPages_ = std::min<std::uint32_t>(
+              std::max(std::bit_ceil(length_), pageLength_) / pageLength_, 64)>
+struct pagedStorage {
+ private:
+  static_assert(std::has_single_bit(pageLength_) && pageLength_ >= 64);
+  static_assert(poolPages_ > 0);
+  static constexpr std::uint32_t mask =
+      std::max(std::bit_ceil(length_), pageLength_) - 1;
+  static constexpr std::uint32_t pageShift = std::countr_zero(pageLength_);
+  static constexpr std::uint32_t directoryLength = (mask + 1) >> pageShift;
+  // one bit per bucket of a page, set if bucket holds volume
+  static constexpr std::uint32_t maskWords = pageLength_ / 64;
+  static constexpr std::size_t bucketBytes =
+      std::size_t{poolPages_ + 1} * pageLength_ * sizeof(bucketType);
+  static constexpr std::size_t alignment =
+      std::max<std::size_t>(alignof(bucketType), 64);
+  MemoryArena::memoryArena* arena;
+  void* memoryPointer;
+  // page 0 is the empty page, pool pages start at 1
+  std::span<bucketType> pages;
+  std::span<std::uint64_t> nonEmpty;
+  std::span<std::uint32_t> directory;
+  std::span<std::uint32_t> freePages;
+  std::uint32_t nFree = poolPages_;
+  std::uint32_t offset = 0;
+
+ public:
+  static constexpr std::uint32_t length = length_;
+  static constexpr std::uint32_t capacity = mask + 1;
+  static constexpr bool shiftMovesBuckets = false;
+  static constexpr bool contiguous = false;
+  static constexpr bool levelMetadata = false;
+  static constexpr std::uint32_t pageLength = pageLength_;
+  static constexpr std::uint32_t poolPages = poolPages_;
+  static constexpr std::size_t byteLength =
+      bucketBytes +
+      std::size_t{poolPages_ + 1} * maskWords * sizeof(std::uint64_t) +
+      (directoryLength + poolPages_) * sizeof(std::uint32_t);
+  explicit pagedStorage(MemoryArena::memoryArena* = nullptr);
+  ~pagedStorage();
+  pagedStorage(const pagedStorage&) = delete;
+  pagedStorage& operator=(const pagedStorage&) = delete;
+  pagedStorage(pagedStorage&&) = delete;
+  pagedStorage& operator=(pagedStorage&&) = delete;
+  bucketType& operator[](std::uint32_t) noexcept;
+  const bucketType& operator[](std::uint32_t) const noexcept;
+  std::uint32_t slot(std::uint32_t) const noexcept;
+  std::uint32_t index(std::uint32_t) const noexcept;
+  // buckets dropping out of range are empty and their pages have already been
+  // returned, shifting only moves the offset
+  void shift(std::int32_t) noexcept;
+  auto subrange(std::uint32_t, std::uint32_t) const noexcept;
+  // true if bucket at index is backed by a page or a page is left in the pool
+  bool reservable(std::uint32_t, std::int64_t) const noexcept;
+  // takes page for bucket at index from the pool unless it already has one,
+  // requires reservable to be true, volume must only be added to buckets
+  // reserved
+  void reserve(std::uint32_t) noexcept;
+  // to be called after volume of bucket at index changed, returns its page to
+  // the pool if all buckets of the page are empty
+  void updated(std::uint32_t) noexcept;
+  std::uint32_t pagesInUse() const noexcept;
+};
+
+// slots arranged like in ringStorage, volume, number of orders and sequence
+// number of the last update of every level kept in separate arrays (structure
+// of arrays), volume stored as volumeType_ (narrower than the entry type of
+// the book) so more levels near the touch share a cacheline, volumes not
+// fitting are marked and kept in a side table of overflowSlots_ entries
+template <typename bucketType, std::uint32_t length_,
+          typename volumeType_ = std::int32_t,
+          std::uint32_t overflowSlots_ = 64>
+struct soaStorage {
+ private:
+  using entryType = typename bucketType::entryType;
+  // queues of order level buckets cannot be split into arrays
+  static_assert(!requires { typename bucketType::nodeType; });
+  static_assert(std::signed_integral<volumeType_> &&
+                sizeof(volumeType_) <= sizeof(entryType));
+  static constexpr std::uint32_t mask = std::bit_ceil(length_) - 1;
+  static constexpr std::size_t cacheline = 64;
+  // marks volume kept in the overflow table, the narrow range is hence one
+  // short of the range of volumeType_ on the negative side
+  static constexpr volumeType_ overflowMark =
+      std::numeric_limits<volumeType_>::min();
+  static constexpr std::uint32_t noSlot =
+      std::numeric_limits<std::uint32_t>::max();
+  struct overflowEntry {
+    std::uint32_t slot = noSlot;
+    entryType volume = 0;
+  };
+  static constexpr std::size_t roundUp(std::size_t bytes) noexcept {
+    return (bytes + cacheline - 1) / cacheline * cacheline;
+  };
+  static constexpr std::size_t volumeBytes =
+      roundUp((mask + 1) * sizeof(volumeType_));
+  static constexpr std::size_t countBytes =
+      roundUp((mask + 1) * sizeof(std::uint32_t));
+  static constexpr std::size_t updateBytes =
+      roundUp((mask + 1) * sizeof(std::uint64_t));
+  MemoryArena::memoryArena* arena;
+  void* memoryPointer;
+  std::span<volumeType_, mask + 1> volumes;
+  std::span<std::uint32_t, mask + 1> orderCounts;
+  std::span<std::uint64_t, mask + 1> lastUpdates;
+  std::span<overflowEntry, overflowSlots_> overflow;
+  std::uint32_t nOverflow = 0;
+  std::uint64_t sequence = 0;
+  std::uint32_t offset = 0;
+  static constexpr bool fitsNarrow(entryType volume) noexcept {
+    return volume > overflowMark &&
+           volume <= std::numeric_limits<volumeType_>::max();
+  };
+  entryType volumeAt(std::uint32_t) const noexcept;
+  // stores volume of slot, moves it into or out of the overflow table
+  void store(std::uint32_t, entryType) noexcept;
+
+  // stand-ins for buckets returned by operator[], bucket operations are
+  // carried out on a temporary bucket so they behave exactly like the bucket
+  // type of the book
+  struct constLevel {
+    const soaStorage* storage;
+    std::uint32_t slot;
+    entryType getVolume() const noexcept {
+      return this->storage->volumeAt(this->slot);
+    };
+  };
+  struct level {
+    soaStorage* storage;
+    std::uint32_t slot;
+    entryType getVolume() const noexcept {
+      return this->storage->volumeAt(this->slot);
+    };
+    entryType consumeLiquidity(entryType fillVolume) noexcept {
+      bucketType bucket;
+      bucket.addLiquidity(this->getVolume());
+      const entryType filled = bucket.consumeLiquidity(fillVolume);
+      this->storage->store(this->slot, bucket.getVolume());
+      return filled;
+    };
+    void addLiquidity(entryType addVolume) noexcept {
+      this->storage->orderCounts[this->slot] += addVolume != 0;
+      this->storage->store(this->slot, this->getVolume() + addVolume);
+    };
+  };
+
+ public:
+  static constexpr std::uint32_t length = length_;
+  static constexpr std::uint32_t capacity = mask + 1;
+  static constexpr bool shiftMovesBuckets = false;
+  static constexpr bool contiguous = false;
+  static constexpr bool levelMetadata = true;
+  static constexpr std::size_t byteLength =
+      volumeBytes + countBytes + updateBytes +
+      roundUp(overflowSlots_ * sizeof(overflowEntry));
+  explicit soaStorage(MemoryArena::memoryArena* = nullptr);
+  ~soaStorage();
+  soaStorage(const soaStorage&) = delete;
+  soaStorage& operator=(const soaStorage&) = delete;
+  soaStorage(soaStorage&&) = delete;
+  soaStorage& operator=(soaStorage&&) = delete;
+  level operator[](std::uint32_t) noexcept;
+  constLevel operator[](std::uint32_t) const noexcept;
+  std::uint32_t slot(std::uint32_t) const noexcept;
+  std::uint32_t index(std::uint32_t) const noexcept;
+  // empties levels dropping out of range, moves the offset
+  void shift(std::int32_t) noexcept;
+  auto subrange(std::uint32_t, std::uint32_t) const noexcept;
+  // true unless the volume added may not fit the narrow type while the
+  // overflow table is full
+  bool reservable(std::uint32_t, std::int64_t) const noexcept;
+  void reserve(std::uint32_t) noexcept {};
+  // stamps level at index with the next sequence number, resets its number
+  // of orders once it is empty
+  void updated(std::uint32_t) noexcept;
+  // number of orders added since level at index was last empty
+  std::uint32_t orderCount(std::uint32_t) const noexcept;
+  // sequence number of the last update of level at index, 0 if never updated
+  std::uint64_t lastUpdate(std::uint32_t) const noexcept;
+  std::uint32_t overflowCount() const noexcept;
+};
+};  // namespace OrderBookStorage
+
+#define DENSE_STORAGE OrderBookStorage::denseStorage<bucketType, length_>
+#define RING_STORAGE OrderBookStorage::ringStorage<bucketType, length_>
+#define PAGED_STORAGE_TEMPLATE_DECLARATION                     \
+  template <typename bucketType, std::uint32_t length_,        \
+            std::uint32_t pageLength_, std::uint32_t poolPages_>
+#define PAGED_STORAGE \
+  OrderBookStorage::pagedStorage<bucketType, length_, pageLength_, poolPages_>
+
+namespace OrderBookStorage {
+template <typename bucketType, std::uint32_t length_>
+DENSE_STORAGE::denseStorage(MemoryArena::memoryArena* arena_)
+    : arena{arena_},
+      memoryPointer{
+          MemoryArena::allocate(arena, alignof(bucketType), byteLength)},
+      memSpan{reinterpret_cast<bucketType*>(memoryPointer), capacity} {
+  std::ranges::fill(this->memSpan, bucketType());
+};
+
+template <typename bucketType, std::uint32_t length_>
+DENSE_STORAGE::~denseStorage() {
+  MemoryArena::release(this->arena, this->memoryPointer);
+};
+
+template <typename bucketType, std::uint32_t length_>
+bucketType& DENSE_STORAGE::operator[](std::uint32_t index) noexcept {
+  return this->memSpan[index];
+};
+
+template <typename bucketType, std::uint32_t length_>
+const bucketType& DENSE_STORAGE::operator[](
+    std::uint32_t index) const noexcept {
+  return this->memSpan[index];
+};
+
+template <typename bucketType, std::uint32_t length_>
+std::uint32_t DENSE_STORAGE::slot(std::uint32_t index) const noexcept {
+  return index;
+};
+
+template <typename bucketType, std::uint32_t length_>
+std::uint32_t DENSE_STORAGE::index(std::uint32_t slot) const noexcept {
+  return slot;
+};
+
+template <typename bucketType, std::uint32_t length_>
+void DENSE_STORAGE::shift(std::int32_t shiftBy) noexcept {
+  const bool shiftUp = shiftBy >= 0;
+  const std::uint32_t shiftAbs =
+      std::min<std::uint32_t>(shiftUp ? shiftBy : -shiftBy, capacity);
+  std::shift_left(this->memSpan.begin(), this->memSpan.end(),
+                  shiftUp * shiftAbs);
+  std::shift_right(this->memSpan.begin(), this->memSpan.end(),
+                   !shiftUp * shiftAbs);
+  // std::shift_left/std::shift_right leave vacated buckets untouched
+  auto vacated = shiftUp ? this->memSpan.last(shiftAbs)
+                         : this->memSpan.first(shiftAbs);
+  std::ranges::fill(vacated, bucketType());
+};
+
+template <typename bucketType, std::uint32_t length_>
+auto DENSE_STORAGE::subrange(std::uint32_t from,
+                             std::uint32_t count) const noexcept {
+  return std::span<const bucketType>{this->memSpan.subspan(from, count)};
+};
+
+template <typename bucketType, std::uint32_t length_>
+RING_STORAGE::ringStorage(MemoryArena::memoryArena* arena_)
+    : arena{arena_},
+      memoryPointer{
+          MemoryArena::allocate(arena, alignof(bucketType), byteLength)},
+      memSpan{reinterpret_cast<bucketType*>(memoryPointer), capacity} {
+  std::ranges::fill(this->memSpan, bucketType());
+};
+
+template <typename bucketType, std::uint32_t length_>
+RING_STORAGE::~ringStorage() {
+  MemoryArena::release(this->arena, this->memoryPointer);
+};
+
+template <typename bucketType, std::uint32_t length_>
+bucketType& RING_STORAGE::operator[](std::uint32_t index) noexcept {
+  return this->memSpan[(this->offset + index) & mask];
+};
+
+template <typename bucketType, std::uint32_t length_>
+const bucketType& RING_STORAGE::operator[](
+    std::uint32_t index) const noexcept {
+  return this->memSpan[(Auxil::relaxed_load(this->offset) + index) & mask];
+};
+
+template <typename bucketType, std::uint32_t length_>
+std::uint32_t RING_STORAGE::slot(std::uint32_t index) const noexcept {
+  return (Auxil::relaxed_load(this->offset) + index) & mask;
+};
+
+template <typename bucketType, std::uint32_t length_>
+std::uint32_t RING_STORAGE::index(std::uint32_t slot) const noexcept {
+  return (slot - Auxil::relaxed_load(this->offset)) & mask;
+};
+
+template <typename bucketType, std::uint32_t length_>
+void RING_STORAGE::shift(std::int32_t shiftBy) noexcept {
+  // empty buckets dropping out of the logical range before they wrap around,
+  // all slots outside of the logical range hence always remain empty
+  const bool shiftUp = shiftBy >= 0;
+  const std::uint32_t shiftAbs =
+      std::min<std::uint32_t>(shiftUp ? shiftBy : -shiftBy, length);
+  const std::uint32_t firstDropped = shiftUp ? 0 : length - shiftAbs;
+  for (std::uint32_t i = 0; i < shiftAbs; ++i) {
+    (*this)[firstDropped + i] = bucketType();
+  }
+  this->offset = (this->offset + shiftBy) & mask;
+};
+
+template <typename bucketType, std::uint32_t length_>
+auto RING_STORAGE::subrange(std::uint32_t from,
+                            std::uint32_t count) const noexcept {
+  return std::views::iota(from, from + count) |
+         std::views::transform(
+             [this](std::uint32_t index) -> const bucketType& {
+               return (*this)[index];
+             });
+};
+
+PAGED_STORAGE_TEMPLATE_DECLARATION
+PAGED_STORAGE::pagedStorage(MemoryArena::memoryArena* arena_)
+    : arena{arena_},
+      memoryPointer{MemoryArena::allocate(arena, alignment, byteLength)},
+      pages{reinterpret_cast<bucketType*>(memoryPointer),
+            std::size_t{poolPages_ + 1} * pageLength_},
+      nonEmpty{reinterpret_cast<std::uint64_t*>(
+                   reinterpret_cast<std::byte*>(memoryPointer) + bucketBytes),
+               std::size_t{poolPages_ + 1} * maskWords},
+      directory{reinterpret_cast<std::uint32_t*>(nonEmpty.data() +
+                                                 nonEmpty.size()),
+                directoryLength},
+      freePages{directory.data() + directoryLength, poolPages_} {
+  // pool pages are only written once taken, memory backing them is hence
+  // only touched once needed
+  std::ranges::fill(this->pages.first(pageLength_), bucketType());
+  std::ranges::fill(this->nonEmpty, 0);
+  std::ranges::fill(this->directory, 0);
+  for (std::uint32_t i = 0; i < poolPages_; ++i) {
+    // lowest pages taken first
+    this->freePages[i] = poolPages_ - i;
+  }
+};
+
+PAGED_STORAGE_TEMPLATE_DECLARATION
+PAGED_STORAGE::~pagedStorage() {
+  MemoryArena::release(this->arena, this->memoryPointer);
+};
+
+PAGED_STORAGE_TEMPLATE_DECLARATION
+bucketType& PAGED_STORAGE::operator[](std::uint32_t index) noexcept {
+  const std::uint32_t slot = this->slot(index);
+  return this->pages[(this->directory[slot >> pageShift] << pageShift) +
+                     (slot & (pageLength_ - 1))];
+};
+
+PAGED_STORAGE_TEMPLATE_DECLARATION
+const bucketType& PAGED_STORAGE::operator[](
+    std::uint32_t index) const noexcept {
+  const std::uint32_t slot = this->slot(index);
+  return this->pages[(Auxil::relaxed_load(this->directory[slot >> pageShift])
+                      << pageShift) +
+                     (slot & (pageLength_ - 1))];
+};
+
+PAGED_STORAGE_TEMPLATE_DECLARATION
+std::uint32_t PAGED_STORAGE::slot(std::uint32_t index) const noexcept {
+  return (Auxil::relaxed_load(this->offset) + index) & mask;
+};
+
+PAGED_STORAGE_TEMPLATE_DECLARATION
+std::uint32_t PAGED_STORAGE::index(std::uint32_t slot) const noexcept {
+  return (slot - Auxil::relaxed_load(this->offset)) & mask;
+};
+
+PAGED_STORAGE_TEMPLATE_DECLARATION
+void PAGED_STORAGE::shift(std::int32_t shiftBy) noexcept {
+  this->offset = (this->offset + shiftBy) & mask;
+};
+
+PAGED_STORAGE_TEMPLATE_DECLARATION
+auto PAGED_STORAGE::subrange(std::uint32_t from,
+                             std::uint32_t count) const noexcept {
+  return std::views::iota(from, from + count) |
+         std::views::transform(
+             [this](std::uint32_t index) -> const bucketType& {
+               return (*this)[index];
+             });
+};
+
+PAGED_STORAGE_TEMPLATE_DECLARATION
+bool PAGED_STORAGE::reservable(std::uint32_t index,
+                               std::int64_t) const noexcept {
+  return this->directory[this->slot(index) >> pageShift] != 0 ||
+         this->nFree != 0;
+};
+
+PAGED_STORAGE_TEMPLATE_DECLARATION
+void PAGED_STORAGE::reserve(std::uint32_t index) noexcept {
+  std::uint32_t& page = this->directory[this->slot(index) >> pageShift];
+  if (page == 0) {
+    --this->nFree;
+    page = this->freePages[this->nFree];
+    // buckets of a page returned are empty, but queue buckets of an order
+    // level book may not be in their initial state
+    std::ranges::fill(this->pages.subspan(page << pageShift, pageLength_),
+                      bucketType());
+  }
+};
+
+PAGED_STORAGE_TEMPLATE_DECLARATION
+void PAGED_STORAGE::updated(std::uint32_t index) noexcept {
+  const std::uint32_t slot = this->slot(index);
+  std::uint32_t& page = this->directory[slot >> pageShift];
+  if (page == 0) {
+    return;
+  }
+  const std::uint32_t bucket = slot & (pageLength_ - 1);
+  auto words = this->nonEmpty.subspan(page * maskWords, maskWords);
+  const std::uint64_t bit = std::uint64_t{1} << (bucket % 64);
+  std::uint64_t& word = words[bucket / 64];
+  word = (*this)[index].getVolume() != 0 ? word | bit : word & ~bit;
+  if (std::ranges::all_of(words, [](std::uint64_t w) { return w == 0; })) {
+    this->freePages[this->nFree] = page;
+    ++this->nFree;
+    page = 0;
+  }
+};
+
+PAGED_STORAGE_TEMPLATE_DECLARATION
+std::uint32_t PAGED_STORAGE::pagesInUse() const noexcept {
+  return poolPages_ - this->nFree;
+};
+};  // namespace OrderBookStorage
+
+#define SOA_STORAGE_TEMPLATE_DECLARATION                        \
+  template <typename bucketType, std::uint32_t length_,         \
+            typename volumeType_, std::uint32_t overflowSlots_>
+#define SOA_STORAGE                                              \
+  OrderBookStorage::soaStorage<bucketType, length_, volumeType_, \
+                               overflowSlots_>
+
+namespace OrderBookStorage {
+SOA_STORAGE_TEMPLATE_DECLARATION
+SOA_STORAGE::soaStorage(MemoryArena::memoryArena* arena_)
+    : arena{arena_},
+      memoryPointer{MemoryArena::allocate(arena, cacheline, byteLength)},
+      volumes{reinterpret_cast<volumeType_*>(memoryPointer), capacity},
+      orderCounts{reinterpret_cast<std::uint32_t*>(
+                      reinterpret_cast<std::byte*>(memoryPointer) +
+                      volumeBytes),
+                  capacity},
+      lastUpdates{reinterpret_cast<std::uint64_t*>(
+                      reinterpret_cast<std::byte*>(memoryPointer) +
+                      volumeBytes + countBytes),
+                  capacity},
+      overflow{reinterpret_cast<overflowEntry*>(
+                   reinterpret_cast<std::byte*>(memoryPointer) + volumeBytes +
+                   countBytes + updateBytes),
+               overflowSlots_} {
+  std::ranges::fill(this->volumes, 0);
+  std::ranges::fill(this->orderCounts, 0);
+  std::ranges::fill(this->lastUpdates, 0);
+  std::ranges::fill(this->overflow, overflowEntry{});
+};
+
+SOA_STORAGE_TEMPLATE_DECLARATION
+SOA_STORAGE::~soaStorage() {
+  MemoryArena::release(this->arena, this->memoryPointer);
+};
+
+SOA_STORAGE_TEMPLATE_DECLARATION
+typename SOA_STORAGE::entryType SOA_STORAGE::volumeAt(
+    std::uint32_t slot) const noexcept {
+  const volumeType_ narrow = Auxil::relaxed_load(this->volumes[slot]);
+  if (narrow != overflowMark) [[likely]] {
+    return narrow;
+  }
+  // search is bounded so readers racing the writer always terminate
+  auto entry =
+      std::ranges::find_if(this->overflow, [slot](const overflowEntry& e) {
+        return Auxil::relaxed_load(e.slot) == slot;
+      });
+  return entry != this->overflow.end() ? Auxil::relaxed_load(entry->volume)
+                                       : 0;
+};
+
+SOA_STORAGE_TEMPLATE_DECLARATION
+void SOA_STORAGE::store(std::uint32_t slot, entryType volume) noexcept {
+  const bool wasOverflow = this->volumes[slot] == overflowMark;
+  if (fitsNarrow(volume) && !wasOverflow) [[likely]] {
+    this->volumes[slot] = static_cast<volumeType_>(volume);
+    return;
+  }
+  auto entry = std::ranges::find(this->overflow, wasOverflow ? slot : noSlot,
+                                 &overflowEntry::slot);
+  if (fitsNarrow(volume)) {
+    *entry = overflowEntry{};
+    --this->nOverflow;
+    this->volumes[slot] = static_cast<volumeType_>(volume);
+    return;
+  }
+  // entry free if slot did not overflow before, guaranteed by reservable
+  this->nOverflow += !wasOverflow;
+  *entry = overflowEntry{slot, volume};
+  this->volumes[slot] = overflowMark;
+};
+
+SOA_STORAGE_TEMPLATE_DECLARATION
+typename SOA_STORAGE::level SOA_STORAGE::operator[](
+    std::uint32_t index) noexcept {
+  return level{this, this->slot(index)};
+};
+
+SOA_STORAGE_TEMPLATE_DECLARATION
+typename SOA_STORAGE::constLevel SOA_STORAGE::operator[](
+    std::uint32_t index) const noexcept {
+  return constLevel{this, this->slot(index)};
+};
+
+SOA_STORAGE_TEMPLATE_DECLARATION
+std::uint32_t SOA_STORAGE::slot(std::uint32_t index) const noexcept {
+  return (Auxil::relaxed_load(this->offset) + index) & mask;
+};
+
+SOA_STORAGE_TEMPLATE_DECLARATION
+std::uint32_t SOA_STORAGE::index(std::uint32_t slot) const noexcept {
+  return (slot - Auxil::relaxed_load(this->offset)) & mask;
+};
+
+SOA_STORAGE_TEMPLATE_DECLARATION
+void SOA_STORAGE::shift(std::int32_t shiftBy) noexcept {
+  const bool shiftUp = shiftBy >= 0;
+  const std::uint32_t shiftAbs =
+      std::min<std::uint32_t>(shiftUp ? shiftBy : -shiftBy, length);
+  const std::uint32_t firstDropped = shiftUp ? 0 : length - shiftAbs;
+  for (std::uint32_t i = 0; i < shiftAbs; ++i) {
+    const std::uint32_t slot = this->slot(firstDropped + i);
+    this->store(slot, 0);
+    this->orderCounts[slot] = 0;
+    this->lastUpdates[slot] = 0;
+  }
+  this->offset = (this->offset + shiftBy) & mask;
+};
+
+SOA_STORAGE_TEMPLATE_DECLARATION
+auto SOA_STORAGE::subrange(std::uint32_t from,
+                           std::uint32_t count) const noexcept {
+  return std::views::iota(from, from + count) |
+         std::views::transform(
+             [this](std::uint32_t index) { return (*this)[index]; });
+};
+
+SOA_STORAGE_TEMPLATE_DECLARATION
+bool SOA_STORAGE::reservable(std::uint32_t index,
+                             std::int64_t volume) const noexcept {
+  const std::uint32_t slot = this->slot(index);
+  // bound of the volume after adding, opposite volume is filled first
+  const std::int64_t bound = std::abs(this->volumeAt(slot)) + std::abs(volume);
+  return bound < std::numeric_limits<volumeType_>::max() ||
+         this->volumes[slot] == overflowMark ||
+         this->nOverflow < overflowSlots_;
+};
+
+SOA_STORAGE_TEMPLATE_DECLARATION
+void SOA_STORAGE::updated(std::uint32_t index) noexcept {
+  const std::uint32_t slot = this->slot(index);
+  this->lastUpdates[slot] = ++this->sequence;
+  this->orderCounts[slot] *= this->volumes[slot] != 0;
+};
+
+SOA_STORAGE_TEMPLATE_DECLARATION
+std::uint32_t SOA_STORAGE::orderCount(std::uint32_t index) const noexcept {
+  return Auxil::relaxed_load(this->orderCounts[this->slot(index)]);
+};
+
+SOA_STORAGE_TEMPLATE_DECLARATION
+std::uint64_t SOA_STORAGE::lastUpdate(std::uint32_t index) const noexcept {
+  return Auxil::relaxed_load(this->lastUpdates[this->slot(index)]);
+};
+
+SOA_STORAGE_TEMPLATE_DECLARATION
+std::uint32_t SOA_STORAGE::overflowCount() const noexcept {
+  return this->nOverflow;
+};
+};  // namespace OrderBookStorage
+
+#undef DENSE_STORAGE
+#undef RING_STORAGE
+#undef PAGED_STORAGE_TEMPLATE_DECLARATION
+#undef PAGED_STORAGE
+#undef SOA_STORAGE_TEMPLATE_DECLARATION
+#undef SOA_STORAGE
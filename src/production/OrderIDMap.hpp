@@ -0,0 +1,140 @@
+// open addressing hash table mapping order IDs to indices of nodes in an order
+// pool, linear probing with backward shift deletion so no tombstones pile up,
+// table is sized to a load factor of at most 0.5 and allocated up front
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <optional>
+#include <span>
+
+#include "MemoryArena.hpp"
+
+namespace OrderIDMap {
+template <std::uint32_t capacity_>
+requires(capacity_ > 0) struct orderIDMap {
+ private:
+  static constexpr std::uint32_t cacheline = 64;
+  static constexpr std::uint32_t tableSize = std::bit_ceil(2 * capacity_);
+  static constexpr std::uint32_t mask = tableSize - 1;
+  static constexpr std::uint32_t hashShift = 64 - std::countr_zero(tableSize);
+  static constexpr std::uint32_t emptySlot =
+      std::numeric_limits<std::uint32_t>::max();
+  struct slotType {
+    std::uint64_t orderID = 0;
+    std::uint32_t value = emptySlot;
+  };
+  MemoryArena::memoryArena* arena;
+  void* memoryPointer;
+  std::span<slotType, tableSize> slots;
+  std::uint32_t nEntries = 0;
+  // fibonacci hashing, spreads sequential IDs evenly across the table
+  static std::uint32_t home(std::uint64_t) noexcept;
+  // index of slot containing ID or of the empty slot ending its probe sequence
+  std::uint32_t probe(std::uint64_t) const noexcept;
+
+ public:
+  static constexpr std::uint32_t capacity = capacity_;
+  static constexpr std::size_t byteLength =
+      ((tableSize * sizeof(slotType) + cacheline - 1) / cacheline) * cacheline;
+  // memory is taken from arena if one is passed
+  explicit orderIDMap(MemoryArena::memoryArena* = nullptr);
+  ~orderIDMap();
+  orderIDMap(const orderIDMap&) = delete;
+  orderIDMap& operator=(const orderIDMap&) = delete;
+  orderIDMap(orderIDMap&&) = delete;
+  orderIDMap& operator=(orderIDMap&&) = delete;
+  // returns false if ID is already contained or map is full
+  bool insert(std::uint64_t, std::uint32_t) noexcept;
+  std::optional<std::uint32_t> find(std::uint64_t) const noexcept;
+  // returns false if ID was not contained
+  bool erase(std::uint64_t) noexcept;
+  std::uint32_t size() const noexcept;
+};
+};  // namespace OrderIDMap
+
+#define ORDER_ID_MAP OrderIDMap::orderIDMap<capacity_>
+
+namespace OrderIDMap {
+template <std::uint32_t capacity_>
+requires(capacity_ > 0) ORDER_ID_MAP::orderIDMap(
+    MemoryArena::memoryArena* arena_)
+    : arena{arena_},
+      memoryPointer{MemoryArena::allocate(arena, cacheline, byteLength)},
+      slots{reinterpret_cast<slotType*>(memoryPointer), tableSize} {
+  std::ranges::fill(this->slots, slotType());
+};
+
+template <std::uint32_t capacity_>
+requires(capacity_ > 0) ORDER_ID_MAP::~orderIDMap() {
+  MemoryArena::release(this->arena, this->memoryPointer);
+};
+
+template <std::uint32_t capacity_>
+requires(capacity_ > 0) std::uint32_t ORDER_ID_MAP::home(
+    std::uint64_t orderID) noexcept {
+  return (orderID * 0x9E3779B97F4A7C15) >> hashShift;
+};
+
+template <std::uint32_t capacity_>
+requires(capacity_ > 0) std::uint32_t ORDER_ID_MAP::probe(
+    std::uint64_t orderID) const noexcept {
+  // terminates since load factor never exceeds 0.5
+  std::uint32_t index = home(orderID);
+  while (this->slots[index].value != emptySlot &&
+         this->slots[index].orderID != orderID) {
+    index = (index + 1) & mask;
+  }
+  return index;
+};
+
+template <std::uint32_t capacity_>
+requires(capacity_ > 0) bool ORDER_ID_MAP::insert(
+    std::uint64_t orderID, std::uint32_t value) noexcept {
+  const std::uint32_t index = this->probe(orderID);
+  const bool success =
+      this->slots[index].value == emptySlot && this->nEntries < capacity_;
+  this->slots[index] = success ? slotType{orderID, value} : this->slots[index];
+  this->nEntries += success;
+  return success;
+};
+
+template <std::uint32_t capacity_>
+requires(capacity_ > 0) std::optional<std::uint32_t> ORDER_ID_MAP::find(
+    std::uint64_t orderID) const noexcept {
+  const std::uint32_t value = this->slots[this->probe(orderID)].value;
+  return value != emptySlot ? std::make_optional(value) : std::nullopt;
+};
+
+template <std::uint32_t capacity_>
+requires(capacity_ > 0) bool ORDER_ID_MAP::erase(
+    std::uint64_t orderID) noexcept {
+  std::uint32_t gap = this->probe(orderID);
+  if (this->slots[gap].value == emptySlot) {
+    return false;
+  }
+  // move entries back into the gap unless that would place them before their
+  // home slot, keeps every probe sequence free of empty slots
+  for (std::uint32_t index = (gap + 1) & mask;
+       this->slots[index].value != emptySlot; index = (index + 1) & mask) {
+    const std::uint32_t homeIndex = home(this->slots[index].orderID);
+    const bool movable = ((index - homeIndex) & mask) >= ((index - gap) & mask);
+    this->slots[gap] = movable ? this->slots[index] : this->slots[gap];
+    gap = movable ? index : gap;
+  }
+  this->slots[gap] = slotType();
+  --this->nEntries;
+  return true;
+};
+
+template <std::uint32_t capacity_>
+requires(capacity_ > 0) std::uint32_t ORDER_ID_MAP::size() const noexcept {
+  return this->nEntries;
+};
+};  // namespace OrderIDMap
+
+#undef ORDER_ID_MAP
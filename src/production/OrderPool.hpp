@@ -0,0 +1,118 @@
+// fixed capacity pool of nodes for resting orders, all memory is allocated
+// during construction, nodes are handed out and returned via a stack of free
+// indices without touching the heap
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <numeric>
+#include <optional>
+#include <span>
+
+#include "MemoryArena.hpp"
+
+namespace OrderPool {
+template <typename nodeType, std::uint32_t capacity_>
+requires(capacity_ > 0) struct orderPool {
+ private:
+  static constexpr std::uint32_t cacheline = 64;
+  static constexpr std::size_t nodeBytes =
+      ((capacity_ * sizeof(nodeType) + cacheline - 1) / cacheline) * cacheline;
+  MemoryArena::memoryArena* arena;
+  void* memoryPointer;
+  std::span<nodeType, capacity_> nodes;
+  // indices of unused nodes, the first nFree entries are valid
+  std::span<std::uint32_t, capacity_> freeIndices;
+  std::uint32_t nFree = capacity_;
+
+ public:
+  static constexpr std::uint32_t capacity = capacity_;
+  static constexpr std::size_t byteLength =
+      nodeBytes +
+      ((capacity_ * sizeof(std::uint32_t) + cacheline - 1) / cacheline) *
+          cacheline;
+  // memory is taken from arena if one is passed
+  explicit orderPool(MemoryArena::memoryArena* = nullptr);
+  ~orderPool();
+  orderPool(const orderPool&) = delete;
+  orderPool& operator=(const orderPool&) = delete;
+  orderPool(orderPool&&) = delete;
+  orderPool& operator=(orderPool&&) = delete;
+  // returns index of an unused node, empty optional if pool is exhausted
+  std::optional<std::uint32_t> allocate() noexcept;
+  // returns node at index to the pool, node is reset to default state
+  void release(std::uint32_t) noexcept;
+  std::uint32_t available() const noexcept;
+  nodeType& operator[](std::uint32_t) noexcept;
+  const nodeType& operator[](std::uint32_t) const noexcept;
+  std::span<nodeType, capacity_> nodeSpan() noexcept;
+};
+};  // namespace OrderPool
+
+#define ORDER_POOL OrderPool::orderPool<nodeType, capacity_>
+
+namespace OrderPool {
+template <typename nodeType, std::uint32_t capacity_>
+requires(capacity_ > 0) ORDER_POOL::orderPool(
+    MemoryArena::memoryArena* arena_)
+    : arena{arena_},
+      memoryPointer{MemoryArena::allocate(arena, cacheline, byteLength)},
+      nodes{reinterpret_cast<nodeType*>(memoryPointer), capacity_},
+      freeIndices{reinterpret_cast<std::uint32_t*>(
+                      reinterpret_cast<std::byte*>(memoryPointer) + nodeBytes),
+                  capacity_} {
+  // writing to all of the memory also makes sure it is paged in before the
+  // first order arrives
+  std::ranges::fill(this->nodes, nodeType());
+  // hand out low indices first
+  std::iota(this->freeIndices.rbegin(), this->freeIndices.rend(), 0);
+};
+
+template <typename nodeType, std::uint32_t capacity_>
+requires(capacity_ > 0) ORDER_POOL::~orderPool() {
+  MemoryArena::release(this->arena, this->memoryPointer);
+};
+
+template <typename nodeType, std::uint32_t capacity_>
+requires(capacity_ > 0) std::optional<std::uint32_t> ORDER_POOL::allocate()
+noexcept {
+  const bool exhausted = this->nFree == 0;
+  this->nFree -= !exhausted;
+  return exhausted ? std::nullopt
+                   : std::make_optional(this->freeIndices[this->nFree]);
+};
+
+template <typename nodeType, std::uint32_t capacity_>
+requires(capacity_ > 0) void ORDER_POOL::release(std::uint32_t index) noexcept {
+  this->nodes[index] = nodeType();
+  this->freeIndices[this->nFree] = index;
+  ++this->nFree;
+};
+
+template <typename nodeType, std::uint32_t capacity_>
+requires(capacity_ > 0) std::uint32_t ORDER_POOL::available() const noexcept {
+  return this->nFree;
+};
+
+template <typename nodeType, std::uint32_t capacity_>
+requires(capacity_ > 0) nodeType& ORDER_POOL::operator[](
+    std::uint32_t index) noexcept {
+  return this->nodes[index];
+};
+
+template <typename nodeType, std::uint32_t capacity_>
+requires(capacity_ > 0) const nodeType& ORDER_POOL::operator[](
+    std::uint32_t index) const noexcept {
+  return this->nodes[index];
+};
+
+template <typename nodeType, std::uint32_t capacity_>
+requires(capacity_ > 0) std::span<nodeType, capacity_> ORDER_POOL::nodeSpan()
+noexcept {
+  return this->nodes;
+};
+};  // namespace OrderPool
+
+#undef ORDER_POOL
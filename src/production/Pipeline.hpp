@@ -0,0 +1,470 @@
+// runs message handlers and order books on threads of their own, each pinned
+// to a core: handler threads read messages and route them by instrument ID to
+// the shard owning the instrument, every shard thread runs a
+// BookManager::bookManager holding the books of its instruments
+// every handler/shard pair is connected by a single producer single consumer
+// queue, e.g. Queue::SeqLockQueue, handlers never block on a slow shard, a
+// shard falling a whole queue length behind loses entries
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <latch>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "Auxil.hpp"
+#include "BookManager.hpp"
+#include "FIXmsgTypeChecks.hpp"
+
+namespace Pipeline {
+// shard of instruments without a route
+static constexpr std::uint32_t unrouted =
+    std::numeric_limits<std::uint32_t>::max();
+
+// pins calling thread to core, negative index leaves it unpinned
+inline bool pinToCore(int coreIndex) noexcept {
+  if (coreIndex < 0) {
+    return true;
+  }
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(coreIndex, &cpuSet);
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) ==
+         0;
+};
+
+// steady clock in nanoseconds
+inline std::uint64_t now() noexcept {
+  return duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+};
+
+// entry passed from handler to shard, instrument ID of the message is
+// replaced by the index of the instrument's book within the shard
+template <typename msgClassVariant_>
+struct routedMsg {
+  msgClassVariant_ msg;
+  // time the handler enqueued the message, zero unless observed
+  std::uint64_t enqueued = 0;
+};
+
+// static assignment of instruments to shards, fixed at construction and only
+// read afterwards
+struct routingTable {
+ private:
+  std::uint32_t nShards;
+  std::vector<std::uint32_t> shardOf;
+  std::vector<std::uint32_t> localIDs;
+  std::vector<std::uint32_t> shardSizes;
+
+ public:
+  // shard of every instrument indexed by instrument ID, not valid if a shard
+  // index is out of range or a shard owns no instrument
+  routingTable(std::span<const std::uint32_t>, std::uint32_t);
+  // instrument i is owned by shard i % number of shards
+  static routingTable roundRobin(std::uint32_t, std::uint32_t);
+  bool valid() const noexcept;
+  // unrouted if the instrument is unknown
+  std::uint32_t shard(std::uint32_t) const noexcept;
+  // index of the instrument's book in the book manager of its shard
+  std::uint32_t localID(std::uint32_t) const noexcept;
+  // instrument IDs owned by shard, ordered by their local IDs
+  std::vector<std::uint32_t> instruments(std::uint32_t) const;
+  std::uint32_t shards() const noexcept;
+  std::uint32_t size() const noexcept;
+};
+
+// core of every stage, the number of handler and shard threads equals the
+// number of entries, negative entries leave a stage unpinned
+struct pipelineConfig {
+  std::vector<int> handlerCores;
+  std::vector<int> shardCores;
+};
+
+// called by a shard thread after every order it processed, each shard owns an
+// instance
+struct noObserver {
+  static constexpr bool enabled = false;
+  template <typename responseType>
+  void processed(std::uint64_t, const responseType&) noexcept {};
+};
+
+template <typename handlerType_, typename bookType_, typename queueType_,
+          typename observerType_ = noObserver>
+requires MsgTypeChecks::InstrumentMsgVariant<
+    typename bookType_::msgClassVariant>::value &&
+    Auxil::readableAsMessages<handlerType_,
+                              typename bookType_::msgClassVariant> &&
+    Auxil::writableAsQueue<queueType_,
+                           routedMsg<typename bookType_::msgClassVariant>> &&
+    Auxil::readableAsQueue<typename queueType_::ReaderType,
+                           routedMsg<typename bookType_::msgClassVariant>>
+struct shardedPipeline {
+ private:
+  static constexpr std::size_t cacheline = 64;
+  using msgClassVariant = typename bookType_::msgClassVariant;
+  using managerType = BookManager::bookManager<bookType_>;
+  using entryType = routedMsg<msgClassVariant>;
+  // counters are written by the stage's thread only
+  struct alignas(cacheline) handlerState {
+    handlerType_* handler = nullptr;
+    std::atomic<std::uint64_t> enqueued = 0;
+    std::atomic<std::uint64_t> unrouted = 0;
+  };
+  struct alignas(cacheline) shardState {
+    // constructed by the shard thread, memory is first touched on its core
+    std::unique_ptr<managerType> manager;
+    std::atomic<std::uint64_t> processed = 0;
+    observerType_ observer;
+  };
+  // stages not started yet, running or stopped, cannot be restarted
+  static constexpr std::uint8_t idle = 0;
+  static constexpr std::uint8_t running = 1;
+  static constexpr std::uint8_t stopped = 2;
+  std::uint32_t nHandlers;
+  std::uint32_t nShards;
+  std::vector<std::uint32_t> basePrices;
+  routingTable routing;
+  pipelineConfig config;
+  std::unique_ptr<handlerState[]> handlerStates;
+  std::unique_ptr<shardState[]> shardStates;
+  // queue of handler h and shard s at index h * nShards + s
+  std::vector<std::unique_ptr<queueType_>> queues;
+  // every stage and start() arrive once ready
+  std::unique_ptr<std::latch> ready;
+  std::atomic<std::uint32_t> pinFailures = 0;
+  std::uint8_t state = idle;
+  std::vector<std::jthread> handlerThreads;
+  std::vector<std::jthread> shardThreads;
+  static void count(std::atomic<std::uint64_t>&) noexcept;
+  void runHandler(std::stop_token, std::uint32_t) noexcept;
+  void runShard(std::stop_token, std::uint32_t);
+
+ public:
+  // one handler per entry of handlerCores, base price of every instrument
+  // indexed by instrument ID, not valid if the number of handlers, instruments
+  // or shards does not match routing table and config
+  shardedPipeline(std::span<handlerType_* const>,
+                  std::span<const std::uint32_t>, routingTable,
+                  pipelineConfig);
+  ~shardedPipeline();
+  shardedPipeline(const shardedPipeline&) = delete;
+  shardedPipeline& operator=(const shardedPipeline&) = delete;
+  shardedPipeline(shardedPipeline&&) = delete;
+  shardedPipeline& operator=(shardedPipeline&&) = delete;
+  bool valid() const noexcept;
+  // launches all stages and returns once every stage is pinned, has
+  // constructed its books and is about to poll, false if the pipeline is not
+  // valid, was started before or pinning a stage failed (stages run anyway)
+  bool start();
+  // stops handlers first, shards drain their queues before stopping
+  void stop() noexcept;
+  std::uint32_t handlers() const noexcept;
+  std::uint32_t shards() const noexcept;
+  // messages handler routed to a shard
+  std::uint64_t enqueuedCount(std::uint32_t) const noexcept;
+  // messages handler dropped for lack of a route
+  std::uint64_t unroutedCount(std::uint32_t) const noexcept;
+  // orders shard processed
+  std::uint64_t processedCount(std::uint32_t) const noexcept;
+  // packed top of book of instrument, callable from any thread once start()
+  // returned
+  std::tuple<std::optional<std::uint32_t>, std::optional<std::uint32_t>>
+  bestBidAsk(std::uint32_t) const noexcept;
+  // book of instrument, only to be accessed after stop()
+  bookType_& book(std::uint32_t) noexcept;
+  // observer of shard, only to be accessed before start() or after stop()
+  observerType_& observer(std::uint32_t) noexcept;
+};
+};  // namespace Pipeline
+
+namespace Pipeline {
+inline routingTable::routingTable(std::span<const std::uint32_t> shardOf_,
+                                  std::uint32_t nShards_)
+    : nShards{nShards_},
+      shardOf(shardOf_.begin(), shardOf_.end()),
+      localIDs(shardOf_.size(), 0),
+      shardSizes(nShards_, 0) {
+  for (std::size_t i = 0; i < this->shardOf.size(); ++i) {
+    const std::uint32_t shard = this->shardOf[i];
+    this->shardOf[i] = shard < this->nShards ? shard : unrouted;
+    if (shard < this->nShards) {
+      this->localIDs[i] = this->shardSizes[shard]++;
+    }
+  }
+};
+
+inline routingTable routingTable::roundRobin(std::uint32_t nInstruments,
+                                             std::uint32_t nShards_) {
+  std::vector<std::uint32_t> shardOf_(nInstruments);
+  for (std::uint32_t i = 0; i < nInstruments; ++i) {
+    shardOf_[i] = nShards_ > 0 ? i % nShards_ : unrouted;
+  }
+  return routingTable(shardOf_, nShards_);
+};
+
+inline bool routingTable::valid() const noexcept {
+  return this->nShards > 0 &&
+         std::ranges::find(this->shardOf, unrouted) == this->shardOf.end() &&
+         std::ranges::find(this->shardSizes, 0u) == this->shardSizes.end();
+};
+
+inline std::uint32_t routingTable::shard(
+    std::uint32_t instrumentID) const noexcept {
+  return instrumentID < this->shardOf.size() ? this->shardOf[instrumentID]
+                                             : unrouted;
+};
+
+inline std::uint32_t routingTable::localID(
+    std::uint32_t instrumentID) const noexcept {
+  return this->localIDs[instrumentID];
+};
+
+inline std::vector<std::uint32_t> routingTable::instruments(
+    std::uint32_t shard) const {
+  std::vector<std::uint32_t> ret;
+  ret.reserve(this->shardSizes[shard]);
+  for (std::uint32_t i = 0; i < this->shardOf.size(); ++i) {
+    this->shardOf[i] == shard ? ret.push_back(i) : void();
+  }
+  return ret;
+};
+
+inline std::uint32_t routingTable::shards() const noexcept {
+  return this->nShards;
+};
+
+inline std::uint32_t routingTable::size() const noexcept {
+  return static_cast<std::uint32_t>(this->shardOf.size());
+};
+};  // namespace Pipeline
+
+#define PIPELINE_TEMPLATE_DECLARATION                                        \
+  template <typename handlerType_, typename bookType_, typename queueType_, \
+            typename observerType_>                                         \
+  requires MsgTypeChecks::InstrumentMsgVariant<                             \
+      typename bookType_::msgClassVariant>::value &&                        \
+      Auxil::readableAsMessages<handlerType_,                               \
+                                typename bookType_::msgClassVariant> &&     \
+      Auxil::writableAsQueue<                                               \
+          queueType_, routedMsg<typename bookType_::msgClassVariant>> &&    \
+      Auxil::readableAsQueue<typename queueType_::ReaderType,               \
+                             routedMsg<typename bookType_::msgClassVariant>>
+
+#define PIPELINE \
+  Pipeline::shardedPipeline<handlerType_, bookType_, queueType_, observerType_>
+
+namespace Pipeline {
+PIPELINE_TEMPLATE_DECLARATION
+PIPELINE::shardedPipeline(std::span<handlerType_* const> handlers_,
+                          std::span<const std::uint32_t> basePrices_,
+                          routingTable routing_, pipelineConfig config_)
+    : nHandlers{static_cast<std::uint32_t>(config_.handlerCores.size())},
+      nShards{static_cast<std::uint32_t>(config_.shardCores.size())},
+      basePrices(basePrices_.begin(), basePrices_.end()),
+      routing{std::move(routing_)},
+      config{std::move(config_)},
+      handlerStates{std::make_unique<handlerState[]>(this->nHandlers)},
+      shardStates{std::make_unique<shardState[]>(this->nShards)} {
+  if (!this->valid() || handlers_.size() != this->nHandlers) {
+    this->nHandlers = 0;
+    return;
+  }
+  for (std::uint32_t i = 0; i < this->nHandlers; ++i) {
+    this->handlerStates[i].handler = handlers_[i];
+  }
+  this->queues.reserve(this->nHandlers * this->nShards);
+  for (std::uint32_t i = 0; i < this->nHandlers * this->nShards; ++i) {
+    this->queues.push_back(std::make_unique<queueType_>());
+  }
+};
+
+PIPELINE_TEMPLATE_DECLARATION
+PIPELINE::~shardedPipeline() { this->stop(); };
+
+PIPELINE_TEMPLATE_DECLARATION
+bool PIPELINE::valid() const noexcept {
+  return this->nHandlers > 0 && this->routing.valid() &&
+         this->routing.shards() == this->nShards &&
+         this->routing.size() == this->basePrices.size();
+};
+
+PIPELINE_TEMPLATE_DECLARATION
+void PIPELINE::count(std::atomic<std::uint64_t>& counter) noexcept {
+  // single writer, no read-modify-write needed
+  counter.store(counter.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+};
+
+PIPELINE_TEMPLATE_DECLARATION
+bool PIPELINE::start() {
+  if (!this->valid() || this->state != idle) {
+    return false;
+  }
+  this->state = running;
+  this->ready =
+      std::make_unique<std::latch>(this->nHandlers + this->nShards + 1);
+  // shards first, their readers exist before the first message is enqueued
+  for (std::uint32_t i = 0; i < this->nShards; ++i) {
+    this->shardThreads.emplace_back(
+        [this, i](std::stop_token stop) { this->runShard(stop, i); });
+  }
+  for (std::uint32_t i = 0; i < this->nHandlers; ++i) {
+    this->handlerThreads.emplace_back(
+        [this, i](std::stop_token stop) { this->runHandler(stop, i); });
+  }
+  this->ready->arrive_and_wait();
+  return this->pinFailures.load(std::memory_order_acquire) == 0;
+};
+
+PIPELINE_TEMPLATE_DECLARATION
+void PIPELINE::runHandler(std::stop_token stop,
+                          std::uint32_t handlerIndex) noexcept {
+  handlerState& handler = this->handlerStates[handlerIndex];
+  !pinToCore(this->config.handlerCores[handlerIndex])
+      ? void(this->pinFailures.fetch_add(1, std::memory_order_release))
+      : void();
+  const std::span<const std::unique_ptr<queueType_>> queues_(
+      &this->queues[handlerIndex * this->nShards], this->nShards);
+  this->ready->arrive_and_wait();
+  while (!stop.stop_requested()) {
+    const std::optional<msgClassVariant> msg =
+        handler.handler->readNextMessage();
+    if (!msg.has_value()) {
+      continue;
+    }
+    entryType entry{msg.value(), observerType_::enabled ? now() : 0};
+    std::uint32_t& instrumentID = std::visit(
+        [](auto& msg_) -> std::uint32_t& { return msg_.instrumentID; },
+        entry.msg);
+    const std::uint32_t shard = this->routing.shard(instrumentID);
+    if (shard == unrouted) {
+      count(handler.unrouted);
+      continue;
+    }
+    instrumentID = this->routing.localID(instrumentID);
+    queues_[shard]->enqueue(entry);
+    count(handler.enqueued);
+  }
+};
+
+PIPELINE_TEMPLATE_DECLARATION
+void PIPELINE::runShard(std::stop_token stop, std::uint32_t shardIndex) {
+  shardState& shard = this->shardStates[shardIndex];
+  !pinToCore(this->config.shardCores[shardIndex])
+      ? void(this->pinFailures.fetch_add(1, std::memory_order_release))
+      : void();
+  std::vector<std::uint32_t> shardPrices;
+  for (std::uint32_t instrumentID : this->routing.instruments(shardIndex)) {
+    shardPrices.push_back(this->basePrices[instrumentID]);
+  }
+  shard.manager = std::make_unique<managerType>(shardPrices);
+  // readers can neither be copied nor moved
+  std::deque<typename queueType_::ReaderType> readers;
+  for (std::uint32_t i = 0; i < this->nHandlers; ++i) {
+    readers.emplace_back(this->queues[i * this->nShards + shardIndex].get());
+  }
+  this->ready->arrive_and_wait();
+  // handlers have stopped once stop is requested, a pass over all queues
+  // started after that and finding them empty means everything was processed
+  bool stopping = false;
+  bool drained = false;
+  while (!(stopping && drained)) {
+    stopping = stop.stop_requested();
+    drained = true;
+    for (auto& reader : readers) {
+      const std::optional<entryType> entry = reader.read_next_entry();
+      if (!entry.has_value()) {
+        continue;
+      }
+      drained = false;
+      const auto response = shard.manager->processOrder(entry->msg);
+      if constexpr (observerType_::enabled) {
+        shard.observer.processed(entry->enqueued, response);
+      }
+      count(shard.processed);
+    }
+  }
+};
+
+PIPELINE_TEMPLATE_DECLARATION
+void PIPELINE::stop() noexcept {
+  if (this->state != running) {
+    return;
+  }
+  for (auto& thread : this->handlerThreads) {
+    thread.request_stop();
+    thread.join();
+  }
+  for (auto& thread : this->shardThreads) {
+    thread.request_stop();
+    thread.join();
+  }
+  this->state = stopped;
+};
+
+PIPELINE_TEMPLATE_DECLARATION
+std::uint32_t PIPELINE::handlers() const noexcept { return this->nHandlers; };
+
+PIPELINE_TEMPLATE_DECLARATION
+std::uint32_t PIPELINE::shards() const noexcept { return this->nShards; };
+
+PIPELINE_TEMPLATE_DECLARATION
+std::uint64_t PIPELINE::enqueuedCount(
+    std::uint32_t handlerIndex) const noexcept {
+  return this->handlerStates[handlerIndex].enqueued.load(
+      std::memory_order_acquire);
+};
+
+PIPELINE_TEMPLATE_DECLARATION
+std::uint64_t PIPELINE::unroutedCount(
+    std::uint32_t handlerIndex) const noexcept {
+  return this->handlerStates[handlerIndex].unrouted.load(
+      std::memory_order_acquire);
+};
+
+PIPELINE_TEMPLATE_DECLARATION
+std::uint64_t PIPELINE::processedCount(
+    std::uint32_t shardIndex) const noexcept {
+  return this->shardStates[shardIndex].processed.load(
+      std::memory_order_acquire);
+};
+
+PIPELINE_TEMPLATE_DECLARATION
+std::tuple<std::optional<std::uint32_t>, std::optional<std::uint32_t>>
+PIPELINE::bestBidAsk(std::uint32_t instrumentID) const noexcept {
+  return this->shardStates[this->routing.shard(instrumentID)]
+      .manager->bestBidAsk(this->routing.localID(instrumentID));
+};
+
+PIPELINE_TEMPLATE_DECLARATION
+bookType_& PIPELINE::book(std::uint32_t instrumentID) noexcept {
+  return this->shardStates[this->routing.shard(instrumentID)].manager->book(
+      this->routing.localID(instrumentID));
+};
+
+PIPELINE_TEMPLATE_DECLARATION
+observerType_& PIPELINE::observer(std::uint32_t shardIndex) noexcept {
+  return this->shardStates[shardIndex].observer;
+};
+};  // namespace Pipeline
+
+#undef PIPELINE_TEMPLATE_DECLARATION
+#undef PIPELINE
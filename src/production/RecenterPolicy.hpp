@@ -0,0 +1,45 @@
+// policies deciding when and by how much an order book shifts its price range
+// on its own, evaluated by the book after processing every order
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+
+namespace RecenterPolicy {
+// never shifts the book
+struct noRecentering {
+  static constexpr bool enabled = false;
+  static constexpr std::int32_t shiftBy(std::uint32_t, std::uint32_t,
+                                        std::optional<std::uint32_t>,
+                                        std::optional<std::uint32_t>) noexcept {
+    return 0;
+  };
+};
+
+// shifts book by step_ towards the touch once best bid or best offer come
+// within margin_ buckets of either edge of the price range, repeats with every
+// order until the touch is far enough from the edge
+template <std::uint32_t margin_, std::uint32_t step_>
+requires(step_ > 0) struct edgeDistance {
+  static constexpr bool enabled = true;
+  static constexpr std::uint32_t margin = margin_;
+  static constexpr std::uint32_t step = step_;
+  static constexpr std::int32_t shiftBy(
+      std::uint32_t basePrice, std::uint32_t bookLength,
+      std::optional<std::uint32_t> bestBid,
+      std::optional<std::uint32_t> bestOffer) noexcept {
+    const bool noTouch = !bestBid.has_value() && !bestOffer.has_value();
+    const std::uint32_t highTouch =
+        std::max(bestBid.value_or(0), bestOffer.value_or(0));
+    const std::uint32_t lowTouch = std::min(bestBid.value_or(highTouch),
+                                            bestOffer.value_or(highTouch));
+    const bool nearTop = highTouch + margin > basePrice + bookLength;
+    const bool nearBottom = lowTouch < basePrice + margin;
+    // no shift if both edges are too close, the book is too short for margin
+    return !noTouch * (static_cast<std::int32_t>(nearTop) -
+                       static_cast<std::int32_t>(nearBottom)) *
+           static_cast<std::int32_t>(step);
+  };
+};
+};  // namespace RecenterPolicy
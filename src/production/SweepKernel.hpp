@@ -0,0 +1,207 @@
+// consumes whole buckets of a contiguous array of 64 bit volumes while their
+// cumulative liquidity is covered by the open volume of an order, used for
+// orders sweeping many price levels at once, the bucket only partially filled
+// is left to the caller
+// AVX2 and AVX-512 versions are compiled alongside the scalar one, the version
+// used is picked once at runtime depending on the CPU
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace SweepKernel {
+// sweeps spanning fewer levels are left to the scalar loop of the book
+static constexpr std::uint32_t minLevels = 8;
+
+// liquidity and revenue are absolute values regardless of the side swept
+struct sweepResult {
+  // sum of volume of all consumed buckets
+  std::int64_t liquidity = 0;
+  // sum of volume times price of all consumed buckets
+  std::int64_t revenue = 0;
+  // number of buckets consumed entirely, counted from the first one
+  std::uint32_t consumed = 0;
+  // offset of the last consumed bucket containing volume, -1 if there is none
+  std::int32_t lastFilled = -1;
+};
+
+// arguments: pointer to first bucket, number of buckets in range, direction
+// (upwards for buy orders consuming offers, downwards for sell orders
+// consuming bids), absolute open volume, price of first bucket
+using sweepFunc = sweepResult (*)(std::int64_t*, std::uint32_t, bool,
+                                  std::int64_t, std::uint32_t) noexcept;
+
+// continues sweep after the buckets already accounted for in the result passed
+inline sweepResult sweepTail(std::int64_t* first, std::uint32_t count, bool up,
+                             std::int64_t open, std::uint32_t firstPrice,
+                             sweepResult ret) noexcept {
+  const std::int64_t sign = up ? 1 : -1;
+  for (; ret.consumed < count; ++ret.consumed) {
+    std::int64_t& bucket = first[sign * ret.consumed];
+    // bids are stored as negative volume
+    const std::int64_t liquidity = bucket * sign;
+    if (ret.liquidity + liquidity > open) {
+      break;
+    }
+    ret.liquidity += liquidity;
+    ret.revenue += liquidity * (firstPrice + sign * ret.consumed);
+    ret.lastFilled = liquidity != 0 ? static_cast<std::int32_t>(ret.consumed)
+                                    : ret.lastFilled;
+    bucket = 0;
+  }
+  return ret;
+};
+
+inline sweepResult sweepScalar(std::int64_t* first, std::uint32_t count,
+                               bool up, std::int64_t open,
+                               std::uint32_t firstPrice) noexcept {
+  return sweepTail(first, count, up, open, firstPrice, sweepResult{});
+};
+
+#if defined(__x86_64__)
+// 4 buckets per block, a block is consumed if the prefix sums of all its lanes
+// are covered by the open volume, otherwise the scalar tail takes over
+__attribute__((target("avx2"))) inline sweepResult sweepAVX2(
+    std::int64_t* first, std::uint32_t count, bool up, std::int64_t open,
+    std::uint32_t firstPrice) noexcept {
+  static constexpr std::uint32_t lanes = 4;
+  const std::int64_t sign = up ? 1 : -1;
+  const __m256i zero = _mm256_setzero_si256();
+  // negates bids via (v ^ m) - m with m all ones
+  const __m256i negate = _mm256_set1_epi64x(-static_cast<std::int64_t>(!up));
+  const __m256i openVec = _mm256_set1_epi64x(open);
+  const __m256i priceStep = _mm256_set1_epi64x(lanes * sign);
+  __m256i prices = _mm256_add_epi64(_mm256_set1_epi64x(firstPrice),
+                                    _mm256_set_epi64x(3 * sign, 2 * sign,
+                                                      sign, 0));
+  __m256i revenue = zero;
+  // running total of liquidity broadcast to all lanes
+  __m256i carry = zero;
+  sweepResult ret;
+  for (; ret.consumed + lanes <= count; ret.consumed += lanes) {
+    // lane k always holds bucket consumed + k, downwards loads are reversed
+    std::int64_t* address =
+        up ? first + ret.consumed : first - ret.consumed - (lanes - 1);
+    __m256i volume =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(address));
+    volume = up ? volume : _mm256_permute4x64_epi64(volume, 0x1B);
+    const __m256i liquidity =
+        _mm256_sub_epi64(_mm256_xor_si256(volume, negate), negate);
+    // in-lane prefix sums: add lanes shifted up by one, then by two
+    __m256i cumulative = _mm256_add_epi64(
+        liquidity, _mm256_blend_epi32(
+                       _mm256_permute4x64_epi64(liquidity, 0x90), zero, 0x03));
+    cumulative = _mm256_add_epi64(
+        cumulative,
+        _mm256_blend_epi32(_mm256_permute4x64_epi64(cumulative, 0x40), zero,
+                           0x0F));
+    cumulative = _mm256_add_epi64(cumulative, carry);
+    const int exceeding = _mm256_movemask_pd(
+        _mm256_castsi256_pd(_mm256_cmpgt_epi64(cumulative, openVec)));
+    if (exceeding != 0) {
+      break;
+    }
+    carry = _mm256_permute4x64_epi64(cumulative, 0xFF);
+    // prices fit 32 bits, 64 bit product assembled from low and high half of
+    // the volume
+    const __m256i low = _mm256_mul_epu32(liquidity, prices);
+    const __m256i high = _mm256_slli_epi64(
+        _mm256_mul_epu32(_mm256_srli_epi64(liquidity, 32), prices), 32);
+    revenue = _mm256_add_epi64(revenue, _mm256_add_epi64(low, high));
+    prices = _mm256_add_epi64(prices, priceStep);
+    const std::uint32_t nonEmpty =
+        ~_mm256_movemask_pd(
+            _mm256_castsi256_pd(_mm256_cmpeq_epi64(liquidity, zero))) &
+        0xF;
+    // highest lane containing volume
+    const std::uint32_t lastLane = std::bit_width(nonEmpty);
+    ret.lastFilled =
+        lastLane != 0 ? static_cast<std::int32_t>(ret.consumed + lastLane) - 1
+                      : ret.lastFilled;
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(address), zero);
+  }
+  const __m128i halves = _mm_add_epi64(_mm256_castsi256_si128(revenue),
+                                       _mm256_extracti128_si256(revenue, 1));
+  ret.revenue = _mm_cvtsi128_si64(halves) + _mm_extract_epi64(halves, 1);
+  ret.liquidity = _mm256_extract_epi64(carry, 0);
+  return sweepTail(first, count, up, open, firstPrice, ret);
+};
+
+// 8 buckets per block, same scheme as the AVX2 version
+__attribute__((target("avx512f,avx512dq"))) inline sweepResult sweepAVX512(
+    std::int64_t* first, std::uint32_t count, bool up, std::int64_t open,
+    std::uint32_t firstPrice) noexcept {
+  static constexpr std::uint32_t lanes = 8;
+  const std::int64_t sign = up ? 1 : -1;
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512i openVec = _mm512_set1_epi64(open);
+  const __m512i reverse = _mm512_set_epi64(0, 1, 2, 3, 4, 5, 6, 7);
+  const __m512i priceStep = _mm512_set1_epi64(lanes * sign);
+  __m512i prices = _mm512_add_epi64(
+      _mm512_set1_epi64(firstPrice),
+      _mm512_set_epi64(7 * sign, 6 * sign, 5 * sign, 4 * sign, 3 * sign,
+                       2 * sign, sign, 0));
+  const __m512i last = _mm512_set1_epi64(lanes - 1);
+  __m512i revenue = zero;
+  __m512i carry = zero;
+  sweepResult ret;
+  for (; ret.consumed + lanes <= count; ret.consumed += lanes) {
+    std::int64_t* address =
+        up ? first + ret.consumed : first - ret.consumed - (lanes - 1);
+    __m512i volume = _mm512_loadu_si512(address);
+    volume = up ? volume : _mm512_permutexvar_epi64(reverse, volume);
+    const __m512i liquidity =
+        up ? volume : _mm512_sub_epi64(zero, volume);
+    // in-lane prefix sums, lanes shifted up by one, two and four
+    __m512i cumulative =
+        _mm512_add_epi64(liquidity, _mm512_alignr_epi64(liquidity, zero, 7));
+    cumulative =
+        _mm512_add_epi64(cumulative, _mm512_alignr_epi64(cumulative, zero, 6));
+    cumulative =
+        _mm512_add_epi64(cumulative, _mm512_alignr_epi64(cumulative, zero, 4));
+    cumulative = _mm512_add_epi64(cumulative, carry);
+    if (_mm512_cmpgt_epi64_mask(cumulative, openVec) != 0) {
+      break;
+    }
+    carry = _mm512_permutexvar_epi64(last, cumulative);
+    revenue = _mm512_add_epi64(revenue, _mm512_mullo_epi64(liquidity, prices));
+    prices = _mm512_add_epi64(prices, priceStep);
+    const std::uint32_t nonEmpty = _mm512_test_epi64_mask(liquidity, liquidity);
+    // highest lane containing volume
+    const std::uint32_t lastLane = std::bit_width(nonEmpty);
+    ret.lastFilled =
+        lastLane != 0 ? static_cast<std::int32_t>(ret.consumed + lastLane) - 1
+                      : ret.lastFilled;
+    _mm512_storeu_si512(address, zero);
+  }
+  ret.revenue = _mm512_reduce_add_epi64(revenue);
+  ret.liquidity = _mm_cvtsi128_si64(_mm512_castsi512_si128(carry));
+  return sweepTail(first, count, up, open, firstPrice, ret);
+};
+#endif
+
+// widest version supported by the CPU
+inline sweepFunc selectSweep() noexcept {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+    return sweepAVX512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return sweepAVX2;
+  }
+#endif
+  return sweepScalar;
+};
+
+// dispatches to the version selected on first use
+inline sweepResult sweep(std::int64_t* first, std::uint32_t count, bool up,
+                         std::int64_t open, std::uint32_t firstPrice) noexcept {
+  static const sweepFunc selected = selectSweep();
+  return selected(first, count, up, open, firstPrice);
+};
+};  // namespace SweepKernel
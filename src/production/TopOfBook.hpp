@@ -0,0 +1,32 @@
+// best bid and best offer packed into a single 64-bit word, allows for torn
+// free reads of both prices via a single atomic load
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <tuple>
+
+namespace TopOfBook {
+// marks absence of best bid or best offer
+static constexpr std::uint32_t noPrice =
+    std::numeric_limits<std::uint32_t>::max();
+// neither best bid nor best offer
+static constexpr std::uint64_t empty =
+    (std::uint64_t{noPrice} << 32) | noPrice;
+
+// best bid in upper and best offer in lower 32 bits
+constexpr std::uint64_t pack(std::optional<std::uint32_t> bestBid,
+                             std::optional<std::uint32_t> bestOffer) noexcept {
+  return (std::uint64_t{bestBid.value_or(noPrice)} << 32) |
+         bestOffer.value_or(noPrice);
+};
+
+constexpr std::tuple<std::optional<std::uint32_t>, std::optional<std::uint32_t>>
+unpack(std::uint64_t packed) noexcept {
+  const std::uint32_t bestBid = packed >> 32;
+  const std::uint32_t bestOffer = packed & noPrice;
+  return {bestBid != noPrice ? std::make_optional(bestBid) : std::nullopt,
+          bestOffer != noPrice ? std::make_optional(bestOffer) : std::nullopt};
+};
+};  // namespace TopOfBook
@@ -31,6 +31,25 @@ struct fixMockSocket {
   void insertOversizedMsg(
       const std::tuple<std::uint8_t, std::int32_t, std::uint32_t>&,
       std::uint32_t);
+  // 20 pseudo random bytes derived from volume and price, delimiters are
+  // broken up so the bytes are never mistaken for a header
+  void insertGarbage(
+      const std::tuple<std::uint8_t, std::int32_t, std::uint32_t>&,
+      std::uint32_t);
+  // first 12 bytes of a new limit order, as if cut short by the sender
+  void insertTruncatedMsg(
+      const std::tuple<std::uint8_t, std::int32_t, std::uint32_t>&,
+      std::uint32_t);
+  // header with valid delimiter but length of 3 bytes, followed by 6 zero
+  // bytes
+  void insertShortHeader(
+      const std::tuple<std::uint8_t, std::int32_t, std::uint32_t>&,
+      std::uint32_t);
+  // messages of types 0 to 2 preceded by an SBE message header (template IDs 1
+  // to 3, schema ID 1, version 0), type 9 a new limit order with template ID 4
+  void insertSBEMsg(
+      const std::tuple<std::uint8_t, std::int32_t, std::uint32_t>&,
+      std::uint32_t);
   std::uint32_t memSize;
   std::uint8_t* memPtr;
   std::span<uint8_t> memSpan;
@@ -45,18 +64,26 @@ struct fixMockSocket {
           std::tuple<std::uint8_t, std::int32_t, std::uint32_t>>&);
   // bookkeeping on number of messages already read and index for next read
   std::uint32_t readIndex = 0;
+  // upper bound for bytes handed out per call, simulates partial reads
+  std::uint32_t maxRecvLength = 0xFFFFFFFF;
+  std::uint64_t recvCalls = 0;
   // flag to set when end of the buffer is reached
   std::atomic_flag* endOfBuffer;
 
  public:
   // construct mock socket from vector of tuples containing:
   // unit8_t: message type(0: newLimitOrder, 1 withdrawLimitOrder, 2
-  // marketOrder) int32_t order volume uint32_t order price
+  // marketOrder, 3 garbage, 4 oversized message, 5 truncated newLimitOrder,
+  // 6 to 8 types 0 to 2 with SBE message header, 9 SBE newLimitOrder with
+  // template ID 4, 10 header with a length too short for any message)
+  // int32_t order volume uint32_t order price
   fixMockSocket(
       const std::vector<std::tuple<std::uint8_t, std::int32_t, std::uint32_t>>&,
       std::atomic_flag*);
   ~fixMockSocket();
   std::int32_t recv(void*, std::uint32_t) noexcept;
+  void limitRecvLength(std::uint32_t) noexcept;
+  std::uint64_t recvCount() const noexcept;
 };
 };  // namespace FIXmockSocket
 
@@ -116,6 +143,66 @@ void fixMockSocket::insertOversizedMsg(
   *reinterpret_cast<std::uint8_t*>(&this->memSpan[beginIndex + 6]) = 0xFF;
 };
 
+void fixMockSocket::insertGarbage(
+    const std::tuple<std::uint8_t, std::int32_t, std::uint32_t>& orderTuple,
+    std::uint32_t beginIndex) {
+  // xorshift, seed must not be zero
+  std::uint32_t state =
+      static_cast<std::uint32_t>(std::get<1>(orderTuple)) * 2654435761u ^
+      std::get<2>(orderTuple) ^ 0x9E3779B9u;
+  state = state == 0 ? 1 : state;
+  for (std::uint32_t i = 0; i < 20; ++i) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    this->memSpan[beginIndex + i] = state & 0xFF;
+  }
+  auto garbage = this->memSpan.subspan(beginIndex, 20);
+  for (std::uint32_t i = 1; i < 20; ++i) {
+    garbage[i] = garbage[i - 1] == 0x50 && garbage[i] == 0xEB ? 0 : garbage[i];
+  }
+};
+
+void fixMockSocket::insertTruncatedMsg(
+    const std::tuple<std::uint8_t, std::int32_t, std::uint32_t>& orderTuple,
+    std::uint32_t beginIndex) {
+  *reinterpret_cast<std::uint32_t*>(&this->memSpan[beginIndex]) = 17;
+  *reinterpret_cast<std::uint16_t*>(&this->memSpan[beginIndex + 4]) = 0xEB50;
+  *reinterpret_cast<std::int32_t*>(&this->memSpan[beginIndex + 6]) =
+      std::get<1>(orderTuple);
+  *reinterpret_cast<std::uint16_t*>(&this->memSpan[beginIndex + 10]) =
+      std::get<2>(orderTuple);
+};
+
+void fixMockSocket::insertShortHeader(
+    const std::tuple<std::uint8_t, std::int32_t, std::uint32_t>& orderTuple,
+    std::uint32_t beginIndex) {
+  *reinterpret_cast<std::uint32_t*>(&this->memSpan[beginIndex]) = 3;
+  *reinterpret_cast<std::uint16_t*>(&this->memSpan[beginIndex + 4]) = 0xEB50;
+};
+
+void fixMockSocket::insertSBEMsg(
+    const std::tuple<std::uint8_t, std::int32_t, std::uint32_t>& orderTuple,
+    std::uint32_t beginIndex) {
+  const std::uint8_t type = std::get<0>(orderTuple);
+  const std::uint32_t msgLength = type == 7 ? 26 : type == 8 ? 21 : 25;
+  *reinterpret_cast<std::uint32_t*>(&this->memSpan[beginIndex]) = msgLength;
+  *reinterpret_cast<std::uint16_t*>(&this->memSpan[beginIndex + 4]) = 0xEB50;
+  // block length, template ID, schema ID, version
+  *reinterpret_cast<std::uint16_t*>(&this->memSpan[beginIndex + 6]) =
+      msgLength - 17;
+  *reinterpret_cast<std::uint16_t*>(&this->memSpan[beginIndex + 8]) = type - 5;
+  *reinterpret_cast<std::uint16_t*>(&this->memSpan[beginIndex + 10]) = 1;
+  *reinterpret_cast<std::uint16_t*>(&this->memSpan[beginIndex + 12]) = 0;
+  *reinterpret_cast<std::int32_t*>(&this->memSpan[beginIndex + 14]) =
+      std::get<1>(orderTuple);
+  type != 8 ? void(*reinterpret_cast<std::uint32_t*>(
+                  &this->memSpan[beginIndex + 18]) = std::get<2>(orderTuple))
+            : void();
+  type == 7 ? void(this->memSpan[beginIndex + 22] = 0xFF) : void();
+  this->insertChecksum(beginIndex, beginIndex + msgLength - 3);
+};
+
 std::uint32_t fixMockSocket::determineMemSize(
     const std::vector<std::tuple<std::uint8_t, std::int32_t, std::uint32_t>>&
         msgVec) {
@@ -123,7 +210,10 @@ std::uint32_t fixMockSocket::determineMemSize(
   for (auto msg : msgVec) {
     ret += 17 * (std::get<0>(msg) == 0) + 18 * (std::get<0>(msg) == 1) +
            13 * (std::get<0>(msg) == 2) + 20 * (std::get<0>(msg) == 3) +
-           40 * (std::get<0>(msg) == 4);
+           40 * (std::get<0>(msg) == 4) + 12 * (std::get<0>(msg) == 5) +
+           25 * (std::get<0>(msg) == 6) + 26 * (std::get<0>(msg) == 7) +
+           21 * (std::get<0>(msg) == 8) + 25 * (std::get<0>(msg) == 9) +
+           12 * (std::get<0>(msg) == 10);
   };
   return ret;
 };
@@ -150,6 +240,7 @@ void fixMockSocket::populateMemory(
         break;
       // 20 arbitrary bytes to simulate faulty order
       case 3:
+        this->insertGarbage(msg, index);
         index += 20;
         break;
       case 4:
@@ -158,6 +249,27 @@ void fixMockSocket::populateMemory(
         this->insertOversizedMsg(msg, index);
         index += 40;
         break;
+      case 5:
+        this->insertTruncatedMsg(msg, index);
+        index += 12;
+        break;
+      case 6:
+      case 9:
+        this->insertSBEMsg(msg, index);
+        index += 25;
+        break;
+      case 7:
+        this->insertSBEMsg(msg, index);
+        index += 26;
+        break;
+      case 8:
+        this->insertSBEMsg(msg, index);
+        index += 21;
+        break;
+      case 10:
+        this->insertShortHeader(msg, index);
+        index += 12;
+        break;
     };
   };
 };
@@ -168,7 +280,7 @@ fixMockSocket::fixMockSocket(
     std::atomic_flag* flagPtr = nullptr)
     : endOfBuffer(flagPtr) {
   this->memSize = this->determineMemSize(msgVec);
-  this->memPtr = new std::uint8_t[this->memSize];
+  this->memPtr = new std::uint8_t[this->memSize]();
   this->memSpan = std::span<std::uint8_t>{this->memPtr, this->memSize};
   this->populateMemory(msgVec);
 };
@@ -176,17 +288,23 @@ fixMockSocket::fixMockSocket(
 fixMockSocket::~fixMockSocket() { delete[] this->memPtr; };
 
 std::int32_t fixMockSocket::recv(void* dest, std::uint32_t len) noexcept {
-  if ((this->readIndex + len) > this->memSize) {
-    std::cout << "fixMockSocket: out of bounds read during call of recv(). "
-                 "terminating."
-              << "\n";
-    std::terminate();
-  };
-  std::memcpy(dest, &this->memSpan[this->readIndex], len);
+  // like recv on a POSIX socket, hands out fewer bytes than requested if no
+  // more are available, zero once all messages have been read
+  len = std::min({len, this->maxRecvLength, this->memSize - this->readIndex});
+  ++this->recvCalls;
+  std::memcpy(dest, this->memPtr + this->readIndex, len);
   this->readIndex += len;
   if (this->readIndex == this->memSize && this->endOfBuffer != nullptr) {
     this->endOfBuffer->test_and_set(std::memory_order_release);
   };
   return len;
 };
+
+void fixMockSocket::limitRecvLength(std::uint32_t maxLen) noexcept {
+  this->maxRecvLength = maxLen;
+};
+
+std::uint64_t fixMockSocket::recvCount() const noexcept {
+  return this->recvCalls;
+};
 }  // namespace FIXmockSocket
\ No newline at end of file
@@ -0,0 +1,185 @@
+// compares processing messages handed over via Queue::SeqLockQueue one by one
+// and in batches of whatever is queued (orderBook::drainQueue), both with a
+// saturating and a paced producer
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "FIXSocketHandler.hpp"
+#include "FIXmockSocket.hpp"
+#include "FIXmsgClasses.hpp"
+#include "FileToTuples.hpp"
+#include "OrderBook.hpp"
+#include "Queue.hpp"
+#include "busyWait.hpp"
+
+using lineTuple = std::tuple<std::uint8_t, std::int32_t, std::uint32_t>;
+using msgClassVar =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+static constexpr std::uint32_t twoPow20 = 1048576;
+static constexpr std::size_t maxBatch = 256;
+using ordBook =
+    OrderBook::orderBook<msgClassVar, std::int64_t, 6000, false, 0, 1, 2>;
+using orderResponse = ordBook::orderResponseType;
+using seqLockQueue = Queue::SeqLockQueue<msgClassVar, twoPow20, false, false>;
+using sockHandler =
+    FIXSocketHandler::fixSocketHandler<msgClassVar,
+                                       FIXmockSocket::fixMockSocket>;
+using timePoint = decltype(std::chrono::high_resolution_clock::now());
+
+// decode all messages up front so only queue and order book are being measured
+std::vector<msgClassVar> readMessages(const std::string& csvPath) {
+  auto tupleVec = FileToTuples::fileToTuples<lineTuple>(csvPath);
+  auto mockSock = FIXmockSocket::fixMockSocket(tupleVec, nullptr);
+  auto sHandler = sockHandler(&mockSock);
+  const std::size_t nMsgs = std::min<std::size_t>(tupleVec.size(), twoPow20);
+  std::vector<msgClassVar> ret;
+  ret.reserve(nMsgs);
+  for (std::size_t i = 0; i < nMsgs; ++i) {
+    ret.push_back(sHandler.readNextMessage().value());
+  }
+  return ret;
+}
+
+void pinThread(int coreIndex) {
+  if (coreIndex < 0) {
+    return;
+  }
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(coreIndex, &cpuSet);
+  int setAffRet =
+      pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+  if (setAffRet != 0) {
+    std::cout << "setting up CPU-affinity failed. teminating."
+              << "\n";
+    std::terminate();
+  }
+}
+
+template <bool batched>
+void profileConsumer(const std::vector<msgClassVar>& msgs,
+                     std::uint64_t pacing, int enqCoreIndex, int deqCoreIndex,
+                     const std::string& label) {
+  const std::size_t nMsgs = msgs.size();
+  auto book = ordBook(7000);
+  auto slq = std::make_unique<seqLockQueue>();
+  auto reader = slq->get_reader();
+  std::vector<timePoint> startTimes(nMsgs), completionTimes(nMsgs);
+  std::atomic_flag signalFlag{false};
+
+  std::thread enqThread([&]() {
+    pinThread(enqCoreIndex);
+    signalFlag.test_and_set();
+    while (signalFlag.test()) {
+    };
+    for (std::size_t i = 0; i < nMsgs; ++i) {
+      startTimes[i] = std::chrono::high_resolution_clock::now();
+      slq->enqueue(msgs[i]);
+      pacing > 0 ? BusyWait::busyWait(pacing) : void();
+    }
+  });
+
+  pinThread(deqCoreIndex);
+  std::vector<msgClassVar> buffer(maxBatch);
+  std::vector<orderResponse> responses(maxBatch);
+  std::optional<msgClassVar> deqRet;
+  std::size_t index{0}, nBatches{0};
+  std::int64_t checkSum{0};
+  while (!signalFlag.test()) {
+  };
+  signalFlag.clear();
+  const auto startTime = std::chrono::high_resolution_clock::now();
+  while (index < nMsgs) {
+    if constexpr (batched) {
+      const std::size_t nProcessed = book.drainQueue(reader, buffer, responses);
+      const auto completionTime = std::chrono::high_resolution_clock::now();
+      for (std::size_t i = 0; i < nProcessed; ++i) {
+        checkSum += std::get<1>(responses[i]);
+        completionTimes[index + i] = completionTime;
+      }
+      index += nProcessed;
+      nBatches += nProcessed > 0;
+    } else {
+      deqRet = reader.read_next_entry();
+      if (deqRet.has_value()) {
+        checkSum += std::get<1>(book.processOrder(deqRet.value()));
+        completionTimes[index] = std::chrono::high_resolution_clock::now();
+        ++index;
+        ++nBatches;
+      }
+    }
+  }
+  const auto endTime = std::chrono::high_resolution_clock::now();
+  enqThread.join();
+
+  // latency: time between starting to enqueue and completing processing
+  std::vector<double> latencies(nMsgs);
+  for (std::size_t i = 0; i < nMsgs; ++i) {
+    latencies[i] = static_cast<double>(duration_cast<std::chrono::nanoseconds>(
+                                           completionTimes[i] - startTimes[i])
+                                           .count());
+  }
+  std::ranges::sort(latencies);
+  const double mean =
+      std::accumulate(latencies.begin(), latencies.end(), 0.0) / nMsgs;
+  const double seconds =
+      static_cast<double>(
+          duration_cast<std::chrono::nanoseconds>(endTime - startTime)
+              .count()) /
+      1e9;
+  std::cout << label << ": " << nMsgs / seconds / 1e6 << " M msgs/s, "
+            << static_cast<double>(nMsgs) / nBatches
+            << " msgs per batch, latency mean " << mean << ", 0.99 quantile "
+            << latencies[nMsgs * 99 / 100] << ", 0.999 quantile "
+            << latencies[nMsgs * 999 / 1000] << " (checksum " << checkSum
+            << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+  // process and validate command line arguments
+  if (argc != 2 && argc != 4) {
+    std::cout << "usage: profiling_batching <csv> [enqueue core index "
+                 "dequeue core index]"
+              << "\n";
+    return 1;
+  }
+  int enqCoreIndex = -1;
+  int deqCoreIndex = -1;
+  if (argc == 4) {
+    int nCores = std::thread::hardware_concurrency();
+    enqCoreIndex = std::atoi(argv[2]);
+    deqCoreIndex = std::atoi(argv[3]);
+    bool invalidIndex = enqCoreIndex < 0 || enqCoreIndex > nCores ||
+                        deqCoreIndex < 0 || deqCoreIndex > nCores;
+    if (invalidIndex) {
+      std::cout << "invalid CPU-index argument. teminating."
+                << "\n";
+      std::terminate();
+    }
+  }
+  const auto msgs = readMessages(argv[1]);
+  // pacing in nanoseconds between enqueued messages, 0 saturates the consumer
+  for (std::uint64_t pacing : {0, 50}) {
+    std::cout << "producer pacing " << pacing << "ns\n";
+    profileConsumer<false>(msgs, pacing, enqCoreIndex, deqCoreIndex,
+                           "  per message");
+    profileConsumer<true>(msgs, pacing, enqCoreIndex, deqCoreIndex,
+                          "  drained batches");
+  }
+}
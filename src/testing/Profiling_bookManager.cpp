@@ -0,0 +1,147 @@
+// measures latencies of a book manager holding 1, 100 and 10000 instruments
+// on a single core, as well as the cost of sweeping the best bid and offer of
+// all instruments via the packed top of book and via the books themselves
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "BookManager.hpp"
+#include "FIXmsgClasses.hpp"
+#include "OrderBook.hpp"
+#include "OrderBookStorage.hpp"
+
+using addLimitOrder =
+    FIXmsgClasses::instrumentMsg<FIXmsgClasses::addLimitOrder>;
+using withdrawLimitOrder =
+    FIXmsgClasses::instrumentMsg<FIXmsgClasses::withdrawLimitOrder>;
+using marketOrder = FIXmsgClasses::instrumentMsg<FIXmsgClasses::marketOrder>;
+using msgClassVar =
+    std::variant<addLimitOrder, withdrawLimitOrder, marketOrder>;
+using ordBook =
+    OrderBook::orderBook<msgClassVar, std::int32_t, 2000, false, 0, 1, 2, true,
+                         OrderBookStorage::ringStorage>;
+using manager = BookManager::bookManager<ordBook>;
+static constexpr std::uint32_t nMsgs = 1000000;
+static constexpr std::uint32_t nSweeps = 100;
+
+// random walk of every instrument's mid price, orders are placed around the
+// mid of a randomly chosen instrument, generated up front so only the manager
+// is being measured
+std::vector<msgClassVar> generateMessages(std::uint32_t nInstruments) {
+  std::vector<std::int32_t> mids(nInstruments, 1000);
+  std::vector<msgClassVar> ret;
+  ret.reserve(nMsgs);
+  for (std::uint32_t i = 0; i < nMsgs; ++i) {
+    const std::uint32_t instrument = std::rand() % nInstruments;
+    mids[instrument] =
+        std::clamp(mids[instrument] + std::rand() % 3 - 1, 100, 1900);
+    const bool bid = std::rand() % 2;
+    const std::int32_t volume = (1 + std::rand() % 50) * (bid ? -1 : 1);
+    const std::int32_t distance = 1 + std::rand() % 20;
+    const std::uint32_t price = mids[instrument] + (bid ? -distance : distance);
+    const int msgType = std::rand() % 100;
+    msgType < 60
+        ? ret.push_back(addLimitOrder(
+              FIXmsgClasses::addLimitOrder(volume, price), instrument))
+    : msgType < 85
+        ? ret.push_back(withdrawLimitOrder(
+              FIXmsgClasses::withdrawLimitOrder(volume, price), instrument))
+        : ret.push_back(marketOrder(FIXmsgClasses::marketOrder(-volume),
+                                    instrument));
+  }
+  return ret;
+}
+
+void profileManager(std::uint32_t nInstruments) {
+  const auto msgs = generateMessages(nInstruments);
+  const std::vector<std::uint32_t> basePrices(nInstruments, 0);
+  auto bookManager = manager(basePrices);
+  std::vector<double> latencies(msgs.size());
+  std::int64_t checkSum{0};
+  for (std::size_t i = 0; i < msgs.size(); ++i) {
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    checkSum += std::get<1>(bookManager.processOrder(msgs[i]));
+    const auto completionTime = std::chrono::high_resolution_clock::now();
+    latencies[i] = static_cast<double>(
+        duration_cast<std::chrono::nanoseconds>(completionTime - startTime)
+            .count());
+  }
+  std::ranges::sort(latencies);
+  const double mean =
+      std::accumulate(latencies.begin(), latencies.end(), 0.0) /
+      latencies.size();
+  std::cout << nInstruments << " instruments (arena "
+            << bookManager.arenaUsed() / 1024 << " KiB): mean " << mean
+            << ", 0.99 quantile " << latencies[latencies.size() * 99 / 100]
+            << ", max " << latencies.back() << " (checksum " << checkSum
+            << ")\n";
+
+  // nanoseconds per instrument for reading best bid and offer of all of them
+  auto sweep = [&](auto&& query) {
+    std::uint64_t priceSum{0};
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    for (std::uint32_t s = 0; s < nSweeps; ++s) {
+      for (std::uint32_t i = 0; i < nInstruments; ++i) {
+        const auto [bestBid, bestOffer] = query(i);
+        priceSum += bestBid.value_or(0) + bestOffer.value_or(0);
+      }
+    }
+    const auto completionTime = std::chrono::high_resolution_clock::now();
+    const double perInstrument =
+        static_cast<double>(
+            duration_cast<std::chrono::nanoseconds>(completionTime - startTime)
+                .count()) /
+        (static_cast<double>(nSweeps) * nInstruments);
+    return std::make_tuple(perInstrument, priceSum);
+  };
+  const auto [packed, packedSum] =
+      sweep([&](std::uint32_t i) { return bookManager.bestBidAsk(i); });
+  const auto [perBook, perBookSum] =
+      sweep([&](std::uint32_t i) { return bookManager.book(i).bestBidAsk(); });
+  std::cout << "  top of book sweep: packed " << packed << ", per book "
+            << perBook << " (checksums " << packedSum << ", " << perBookSum
+            << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+  // process and validate command line arguments
+  if (argc == 2) {
+    int nCores = std::thread::hardware_concurrency();
+    int coreIndex = std::atoi(argv[1]);
+    bool invalidIndex = coreIndex < 0 || coreIndex > nCores;
+    if (invalidIndex) {
+      std::cout << "invalid CPU-index argument. teminating."
+                << "\n";
+      std::terminate();
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(coreIndex, &cpuSet);
+    int setAffRet =
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+    if (setAffRet != 0) {
+      std::cout << "setting up CPU-affinity failed. teminating."
+                << "\n";
+      std::terminate();
+    }
+  }
+  // fixed seed, every run processes identical messages
+  std::srand(42);
+  // latencies in nanoseconds per message
+  for (std::uint32_t nInstruments : {1, 100, 10000}) {
+    profileManager(nInstruments);
+  }
+}
@@ -0,0 +1,169 @@
+// compares reading messages one at a time via readNextMessage (two recv calls
+// per message) and decoding them in bulk out of a ring buffer via
+// readMessages, prints recv calls per message and messages per second for
+// - fixMockSocket: cost of parsing only, recv is a memcpy
+// - a connected pair of UNIX domain stream sockets fed by a writer thread:
+//   every recv is a syscall, readNextMessage waits for all bytes requested
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "FIXSocketHandler.hpp"
+#include "FIXmockSocket.hpp"
+#include "FIXmsgClasses.hpp"
+
+using lineTuple = std::tuple<std::uint8_t, std::int32_t, std::uint32_t>;
+using msgClassVar =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+static constexpr std::uint32_t nMsgs = 1000000;
+static constexpr std::uint32_t ringSize = 65536;
+
+// recv on a file descriptor, counts calls
+struct posixSocket {
+  int fd;
+  int flags;
+  std::uint64_t recvCalls = 0;
+  std::int32_t recv(void* dest, std::uint32_t len) noexcept {
+    ++recvCalls;
+    return ::recv(fd, dest, len, flags);
+  };
+  std::uint64_t recvCount() const noexcept { return recvCalls; };
+};
+
+std::vector<lineTuple> generateMessages() {
+  std::vector<lineTuple> ret;
+  ret.reserve(nMsgs);
+  for (std::uint32_t i = 0; i < nMsgs; ++i) {
+    ret.emplace_back(std::rand() % 3, std::rand() % 2000 - 1000,
+                     std::rand() % 2000);
+  }
+  return ret;
+}
+
+// reads nMsgs messages, returns messages per second, checksum over volumes
+// keeps the compiler from discarding the messages
+template <typename handlerType>
+std::tuple<double, std::int64_t> readAll(handlerType& handler,
+                                         std::uint32_t batchSize) {
+  std::vector<msgClassVar> msgs(std::max<std::uint32_t>(batchSize, 1));
+  std::int64_t checkSum = 0;
+  auto volume = [](const msgClassVar& msg) {
+    return std::visit([](const auto& m) { return m.orderVolume; }, msg);
+  };
+  const auto startTime = std::chrono::high_resolution_clock::now();
+  for (std::uint32_t nRead = 0; nRead < nMsgs;) {
+    if constexpr (handlerType::streamBufferSize == 0) {
+      const auto msg = handler.readNextMessage();
+      checkSum += msg.has_value() ? volume(msg.value()) : 0;
+      ++nRead;
+    } else {
+      const std::size_t n = handler.readMessages(msgs);
+      for (std::size_t i = 0; i < n; ++i) {
+        checkSum += volume(msgs[i]);
+      }
+      nRead += n;
+    }
+  }
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::high_resolution_clock::now() -
+                                    startTime)
+          .count();
+  return {nMsgs / seconds, checkSum};
+}
+
+template <typename handlerType, typename socketType>
+void report(const std::string& label, socketType& socket,
+            std::uint32_t batchSize) {
+  handlerType handler(&socket);
+  const auto [msgsPerSecond, checkSum] = readAll(handler, batchSize);
+  std::cout << label << ": "
+            << static_cast<double>(socket.recvCount()) / nMsgs
+            << " recv calls per message, " << msgsPerSecond
+            << " messages per second (checksum " << checkSum << ")"
+            << std::endl;
+}
+
+// runs a handler on one end of a socket pair while a writer thread sends the
+// bytes of all messages through the other end
+template <typename handlerType>
+void profileSocketPair(const std::string& label,
+                       const std::vector<std::uint8_t>& bytes, int flags,
+                       std::uint32_t batchSize) {
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    std::cout << "creating socket pair failed. teminating."
+              << "\n";
+    std::terminate();
+  }
+  std::jthread writer([&] {
+    for (std::size_t sent = 0; sent < bytes.size();) {
+      const auto n =
+          ::send(fds[1], &bytes[sent],
+                 std::min<std::size_t>(4096, bytes.size() - sent), 0);
+      sent += std::max<decltype(n)>(n, 0);
+    }
+  });
+  auto socket = posixSocket{fds[0], flags};
+  report<handlerType>(label, socket, batchSize);
+  writer.join();
+  close(fds[0]);
+  close(fds[1]);
+}
+
+int main() {
+  std::srand(42);
+  const auto tuples = generateMessages();
+  // bytes of all messages as they would arrive via network
+  std::vector<std::uint8_t> bytes(18 * nMsgs);
+  {
+    auto mockSocket = FIXmockSocket::fixMockSocket(tuples);
+    bytes.resize(mockSocket.recv(bytes.data(), bytes.size()));
+  }
+  using singleHandler =
+      FIXSocketHandler::fixSocketHandler<msgClassVar,
+                                         FIXmockSocket::fixMockSocket>;
+  using bulkHandler =
+      FIXSocketHandler::fixSocketHandler<msgClassVar,
+                                         FIXmockSocket::fixMockSocket,
+                                         ringSize>;
+  using singlePosixHandler =
+      FIXSocketHandler::fixSocketHandler<msgClassVar, posixSocket>;
+  using bulkPosixHandler =
+      FIXSocketHandler::fixSocketHandler<msgClassVar, posixSocket, ringSize>;
+  std::cout << nMsgs << " messages, " << bytes.size() << " bytes, "
+            << ringSize << " byte ring buffer\n";
+  {
+    auto mockSocket = FIXmockSocket::fixMockSocket(tuples);
+    report<singleHandler>("mock socket, readNextMessage", mockSocket, 1);
+  }
+  for (std::uint32_t batchSize : {1, 16, 256}) {
+    auto mockSocket = FIXmockSocket::fixMockSocket(tuples);
+    report<bulkHandler>(
+        "mock socket, readMessages, " + std::to_string(batchSize) +
+            " per call",
+        mockSocket, batchSize);
+  }
+  profileSocketPair<singlePosixHandler>("socket pair, readNextMessage", bytes,
+                                        MSG_WAITALL, 1);
+  for (std::uint32_t batchSize : {1, 16, 256}) {
+    profileSocketPair<bulkPosixHandler>(
+        "socket pair, readMessages, " + std::to_string(batchSize) +
+            " per call",
+        bytes, 0, batchSize);
+  }
+}
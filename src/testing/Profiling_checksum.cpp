@@ -0,0 +1,93 @@
+// compares the versions of the byte sum behind checksum validation for
+// messages of 10 bytes to 4 KB, prints cycles (time stamp counter) and
+// nanoseconds per message for
+// - the scalar loop, equivalent to the std::accumulate used before
+// - SSE2 (psadbw over 16 bytes) and AVX2 (32 bytes) if supported
+// - byteSumFixed, the sequence of loads for a length known at compile time
+//   used for the message types of the socket handler
+// messages are spread over a buffer larger than the L1 cache
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include "Checksum.hpp"
+
+static constexpr std::uint32_t nMsgs = 1000000;
+static constexpr std::uint32_t bufferSize = 1 << 20;
+
+std::uint64_t cycles() noexcept {
+#if defined(__x86_64__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+// sums nMsgs messages of length len starting at pseudo random offsets,
+// prints cost per message and the sum of all sums as checksum
+template <typename funcType>
+void profile(const std::string& label, const std::vector<std::uint8_t>& bytes,
+             const std::vector<std::uint32_t>& offsets, std::uint32_t len,
+             funcType&& func) {
+  std::uint64_t checkSum = 0;
+  const auto startTime = std::chrono::high_resolution_clock::now();
+  const std::uint64_t startCycles = cycles();
+  for (std::uint32_t i = 0; i < nMsgs; ++i) {
+    checkSum += func(&bytes[offsets[i % offsets.size()] % (bufferSize - len)],
+                     len);
+  }
+  const std::uint64_t totalCycles = cycles() - startCycles;
+  const double nanoseconds =
+      std::chrono::duration<double, std::nano>(
+          std::chrono::high_resolution_clock::now() - startTime)
+          .count();
+  std::cout << "  " << label << ": "
+            << static_cast<double>(totalCycles) / nMsgs << " cycles, "
+            << nanoseconds / nMsgs << " ns per message (checksum " << checkSum
+            << ")" << std::endl;
+}
+
+// runs every version for messages of length len_
+template <std::uint32_t len_>
+void profileLength(const std::vector<std::uint8_t>& bytes,
+                   const std::vector<std::uint32_t>& offsets) {
+  std::cout << len_ << " bytes:\n";
+  profile("scalar", bytes, offsets, len_, Checksum::byteSumScalar);
+#if defined(__x86_64__)
+  profile("SSE2", bytes, offsets, len_, Checksum::byteSumSSE2);
+  __builtin_cpu_supports("avx2")
+      ? profile("AVX2", bytes, offsets, len_, Checksum::byteSumAVX2)
+      : void();
+#endif
+  profile("runtime dispatch", bytes, offsets, len_, Checksum::byteSum);
+  profile("fixed length", bytes, offsets, len_,
+          [](const std::uint8_t* msg, std::uint32_t) {
+            return Checksum::byteSumFixed<len_>(msg);
+          });
+}
+
+int main() {
+  std::srand(42);
+  std::vector<std::uint8_t> bytes(bufferSize);
+  for (auto& byte : bytes) {
+    byte = std::rand() % 256;
+  }
+  std::vector<std::uint32_t> offsets(4096);
+  for (auto& offset : offsets) {
+    offset = std::rand();
+  }
+  // 10, 14, 15, 22 and 23 bytes: the message types of FIXmsgClasses without
+  // their trailer
+  [&]<std::uint32_t... lens>(std::integer_sequence<std::uint32_t, lens...>) {
+    (profileLength<lens>(bytes, offsets), ...);
+  }(std::integer_sequence<std::uint32_t, 10, 13, 14, 15, 22, 23, 32, 64, 128,
+                          256, 1024, 4096>());
+}
@@ -0,0 +1,158 @@
+// compares building a 10 level ladder per side via orderBook::depthSnapshot
+// and via looping over orderBook::volumeAtPrice, both on a quiescent book and
+// while a writer thread keeps processing orders
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "FIXSocketHandler.hpp"
+#include "FIXmockSocket.hpp"
+#include "FIXmsgClasses.hpp"
+#include "FileToTuples.hpp"
+#include "OrderBook.hpp"
+
+using lineTuple = std::tuple<std::uint8_t, std::int32_t, std::uint32_t>;
+using msgClassVar =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+using ordBook =
+    OrderBook::orderBook<msgClassVar, std::int64_t, 6000, false, 0, 1, 2>;
+using level = ordBook::level;
+using sockHandler =
+    FIXSocketHandler::fixSocketHandler<msgClassVar,
+                                       FIXmockSocket::fixMockSocket>;
+static constexpr std::uint32_t nLevels = 10;
+static constexpr std::uint32_t basePrice = 7000;
+static constexpr auto measuringPeriod = std::chrono::milliseconds(500);
+
+// decode all messages up front so only the order book is being measured
+std::vector<msgClassVar> readMessages(const std::string& csvPath) {
+  auto tupleVec = FileToTuples::fileToTuples<lineTuple>(csvPath);
+  auto mockSock = FIXmockSocket::fixMockSocket(tupleVec, nullptr);
+  auto sHandler = sockHandler(&mockSock);
+  std::vector<msgClassVar> ret;
+  ret.reserve(tupleVec.size());
+  for (std::size_t i = 0; i < tupleVec.size(); ++i) {
+    ret.push_back(sHandler.readNextMessage().value());
+  }
+  return ret;
+}
+
+void pinThread(int coreIndex) {
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(coreIndex, &cpuSet);
+  int setAffRet =
+      pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+  if (setAffRet != 0) {
+    std::cout << "setting up CPU-affinity failed. teminating."
+              << "\n";
+    std::terminate();
+  }
+}
+
+// one seqlock round trip per price, levels may stem from different states of
+// the book
+std::uint32_t ladderViaVolumeAtPrice(const ordBook& book,
+                                     std::span<level> bids,
+                                     std::span<level> asks) {
+  const auto [bestBid, bestOffer] = book.bestBidAsk();
+  std::uint32_t nBids{0}, nAsks{0};
+  for (std::int64_t price = bestBid.has_value()
+                                ? static_cast<std::int64_t>(bestBid.value())
+                                : -1;
+       price >= basePrice && nBids < bids.size(); --price) {
+    const auto volume = book.volumeAtPrice(price);
+    bids[nBids] = level{static_cast<std::uint32_t>(price), volume};
+    nBids += volume != 0;
+  }
+  for (std::uint32_t price = bestOffer.value_or(basePrice + 6001);
+       price <= basePrice + 6000 && nAsks < asks.size(); ++price) {
+    const auto volume = book.volumeAtPrice(price);
+    asks[nAsks] = level{price, volume};
+    nAsks += volume != 0;
+  }
+  return nBids + nAsks;
+}
+
+template <bool snapshot>
+void profileLadder(const std::vector<msgClassVar>& msgs, bool concurrentWriter,
+                   const std::string& label) {
+  auto book = std::make_unique<ordBook>(basePrice);
+  // fill book with first half of the messages, writer keeps processing the
+  // second half in a loop
+  const std::size_t half = msgs.size() / 2;
+  for (std::size_t i = 0; i < half; ++i) {
+    book->processOrder(msgs[i]);
+  }
+  std::atomic<bool> startSignal{false}, stopSignal{false};
+  std::thread writer;
+  if (concurrentWriter) {
+    writer = std::thread([&]() {
+      pinThread(1 % std::thread::hardware_concurrency());
+      while (!startSignal.load(std::memory_order_acquire)) {
+      };
+      for (std::size_t i = half; !stopSignal.load(std::memory_order_relaxed);
+           i = i + 1 < msgs.size() ? i + 1 : half) {
+        book->processOrder(msgs[i]);
+      }
+    });
+  }
+  pinThread(0);
+  std::array<level, nLevels> bids, asks;
+  std::uint64_t nLadders{0}, levelSum{0}, retrySum{0};
+  startSignal.store(true, std::memory_order_release);
+  const auto startTime = std::chrono::high_resolution_clock::now();
+  auto now = startTime;
+  while (now - startTime < measuringPeriod) {
+    // check clock every 1024 ladders only
+    for (int i = 0; i < 1024; ++i) {
+      if constexpr (snapshot) {
+        const auto [nBids, nAsks, retries] = book->depthSnapshot(bids, asks);
+        levelSum += nBids + nAsks;
+        retrySum += retries;
+      } else {
+        levelSum += ladderViaVolumeAtPrice(*book, bids, asks);
+      }
+    }
+    nLadders += 1024;
+    now = std::chrono::high_resolution_clock::now();
+  }
+  stopSignal.store(true, std::memory_order_relaxed);
+  concurrentWriter ? writer.join() : void();
+  const double nanoseconds = static_cast<double>(
+      duration_cast<std::chrono::nanoseconds>(now - startTime).count());
+  std::cout << label << ": " << nanoseconds / nLadders << " ns per ladder, "
+            << static_cast<double>(levelSum) / nLadders << " levels, "
+            << static_cast<double>(retrySum) / nLadders
+            << " retries per ladder\n";
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cout << "usage: profiling_depthSnapshot <csv>"
+              << "\n";
+    return 1;
+  }
+  const auto msgs = readMessages(argv[1]);
+  for (bool concurrentWriter : {false, true}) {
+    std::cout << (concurrentWriter ? "concurrent writer\n" : "no writer\n");
+    profileLadder<true>(msgs, concurrentWriter, "  depthSnapshot");
+    profileLadder<false>(msgs, concurrentWriter, "  volumeAtPrice loop");
+  }
+}
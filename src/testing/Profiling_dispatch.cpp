@@ -0,0 +1,140 @@
+// reports time stamp counter cycles per message for every type of message
+// when dispatching via DispatchPolicy::runAll, via DispatchPolicy::jumpTable
+// and when calling the typed entry points of the order book directly
+#include <pthread.h>
+#include <sched.h>
+#include <x86intrin.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "DispatchPolicy.hpp"
+#include "FIXSocketHandler.hpp"
+#include "FIXmockSocket.hpp"
+#include "FIXmsgClasses.hpp"
+#include "FileToTuples.hpp"
+#include "OrderBook.hpp"
+
+using lineTuple = std::tuple<std::uint8_t, std::int32_t, std::uint32_t>;
+using msgClassVar =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+template <typename dispatchPolicy>
+using ordBook =
+    OrderBook::orderBook<msgClassVar, std::int64_t, 6000, false, 0, 1, 2, true,
+                         OrderBookStorage::denseStorage,
+                         RecenterPolicy::noRecentering, 0, dispatchPolicy>;
+using sockHandler =
+    FIXSocketHandler::fixSocketHandler<msgClassVar,
+                                       FIXmockSocket::fixMockSocket>;
+static constexpr std::array<const char*, 3> msgTypeNames{
+    "add limit order", "withdraw limit order", "market order"};
+
+// decode all messages up front so only the order book is being measured
+std::vector<msgClassVar> readMessages(const std::string& csvPath) {
+  auto tupleVec = FileToTuples::fileToTuples<lineTuple>(csvPath);
+  auto mockSock = FIXmockSocket::fixMockSocket(tupleVec, nullptr);
+  auto sHandler = sockHandler(&mockSock);
+  std::vector<msgClassVar> ret;
+  ret.reserve(tupleVec.size());
+  for (std::size_t i = 0; i < tupleVec.size(); ++i) {
+    ret.push_back(sHandler.readNextMessage().value());
+  }
+  return ret;
+}
+
+// typedEntry: call addLimit/withdrawLimit/marketOrder instead of processOrder
+template <typename dispatchPolicy, bool typedEntry>
+void profileDispatch(const std::vector<msgClassVar>& msgs,
+                     const std::string& label) {
+  auto book = ordBook<dispatchPolicy>(7000);
+  std::array<std::vector<double>, 3> cycles;
+  std::int64_t checkSum{0};
+  for (const auto& msg : msgs) {
+    std::uint64_t startCycles, completionCycles;
+    if constexpr (typedEntry) {
+      // type is resolved before starting to count
+      std::visit(
+          [&](const auto& order) {
+            using orderType = std::decay_t<decltype(order)>;
+            startCycles = __rdtsc();
+            if constexpr (std::is_same_v<orderType,
+                                         FIXmsgClasses::addLimitOrder>) {
+              checkSum += std::get<1>(book.addLimit(order));
+            } else if constexpr (std::is_same_v<
+                                     orderType,
+                                     FIXmsgClasses::withdrawLimitOrder>) {
+              checkSum += std::get<1>(book.withdrawLimit(order));
+            } else {
+              checkSum += std::get<1>(book.marketOrder(order));
+            }
+            completionCycles = __rdtsc();
+          },
+          msg);
+    } else {
+      startCycles = __rdtsc();
+      checkSum += std::get<1>(book.processOrder(msg));
+      completionCycles = __rdtsc();
+    }
+    cycles[msg.index()].push_back(
+        static_cast<double>(completionCycles - startCycles));
+  }
+  std::cout << label << " (checksum " << checkSum << ")\n";
+  for (std::size_t i = 0; i < cycles.size(); ++i) {
+    auto& typeCycles = cycles[i];
+    std::ranges::sort(typeCycles);
+    const double mean =
+        std::accumulate(typeCycles.begin(), typeCycles.end(), 0.0) /
+        typeCycles.size();
+    std::cout << "  " << msgTypeNames[i] << ": mean " << mean
+              << ", median " << typeCycles[typeCycles.size() / 2]
+              << ", 0.99 quantile " << typeCycles[typeCycles.size() * 99 / 100]
+              << "\n";
+  }
+}
+
+int main(int argc, char* argv[]) {
+  // process and validate command line arguments
+  if (argc < 2) {
+    std::cout << "usage: profiling_dispatch <csv> [core index]"
+              << "\n";
+    return 1;
+  }
+  if (argc == 3) {
+    int nCores = std::thread::hardware_concurrency();
+    int coreIndex = std::atoi(argv[2]);
+    bool invalidIndex = coreIndex < 0 || coreIndex > nCores;
+    if (invalidIndex) {
+      std::cout << "invalid CPU-index argument. teminating."
+                << "\n";
+      std::terminate();
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(coreIndex, &cpuSet);
+    int setAffRet =
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+    if (setAffRet != 0) {
+      std::cout << "setting up CPU-affinity failed. teminating."
+                << "\n";
+      std::terminate();
+    }
+  }
+  // cycles as counted by the time stamp counter, including the overhead of
+  // reading it
+  const auto msgs = readMessages(argv[1]);
+  profileDispatch<DispatchPolicy::runAll, false>(msgs, "runAll");
+  profileDispatch<DispatchPolicy::jumpTable, false>(msgs, "jumpTable");
+  profileDispatch<DispatchPolicy::runAll, true>(msgs, "typed entry points");
+}
@@ -0,0 +1,142 @@
+// measures what reporting fills adds to the write path of the order book: no
+// fill sink at all (dense storage, sweeps may use SweepKernel), sink type set
+// but nobody subscribed, records written to a buffer cleared after every
+// order, records pushed onto a Queue::SeqLockQueue
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "FIXmsgClasses.hpp"
+#include "FillSink.hpp"
+#include "OrderBook.hpp"
+#include "Queue.hpp"
+
+using msgClassVar =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+using recordType = FillSink::fillRecord<std::int64_t>;
+using seqLockQueue = Queue::SeqLockQueue<recordType, 65536, false, false>;
+using bufferSink = FillSink::bufferSink<std::int64_t>;
+using queueSink = FillSink::queueSink<std::int64_t, seqLockQueue>;
+static constexpr std::uint32_t nTicks = 5000;
+static constexpr std::uint32_t nMsgs = 2000000;
+template <typename sink>
+using ordBook =
+    OrderBook::orderBook<msgClassVar, std::int64_t, nTicks, false, 0, 1, 2,
+                         true, OrderBookStorage::denseStorage,
+                         RecenterPolicy::noRecentering, 0,
+                         DispatchPolicy::runAll, false, sink>;
+
+// orders within 100 ticks of a wandering mid price, one in ten is a market
+// order large enough to take out several levels
+std::vector<msgClassVar> generateMessages() {
+  std::int64_t mid = nTicks / 2;
+  std::vector<msgClassVar> ret;
+  ret.reserve(nMsgs);
+  for (std::uint32_t i = 0; i < nMsgs; ++i) {
+    mid = std::clamp<std::int64_t>(mid + std::rand() % 3 - 1, 500,
+                                   nTicks - 500);
+    const bool bid = std::rand() % 2;
+    const std::int32_t volume = (1 + std::rand() % 50) * (bid ? -1 : 1);
+    const std::int64_t distance = 1 + std::rand() % 100;
+    const std::uint32_t price = mid + (bid ? -distance : distance);
+    const int msgType = std::rand() % 100;
+    msgType < 60   ? ret.push_back(FIXmsgClasses::addLimitOrder(volume, price))
+    : msgType < 90 ? ret.push_back(
+                         FIXmsgClasses::withdrawLimitOrder(volume, price))
+                   : ret.push_back(FIXmsgClasses::marketOrder(-4 * volume));
+  }
+  return ret;
+}
+
+// returns mean latency in nanoseconds per message
+template <typename bookType, typename funcType>
+double profileBook(bookType& book, const std::vector<msgClassVar>& msgs,
+                   funcType&& afterOrder, const std::string& label) {
+  std::vector<double> latencies(msgs.size(), 0.0);
+  std::int64_t checkSum{0};
+  for (std::size_t i = 0; i < msgs.size(); ++i) {
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    checkSum += std::get<1>(book.processOrder(msgs[i]));
+    afterOrder();
+    const auto completionTime = std::chrono::high_resolution_clock::now();
+    latencies[i] = static_cast<double>(
+        duration_cast<std::chrono::nanoseconds>(completionTime - startTime)
+            .count());
+  }
+  std::ranges::sort(latencies);
+  const double mean =
+      std::accumulate(latencies.begin(), latencies.end(), 0.0) /
+      latencies.size();
+  std::cout << label << ": latency mean " << mean << ", 0.99 quantile "
+            << latencies[latencies.size() * 99 / 100] << ", 0.999 quantile "
+            << latencies[latencies.size() * 999 / 1000] << " (checksum "
+            << checkSum << ")\n";
+  return mean;
+}
+
+int main(int argc, char* argv[]) {
+  // process and validate command line arguments
+  if (argc == 2) {
+    int nCores = std::thread::hardware_concurrency();
+    int coreIndex = std::atoi(argv[1]);
+    bool invalidIndex = coreIndex < 0 || coreIndex > nCores;
+    if (invalidIndex) {
+      std::cout << "invalid CPU-index argument. teminating."
+                << "\n";
+      std::terminate();
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(coreIndex, &cpuSet);
+    int setAffRet =
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+    if (setAffRet != 0) {
+      std::cout << "setting up CPU-affinity failed. teminating."
+                << "\n";
+      std::terminate();
+    }
+  }
+  // fixed seed, every configuration processes identical messages on its own
+  // book
+  std::srand(42);
+  const auto msgs = generateMessages();
+  auto plainBook = std::make_unique<ordBook<FillSink::noFills>>(0);
+  const double plain =
+      profileBook(*plainBook, msgs, [] {}, "no fill sink");
+  auto unsubscribedBook = std::make_unique<ordBook<bufferSink>>(0);
+  const double unsubscribed = profileBook(
+      *unsubscribedBook, msgs, [] {}, "fill sink type, no subscriber");
+  // buffer large enough for every sweep, consumer reads the records in place
+  std::vector<recordType> buffer(nTicks);
+  auto bSink = bufferSink(buffer);
+  auto bufferBook = std::make_unique<ordBook<bufferSink>>(0);
+  bufferBook->subscribeFills(&bSink);
+  const double buffered = profileBook(
+      *bufferBook, msgs, [&] { bSink.clear(); }, "fills written to buffer");
+  auto slq = std::make_unique<seqLockQueue>();
+  auto qSink = queueSink(slq.get());
+  auto queueBook = std::make_unique<ordBook<queueSink>>(0);
+  queueBook->subscribeFills(&qSink);
+  const double queued = profileBook(*queueBook, msgs, [] {},
+                                    "fills pushed onto SeqLockQueue");
+  std::cout << "added by sink type: " << unsubscribed - plain
+            << ", by buffer subscriber: " << buffered - plain
+            << ", by queue subscriber: " << queued - plain << " ("
+            << static_cast<double>(qSink.lastSequence()) / msgs.size()
+            << " records per message, " << bSink.droppedCount()
+            << " dropped)\n";
+}
@@ -0,0 +1,133 @@
+// measures what journaling adds per message when reading messages from a mock
+// socket and processing them in an order book, then replays the journal into a
+// fresh book at full speed and reports replay throughput
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "FIXSocketHandler.hpp"
+#include "FIXmockSocket.hpp"
+#include "FIXmsgClasses.hpp"
+#include "FileToTuples.hpp"
+#include "Journal.hpp"
+#include "OrderBook.hpp"
+
+using lineTuple = std::tuple<std::uint8_t, std::int32_t, std::uint32_t>;
+using msgClassVar =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+using ordBook =
+    OrderBook::orderBook<msgClassVar, std::int64_t, 6000, false, 0, 1, 2>;
+using sockHandler =
+    FIXSocketHandler::fixSocketHandler<msgClassVar,
+                                       FIXmockSocket::fixMockSocket>;
+
+// reads and processes every message of the CSV via the stage passed (handler
+// or journaling stage), returns mean latency in nanoseconds
+template <typename stageType>
+double profile(stageType& stage, std::size_t nMsgs, const std::string& label) {
+  auto book = ordBook(7000);
+  std::vector<double> latencies(nMsgs);
+  std::int64_t checkSum{0};
+  for (std::size_t i = 0; i < nMsgs; ++i) {
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    const auto msg = stage.readNextMessage();
+    checkSum += msg.has_value() ? std::get<1>(book.processOrder(msg.value()))
+                                : 0;
+    const auto completionTime = std::chrono::high_resolution_clock::now();
+    latencies[i] = static_cast<double>(
+        duration_cast<std::chrono::nanoseconds>(completionTime - startTime)
+            .count());
+  }
+  std::ranges::sort(latencies);
+  const double mean =
+      std::accumulate(latencies.begin(), latencies.end(), 0.0) / nMsgs;
+  std::cout << label << ": latency mean " << mean << ", 0.99 quantile "
+            << latencies[nMsgs * 99 / 100] << ", 0.999 quantile "
+            << latencies[nMsgs * 999 / 1000] << " (checksum " << checkSum
+            << ")\n";
+  return mean;
+}
+
+int main(int argc, char* argv[]) {
+  // process and validate command line arguments
+  if (argc != 2 && argc != 3) {
+    std::cout << "usage: profiling_journal <csv> [core index]"
+              << "\n";
+    return 1;
+  }
+  if (argc == 3) {
+    int nCores = std::thread::hardware_concurrency();
+    int coreIndex = std::atoi(argv[2]);
+    bool invalidIndex = coreIndex < 0 || coreIndex > nCores;
+    if (invalidIndex) {
+      std::cout << "invalid CPU-index argument. teminating."
+                << "\n";
+      std::terminate();
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(coreIndex, &cpuSet);
+    int setAffRet =
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+    if (setAffRet != 0) {
+      std::cout << "setting up CPU-affinity failed. teminating."
+                << "\n";
+      std::terminate();
+    }
+  }
+  const auto tupleVec = FileToTuples::fileToTuples<lineTuple>(argv[1]);
+  const std::string dir =
+      (std::filesystem::temp_directory_path() / "profiling_journal").string();
+  std::filesystem::remove_all(dir);
+
+  // latencies in nanoseconds per message, from start of read until the book
+  // has processed the message
+  auto plainSocket = FIXmockSocket::fixMockSocket(tupleVec, nullptr);
+  auto plainHandler = sockHandler(&plainSocket);
+  const double plain = profile(plainHandler, tupleVec.size(), "no journal");
+  auto journaledSocket = FIXmockSocket::fixMockSocket(tupleVec, nullptr);
+  auto journaledHandler = sockHandler(&journaledSocket);
+  double journaled = 0;
+  {
+    auto writer = Journal::journalWriter(dir.c_str());
+    if (!writer.valid()) {
+      std::cout << "mapping journal segments failed. teminating."
+                << "\n";
+      std::terminate();
+    }
+    auto stage = Journal::journalingStage(&journaledHandler, &writer);
+    journaled = profile(stage, tupleVec.size(), "journaled");
+    std::cout << "added by journaling: " << journaled - plain << " ns ("
+              << writer.lastSequence() << " records, "
+              << writer.rolloverWaits() << " rollovers waiting)\n";
+  }
+
+  // replay journal into a fresh book
+  auto book = ordBook(7000);
+  const auto startTime = std::chrono::high_resolution_clock::now();
+  const std::uint64_t nReplayed = Journal::replay(dir.c_str(), book);
+  const double seconds =
+      static_cast<double>(duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::high_resolution_clock::now() -
+                              startTime)
+                              .count()) /
+      1e9;
+  std::cout << "replayed " << nReplayed << " messages in " << seconds
+            << " s: " << nReplayed / seconds << " messages per second\n";
+  std::filesystem::remove_all(dir);
+}
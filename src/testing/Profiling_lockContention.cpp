@@ -0,0 +1,133 @@
+// measures throughput and latency of 1 to 8 writer threads sharing an order
+// book under every LockPolicy, writer i is pinned to core i modulo the number
+// of cores, a single writer without lock serves as baseline
+// with more writers than cores a preempted lock holder stalls every waiter
+// for whole time slices (the ticket lock hands the lock to waiters in a fixed
+// order and suffers most), the maximum number of writers can thus be lowered
+// via the first argument
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "FIXmsgClasses.hpp"
+#include "LockPolicy.hpp"
+#include "OrderBook.hpp"
+
+using msgClassVar =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+static constexpr std::uint32_t nTicks = 5000;
+static constexpr std::uint32_t msgsPerWriter = 200000;
+template <typename lockPolicy>
+using ordBook =
+    OrderBook::orderBook<msgClassVar, std::int64_t, nTicks, false, 0, 1, 2,
+                         true, OrderBookStorage::denseStorage,
+                         RecenterPolicy::noRecentering, 0,
+                         DispatchPolicy::runAll, false, FillSink::noFills,
+                         lockPolicy>;
+
+// orders within 100 ticks of the middle of the book, one in ten a market order
+std::vector<msgClassVar> generateMessages() {
+  std::vector<msgClassVar> ret;
+  ret.reserve(msgsPerWriter);
+  for (std::uint32_t i = 0; i < msgsPerWriter; ++i) {
+    const bool bid = std::rand() % 2;
+    const std::int32_t volume = (1 + std::rand() % 50) * (bid ? -1 : 1);
+    const std::int64_t distance = 1 + std::rand() % 100;
+    const std::uint32_t price = nTicks / 2 + (bid ? -distance : distance);
+    const int msgType = std::rand() % 100;
+    msgType < 60   ? ret.push_back(FIXmsgClasses::addLimitOrder(volume, price))
+    : msgType < 90 ? ret.push_back(
+                         FIXmsgClasses::withdrawLimitOrder(volume, price))
+                   : ret.push_back(FIXmsgClasses::marketOrder(-volume));
+  }
+  return ret;
+}
+
+void pinToCore(int coreIndex) {
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(coreIndex, &cpuSet);
+  int setAffRet =
+      pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+  if (setAffRet != 0) {
+    std::cout << "setting up CPU-affinity failed. teminating."
+              << "\n";
+    std::terminate();
+  }
+}
+
+// every writer processes all messages on the shared book, writers start
+// together once all of them are pinned
+template <typename lockPolicy>
+void profile(const std::vector<msgClassVar>& msgs, std::uint32_t nWriters,
+             const std::string& label) {
+  const int nCores = std::thread::hardware_concurrency();
+  auto book = std::make_unique<ordBook<lockPolicy>>(0);
+  std::vector<std::vector<double>> latencies(
+      nWriters, std::vector<double>(msgs.size()));
+  std::atomic<std::uint32_t> nReady = 0;
+  const auto startTime = std::chrono::high_resolution_clock::now();
+  {
+    std::vector<std::jthread> writers;
+    for (std::uint32_t w = 0; w < nWriters; ++w) {
+      writers.emplace_back([&, w] {
+        pinToCore(w % nCores);
+        nReady.fetch_add(1);
+        while (nReady.load() < nWriters) {
+          std::this_thread::yield();
+        }
+        for (std::size_t i = 0; i < msgs.size(); ++i) {
+          const auto before = std::chrono::high_resolution_clock::now();
+          book->processOrder(msgs[i]);
+          latencies[w][i] = static_cast<double>(
+              duration_cast<std::chrono::nanoseconds>(
+                  std::chrono::high_resolution_clock::now() - before)
+                  .count());
+        }
+      });
+    }
+  }
+  const double seconds =
+      static_cast<double>(duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::high_resolution_clock::now() -
+                              startTime)
+                              .count()) /
+      1e9;
+  std::vector<double> all;
+  for (auto& writerLatencies : latencies) {
+    all.insert(all.end(), writerLatencies.begin(), writerLatencies.end());
+  }
+  std::ranges::sort(all);
+  std::cout << label << ", " << nWriters << " writers: "
+            << all.size() / seconds << " orders per second, latency mean "
+            << std::accumulate(all.begin(), all.end(), 0.0) / all.size()
+            << ", 0.99 quantile " << all[all.size() * 99 / 100]
+            << ", 0.999 quantile " << all[all.size() * 999 / 1000]
+            << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  const std::uint32_t maxWriters = argc == 2 ? std::atoi(argv[1]) : 8;
+  // fixed seed, every configuration processes identical messages
+  std::srand(42);
+  const auto msgs = generateMessages();
+  profile<LockPolicy::noLock>(msgs, 1, "noLock");
+  for (std::uint32_t nWriters = 1; nWriters <= maxWriters; ++nWriters) {
+    profile<LockPolicy::flagSpin>(msgs, nWriters, "flagSpin");
+    profile<LockPolicy::ticketLock>(msgs, nWriters, "ticketLock");
+    profile<LockPolicy::backoffLock<>>(msgs, nWriters, "backoffLock");
+  }
+}
@@ -0,0 +1,152 @@
+// measures what tracking changed price levels adds to the write path of the
+// order book, and what publishing them as delta records onto a
+// Queue::SeqLockQueue after every order adds on top of that
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "FIXSocketHandler.hpp"
+#include "FIXmockSocket.hpp"
+#include "FIXmsgClasses.hpp"
+#include "FileToTuples.hpp"
+#include "MBPPublisher.hpp"
+#include "OrderBook.hpp"
+#include "Queue.hpp"
+
+using lineTuple = std::tuple<std::uint8_t, std::int32_t, std::uint32_t>;
+using msgClassVar =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+template <bool trackChanges>
+using ordBook =
+    OrderBook::orderBook<msgClassVar, std::int64_t, 6000, false, 0, 1, 2, true,
+                         OrderBookStorage::denseStorage,
+                         RecenterPolicy::noRecentering, 0,
+                         DispatchPolicy::runAll, trackChanges>;
+using deltaType = MBPPublisher::mbpDelta<std::int64_t>;
+using seqLockQueue = Queue::SeqLockQueue<deltaType, 65536, false, false>;
+using publisher = MBPPublisher::mbpPublisher<ordBook<true>, seqLockQueue>;
+using sockHandler =
+    FIXSocketHandler::fixSocketHandler<msgClassVar,
+                                       FIXmockSocket::fixMockSocket>;
+
+// decode all messages up front so only the order book is being measured
+std::vector<msgClassVar> readMessages(const std::string& csvPath) {
+  auto tupleVec = FileToTuples::fileToTuples<lineTuple>(csvPath);
+  auto mockSock = FIXmockSocket::fixMockSocket(tupleVec, nullptr);
+  auto sHandler = sockHandler(&mockSock);
+  std::vector<msgClassVar> ret;
+  ret.reserve(tupleVec.size());
+  for (std::size_t i = 0; i < tupleVec.size(); ++i) {
+    ret.push_back(sHandler.readNextMessage().value());
+  }
+  return ret;
+}
+
+// mean over the whole run without timing every message, quantiles from
+// timing every message separately, returns mean
+template <typename funcType>
+double profile(const std::vector<msgClassVar>& msgs, funcType&& processMsg,
+               const std::string& label) {
+  std::int64_t checkSum{0};
+  auto startTime = std::chrono::high_resolution_clock::now();
+  for (const auto& msg : msgs) {
+    checkSum += processMsg(msg);
+  }
+  const double mean =
+      static_cast<double>(duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::high_resolution_clock::now() -
+                              startTime)
+                              .count()) /
+      msgs.size();
+  std::vector<double> latencies(msgs.size());
+  for (std::size_t i = 0; i < msgs.size(); ++i) {
+    startTime = std::chrono::high_resolution_clock::now();
+    checkSum += processMsg(msgs[i]);
+    latencies[i] = static_cast<double>(
+        duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now() - startTime)
+            .count());
+  }
+  std::ranges::sort(latencies);
+  std::cout << label << ": mean " << mean << ", 0.99 quantile "
+            << latencies[latencies.size() * 99 / 100] << ", 0.999 quantile "
+            << latencies[latencies.size() * 999 / 1000] << " (checksum "
+            << checkSum << ")\n";
+  return mean;
+}
+
+int main(int argc, char* argv[]) {
+  // process and validate command line arguments
+  if (argc != 2 && argc != 3) {
+    std::cout << "usage: profiling_mbpPublisher <csv> [core index]"
+              << "\n";
+    return 1;
+  }
+  if (argc == 3) {
+    int nCores = std::thread::hardware_concurrency();
+    int coreIndex = std::atoi(argv[2]);
+    bool invalidIndex = coreIndex < 0 || coreIndex > nCores;
+    if (invalidIndex) {
+      std::cout << "invalid CPU-index argument. teminating."
+                << "\n";
+      std::terminate();
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(coreIndex, &cpuSet);
+    int setAffRet =
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+    if (setAffRet != 0) {
+      std::cout << "setting up CPU-affinity failed. teminating."
+                << "\n";
+      std::terminate();
+    }
+  }
+  const auto msgs = readMessages(argv[1]);
+  // latencies in nanoseconds per message, every configuration processes all
+  // messages twice on its own book
+  auto untrackedBook = ordBook<false>(7000);
+  const double untracked = profile(
+      msgs,
+      [&](const msgClassVar& msg) {
+        return std::get<1>(untrackedBook.processOrder(msg));
+      },
+      "changes not tracked");
+  auto trackedBook = ordBook<true>(7000);
+  const double tracked = profile(
+      msgs,
+      [&](const msgClassVar& msg) {
+        return std::get<1>(trackedBook.processOrder(msg));
+      },
+      "changes tracked");
+  auto publishedBook = ordBook<true>(7000);
+  auto slq = std::make_unique<seqLockQueue>();
+  auto mbpPublisher = publisher(&publishedBook, slq.get());
+  std::uint64_t nRecords{0};
+  const double published = profile(
+      msgs,
+      [&](const msgClassVar& msg) {
+        const auto filled = std::get<1>(publishedBook.processOrder(msg));
+        nRecords += mbpPublisher.publish();
+        return filled;
+      },
+      "changes tracked and published");
+  std::cout << "added by tracking: " << tracked - untracked
+            << ", added by tracking and publishing: " << published - untracked
+            << " (" << static_cast<double>(nRecords) / (2 * msgs.size())
+            << " records per message)\n";
+}
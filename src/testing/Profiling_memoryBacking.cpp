@@ -0,0 +1,178 @@
+// runs the two threaded pipeline of profiling_multithreaded (socket handler
+// and queue on one thread, order book on the other) with default allocations
+// and with socket handler buffer, queue and order book all placed in one
+// hugepage-backed, prefaulted and locked MemoryArena::memoryArena, compares
+// latency spikes of both
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "FIXSocketHandler.hpp"
+#include "FIXmockSocket.hpp"
+#include "FIXmsgClasses.hpp"
+#include "FileToTuples.hpp"
+#include "MemoryArena.hpp"
+#include "OrderBook.hpp"
+#include "Queue.hpp"
+#include "busyWait.hpp"
+
+using lineTuple = std::tuple<std::uint8_t, std::int32_t, std::uint32_t>;
+using msgClassVar =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+static constexpr std::uint32_t twoPow20 = 1048576;
+using ordBook =
+    OrderBook::orderBook<msgClassVar, std::int64_t, 6000, false, 0, 1, 2>;
+using seqLockQueue = Queue::SeqLockQueue<msgClassVar, twoPow20, false, false>;
+using sockHandler =
+    FIXSocketHandler::fixSocketHandler<msgClassVar,
+                                       FIXmockSocket::fixMockSocket>;
+using timePoint = decltype(std::chrono::high_resolution_clock::now());
+static constexpr std::size_t arenaBytes =
+    sockHandler::arenaBytes + ordBook::arenaBytes +
+    MemoryArena::memoryArena::footprint(seqLockQueue::required_alignment,
+                                        seqLockQueue::required_bytes);
+
+void pinThread(int coreIndex) {
+  if (coreIndex < 0) {
+    return;
+  }
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(coreIndex, &cpuSet);
+  int setAffRet =
+      pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+  if (setAffRet != 0) {
+    std::cout << "setting up CPU-affinity failed. teminating."
+              << "\n";
+    std::terminate();
+  }
+}
+
+// arena is nullptr for default allocations
+void profilePipeline(const std::vector<lineTuple>& tupleVec,
+                     MemoryArena::memoryArena* arena, int enqCoreIndex,
+                     int deqCoreIndex, const std::string& label) {
+  const std::size_t nMsgs = tupleVec.size();
+  alignas(64) std::atomic_flag endOfBuffer{false};
+  std::atomic_flag signalFlag{false};
+  std::vector<timePoint> startTimes(nMsgs), completionTimes(nMsgs);
+  auto mockSock = FIXmockSocket::fixMockSocket(tupleVec, &endOfBuffer);
+  auto sHandler = sockHandler(&mockSock, arena);
+  auto book = std::make_unique<ordBook>(7000, arena);
+  auto slq = arena != nullptr
+                 ? std::make_unique<seqLockQueue>(
+                       arena->allocate(seqLockQueue::required_alignment,
+                                       seqLockQueue::required_bytes))
+                 : std::make_unique<seqLockQueue>();
+  auto reader = slq->get_reader();
+
+  std::thread enqThread([&]() {
+    pinThread(enqCoreIndex);
+    signalFlag.test_and_set();
+    while (signalFlag.test()) {
+    };
+    std::size_t index{0};
+    while (!endOfBuffer.test(std::memory_order_acquire)) {
+      const auto startTime = std::chrono::high_resolution_clock::now();
+      slq->enqueue(sHandler.readNextMessage().value());
+      startTimes[index] = startTime;
+      ++index;
+      BusyWait::busyWait(50);
+    }
+  });
+
+  pinThread(deqCoreIndex);
+  while (!signalFlag.test()) {
+  };
+  signalFlag.clear();
+  std::optional<msgClassVar> deqRet;
+  std::size_t index{0};
+  std::int64_t checkSum{0};
+  do {
+    deqRet = reader.read_next_entry();
+    if (deqRet.has_value()) {
+      checkSum += std::get<1>(book->processOrder(deqRet.value()));
+      completionTimes[index] = std::chrono::high_resolution_clock::now();
+      ++index;
+    };
+  } while (
+      !(endOfBuffer.test(std::memory_order_acquire) && !deqRet.has_value()));
+  enqThread.join();
+
+  // latencies in nanoseconds, spikes are latencies above 1 microsecond, their
+  // spacing in messages shows if they recur at a fixed interval
+  std::vector<double> latencies(index);
+  std::vector<std::size_t> spikes;
+  for (std::size_t i = 0; i < index; ++i) {
+    latencies[i] = static_cast<double>(duration_cast<std::chrono::nanoseconds>(
+                                           completionTimes[i] - startTimes[i])
+                                           .count());
+    latencies[i] > 1000 ? spikes.push_back(i) : void();
+  }
+  std::vector<std::size_t> spacing(spikes.size());
+  std::adjacent_difference(spikes.begin(), spikes.end(), spacing.begin());
+  std::ranges::sort(spacing);
+  const double mean =
+      std::accumulate(latencies.begin(), latencies.end(), 0.0) / index;
+  std::ranges::sort(latencies);
+  std::cout << label << ": mean " << mean << ", 0.99 quantile "
+            << latencies[index * 99 / 100] << ", max " << latencies.back()
+            << ", outcomes > 1 microsecond " << spikes.size()
+            << ", median messages between them "
+            << (spacing.empty() ? 0 : spacing[spacing.size() / 2])
+            << " (checksum " << checkSum << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+  // process and validate command line arguments
+  if (argc != 2 && argc != 4 && argc != 5) {
+    std::cout << "usage: profiling_memoryBacking <csv> [enqueue core index "
+                 "dequeue core index [NUMA node]]"
+              << "\n";
+    return 1;
+  }
+  int enqCoreIndex = -1;
+  int deqCoreIndex = -1;
+  MemoryArena::arenaOptions options;
+  if (argc >= 4) {
+    int nCores = std::thread::hardware_concurrency();
+    enqCoreIndex = std::atoi(argv[2]);
+    deqCoreIndex = std::atoi(argv[3]);
+    bool invalidIndex = enqCoreIndex < 0 || enqCoreIndex > nCores ||
+                        deqCoreIndex < 0 || deqCoreIndex > nCores;
+    if (invalidIndex) {
+      std::cout << "invalid CPU-index argument. teminating."
+                << "\n";
+      std::terminate();
+    }
+  }
+  if (argc == 5) {
+    options.numaNode = std::atoi(argv[4]);
+  }
+  const auto tupleVec = FileToTuples::fileToTuples<lineTuple>(argv[1]);
+  profilePipeline(tupleVec, nullptr, enqCoreIndex, deqCoreIndex,
+                  "default allocations");
+  auto arena = MemoryArena::memoryArena(arenaBytes, options);
+  std::cout << "arena of " << arena.capacity() / 1024 / 1024
+            << " MiB: explicit huge pages " << arena.hugeTLB()
+            << ", bound to NUMA node " << arena.numaBound() << ", locked "
+            << arena.locked() << "\n";
+  profilePipeline(tupleVec, &arena, enqCoreIndex, deqCoreIndex,
+                  "single arena");
+}
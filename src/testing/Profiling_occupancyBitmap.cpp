@@ -0,0 +1,109 @@
+// compares order book latencies when searching for liquid buckets via
+// occupancy bitmaps and via linear scan over the price buckets
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "FIXSocketHandler.hpp"
+#include "FIXmockSocket.hpp"
+#include "FIXmsgClasses.hpp"
+#include "FileToTuples.hpp"
+#include "OrderBook.hpp"
+
+using lineTuple = std::tuple<std::uint8_t, std::int32_t, std::uint32_t>;
+using msgClassVar =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+using bitmapBook =
+    OrderBook::orderBook<msgClassVar, std::int64_t, 6000, false, 0, 1, 2, true>;
+using linearBook = OrderBook::orderBook<msgClassVar, std::int64_t, 6000, false,
+                                        0, 1, 2, false>;
+using sockHandler =
+    FIXSocketHandler::fixSocketHandler<msgClassVar,
+                                       FIXmockSocket::fixMockSocket>;
+
+// decode all messages up front so only the order book is being measured
+std::vector<msgClassVar> readMessages(const std::string& csvPath) {
+  auto tupleVec = FileToTuples::fileToTuples<lineTuple>(csvPath);
+  auto mockSock = FIXmockSocket::fixMockSocket(tupleVec, nullptr);
+  auto sHandler = sockHandler(&mockSock);
+  std::vector<msgClassVar> ret;
+  ret.reserve(tupleVec.size());
+  for (std::size_t i = 0; i < tupleVec.size(); ++i) {
+    ret.push_back(sHandler.readNextMessage().value());
+  }
+  return ret;
+}
+
+template <typename bookType>
+void profileBook(const std::vector<msgClassVar>& msgs,
+                 const std::string& label) {
+  auto book = bookType(7000);
+  std::vector<double> latencies(msgs.size());
+  std::int64_t checkSum{0};
+  for (std::size_t i = 0; i < msgs.size(); ++i) {
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    checkSum += std::get<1>(book.processOrder(msgs[i]));
+    const auto completionTime = std::chrono::high_resolution_clock::now();
+    latencies[i] = static_cast<double>(
+        duration_cast<std::chrono::nanoseconds>(completionTime - startTime)
+            .count());
+  }
+  std::ranges::sort(latencies);
+  const double mean =
+      std::accumulate(latencies.begin(), latencies.end(), 0.0) /
+      latencies.size();
+  std::cout << label << ": mean " << mean << ", 0.99 quantile "
+            << latencies[latencies.size() * 99 / 100] << ", max "
+            << latencies.back() << " (checksum " << checkSum << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+  // process and validate command line arguments
+  if (argc < 3) {
+    std::cout << "usage: profiling_occupancy_bitmap <erratic csv> "
+                 "<random walk csv> [core index]"
+              << "\n";
+    return 1;
+  }
+  if (argc == 4) {
+    int nCores = std::thread::hardware_concurrency();
+    int coreIndex = std::atoi(argv[3]);
+    bool invalidIndex = coreIndex < 0 || coreIndex > nCores;
+    if (invalidIndex) {
+      std::cout << "invalid CPU-index argument. teminating."
+                << "\n";
+      std::terminate();
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(coreIndex, &cpuSet);
+    int setAffRet =
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+    if (setAffRet != 0) {
+      std::cout << "setting up CPU-affinity failed. teminating."
+                << "\n";
+      std::terminate();
+    }
+  }
+  // latencies in nanoseconds per message
+  for (int i = 1; i < 3; ++i) {
+    const auto msgs = readMessages(argv[i]);
+    std::cout << argv[i] << "\n";
+    profileBook<linearBook>(msgs, "  linear scan");
+    profileBook<bitmapBook>(msgs, "  occupancy bitmap");
+  }
+}
@@ -0,0 +1,133 @@
+// compares an order book covering 1000000 ticks with dense storage and with
+// paged storage, reports memory reserved, memory actually touched (resident
+// set growth) and latencies for orders placed around a wandering mid price
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "FIXmsgClasses.hpp"
+#include "OrderBook.hpp"
+#include "OrderBookStorage.hpp"
+
+using msgClassVar =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+static constexpr std::uint32_t nTicks = 1000000;
+static constexpr std::uint32_t nMsgs = 1000000;
+template <typename bucketType, std::uint32_t length>
+using pagedStorage =
+    OrderBookStorage::pagedStorage<bucketType, length, 256, 256>;
+template <template <typename, std::uint32_t> class storage>
+using ordBook = OrderBook::orderBook<msgClassVar, std::int64_t, nTicks, false,
+                                     0, 1, 2, true, storage>;
+
+// random walk of the mid price across the whole range, orders are placed
+// within 200 ticks of the mid, generated up front so only the book is being
+// measured
+std::vector<msgClassVar> generateMessages() {
+  std::int64_t mid = nTicks / 2;
+  std::vector<msgClassVar> ret;
+  ret.reserve(nMsgs);
+  for (std::uint32_t i = 0; i < nMsgs; ++i) {
+    mid = std::clamp<std::int64_t>(mid + std::rand() % 5 - 2, 1000,
+                                   nTicks - 1000);
+    const bool bid = std::rand() % 2;
+    const std::int32_t volume = (1 + std::rand() % 50) * (bid ? -1 : 1);
+    const std::int64_t distance = 1 + std::rand() % 200;
+    const std::uint32_t price = mid + (bid ? -distance : distance);
+    const int msgType = std::rand() % 100;
+    msgType < 50   ? ret.push_back(FIXmsgClasses::addLimitOrder(volume, price))
+    : msgType < 90 ? ret.push_back(
+                         FIXmsgClasses::withdrawLimitOrder(volume, price))
+                   : ret.push_back(FIXmsgClasses::marketOrder(-volume));
+  }
+  return ret;
+}
+
+// resident set size in KiB as reported by the kernel
+std::size_t residentKiB() {
+  std::ifstream statm("/proc/self/statm");
+  std::size_t total{0}, resident{0};
+  statm >> total >> resident;
+  return resident * sysconf(_SC_PAGESIZE) / 1024;
+}
+
+template <template <typename, std::uint32_t> class storage>
+void profileBook(const std::vector<msgClassVar>& msgs,
+                 const std::string& label) {
+  std::vector<double> latencies(msgs.size(), 0.0);
+  const std::size_t residentBefore = residentKiB();
+  auto book = std::make_unique<ordBook<storage>>(0);
+  const std::size_t residentConstructed = residentKiB();
+  std::int64_t checkSum{0};
+  std::uint64_t nRejected{0};
+  for (std::size_t i = 0; i < msgs.size(); ++i) {
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    const auto response = book->processOrder(msgs[i]);
+    const auto completionTime = std::chrono::high_resolution_clock::now();
+    checkSum += std::get<1>(response);
+    nRejected += std::get<3>(response) != 0;
+    latencies[i] = static_cast<double>(
+        duration_cast<std::chrono::nanoseconds>(completionTime - startTime)
+            .count());
+  }
+  const std::size_t residentProcessed = residentKiB();
+  std::ranges::sort(latencies);
+  const double mean =
+      std::accumulate(latencies.begin(), latencies.end(), 0.0) /
+      latencies.size();
+  std::cout << label << ": buckets reserve "
+            << ordBook<storage>::byteLength / 1024
+            << " KiB, resident after construction "
+            << residentConstructed - residentBefore
+            << " KiB, after processing " << residentProcessed - residentBefore
+            << " KiB\n  latency mean " << mean << ", 0.99 quantile "
+            << latencies[latencies.size() * 99 / 100] << ", 0.999 quantile "
+            << latencies[latencies.size() * 999 / 1000] << " (checksum "
+            << checkSum << ", " << nRejected << " rejected)\n";
+}
+
+int main(int argc, char* argv[]) {
+  // process and validate command line arguments
+  if (argc == 2) {
+    int nCores = std::thread::hardware_concurrency();
+    int coreIndex = std::atoi(argv[1]);
+    bool invalidIndex = coreIndex < 0 || coreIndex > nCores;
+    if (invalidIndex) {
+      std::cout << "invalid CPU-index argument. teminating."
+                << "\n";
+      std::terminate();
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(coreIndex, &cpuSet);
+    int setAffRet =
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+    if (setAffRet != 0) {
+      std::cout << "setting up CPU-affinity failed. teminating."
+                << "\n";
+      std::terminate();
+    }
+  }
+  // fixed seed, both books process identical messages
+  std::srand(42);
+  const auto msgs = generateMessages();
+  // latencies in nanoseconds per message
+  profileBook<pagedStorage>(msgs, "paged storage (256 pages of 256 buckets)");
+  profileBook<OrderBookStorage::denseStorage>(msgs, "dense storage");
+}
@@ -0,0 +1,196 @@
+// measures throughput and latency of a Pipeline::shardedPipeline with one
+// handler thread and 1 to all physical cores worth of shard threads, every
+// stage pinned to a physical core of its own as long as there are enough
+// throughput: handler reads messages as fast as it can, messages processed
+// per second from the first read until the last order was processed
+// latency: handler paces messages 50 ns apart like profiling_multithreaded,
+// time from enqueueing until the shard has processed the order
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "BookManager.hpp"
+#include "FIXmsgClasses.hpp"
+#include "OrderBook.hpp"
+#include "OrderBookStorage.hpp"
+#include "Pipeline.hpp"
+#include "Queue.hpp"
+#include "busyWait.hpp"
+
+using addLimitOrder =
+    FIXmsgClasses::instrumentMsg<FIXmsgClasses::addLimitOrder>;
+using withdrawLimitOrder =
+    FIXmsgClasses::instrumentMsg<FIXmsgClasses::withdrawLimitOrder>;
+using marketOrder = FIXmsgClasses::instrumentMsg<FIXmsgClasses::marketOrder>;
+using msgClassVar =
+    std::variant<addLimitOrder, withdrawLimitOrder, marketOrder>;
+using ordBook =
+    OrderBook::orderBook<msgClassVar, std::int32_t, 2000, false, 0, 1, 2, true,
+                         OrderBookStorage::ringStorage>;
+static constexpr std::uint32_t nInstruments = 256;
+// queues hold every message of a run, no shard can be lapped
+static constexpr std::uint32_t nMsgs = 262144;
+using seqLockQueue =
+    Queue::SeqLockQueue<Pipeline::routedMsg<msgClassVar>, nMsgs, true, false>;
+
+// hands out pregenerated messages, optionally paced, remembers the time of the
+// first read
+struct vectorHandler {
+  const std::vector<msgClassVar>* msgs;
+  std::uint64_t pacing = 0;
+  std::size_t index = 0;
+  std::uint64_t firstRead = 0;
+  std::optional<msgClassVar> readNextMessage() noexcept {
+    if (index == msgs->size()) {
+      return std::nullopt;
+    }
+    firstRead = index == 0 ? Pipeline::now() : firstRead;
+    pacing > 0 ? BusyWait::busyWait(pacing) : void();
+    return (*msgs)[index++];
+  };
+};
+
+// latencies in nanoseconds, memory reserved before the pipeline is started
+struct latencyObserver {
+  static constexpr bool enabled = true;
+  std::vector<double> latencies;
+  std::uint64_t lastProcessed = 0;
+  template <typename responseType>
+  void processed(std::uint64_t enqueued, const responseType&) noexcept {
+    lastProcessed = Pipeline::now();
+    latencies.push_back(static_cast<double>(lastProcessed - enqueued));
+  };
+};
+
+using pipelineType = Pipeline::shardedPipeline<vectorHandler, ordBook,
+                                               seqLockQueue, latencyObserver>;
+
+// random walk of every instrument's mid price, orders are placed around the
+// mid of a randomly chosen instrument
+std::vector<msgClassVar> generateMessages() {
+  std::vector<std::int32_t> mids(nInstruments, 1000);
+  std::vector<msgClassVar> ret;
+  ret.reserve(nMsgs);
+  for (std::uint32_t i = 0; i < nMsgs; ++i) {
+    const std::uint32_t instrument = std::rand() % nInstruments;
+    mids[instrument] =
+        std::clamp(mids[instrument] + std::rand() % 3 - 1, 100, 1900);
+    const bool bid = std::rand() % 2;
+    const std::int32_t volume = (1 + std::rand() % 50) * (bid ? -1 : 1);
+    const std::int32_t distance = 1 + std::rand() % 20;
+    const std::uint32_t price = mids[instrument] + (bid ? -distance : distance);
+    const int msgType = std::rand() % 100;
+    msgType < 60
+        ? ret.push_back(addLimitOrder(
+              FIXmsgClasses::addLimitOrder(volume, price), instrument))
+    : msgType < 85
+        ? ret.push_back(withdrawLimitOrder(
+              FIXmsgClasses::withdrawLimitOrder(volume, price), instrument))
+        : ret.push_back(marketOrder(FIXmsgClasses::marketOrder(-volume),
+                                    instrument));
+  }
+  return ret;
+}
+
+// first logical CPU of every physical core, all logical CPUs if topology
+// cannot be read
+std::vector<int> physicalCores() {
+  const int nCPUs = std::thread::hardware_concurrency();
+  std::set<std::pair<int, int>> seen;
+  std::vector<int> ret;
+  for (int cpu = 0; cpu < nCPUs; ++cpu) {
+    const std::string topology = "/sys/devices/system/cpu/cpu" +
+                                 std::to_string(cpu) + "/topology/";
+    std::ifstream coreFile(topology + "core_id");
+    std::ifstream packageFile(topology + "physical_package_id");
+    int core = cpu;
+    int package = 0;
+    coreFile >> core;
+    packageFile >> package;
+    seen.insert({package, core}).second ? ret.push_back(cpu) : void();
+  }
+  return ret;
+}
+
+// runs all messages through a pipeline with nShards shards, returns messages
+// per second and sorted latencies
+std::pair<double, std::vector<double>> profile(
+    const std::vector<msgClassVar>& msgs, const std::vector<int>& cores,
+    std::uint32_t nShards, std::uint64_t pacing) {
+  auto handler = vectorHandler{&msgs, pacing};
+  vectorHandler* handlerPtrs[1]{&handler};
+  // handler gets the first core, shards the following ones, wrapping around
+  // once all physical cores are taken
+  auto config = Pipeline::pipelineConfig{{cores[0]}, {}};
+  for (std::uint32_t i = 0; i < nShards; ++i) {
+    config.shardCores.push_back(cores[(i + 1) % cores.size()]);
+  }
+  const std::vector<std::uint32_t> basePrices(nInstruments, 0);
+  auto pipeline = pipelineType(
+      handlerPtrs, basePrices,
+      Pipeline::routingTable::roundRobin(nInstruments, nShards), config);
+  for (std::uint32_t i = 0; i < nShards; ++i) {
+    pipeline.observer(i).latencies.reserve(msgs.size());
+  }
+  if (!pipeline.start()) {
+    std::cout << "starting pipeline failed. teminating."
+              << "\n";
+    std::terminate();
+  }
+  std::uint64_t nProcessed = 0;
+  while (nProcessed < msgs.size()) {
+    std::this_thread::yield();
+    nProcessed = 0;
+    for (std::uint32_t i = 0; i < nShards; ++i) {
+      nProcessed += pipeline.processedCount(i);
+    }
+  }
+  pipeline.stop();
+  std::vector<double> latencies;
+  std::uint64_t lastProcessed = 0;
+  for (std::uint32_t i = 0; i < nShards; ++i) {
+    auto& observer = pipeline.observer(i);
+    latencies.insert(latencies.end(), observer.latencies.begin(),
+                     observer.latencies.end());
+    lastProcessed = std::max(lastProcessed, observer.lastProcessed);
+  }
+  std::ranges::sort(latencies);
+  const double seconds =
+      static_cast<double>(lastProcessed - handler.firstRead) / 1e9;
+  return {msgs.size() / seconds, std::move(latencies)};
+}
+
+int main() {
+  const std::vector<int> cores = physicalCores();
+  // at least one shard, even if it has to share the handler's core
+  const std::uint32_t maxShards =
+      std::max<std::uint32_t>(1, cores.size() - 1);
+  std::srand(42);
+  const auto msgs = generateMessages();
+  std::cout << cores.size() << " physical cores, " << nInstruments
+            << " instruments, " << nMsgs << " messages\n";
+  for (std::uint32_t nShards = 1; nShards <= maxShards; ++nShards) {
+    const auto throughput = profile(msgs, cores, nShards, 0);
+    const auto paced = profile(msgs, cores, nShards, 50);
+    const auto& latencies = paced.second;
+    std::cout << nShards << " shards: " << throughput.first
+              << " messages per second, paced latency mean "
+              << std::accumulate(latencies.begin(), latencies.end(), 0.0) /
+                     latencies.size()
+              << ", 0.99 quantile " << latencies[latencies.size() * 99 / 100]
+              << ", 0.999 quantile "
+              << latencies[latencies.size() * 999 / 1000] << "\n";
+  }
+}
@@ -0,0 +1,127 @@
+// measures resynchronization on corrupt streams, prints
+// - bytes per nanosecond searched for the delimiter by every version of
+//   DelimiterScan supported by the CPU over 1 MiB of bytes not containing it
+// - messages per second, messages recovered and bytes discarded reading 1M
+//   messages via readNextMessage and via readMessages (256 per call, 64 KiB
+//   ring buffer) from fixMockSocket with garbage (20 pseudo random bytes) or a
+//   truncated message (12 bytes) in front of 0, 0.1, 1 and 10 percent of them
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "DelimiterScan.hpp"
+#include "FIXSocketHandler.hpp"
+#include "FIXmockSocket.hpp"
+#include "FIXmsgClasses.hpp"
+
+using lineTuple = std::tuple<std::uint8_t, std::int32_t, std::uint32_t>;
+using msgClassVar =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+static constexpr std::uint32_t nMsgs = 1000000;
+static constexpr std::uint32_t batchSize = 256;
+static constexpr std::uint16_t delimiter = 0xEB50;
+using singleHandler =
+    FIXSocketHandler::fixSocketHandler<msgClassVar,
+                                       FIXmockSocket::fixMockSocket>;
+using bulkHandler =
+    FIXSocketHandler::fixSocketHandler<msgClassVar,
+                                       FIXmockSocket::fixMockSocket, 65536>;
+
+void profileScan(const std::string& label, DelimiterScan::findFunc func,
+                 const std::vector<std::uint8_t>& bytes) {
+  static constexpr int nRuns = 200;
+  std::uint64_t checkSum = 0;
+  const auto startTime = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < nRuns; ++i) {
+    checkSum += func(bytes.data() + i % 8, bytes.size() - 8, delimiter);
+  }
+  const double nanoseconds =
+      std::chrono::duration<double, std::nano>(
+          std::chrono::high_resolution_clock::now() - startTime)
+          .count();
+  std::cout << "  " << label << ": "
+            << static_cast<double>(nRuns) * bytes.size() / nanoseconds
+            << " bytes per ns (checksum " << checkSum << ")" << std::endl;
+}
+
+// valid messages, every one preceded by garbage or a truncated message with
+// the probability passed
+std::vector<lineTuple> generateMessages(double corruptionRate) {
+  std::vector<lineTuple> ret;
+  ret.reserve(nMsgs * (1 + corruptionRate));
+  for (std::uint32_t i = 0; i < nMsgs; ++i) {
+    const bool corrupt = std::rand() < corruptionRate * RAND_MAX;
+    corrupt ? void(ret.emplace_back(std::rand() % 2 == 0 ? 3 : 5,
+                                    std::rand() % 2000, std::rand() % 2000))
+            : void();
+    ret.emplace_back(std::rand() % 3, 1 + std::rand() % 1000,
+                     std::rand() % 2000);
+  }
+  return ret;
+}
+
+template <typename handlerType>
+void profileStream(const std::string& label,
+                   const std::vector<lineTuple>& tuples) {
+  auto socket = FIXmockSocket::fixMockSocket(tuples);
+  handlerType handler(&socket);
+  std::vector<msgClassVar> msgs(batchSize);
+  std::uint32_t nRecovered = 0;
+  std::int64_t checkSum = 0;
+  const auto startTime = std::chrono::high_resolution_clock::now();
+  if constexpr (handlerType::streamBufferSize == 0) {
+    // blocking reads, stops once all messages are recovered or after as many
+    // reads as there are messages and corruptions
+    for (std::size_t i = 0; i < tuples.size() && nRecovered < nMsgs; ++i) {
+      const auto msg = handler.readNextMessage();
+      nRecovered += msg.has_value();
+      checkSum += msg.has_value() ? msg.value().index() : 0;
+    }
+  } else {
+    for (std::size_t n = handler.readMessages(msgs); n > 0;
+         n = handler.readMessages(msgs)) {
+      nRecovered += n;
+      checkSum += msgs[n - 1].index();
+    }
+  }
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::high_resolution_clock::now() -
+                                    startTime)
+          .count();
+  std::cout << "  " << label << ": " << nRecovered / seconds
+            << " messages per second, " << nRecovered << " of " << nMsgs
+            << " recovered, " << handler.discardedBytes()
+            << " bytes discarded (checksum " << checkSum << ")" << std::endl;
+}
+
+int main() {
+  std::srand(42);
+  // random bytes with every delimiter broken up
+  std::vector<std::uint8_t> bytes(1 << 20);
+  for (auto& byte : bytes) {
+    byte = std::rand() % 256;
+  }
+  for (std::size_t i = 1; i < bytes.size(); ++i) {
+    bytes[i] = bytes[i - 1] == 0x50 && bytes[i] == 0xEB ? 0 : bytes[i];
+  }
+  std::cout << "delimiter search over " << bytes.size() << " bytes:\n";
+  profileScan("scalar", DelimiterScan::findScalar, bytes);
+#if defined(__x86_64__)
+  profileScan("SSE2", DelimiterScan::findSSE2, bytes);
+  __builtin_cpu_supports("avx2")
+      ? profileScan("AVX2", DelimiterScan::findAVX2, bytes)
+      : void();
+#endif
+  for (double rate : {0.0, 0.001, 0.01, 0.1}) {
+    const auto tuples = generateMessages(rate);
+    std::cout << rate * 100 << " percent of messages corrupted:\n";
+    profileStream<singleHandler>("readNextMessage", tuples);
+    profileStream<bulkHandler>("readMessages", tuples);
+  }
+}
@@ -0,0 +1,116 @@
+// measures the cost of telling message types apart by the template ID of the
+// SBE message header as the number of message types grows, prints cycles (time
+// stamp counter) and nanoseconds per message reading 1M generated messages via
+// readNextMessage and via readMessages (256 per call, 64 KiB ring buffer) from
+// fixMockSocket for
+// - three message types without SBE message header, told apart by length
+// - 4, 8, 16 and 32 message types with SBE message header, all but three of
+//   them of the same length
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include "FIXSocketHandler.hpp"
+#include "FIXmockSocket.hpp"
+#include "FIXmsgClasses.hpp"
+
+using lineTuple = std::tuple<std::uint8_t, std::int32_t, std::uint32_t>;
+static constexpr std::uint32_t nMsgs = 1000000;
+static constexpr std::uint32_t batchSize = 256;
+
+using plainVariant =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+
+// template IDs 1 to 3 as written by fixMockSocket, 4 and above share the
+// layout of a new limit order
+template <std::size_t... Is>
+auto makeSBEVariant(std::index_sequence<Is...>)
+    -> std::variant<
+        FIXmsgClasses::sbeMsg<FIXmsgClasses::addLimitOrder, 1>,
+        FIXmsgClasses::sbeMsg<FIXmsgClasses::withdrawLimitOrder, 2>,
+        FIXmsgClasses::sbeMsg<FIXmsgClasses::marketOrder, 3>,
+        FIXmsgClasses::sbeMsg<FIXmsgClasses::addLimitOrder, Is + 4>...>;
+
+template <std::size_t nTypes>
+using sbeVariant = decltype(makeSBEVariant(std::make_index_sequence<nTypes - 3>()));
+
+std::uint64_t cycles() noexcept {
+#if defined(__x86_64__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+template <typename msgClassVariant, std::uint32_t streamBufferSize>
+void profile(const std::string& label, const std::vector<lineTuple>& tuples) {
+  auto socket = FIXmockSocket::fixMockSocket(tuples);
+  FIXSocketHandler::fixSocketHandler<msgClassVariant,
+                                     FIXmockSocket::fixMockSocket,
+                                     streamBufferSize>
+      handler(&socket);
+  std::vector<msgClassVariant> msgs(batchSize);
+  std::uint32_t nRead = 0;
+  std::int64_t checkSum = 0;
+  const auto startTime = std::chrono::high_resolution_clock::now();
+  const std::uint64_t startCycles = cycles();
+  if constexpr (streamBufferSize == 0) {
+    for (std::uint32_t i = 0; i < nMsgs; ++i) {
+      const auto msg = handler.readNextMessage();
+      nRead += msg.has_value();
+      checkSum += msg.has_value() ? msg.value().index() : 0;
+    }
+  } else {
+    for (std::size_t n = handler.readMessages(msgs); n > 0;
+         n = handler.readMessages(msgs)) {
+      nRead += n;
+      checkSum += msgs[n - 1].index();
+    }
+  }
+  const std::uint64_t totalCycles = cycles() - startCycles;
+  const double nanoseconds =
+      std::chrono::duration<double, std::nano>(
+          std::chrono::high_resolution_clock::now() - startTime)
+          .count();
+  std::cout << "  " << label << ": "
+            << static_cast<double>(totalCycles) / nMsgs << " cycles, "
+            << nanoseconds / nMsgs << " ns per message, " << nRead
+            << " read (checksum " << checkSum << ")" << std::endl;
+}
+
+template <typename msgClassVariant>
+void profileBoth(const std::string& label,
+                 const std::vector<lineTuple>& tuples) {
+  std::cout << label << ":\n";
+  profile<msgClassVariant, 0>("readNextMessage", tuples);
+  profile<msgClassVariant, 65536>("readMessages", tuples);
+}
+
+int main() {
+  std::srand(42);
+  std::vector<lineTuple> plainTuples;
+  std::vector<lineTuple> sbeTuples;
+  for (std::uint32_t i = 0; i < nMsgs; ++i) {
+    const std::uint8_t type = std::rand() % 4;
+    const std::int32_t volume = 1 + std::rand() % 1000;
+    const std::uint32_t price = std::rand() % 2000;
+    plainTuples.emplace_back(type % 3, volume, price);
+    sbeTuples.emplace_back(type + 6, volume, price);
+  }
+  profileBoth<plainVariant>("3 types without SBE message header", plainTuples);
+  profileBoth<sbeVariant<4>>("4 types with SBE message header", sbeTuples);
+  profileBoth<sbeVariant<8>>("8 types with SBE message header", sbeTuples);
+  profileBoth<sbeVariant<16>>("16 types with SBE message header", sbeTuples);
+  profileBoth<sbeVariant<32>>("32 types with SBE message header", sbeTuples);
+}
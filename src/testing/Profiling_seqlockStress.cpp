@@ -0,0 +1,157 @@
+// stresses the reader protocol of the order book: writer threads process
+// generated orders as fast as they can while reader threads call every read
+// API in turn, prints reads per second of every API and how many reads had to
+// be retried due to a concurrent write, thread i is pinned to core i modulo
+// the number of cores
+#include <pthread.h>
+#include <sched.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "FIXmsgClasses.hpp"
+#include "OrderBook.hpp"
+
+using msgClassVar =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+static constexpr std::uint32_t nTicks = 5000;
+static constexpr std::uint32_t nMsgs = 1000000;
+static constexpr std::uint32_t depth = 10;
+static constexpr auto duration = std::chrono::seconds(2);
+using ordBook =
+    OrderBook::orderBook<msgClassVar, std::int64_t, nTicks, false, 0, 1, 2>;
+static constexpr std::array<std::uint32_t, 4> readAPIs{
+    OrderBook::volumeRead, OrderBook::volumesRead, OrderBook::depthRead,
+    OrderBook::statsRead};
+static const std::array<std::string, OrderBook::nReadAPIs> apiNames{
+    "volumeAtPrice", "volumesAtPrices", "levelMetadata", "depthSnapshot",
+    "stats"};
+
+// orders within 100 ticks of the middle of the book, one in ten a market order
+std::vector<msgClassVar> generateMessages() {
+  std::vector<msgClassVar> ret;
+  ret.reserve(nMsgs);
+  for (std::uint32_t i = 0; i < nMsgs; ++i) {
+    const bool bid = std::rand() % 2;
+    const std::int32_t volume = (1 + std::rand() % 50) * (bid ? -1 : 1);
+    const std::int64_t distance = 1 + std::rand() % 100;
+    const std::uint32_t price = nTicks / 2 + (bid ? -distance : distance);
+    const int msgType = std::rand() % 100;
+    msgType < 60   ? ret.push_back(FIXmsgClasses::addLimitOrder(volume, price))
+    : msgType < 90 ? ret.push_back(
+                         FIXmsgClasses::withdrawLimitOrder(volume, price))
+                   : ret.push_back(FIXmsgClasses::marketOrder(-volume));
+  }
+  return ret;
+}
+
+void pinToCore(int coreIndex) {
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(coreIndex, &cpuSet);
+  int setAffRet =
+      pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+  if (setAffRet != 0) {
+    std::cout << "setting up CPU-affinity failed. teminating."
+              << "\n";
+    std::terminate();
+  }
+}
+
+int main(int argc, char* argv[]) {
+  // process and validate command line arguments
+  if (argc != 1 && argc != 3) {
+    std::cout << "usage: profiling_seqlockStress [writers readers]"
+              << "\n";
+    return 1;
+  }
+  const int nWriters = argc == 3 ? std::atoi(argv[1]) : 1;
+  const int nReaders = argc == 3 ? std::atoi(argv[2]) : 3;
+  const int nCores = std::thread::hardware_concurrency();
+  std::srand(42);
+  const auto msgs = generateMessages();
+  auto book = std::make_unique<ordBook>(0);
+  std::atomic_flag done = false;
+  std::atomic<std::int64_t> totalCheckSum = 0;
+  // reads per reader and API, summed up once all threads are joined
+  std::vector<std::array<std::uint64_t, OrderBook::nReadAPIs>> reads(
+      nReaders, std::array<std::uint64_t, OrderBook::nReadAPIs>{});
+  std::uint64_t nWrites{0};
+  {
+    std::vector<std::jthread> threads;
+    std::vector<std::uint64_t> writes(nWriters, 0);
+    for (int w = 0; w < nWriters; ++w) {
+      threads.emplace_back([&, w] {
+        pinToCore(w % nCores);
+        for (std::size_t i = 0; !done.test(std::memory_order_relaxed);
+             i = (i + 1) % msgs.size()) {
+          book->processOrder(msgs[i]);
+          ++writes[w];
+        }
+      });
+    }
+    for (int r = 0; r < nReaders; ++r) {
+      threads.emplace_back([&, r] {
+        pinToCore((nWriters + r) % nCores);
+        std::array<std::uint32_t, depth> prices;
+        std::array<std::int64_t, depth> volumes{};
+        std::array<ordBook::level, depth> bids, asks;
+        std::int64_t checkSum{0};
+        for (std::uint32_t i = 0; !done.test(std::memory_order_relaxed);
+             ++i) {
+          const std::uint32_t price = nTicks / 2 - 50 + i % 100;
+          for (std::uint32_t j = 0; j < depth; ++j) {
+            prices[j] = price + j;
+          }
+          // levelMetadata is left out, dense storage keeps no metadata
+          const std::uint32_t api = readAPIs[i % readAPIs.size()];
+          api == OrderBook::volumeRead
+              ? void(checkSum += book->volumeAtPrice(price))
+          : api == OrderBook::volumesRead
+              ? void(book->volumesAtPrices(prices, volumes))
+          : api == OrderBook::depthRead
+              ? void(checkSum += std::get<0>(book->depthSnapshot(bids, asks)))
+              : void(checkSum += book->stats().basePrice);
+          ++reads[r][api];
+        }
+        totalCheckSum.fetch_add(checkSum + volumes[0]);
+      });
+    }
+    std::this_thread::sleep_for(duration);
+    done.test_and_set();
+    threads.clear();
+    for (auto w : writes) {
+      nWrites += w;
+    }
+  }
+  const double seconds = std::chrono::duration<double>(duration).count();
+  std::cout << nWriters << " writers, " << nReaders << " readers: "
+            << nWrites / seconds << " orders per second (checksum "
+            << totalCheckSum.load() << ")\n";
+  for (std::uint32_t api = 0; api < OrderBook::nReadAPIs; ++api) {
+    std::uint64_t nReads{0};
+    for (const auto& readerReads : reads) {
+      nReads += readerReads[api];
+    }
+    if (nReads == 0) {
+      continue;
+    }
+    const auto [collisions, retries] = book->readRetryCounts(api);
+    std::cout << apiNames[api] << ": " << nReads / seconds
+              << " reads per second, " << collisions << " retried ("
+              << 100.0 * collisions / nReads << " %), " << retries
+              << " retries in total\n";
+  }
+}
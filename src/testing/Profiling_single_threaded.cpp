@@ -88,6 +88,8 @@ int main(int argc, char* argv[]) {
   // program logic
   std::cout << "volume at randomly generated price " << randomPrice << ": "
             << book.volumeAtPrice(randomPrice) << "\n";
+  std::cout << "orders rejected as out of range: " << book.outOfRangeCount()
+            << "\n";
 
   // write vectors of all latencies to csv
   {
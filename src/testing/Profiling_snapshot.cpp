@@ -0,0 +1,158 @@
+// measures cold start of a book of 1000000 buckets: rebuilding it by replaying
+// all messages versus restoring it from a snapshot written by
+// BookSnapshot::snapshotWriter, also measures how long the writer is stalled
+// while the snapshot copy is taken and how long writing the copy to disk takes
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "BookSnapshot.hpp"
+#include "FIXmsgClasses.hpp"
+#include "MemoryArena.hpp"
+#include "OrderBook.hpp"
+
+using msgClassVar =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+static constexpr std::uint32_t nTicks = 999999;
+static constexpr std::uint32_t nMsgs = 10000000;
+static constexpr int nReps = 20;
+using ordBook =
+    OrderBook::orderBook<msgClassVar, std::int64_t, nTicks, false, 0, 1, 2>;
+
+// limit orders spread across the whole range, bids in the lower half and
+// offers in the upper half, every tenth message a market order
+std::vector<msgClassVar> generateMessages() {
+  std::vector<msgClassVar> ret;
+  ret.reserve(nMsgs);
+  for (std::uint32_t i = 0; i < nMsgs; ++i) {
+    const bool bid = std::rand() % 2;
+    const std::int32_t volume = (1 + std::rand() % 50) * (bid ? -1 : 1);
+    const std::uint32_t distance = 1 + std::rand() % (nTicks / 2 - 1);
+    const std::uint32_t price = nTicks / 2 + (bid ? -distance : distance);
+    i % 10 == 9 ? ret.push_back(FIXmsgClasses::marketOrder(-volume))
+                : ret.push_back(FIXmsgClasses::addLimitOrder(volume, price));
+  }
+  return ret;
+}
+
+double microsecondsSince(std::chrono::high_resolution_clock::time_point start) {
+  return static_cast<double>(
+             duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::high_resolution_clock::now() - start)
+                 .count()) /
+         1000.0;
+}
+
+// mean and maximum of repeated measurements
+void report(std::vector<double>& results, const std::string& label) {
+  std::ranges::sort(results);
+  std::cout << label << ": mean "
+            << std::accumulate(results.begin(), results.end(), 0.0) /
+                   results.size()
+            << " us, max " << results.back() << " us\n";
+}
+
+int main(int argc, char* argv[]) {
+  // process and validate command line arguments
+  if (argc == 2) {
+    int nCores = std::thread::hardware_concurrency();
+    int coreIndex = std::atoi(argv[1]);
+    bool invalidIndex = coreIndex < 0 || coreIndex > nCores;
+    if (invalidIndex) {
+      std::cout << "invalid CPU-index argument. teminating."
+                << "\n";
+      std::terminate();
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(coreIndex, &cpuSet);
+    int setAffRet =
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+    if (setAffRet != 0) {
+      std::cout << "setting up CPU-affinity failed. teminating."
+                << "\n";
+      std::terminate();
+    }
+  }
+  std::srand(42);
+  const auto msgs = generateMessages();
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "profiling_snapshot.bin")
+          .string();
+  std::filesystem::remove(path);
+  std::cout << ordBook::bookLength + 1 << " buckets, "
+            << ordBook::stateBytes / (1024 * 1024) << " MiB of bucket memory, "
+            << nMsgs << " messages\n";
+
+  // cold start without snapshot: construct and replay every message
+  auto startTime = std::chrono::high_resolution_clock::now();
+  auto book = std::make_unique<ordBook>(0);
+  for (const auto& msg : msgs) {
+    book->processOrder(msg);
+  }
+  std::cout << "construction and replay: " << microsecondsSince(startTime)
+            << " us\n";
+
+  // writer stall: time the lock of the book is held for the copy
+  void* stagingMemory = MemoryArena::allocate(nullptr, BookSnapshot::pageSize,
+                                              ordBook::stateBytes);
+  const std::span<std::byte> staging(static_cast<std::byte*>(stagingMemory),
+                                     ordBook::stateBytes);
+  std::vector<double> stalls, snapshots, restores;
+  for (int i = 0; i < nReps; ++i) {
+    startTime = std::chrono::high_resolution_clock::now();
+    book->copyState(staging);
+    stalls.push_back(microsecondsSince(startTime));
+  }
+  report(stalls, "copyState (writer stalled)");
+  MemoryArena::release(nullptr, stagingMemory);
+
+  // full snapshot including msync
+  auto writer = BookSnapshot::snapshotWriter<ordBook>(book.get(), path.c_str());
+  if (!writer.valid()) {
+    std::cout << "mapping snapshot file failed. teminating."
+              << "\n";
+    std::terminate();
+  }
+  for (int i = 0; i < nReps; ++i) {
+    startTime = std::chrono::high_resolution_clock::now();
+    writer.snapshot();
+    snapshots.push_back(microsecondsSince(startTime));
+  }
+  report(snapshots, "snapshot written and synced");
+
+  // cold start from snapshot: construct, map, copy, rebuild occupancy and
+  // check invariants
+  bool allRestored = true;
+  for (int i = 0; i < nReps; ++i) {
+    startTime = std::chrono::high_resolution_clock::now();
+    auto restored = std::make_unique<ordBook>(0);
+    allRestored = allRestored &&
+                  BookSnapshot::restore(*restored, path.c_str()).has_value();
+    restores.push_back(microsecondsSince(startTime));
+    allRestored = allRestored &&
+                  restored->bestBidAsk() == book->bestBidAsk() &&
+                  restored->volumeAtPrice(nTicks / 3) ==
+                      book->volumeAtPrice(nTicks / 3);
+  }
+  report(restores, "construction and restore from snapshot");
+  std::cout << (allRestored ? "all restored books match"
+                            : "restored book differs")
+            << "\n";
+  std::filesystem::remove(path);
+}
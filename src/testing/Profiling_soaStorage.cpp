@@ -0,0 +1,130 @@
+// processes orders placed within 1000 ticks of a wandering mid price with one
+// of the bucket layouts named on the command line, intended to be run once per
+// layout under perf stat (e.g. perf stat -e
+// L1-dcache-loads,L1-dcache-load-misses,l2_rqsts.miss), messages are generated
+// identically for every layout so differences in counts stem from the book
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "FIXmsgClasses.hpp"
+#include "OrderBook.hpp"
+#include "OrderBookStorage.hpp"
+
+using msgClassVar =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+static constexpr std::uint32_t nTicks = 20000;
+static constexpr std::uint32_t nMsgs = 2000000;
+template <template <typename, std::uint32_t> class storage,
+          bool exclusiveCacheline = false>
+using ordBook =
+    OrderBook::orderBook<msgClassVar, std::int64_t, nTicks, exclusiveCacheline,
+                         0, 1, 2, true, storage>;
+
+// random walk of the mid price, orders are placed within 1000 ticks of the mid
+std::vector<msgClassVar> generateMessages() {
+  std::int64_t mid = nTicks / 2;
+  std::vector<msgClassVar> ret;
+  ret.reserve(nMsgs);
+  for (std::uint32_t i = 0; i < nMsgs; ++i) {
+    mid = std::clamp<std::int64_t>(mid + std::rand() % 5 - 2, 2000,
+                                   nTicks - 2000);
+    const bool bid = std::rand() % 2;
+    const std::int32_t volume = (1 + std::rand() % 50) * (bid ? -1 : 1);
+    const std::int64_t distance = 1 + std::rand() % 1000;
+    const std::uint32_t price = mid + (bid ? -distance : distance);
+    const int msgType = std::rand() % 100;
+    msgType < 50   ? ret.push_back(FIXmsgClasses::addLimitOrder(volume, price))
+    : msgType < 90 ? ret.push_back(
+                         FIXmsgClasses::withdrawLimitOrder(volume, price))
+                   : ret.push_back(FIXmsgClasses::marketOrder(-volume));
+  }
+  return ret;
+}
+
+template <typename bookType>
+void profileBook(const std::vector<msgClassVar>& msgs,
+                 const std::string& label) {
+  std::vector<double> latencies(msgs.size(), 0.0);
+  auto book = std::make_unique<bookType>(0);
+  std::int64_t checkSum{0};
+  for (std::size_t i = 0; i < msgs.size(); ++i) {
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    checkSum += std::get<1>(book->processOrder(msgs[i]));
+    const auto completionTime = std::chrono::high_resolution_clock::now();
+    latencies[i] = static_cast<double>(
+        duration_cast<std::chrono::nanoseconds>(completionTime - startTime)
+            .count());
+  }
+  std::ranges::sort(latencies);
+  const double mean =
+      std::accumulate(latencies.begin(), latencies.end(), 0.0) /
+      latencies.size();
+  std::cout << label << " (" << bookType::byteLength / 1024
+            << " KiB of buckets): latency mean " << mean << ", 0.99 quantile "
+            << latencies[latencies.size() * 99 / 100] << ", 0.999 quantile "
+            << latencies[latencies.size() * 999 / 1000] << " (checksum "
+            << checkSum << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+  // process and validate command line arguments
+  if (argc != 2 && argc != 3) {
+    std::cout << "usage: profiling_soaStorage <dense|exclusive|ring|soa> "
+                 "[core index]"
+              << "\n";
+    return 1;
+  }
+  if (argc == 3) {
+    int nCores = std::thread::hardware_concurrency();
+    int coreIndex = std::atoi(argv[2]);
+    bool invalidIndex = coreIndex < 0 || coreIndex > nCores;
+    if (invalidIndex) {
+      std::cout << "invalid CPU-index argument. teminating."
+                << "\n";
+      std::terminate();
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(coreIndex, &cpuSet);
+    int setAffRet =
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+    if (setAffRet != 0) {
+      std::cout << "setting up CPU-affinity failed. teminating."
+                << "\n";
+      std::terminate();
+    }
+  }
+  // fixed seed, every layout processes identical messages
+  std::srand(42);
+  const auto msgs = generateMessages();
+  const std::string layout(argv[1]);
+  // latencies in nanoseconds per message
+  layout == "dense"
+      ? profileBook<ordBook<OrderBookStorage::denseStorage>>(
+            msgs, "dense storage, 8 byte buckets")
+  : layout == "exclusive"
+      ? profileBook<ordBook<OrderBookStorage::denseStorage, true>>(
+            msgs, "dense storage, one cacheline per bucket")
+  : layout == "ring"
+      ? profileBook<ordBook<OrderBookStorage::ringStorage>>(
+            msgs, "ring buffer storage, 8 byte buckets")
+  : layout == "soa"
+      ? profileBook<ordBook<OrderBookStorage::soaStorage>>(
+            msgs, "SoA storage, 4 byte volumes")
+      : void(std::cout << "unknown layout " << layout << "\n");
+}
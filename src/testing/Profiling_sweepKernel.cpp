@@ -0,0 +1,129 @@
+// measures sweeps consuming 1, 8, 64 and 512 price levels, once for every
+// version of SweepKernel supported by the CPU on a plain array of volumes and
+// once for market orders processed by a dense book (dispatching to the widest
+// kernel) and a ring buffer book (scalar loop only)
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "FIXmsgClasses.hpp"
+#include "OrderBook.hpp"
+#include "OrderBookStorage.hpp"
+#include "SweepKernel.hpp"
+
+using msgClassVar =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+template <template <typename, std::uint32_t> class storage>
+using ordBook = OrderBook::orderBook<msgClassVar, std::int64_t, 2000, false, 0,
+                                     1, 2, true, storage>;
+static constexpr std::uint32_t nReps = 20000;
+static constexpr std::int64_t levelVolume = 10;
+static constexpr std::uint32_t firstPrice = 1000;
+
+std::tuple<double, double> summarize(std::vector<double>& latencies) {
+  std::ranges::sort(latencies);
+  const double mean =
+      std::accumulate(latencies.begin(), latencies.end(), 0.0) /
+      latencies.size();
+  return {mean, latencies[latencies.size() * 99 / 100]};
+}
+
+// every sweep consumes nLevels buckets entirely and the following one in part
+void profileKernel(SweepKernel::sweepFunc func, std::uint32_t nLevels,
+                   const std::string& label) {
+  std::vector<std::int64_t> buckets(nLevels + 16);
+  std::vector<double> latencies(nReps);
+  std::int64_t checkSum{0};
+  for (std::uint32_t i = 0; i < nReps; ++i) {
+    std::ranges::fill(buckets, levelVolume);
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    const auto result =
+        func(buckets.data(), buckets.size(), true,
+             levelVolume * nLevels + levelVolume / 2, firstPrice);
+    const auto completionTime = std::chrono::high_resolution_clock::now();
+    checkSum += result.revenue;
+    latencies[i] = static_cast<double>(
+        duration_cast<std::chrono::nanoseconds>(completionTime - startTime)
+            .count());
+  }
+  const auto [mean, quantile] = summarize(latencies);
+  std::cout << "  " << label << ": mean " << mean << ", 0.99 quantile "
+            << quantile << " (checksum " << checkSum << ")\n";
+}
+
+template <typename bookType>
+void profileBook(std::uint32_t nLevels, const std::string& label) {
+  auto book = bookType(0);
+  std::vector<double> latencies(nReps);
+  std::int64_t checkSum{0};
+  const msgClassVar marketOrder =
+      FIXmsgClasses::marketOrder(-levelVolume * nLevels);
+  for (std::uint32_t i = 0; i < nReps; ++i) {
+    for (std::uint32_t p = firstPrice; p < firstPrice + nLevels; ++p) {
+      book.processOrder(FIXmsgClasses::addLimitOrder(levelVolume, p));
+    }
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    checkSum += std::get<2>(book.processOrder(marketOrder));
+    const auto completionTime = std::chrono::high_resolution_clock::now();
+    latencies[i] = static_cast<double>(
+        duration_cast<std::chrono::nanoseconds>(completionTime - startTime)
+            .count());
+  }
+  const auto [mean, quantile] = summarize(latencies);
+  std::cout << "  " << label << ": mean " << mean << ", 0.99 quantile "
+            << quantile << " (checksum " << checkSum << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+  // process and validate command line arguments
+  if (argc == 2) {
+    int nCores = std::thread::hardware_concurrency();
+    int coreIndex = std::atoi(argv[1]);
+    bool invalidIndex = coreIndex < 0 || coreIndex > nCores;
+    if (invalidIndex) {
+      std::cout << "invalid CPU-index argument. teminating."
+                << "\n";
+      std::terminate();
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(coreIndex, &cpuSet);
+    int setAffRet =
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+    if (setAffRet != 0) {
+      std::cout << "setting up CPU-affinity failed. teminating."
+                << "\n";
+      std::terminate();
+    }
+  }
+  // latencies in nanoseconds per sweep
+  for (std::uint32_t nLevels : {1, 8, 64, 512}) {
+    std::cout << nLevels << " levels\n";
+    profileKernel(SweepKernel::sweepScalar, nLevels, "scalar kernel");
+#if defined(__x86_64__)
+    __builtin_cpu_supports("avx2")
+        ? profileKernel(SweepKernel::sweepAVX2, nLevels, "AVX2 kernel")
+        : void();
+    __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")
+        ? profileKernel(SweepKernel::sweepAVX512, nLevels, "AVX-512 kernel")
+        : void();
+#endif
+    profileBook<ordBook<OrderBookStorage::denseStorage>>(
+        nLevels, "dense book, dispatched kernel");
+    profileBook<ordBook<OrderBookStorage::ringStorage>>(
+        nLevels, "ring buffer book, scalar loop");
+  }
+}
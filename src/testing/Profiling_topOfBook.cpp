@@ -0,0 +1,130 @@
+// measures best bid and offer reads per second while a writer thread keeps
+// processing orders, number of reader threads is scaled from 1 to all cores
+// but the writer's
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include "FIXSocketHandler.hpp"
+#include "FIXmockSocket.hpp"
+#include "FIXmsgClasses.hpp"
+#include "FileToTuples.hpp"
+#include "OrderBook.hpp"
+
+using lineTuple = std::tuple<std::uint8_t, std::int32_t, std::uint32_t>;
+using msgClassVar =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+using ordBook =
+    OrderBook::orderBook<msgClassVar, std::int64_t, 6000, false, 0, 1, 2>;
+using sockHandler =
+    FIXSocketHandler::fixSocketHandler<msgClassVar,
+                                       FIXmockSocket::fixMockSocket>;
+static constexpr auto measuringPeriod = std::chrono::milliseconds(500);
+
+// decode all messages up front so only the order book is being measured
+std::vector<msgClassVar> readMessages(const std::string& csvPath) {
+  auto tupleVec = FileToTuples::fileToTuples<lineTuple>(csvPath);
+  auto mockSock = FIXmockSocket::fixMockSocket(tupleVec, nullptr);
+  auto sHandler = sockHandler(&mockSock);
+  std::vector<msgClassVar> ret;
+  ret.reserve(tupleVec.size());
+  for (std::size_t i = 0; i < tupleVec.size(); ++i) {
+    ret.push_back(sHandler.readNextMessage().value());
+  }
+  return ret;
+}
+
+void pinThread(int coreIndex) {
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(coreIndex, &cpuSet);
+  int setAffRet =
+      pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+  if (setAffRet != 0) {
+    std::cout << "setting up CPU-affinity failed. teminating."
+              << "\n";
+    std::terminate();
+  }
+}
+
+// writer runs on core 0, readers on the following cores (wrapping around if
+// there are more threads than cores)
+void profileReaders(const std::vector<msgClassVar>& msgs, int nReaders,
+                    int nCores) {
+  auto book = std::make_unique<ordBook>(7000);
+  std::atomic<bool> startSignal{false}, stopSignal{false};
+  std::vector<std::uint64_t> readCounts(nReaders, 0);
+  std::uint64_t nWrites{0};
+
+  std::thread writer([&]() {
+    pinThread(0);
+    while (!startSignal.load(std::memory_order_acquire)) {
+    };
+    for (std::size_t i = 0; !stopSignal.load(std::memory_order_relaxed);
+         i = (i + 1) % msgs.size()) {
+      book->processOrder(msgs[i]);
+      ++nWrites;
+    }
+  });
+  std::vector<std::thread> readers;
+  for (int r = 0; r < nReaders; ++r) {
+    readers.emplace_back([&, r]() {
+      pinThread((r + 1) % nCores);
+      std::uint64_t nReads{0}, priceSum{0};
+      while (!startSignal.load(std::memory_order_acquire)) {
+      };
+      while (!stopSignal.load(std::memory_order_relaxed)) {
+        const auto [bestBid, bestOffer] = book->bestBidAsk();
+        priceSum += bestBid.value_or(0) + bestOffer.value_or(0);
+        ++nReads;
+      }
+      // prevent compiler from optimizing away the reads
+      readCounts[r] = nReads + (priceSum == 1);
+    });
+  }
+  startSignal.store(true, std::memory_order_release);
+  std::this_thread::sleep_for(measuringPeriod);
+  stopSignal.store(true, std::memory_order_relaxed);
+  writer.join();
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  const double seconds =
+      std::chrono::duration<double>(measuringPeriod).count();
+  std::uint64_t totalReads{0};
+  for (const auto readCount : readCounts) {
+    totalReads += readCount;
+  }
+  std::cout << nReaders << " readers: " << totalReads / seconds / 1e6
+            << " M reads/s total, " << totalReads / seconds / 1e6 / nReaders
+            << " M reads/s per reader, writer " << nWrites / seconds / 1e6
+            << " M msgs/s\n";
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cout << "usage: profiling_topOfBook <csv>"
+              << "\n";
+    return 1;
+  }
+  const auto msgs = readMessages(argv[1]);
+  const int nCores = std::thread::hardware_concurrency();
+  for (int nReaders = 1; nReaders <= std::max(nCores - 1, 1); ++nReaders) {
+    profileReaders(msgs, nReaders, nCores);
+  }
+}
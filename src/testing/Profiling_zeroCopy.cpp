@@ -0,0 +1,149 @@
+// compares the cost of getting 1M generated messages from the mock socket into
+// an order book, all stages on a single thread, prints cycles (time stamp
+// counter) and nanoseconds per message for
+// - readNextMessage, copy through a SeqLockQueue, processOrder: stages of
+//   profiling_multithreaded without the thread boundary
+// - readNextMessage, processOrder
+// - readMessages into a batch of 256 variants, processOrders
+// - poll(book): views over the ring buffer handed straight to processView
+// optionally takes core index
+#include <pthread.h>
+#include <sched.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include "FIXSocketHandler.hpp"
+#include "FIXmockSocket.hpp"
+#include "FIXmsgClasses.hpp"
+#include "OrderBook.hpp"
+#include "Queue.hpp"
+
+using lineTuple = std::tuple<std::uint8_t, std::int32_t, std::uint32_t>;
+using msgClassVar =
+    std::variant<FIXmsgClasses::addLimitOrder,
+                 FIXmsgClasses::withdrawLimitOrder, FIXmsgClasses::marketOrder>;
+static constexpr std::uint32_t nMsgs = 1000000;
+static constexpr std::uint32_t nTicks = 5000;
+static constexpr std::uint32_t batchSize = 256;
+using ordBook =
+    OrderBook::orderBook<msgClassVar, std::int64_t, nTicks, false, 0, 1, 2>;
+// holds every message of a run
+using seqLockQueue = Queue::SeqLockQueue<msgClassVar, 1048576, false, false>;
+using sockHandler =
+    FIXSocketHandler::fixSocketHandler<msgClassVar,
+                                       FIXmockSocket::fixMockSocket>;
+using streamHandler =
+    FIXSocketHandler::fixSocketHandler<msgClassVar,
+                                       FIXmockSocket::fixMockSocket, 65536>;
+
+std::uint64_t cycles() noexcept {
+#if defined(__x86_64__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+// orders within 100 ticks of the middle of the book, one in ten a market order
+std::vector<lineTuple> generateMessages() {
+  std::vector<lineTuple> ret;
+  ret.reserve(nMsgs);
+  for (std::uint32_t i = 0; i < nMsgs; ++i) {
+    const bool bid = std::rand() % 2;
+    const std::int32_t volume = (1 + std::rand() % 50) * (bid ? -1 : 1);
+    const std::int64_t distance = 1 + std::rand() % 100;
+    const std::uint32_t price = nTicks / 2 + (bid ? -distance : distance);
+    const int msgType = std::rand() % 100;
+    msgType < 60   ? ret.emplace_back(0, volume, price)
+    : msgType < 90 ? ret.emplace_back(1, volume, price)
+                   : ret.emplace_back(2, -volume, 0);
+  }
+  return ret;
+}
+
+// runs func on a fresh book, func returns number of messages it got into the
+// book per call, prints cost per message and best bid and offer as checksum
+template <typename funcType>
+void profile(const std::string& label, funcType&& func) {
+  auto book = std::make_unique<ordBook>(0);
+  const auto startTime = std::chrono::high_resolution_clock::now();
+  const std::uint64_t startCycles = cycles();
+  for (std::uint32_t nProcessed = 0; nProcessed < nMsgs;) {
+    nProcessed += func(*book);
+  }
+  const std::uint64_t totalCycles = cycles() - startCycles;
+  const double nanoseconds =
+      std::chrono::duration<double, std::nano>(
+          std::chrono::high_resolution_clock::now() - startTime)
+          .count();
+  const auto [bestBid, bestAsk] = book->bestBidAsk();
+  std::cout << label << ": " << static_cast<double>(totalCycles) / nMsgs
+            << " cycles, " << nanoseconds / nMsgs
+            << " ns per message (best bid " << bestBid.value_or(0)
+            << ", best ask " << bestAsk.value_or(0) << ")" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc == 2) {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(std::atoi(argv[1]), &cpuSet);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) !=
+        0) {
+      std::cout << "setting up CPU-affinity failed. teminating."
+                << "\n";
+      std::terminate();
+    }
+  }
+  std::srand(42);
+  const auto tuples = generateMessages();
+  {
+    auto socket = FIXmockSocket::fixMockSocket(tuples);
+    auto handler = sockHandler(&socket);
+    auto queue = std::make_unique<seqLockQueue>();
+    auto reader = queue->get_reader();
+    profile("readNextMessage, SeqLockQueue, processOrder", [&](ordBook& book) {
+      queue->enqueue(handler.readNextMessage().value());
+      book.processOrder(reader.read_next_entry().value());
+      return 1;
+    });
+  }
+  {
+    auto socket = FIXmockSocket::fixMockSocket(tuples);
+    auto handler = sockHandler(&socket);
+    profile("readNextMessage, processOrder", [&](ordBook& book) {
+      book.processOrder(handler.readNextMessage().value());
+      return 1;
+    });
+  }
+  {
+    auto socket = FIXmockSocket::fixMockSocket(tuples);
+    auto handler = streamHandler(&socket);
+    std::vector<msgClassVar> msgs(batchSize);
+    std::vector<ordBook::orderResponseType> responses(batchSize);
+    profile("readMessages, processOrders", [&](ordBook& book) {
+      const std::size_t n = handler.readMessages(msgs);
+      return book.processOrders(std::span(msgs).first(n), responses);
+    });
+  }
+  {
+    auto socket = FIXmockSocket::fixMockSocket(tuples);
+    auto handler = streamHandler(&socket);
+    profile("poll", [&](ordBook& book) { return handler.poll(book); });
+  }
+}
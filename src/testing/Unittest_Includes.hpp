@@ -13,15 +13,34 @@
 #include <type_traits>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "AtomicGuards.hpp"
 #include "Auxil.hpp"
+#include "BookManager.hpp"
+#include "BookSnapshot.hpp"
+#include "Checksum.hpp"
+#include "DelimiterScan.hpp"
+#include "DispatchPolicy.hpp"
 #include "FIXSocketHandler.hpp"
 #include "FIXmockSocket.hpp"
 #include "FIXmsgClasses.hpp"
 #include "FileToTuples.hpp"
+#include "FillSink.hpp"
+#include "Journal.hpp"
+#include "LockPolicy.hpp"
+#include "MBPPublisher.hpp"
+#include "MemoryArena.hpp"
+#include "OccupancyBitmap.hpp"
 #include "OrderBook.hpp"
 #include "OrderBookBucket.hpp"
+#include "OrderBookStorage.hpp"
+#include "OrderIDMap.hpp"
+#include "OrderPool.hpp"
+#include "Pipeline.hpp"
+#include "RecenterPolicy.hpp"
 #include "SeqLockElement.hpp"
 #include "SeqLockQueue.hpp"
+#include "SweepKernel.hpp"
+#include "TopOfBook.hpp"
 #include "doctest.h"
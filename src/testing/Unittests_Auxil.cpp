@@ -37,6 +37,13 @@ TEST_CASE("testing Auxil::is_negative") {
   CHECK(Auxil::is_negative(0) == false);
 }
 
+TEST_CASE("testing Auxil::relaxed_load") {
+  const std::int64_t volume = -42;
+  alignas(8) const std::optional<std::uint32_t> price = 100;
+  CHECK(Auxil::relaxed_load(volume) == -42);
+  CHECK(Auxil::relaxed_load(price) == 100);
+}
+
 TEST_CASE("testing Auxil::validate_tuple") {
   CHECK(Auxil::check_parameter_pack<std::is_arithmetic, int, float,
                                     double>::value == true);
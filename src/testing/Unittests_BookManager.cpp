@@ -0,0 +1,153 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include "Unittest_Includes.hpp"
+
+using addLimitOrder =
+    FIXmsgClasses::instrumentMsg<FIXmsgClasses::addLimitOrder>;
+using withdrawLimitOrder =
+    FIXmsgClasses::instrumentMsg<FIXmsgClasses::withdrawLimitOrder>;
+using marketOrder = FIXmsgClasses::instrumentMsg<FIXmsgClasses::marketOrder>;
+using instrumentMsgVariant =
+    std::variant<addLimitOrder, withdrawLimitOrder, marketOrder>;
+
+TEST_CASE("testing FIXmsgClasses::instrumentMsg") {
+  std::vector<std::uint8_t> buffer(addLimitOrder::msgLength, 0);
+  *reinterpret_cast<std::uint32_t*>(&buffer[0]) = addLimitOrder::msgLength;
+  *reinterpret_cast<std::uint16_t*>(&buffer[4]) = 0xEB50;
+  *reinterpret_cast<std::int32_t*>(&buffer[6]) = -100;
+  *reinterpret_cast<std::uint32_t*>(&buffer[10]) = 250;
+  *reinterpret_cast<std::uint32_t*>(&buffer[14]) = 77;
+  auto msg = addLimitOrder(std::span<std::uint8_t>{buffer});
+  CHECK(addLimitOrder::msgLength == 21);
+  CHECK(marketOrder::msgLength == 17);
+  CHECK(msg.orderVolume == -100);
+  CHECK(msg.orderPrice == 250);
+  CHECK(msg.instrumentID == 77);
+  // message classes without instrument ID remain unchanged
+  CHECK(FIXmsgClasses::addLimitOrder::msgLength == 17);
+}
+
+TEST_CASE("testing MemoryArena::memoryArena") {
+  static constexpr std::size_t hugePageSize = 2 * 1024 * 1024;
+  SUBCASE("testing allocations from prefaulted arena") {
+    auto arena = MemoryArena::memoryArena(hugePageSize + 1);
+    CHECK(arena.capacity() == 2 * hugePageSize);
+    void* first = arena.allocate(64, 100);
+    void* second = arena.allocate(4096, 100);
+    CHECK(reinterpret_cast<std::uintptr_t>(first) % hugePageSize == 0);
+    CHECK(reinterpret_cast<std::uintptr_t>(second) % 4096 == 0);
+    CHECK(arena.contains(second));
+    CHECK(arena.used() == 4096 + 100);
+    CHECK(arena.allocate(64, 2 * hugePageSize) == nullptr);
+    // memory is zeroed and writable whether or not it could be locked
+    CHECK(reinterpret_cast<std::uint8_t*>(second)[99] == 0);
+    reinterpret_cast<std::uint8_t*>(second)[99] = 1;
+    CHECK(reinterpret_cast<std::uint8_t*>(second)[99] == 1);
+  }
+
+  SUBCASE("testing arena bound to NUMA node without prefaulting") {
+    auto arena = MemoryArena::memoryArena(
+        hugePageSize, MemoryArena::arenaOptions{false, false, 0});
+    CHECK(!arena.locked());
+    void* memory = arena.allocate(64, hugePageSize);
+    CHECK(memory != nullptr);
+    reinterpret_cast<std::uint8_t*>(memory)[hugePageSize - 1] = 1;
+    CHECK(reinterpret_cast<std::uint8_t*>(memory)[hugePageSize - 1] == 1);
+    // nodes outside the node mask are not bound, memory is usable regardless
+    for (int node : {-1, MemoryArena::maxNumaNodes}) {
+      auto unbound = MemoryArena::memoryArena(
+          hugePageSize, MemoryArena::arenaOptions{false, false, node});
+      CHECK(!unbound.numaBound());
+      CHECK(unbound.allocate(64, hugePageSize) != nullptr);
+    }
+  }
+
+  SUBCASE("testing socket handler and order book sharing an arena") {
+    using msgClassVariant = std::variant<FIXmsgClasses::addLimitOrder,
+                                         FIXmsgClasses::withdrawLimitOrder,
+                                         FIXmsgClasses::marketOrder>;
+    using sockHandlerClass =
+        FIXSocketHandler::fixSocketHandler<msgClassVariant,
+                                           FIXmockSocket::fixMockSocket>;
+    using bookType =
+        OrderBook::orderBook<msgClassVariant, std::int64_t, 1000, false, 0, 1,
+                             2>;
+    using lineTuple = std::tuple<std::uint8_t, std::int32_t, std::uint32_t>;
+    auto arena = MemoryArena::memoryArena(sockHandlerClass::arenaBytes +
+                                          bookType::arenaBytes);
+    auto msgTuples =
+        FileToTuples::fileToTuples<lineTuple>("../testMsgCsv.csv");
+    auto mockSocket = FIXmockSocket::fixMockSocket(msgTuples);
+    auto sockHandler = sockHandlerClass(&mockSocket, &arena);
+    auto book = bookType(0, &arena);
+    CHECK(arena.used() > 0);
+    CHECK(arena.used() <= sockHandlerClass::arenaBytes + bookType::arenaBytes);
+    auto recvRes = sockHandler.readNextMessage();
+    CHECK(recvRes.has_value());
+    book.processOrder(recvRes.value());
+    CHECK(book.volumeAtPrice(111) == -11);
+  }
+}
+
+TEST_CASE("testing BookManager::bookManager") {
+  using bookType =
+      OrderBook::orderBook<instrumentMsgVariant, std::int64_t, 1000, false, 0,
+                           1, 2, true, OrderBookStorage::ringStorage>;
+  const std::vector<std::uint32_t> basePrices{0, 1000, 5000};
+  auto manager = BookManager::bookManager<bookType>(basePrices);
+  CHECK(manager.size() == 3);
+  CHECK(manager.arenaUsed() <=
+        BookManager::bookManager<bookType>::arenaBytes(3));
+
+  SUBCASE("testing routing of messages by instrument ID") {
+    manager.processOrder(
+        addLimitOrder(FIXmsgClasses::addLimitOrder(-10, 500), 0));
+    manager.processOrder(
+        addLimitOrder(FIXmsgClasses::addLimitOrder(10, 1500), 1));
+    manager.processOrder(
+        addLimitOrder(FIXmsgClasses::addLimitOrder(-20, 5500), 2));
+    // price out of range for book of instrument 0
+    auto orderResp = manager.processOrder(
+        addLimitOrder(FIXmsgClasses::addLimitOrder(-10, 5500), 0));
+    CHECK(std::get<3>(orderResp) == 1);
+    CHECK(manager.book(0).volumeAtPrice(500) == -10);
+    CHECK(manager.book(1).volumeAtPrice(1500) == 10);
+    CHECK(manager.book(2).volumeAtPrice(5500) == -20);
+    orderResp = manager.processOrder(
+        marketOrder(FIXmsgClasses::marketOrder(-4), 1));
+    CHECK(std::get<1>(orderResp) == -4);
+    CHECK(manager.book(1).volumeAtPrice(1500) == 6);
+    orderResp = manager.processOrder(
+        withdrawLimitOrder(FIXmsgClasses::withdrawLimitOrder(-5, 5500), 2));
+    CHECK(std::get<1>(orderResp) == -5);
+    // unknown instrument
+    orderResp = manager.processOrder(
+        marketOrder(FIXmsgClasses::marketOrder(-4), 3));
+    CHECK(std::get<3>(orderResp) == 4);
+  }
+
+  SUBCASE("testing packed top of book against books") {
+    std::srand(42);
+    bool allMatch = true;
+    for (int i = 0; i < 10000; ++i) {
+      const std::uint32_t instrument = std::rand() % 3;
+      const std::int32_t volume = std::rand() % 21 - 10;
+      const std::uint32_t price = basePrices[instrument] + std::rand() % 1001;
+      std::rand() % 4 == 0
+          ? void(manager.processOrder(
+                marketOrder(FIXmsgClasses::marketOrder(volume), instrument)))
+          : void(manager.processOrder(addLimitOrder(
+                FIXmsgClasses::addLimitOrder(volume, price), instrument)));
+      for (std::uint32_t j = 0; j < 3; ++j) {
+        allMatch = allMatch &&
+                   manager.bestBidAsk(j) == manager.book(j).bestBidAsk();
+      }
+    }
+    CHECK(allMatch);
+  }
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}
@@ -0,0 +1,163 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include <filesystem>
+#include <string>
+
+#include "Unittest_Includes.hpp"
+
+using msgClassVariant = std::variant<FIXmsgClasses::addLimitOrder,
+                                     FIXmsgClasses::withdrawLimitOrder,
+                                     FIXmsgClasses::marketOrder>;
+template <std::uint32_t bookLength, bool exclusiveCacheline>
+using testOrderBookTemplate =
+    OrderBook::orderBook<msgClassVariant, std::int64_t, bookLength,
+                         exclusiveCacheline, 0, 1, 2>;
+
+// random limit orders and occasional market orders around price 500
+template <typename bookType>
+void processRandomOrders(bookType& book, int nOrders) {
+  for (int i = 0; i < nOrders; ++i) {
+    const std::int32_t volume = std::rand() % 201 - 100;
+    const std::uint32_t price = 400 + std::rand() % 201;
+    msgClassVariant msg;
+    std::rand() % 20 == 0 ? void(msg.emplace<2>(volume))
+                          : void(msg.emplace<0>(volume, price));
+    book.processOrder(msg);
+  }
+};
+
+template <typename bookType>
+bool booksMatch(const bookType& lhs, const bookType& rhs) {
+  bool match = lhs.bestBidAsk() == rhs.bestBidAsk();
+  for (std::uint32_t p = 0; p <= 2000; ++p) {
+    match = match && lhs.volumeAtPrice(p) == rhs.volumeAtPrice(p);
+  }
+  return match;
+};
+
+TEST_CASE_TEMPLATE("testing BookSnapshot", testOrderBookClass,
+                   testOrderBookTemplate<1000, false>,
+                   testOrderBookTemplate<1000, true>) {
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "unittest_snapshot.bin")
+          .string();
+  std::filesystem::remove(path);
+  std::srand(42);
+  auto book = testOrderBookClass(0);
+
+  SUBCASE("testing snapshots on demand") {
+    // no file yet
+    auto restored = testOrderBookClass(0);
+    CHECK(!BookSnapshot::restore(restored, path.c_str()).has_value());
+    auto writer = BookSnapshot::snapshotWriter<testOrderBookClass>(
+        &book, path.c_str());
+    REQUIRE(writer.valid());
+    processRandomOrders(book, 5000);
+    CHECK(writer.snapshot());
+    CHECK(writer.lastSequence() == 1);
+    CHECK(BookSnapshot::restore(restored, path.c_str()) == 1);
+    CHECK(booksMatch(book, restored));
+    // shifted price range and newer state, restore picks newest snapshot
+    CHECK(book.shiftBook(100));
+    processRandomOrders(book, 5000);
+    CHECK(writer.snapshot());
+    auto restoredAgain = testOrderBookClass(0);
+    CHECK(BookSnapshot::restore(restoredAgain, path.c_str()) == 2);
+    CHECK(booksMatch(book, restoredAgain));
+    CHECK(restoredAgain.__invariantsCheck(0) == 0);
+    // restored book keeps processing orders
+    const msgClassVariant marketOrder = FIXmsgClasses::marketOrder(-500);
+    CHECK(book.processOrder(marketOrder) ==
+          restoredAgain.processOrder(marketOrder));
+    CHECK(booksMatch(book, restoredAgain));
+  }
+
+  SUBCASE("testing snapshot interrupted while being written") {
+    processRandomOrders(book, 5000);
+    auto reference = testOrderBookClass(0);
+    {
+      auto writer = BookSnapshot::snapshotWriter<testOrderBookClass>(
+          &book, path.c_str());
+      CHECK(writer.snapshot());
+      BookSnapshot::restore(reference, path.c_str());
+      processRandomOrders(book, 5000);
+      CHECK(writer.snapshot());
+    }
+    // invalidate second snapshot (written to the first slot) as if the
+    // process died while writing it
+    {
+      const int fd = open(path.c_str(), O_RDWR);
+      const std::uint64_t zero = 0;
+      CHECK(pwrite(fd, &zero, sizeof(zero),
+                   offsetof(BookSnapshot::snapshotHeader, sequence)) ==
+            sizeof(zero));
+      close(fd);
+    }
+    auto restored = testOrderBookClass(0);
+    CHECK(BookSnapshot::restore(restored, path.c_str()) == 1);
+    CHECK(booksMatch(reference, restored));
+    // numbering continues after the newest valid snapshot
+    auto writer = BookSnapshot::snapshotWriter<testOrderBookClass>(
+        &book, path.c_str());
+    CHECK(writer.lastSequence() == 1);
+  }
+
+  SUBCASE("testing rejection of snapshot of a different layout") {
+    auto writer = BookSnapshot::snapshotWriter<testOrderBookClass>(
+        &book, path.c_str());
+    processRandomOrders(book, 1000);
+    CHECK(writer.snapshot());
+    auto otherBook = testOrderBookTemplate<2000, false>(0);
+    CHECK(!BookSnapshot::restore(otherBook, path.c_str()).has_value());
+  }
+
+  SUBCASE("testing rejection of snapshot violating invariants") {
+    {
+      auto writer = BookSnapshot::snapshotWriter<testOrderBookClass>(
+          &book, path.c_str());
+      processRandomOrders(book, 1000);
+      CHECK(writer.snapshot());
+    }
+    // best bid of the snapshot (written to the second slot) pointing to a
+    // price without volume
+    {
+      const int fd = open(path.c_str(), O_RDWR);
+      const std::uint32_t price = 999;
+      CHECK(pwrite(fd, &price, sizeof(price),
+                   BookSnapshot::slotBytes<testOrderBookClass> +
+                       offsetof(BookSnapshot::snapshotHeader, bestBid)) ==
+            sizeof(price));
+      close(fd);
+    }
+    // book passed keeps its state
+    auto restored = testOrderBookClass(0);
+    auto reference = testOrderBookClass(0);
+    std::srand(7);
+    processRandomOrders(restored, 1000);
+    std::srand(7);
+    processRandomOrders(reference, 1000);
+    CHECK(!BookSnapshot::restore(restored, path.c_str()).has_value());
+    CHECK(booksMatch(reference, restored));
+    CHECK(restored.__invariantsCheck(0) == 0);
+  }
+
+  SUBCASE("testing snapshots at an interval") {
+    auto writer = BookSnapshot::snapshotWriter<testOrderBookClass>(
+        &book, path.c_str());
+    writer.startInterval(std::chrono::milliseconds(5));
+    processRandomOrders(book, 20000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    writer.stopInterval();
+    CHECK(writer.lastSequence() > 0);
+    auto restored = testOrderBookClass(0);
+    CHECK(BookSnapshot::restore(restored, path.c_str()) ==
+          writer.lastSequence());
+    CHECK(booksMatch(book, restored));
+  }
+  std::filesystem::remove(path);
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}
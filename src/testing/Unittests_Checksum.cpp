@@ -0,0 +1,100 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include "Unittest_Includes.hpp"
+
+// random bytes with an offset, sums are taken at unaligned addresses too
+std::vector<std::uint8_t> randomBytes(std::size_t n) {
+  std::vector<std::uint8_t> ret(n);
+  for (auto& byte : ret) {
+    byte = std::rand() % 256;
+  }
+  return ret;
+}
+
+// appends three ASCII digits holding the byte sum modulo 256
+std::vector<std::uint8_t> withTrailer(std::vector<std::uint8_t> bytes) {
+  const std::uint32_t sum =
+      Checksum::byteSumScalar(bytes.data(), bytes.size()) % 256;
+  bytes.push_back('0' + sum / 100);
+  bytes.push_back('0' + sum / 10 % 10);
+  bytes.push_back('0' + sum % 10);
+  return bytes;
+}
+
+// byteSumFixed for all lengths in Is against the scalar version
+template <std::size_t... Is>
+bool fixedSumsMatch(const std::uint8_t* bytes, std::index_sequence<Is...>) {
+  return ((Checksum::byteSumFixed<Is>(bytes) ==
+           Checksum::byteSumScalar(bytes, Is)) &&
+          ...);
+}
+
+TEST_CASE("testing Checksum") {
+  std::vector<Checksum::byteSumFunc> variants{Checksum::byteSumScalar};
+#if defined(__x86_64__)
+  variants.push_back(Checksum::byteSumSSE2);
+  __builtin_cpu_supports("avx2") ? variants.push_back(Checksum::byteSumAVX2)
+                                 : void();
+#endif
+  std::srand(42);
+
+  SUBCASE("testing all versions of byte sum against each other") {
+    const auto bytes = randomBytes(4096 + 64);
+    bool allMatch = true;
+    for (std::uint32_t len = 0; len <= 4096; ++len) {
+      const std::uint32_t offset = len % 64;
+      const std::uint32_t expected =
+          Checksum::byteSumScalar(&bytes[offset], len);
+      for (auto func : variants) {
+        allMatch = allMatch && func(&bytes[offset], len) == expected;
+      }
+      allMatch = allMatch && Checksum::byteSum(&bytes[offset], len) == expected;
+    }
+    CHECK(allMatch);
+    // 4 KB of bytes of maximum value
+    const std::vector<std::uint8_t> full(4096, 255);
+    for (auto func : variants) {
+      CHECK(func(full.data(), full.size()) == 4096 * 255);
+    }
+  }
+
+  SUBCASE("testing byte sum of lengths known at compile time") {
+    const auto bytes = randomBytes(300);
+    for (std::uint32_t offset = 0; offset < 16; ++offset) {
+      CHECK(fixedSumsMatch(&bytes[offset], std::make_index_sequence<70>()));
+      CHECK(Checksum::byteSumFixed<255>(&bytes[offset]) ==
+            Checksum::byteSumScalar(&bytes[offset], 255));
+    }
+  }
+
+  SUBCASE("testing trailer parsing") {
+    const std::array<std::uint8_t, 3> valid{'2', '5', '5'};
+    CHECK(Checksum::trailerValue(valid.data()) == 255);
+    const std::array<std::uint8_t, 3> zeros{'0', '0', '0'};
+    CHECK(Checksum::trailerValue(zeros.data()) == 0);
+    const std::array<std::uint8_t, 3> belowZero{'1', '/', '0'};
+    CHECK(Checksum::trailerValue(belowZero.data()) == -1);
+    const std::array<std::uint8_t, 3> aboveNine{':', '0', '0'};
+    CHECK(Checksum::trailerValue(aboveNine.data()) == -1);
+  }
+
+  SUBCASE("testing validation of messages") {
+    for (std::uint32_t len : {0, 1, 13, 15, 16, 100, 4093}) {
+      auto msg = withTrailer(randomBytes(len));
+      CHECK(Checksum::validate(msg.data(), msg.size()));
+      ++msg[msg.size() / 2];
+      CHECK(!Checksum::validate(msg.data(), msg.size()));
+    }
+    auto msg = withTrailer(randomBytes(15));
+    CHECK(Checksum::validateFixed<18>(msg.data()));
+    msg[17] = 'x';
+    CHECK(!Checksum::validateFixed<18>(msg.data()));
+    // too short to hold a trailer
+    CHECK(!Checksum::validate(msg.data(), 2));
+  }
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}
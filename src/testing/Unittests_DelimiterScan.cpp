@@ -0,0 +1,71 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include "Unittest_Includes.hpp"
+
+TEST_CASE("testing DelimiterScan") {
+  std::vector<DelimiterScan::findFunc> variants{DelimiterScan::findScalar};
+#if defined(__x86_64__)
+  variants.push_back(DelimiterScan::findSSE2);
+  __builtin_cpu_supports("avx2") ? variants.push_back(DelimiterScan::findAVX2)
+                                 : void();
+#endif
+  static constexpr std::uint16_t delimiter = 0xEB50;
+
+  SUBCASE("testing delimiter at every position") {
+    for (auto func : variants) {
+      bool allFound = true;
+      for (std::uint32_t pos = 0; pos < 100; ++pos) {
+        std::vector<std::uint8_t> bytes(101, 0);
+        bytes[pos] = 0x50;
+        bytes[pos + 1] = 0xEB;
+        allFound = allFound && func(bytes.data(), 101, delimiter) == pos;
+        // not found if cut off before its second byte
+        allFound =
+            allFound && func(bytes.data(), pos + 1, delimiter) == pos + 1;
+      }
+      CHECK(allFound);
+    }
+  }
+
+  SUBCASE("testing bytes of delimiter in wrong order or apart") {
+    std::vector<std::uint8_t> bytes(70, 0x50);
+    bytes[69] = 0x00;
+    for (std::uint32_t i = 1; i < 60; i += 2) {
+      bytes[i] = 0x00;
+    }
+    bytes[40] = 0xEB;
+    bytes[41] = 0x50;
+    for (auto func : variants) {
+      CHECK(func(bytes.data(), bytes.size(), delimiter) == bytes.size());
+      CHECK(func(bytes.data(), 0, delimiter) == 0);
+      CHECK(func(bytes.data(), 1, delimiter) == 1);
+    }
+  }
+
+  SUBCASE("testing all versions against each other with random bytes") {
+    std::srand(42);
+    bool allMatch = true;
+    for (int i = 0; i < 2000; ++i) {
+      // few distinct values, delimiter bytes appear often
+      const std::uint32_t len = std::rand() % 300;
+      std::vector<std::uint8_t> bytes(len);
+      for (auto& byte : bytes) {
+        const int r = std::rand() % 4;
+        byte = r == 0 ? 0x50 : r == 1 ? 0xEB : std::rand() % 256;
+      }
+      const std::uint32_t expected =
+          DelimiterScan::findScalar(bytes.data(), len, delimiter);
+      for (auto func : variants) {
+        allMatch = allMatch && func(bytes.data(), len, delimiter) == expected;
+      }
+      allMatch = allMatch &&
+                 DelimiterScan::find(bytes.data(), len, delimiter) == expected;
+    }
+    CHECK(allMatch);
+  }
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}
@@ -20,6 +20,9 @@ TEST_CASE("testing FIXsocketHandler::fixSocketHandler") {
   CHECK(recvContent.index() == 0);
   CHECK(std::get<0>(recvContent).orderVolume == -11);
   CHECK(std::get<0>(recvContent).orderPrice == 111);
+  // raw bytes of the last message read
+  CHECK(sockHandler.lastMessage().size() == 17);
+  CHECK(sockHandler.lastMessage()[0] == 17);
 
   recvRes = sockHandler.readNextMessage();
   CHECK(recvRes.has_value());
@@ -50,6 +53,7 @@ TEST_CASE("testing FIXsocketHandler::fixSocketHandler") {
 
   recvRes = sockHandler.readNextMessage();
   CHECK(!recvRes.has_value());
+  CHECK(sockHandler.lastMessage().empty());
 
   recvRes = sockHandler.readNextMessage();
   CHECK(recvRes.has_value());
@@ -58,6 +62,534 @@ TEST_CASE("testing FIXsocketHandler::fixSocketHandler") {
   CHECK(std::get<2>(recvContent).orderVolume == 3000);
 }
 
+TEST_CASE_TEMPLATE("testing streaming mode of FIXsocketHandler",
+                   sockHandlerClass,
+                   FIXSocketHandler::fixSocketHandler<
+                       std::variant<FIXmsgClasses::addLimitOrder,
+                                    FIXmsgClasses::withdrawLimitOrder,
+                                    FIXmsgClasses::marketOrder>,
+                       FIXmockSocket::fixMockSocket, 32>,
+                   FIXSocketHandler::fixSocketHandler<
+                       std::variant<FIXmsgClasses::addLimitOrder,
+                                    FIXmsgClasses::withdrawLimitOrder,
+                                    FIXmsgClasses::marketOrder>,
+                       FIXmockSocket::fixMockSocket, 1024>) {
+  using msgClassVariant = typename sockHandlerClass::msgClassVariant;
+  using lineTuple = std::tuple<std::uint8_t, std::int32_t, std::uint32_t>;
+  // volume and price of a decoded message, price of market orders is zero
+  auto contents = [](const msgClassVariant& msg) {
+    return std::visit(
+        [](const auto& m) {
+          if constexpr (requires { m.orderPrice; }) {
+            return std::make_tuple(m.orderVolume, m.orderPrice);
+          } else {
+            return std::make_tuple(m.orderVolume, 0u);
+          }
+        },
+        msg);
+  };
+  std::array<msgClassVariant, 8> msgs;
+
+  SUBCASE("testing invalid and oversized messages") {
+    const auto msgTuples =
+        FileToTuples::fileToTuples<lineTuple>("../testMsgCsv.csv");
+    // expected messages, faulty and oversized messages are skipped
+    const std::vector<std::tuple<std::size_t, std::int32_t, std::uint32_t>>
+        expected{{0, -11, 111}, {1, 22, 222},   {2, 33, 0},
+                 {0, 1000, 20}, {1, -2000, 50}, {2, 3000, 0}};
+    // partial reads make messages straddle recv calls and the wrap point
+    for (std::uint32_t maxLen : {1u, 5u, 7u, 13u, 1000u}) {
+      auto mockSocket = FIXmockSocket::fixMockSocket(msgTuples);
+      mockSocket.limitRecvLength(maxLen);
+      auto sockHandler = sockHandlerClass(&mockSocket);
+      std::vector<std::tuple<std::size_t, std::int32_t, std::uint32_t>> read;
+      for (std::size_t n = sockHandler.readMessages(msgs); n > 0;
+           n = sockHandler.readMessages(msgs)) {
+        for (std::size_t i = 0; i < n; ++i) {
+          const auto [volume, price] = contents(msgs[i]);
+          read.emplace_back(msgs[i].index(), volume, price);
+        }
+      }
+      CHECK(read == expected);
+      CHECK(sockHandler.lastMessage().empty());
+    }
+  }
+
+  SUBCASE("testing long stream of messages") {
+    std::srand(42);
+    std::vector<lineTuple> msgTuples;
+    for (int i = 0; i < 2000; ++i) {
+      msgTuples.emplace_back(std::rand() % 3, std::rand() % 2000 - 1000,
+                             std::rand() % 2000);
+    }
+    auto legacySocket = FIXmockSocket::fixMockSocket(msgTuples);
+    auto legacyHandler = FIXSocketHandler::fixSocketHandler<
+        msgClassVariant, FIXmockSocket::fixMockSocket>(&legacySocket);
+    auto mockSocket = FIXmockSocket::fixMockSocket(msgTuples);
+    auto sockHandler = sockHandlerClass(&mockSocket);
+    std::size_t nRead = 0;
+    bool identical = true;
+    for (std::size_t n = sockHandler.readMessages(msgs); n > 0;
+         n = sockHandler.readMessages(msgs)) {
+      for (std::size_t i = 0; i < n; ++i) {
+        const auto expected = legacyHandler.readNextMessage();
+        identical &= expected.has_value() &&
+                     contents(expected.value()) == contents(msgs[i]) &&
+                     expected.value().index() == msgs[i].index();
+      }
+      nRead += n;
+    }
+    CHECK(identical);
+    CHECK(nRead == msgTuples.size());
+    // at least two recv calls per message without streaming mode
+    CHECK(legacySocket.recvCount() >= 2 * msgTuples.size());
+    // streaming mode needs at most one per message even with a ring buffer
+    // barely larger than a message, otherwise two per ring buffer worth of
+    // bytes (up to and past the wrap point)
+    CHECK(mockSocket.recvCount() <= msgTuples.size());
+    const std::uint32_t ringSize = sockHandlerClass::streamBufferSize;
+    CHECK(mockSocket.recvCount() <=
+          2 + 36 * msgTuples.size() / (ringSize - 18));
+  }
+
+  SUBCASE("testing span smaller than messages available") {
+    const auto msgTuples =
+        FileToTuples::fileToTuples<lineTuple>("../testMsgCsv.csv");
+    auto mockSocket = FIXmockSocket::fixMockSocket(msgTuples);
+    auto sockHandler = sockHandlerClass(&mockSocket);
+    // messages left in the ring buffer are returned by the following calls
+    CHECK(sockHandler.readMessages(std::span(msgs).first(1)) == 1);
+    CHECK(contents(msgs[0]) == std::make_tuple(-11, 111u));
+    CHECK(sockHandler.readMessages(std::span(msgs).first(1)) == 1);
+    CHECK(contents(msgs[0]) == std::make_tuple(22, 222u));
+    CHECK(sockHandler.readMessages(std::span(msgs).first(1)) == 1);
+    CHECK(msgs[0].index() == 2);
+    CHECK(contents(msgs[0]) == std::make_tuple(33, 0u));
+  }
+}
+
+template <typename viewType>
+constexpr bool hasInstrumentID = requires(viewType view) {
+  view.instrumentID();
+};
+template <typename viewType>
+constexpr bool hasOrderPrice = requires(viewType view) { view.orderPrice(); };
+
+TEST_CASE("testing FIXmsgClasses::msgView") {
+  using addL3 = FIXmsgClasses::addLimitOrderL3;
+  using instrumentMarket =
+      FIXmsgClasses::instrumentMsg<FIXmsgClasses::marketOrder>;
+  // fields at odd offsets, loads must not assume alignment
+  std::array<std::uint8_t, 64> buffer{};
+  const auto bytes = std::span(buffer).subspan(1);
+  std::int32_t volume = -7;
+  std::uint32_t price = 4321;
+  std::uint64_t orderID = 0x0123456789ABCDEF;
+  std::memcpy(&bytes[addL3::volumeOffset], &volume, 4);
+  std::memcpy(&bytes[addL3::priceOffset], &price, 4);
+  std::memcpy(&bytes[addL3::orderIDOffset], &orderID, 8);
+  const auto view = FIXmsgClasses::msgView<addL3>(bytes);
+  CHECK(view.orderVolume() == -7);
+  CHECK(view.orderPrice() == 4321);
+  CHECK(view.orderID() == 0x0123456789ABCDEF);
+  const addL3 msg = view.materialize();
+  CHECK(msg.orderVolume == -7);
+  CHECK(msg.orderPrice == 4321);
+  CHECK(msg.orderID == 0x0123456789ABCDEF);
+  // accessors only exist for fields of the message type
+  CHECK(!hasInstrumentID<decltype(view)>);
+  std::uint32_t instrumentID = 99;
+  std::memcpy(&bytes[instrumentMarket::instrumentIDOffset], &instrumentID, 4);
+  const auto marketView = FIXmsgClasses::msgView<instrumentMarket>(bytes);
+  CHECK(marketView.orderVolume() == -7);
+  CHECK(marketView.instrumentID() == 99);
+  CHECK(!hasOrderPrice<decltype(marketView)>);
+}
+
+TEST_CASE("testing FIXsocketHandler::fixSocketHandler::poll") {
+  using msgClassVariant = std::variant<FIXmsgClasses::addLimitOrder,
+                                       FIXmsgClasses::withdrawLimitOrder,
+                                       FIXmsgClasses::marketOrder>;
+  using lineTuple = std::tuple<std::uint8_t, std::int32_t, std::uint32_t>;
+  using sockHandlerClass =
+      FIXSocketHandler::fixSocketHandler<msgClassVariant,
+                                         FIXmockSocket::fixMockSocket, 64>;
+  using testOrderBookClass =
+      OrderBook::orderBook<msgClassVariant, std::int64_t, 1000, false, 0, 1, 2>;
+
+  SUBCASE("testing views passed to callable") {
+    const auto msgTuples =
+        FileToTuples::fileToTuples<lineTuple>("../testMsgCsv.csv");
+    auto mockSocket = FIXmockSocket::fixMockSocket(msgTuples);
+    mockSocket.limitRecvLength(7);
+    auto sockHandler = sockHandlerClass(&mockSocket);
+    std::vector<std::tuple<std::size_t, std::int32_t>> read;
+    auto collect = [&](const auto& view) {
+      using msgType = typename std::decay_t<decltype(view)>::msgType;
+      read.emplace_back(msgClassVariant(std::in_place_type<msgType>).index(),
+                        view.orderVolume());
+    };
+    std::size_t nPolled = 0;
+    for (std::size_t n = sockHandler.poll(collect); n > 0;
+         n = sockHandler.poll(collect)) {
+      nPolled += n;
+    }
+    CHECK(nPolled == 6);
+    CHECK(read == std::vector<std::tuple<std::size_t, std::int32_t>>{
+                      {0, -11}, {1, 22}, {2, 33}, {0, 1000}, {1, -2000},
+                      {2, 3000}});
+  }
+
+  SUBCASE("testing views processed by order book") {
+    // book fed via views ends up in the same state as one fed via variants
+    std::srand(42);
+    std::vector<lineTuple> msgTuples;
+    for (int i = 0; i < 5000; ++i) {
+      const bool bid = std::rand() % 2;
+      const std::int32_t volume = (1 + std::rand() % 20) * (bid ? -1 : 1);
+      const std::uint32_t price = 500 + (bid ? -1 : 1) * (1 + std::rand() % 50);
+      const std::uint8_t type = std::rand() % 10 == 0 ? 2 : std::rand() % 2;
+      msgTuples.emplace_back(type, type == 2 ? -volume : volume, price);
+    }
+    auto legacySocket = FIXmockSocket::fixMockSocket(msgTuples);
+    auto legacyHandler = FIXSocketHandler::fixSocketHandler<
+        msgClassVariant, FIXmockSocket::fixMockSocket>(&legacySocket);
+    auto legacyBook = testOrderBookClass{0};
+    for (std::size_t i = 0; i < msgTuples.size(); ++i) {
+      legacyBook.processOrder(legacyHandler.readNextMessage().value());
+    }
+    auto mockSocket = FIXmockSocket::fixMockSocket(msgTuples);
+    auto sockHandler = sockHandlerClass(&mockSocket);
+    auto book = testOrderBookClass{0};
+    const std::int64_t initVersion = book.version();
+    std::size_t nPolled = 0;
+    for (std::size_t n = sockHandler.poll(book); n > 0;
+         n = sockHandler.poll(book)) {
+      nPolled += n;
+    }
+    CHECK(nPolled == msgTuples.size());
+    CHECK(book.version() - initVersion == 2 * msgTuples.size());
+    CHECK(book.bestBidAsk() == legacyBook.bestBidAsk());
+    CHECK(book.stats().bestBid == legacyBook.stats().bestBid);
+    CHECK(book.stats().lowestBid == legacyBook.stats().lowestBid);
+    CHECK(book.stats().highestOffer == legacyBook.stats().highestOffer);
+    bool identical = true;
+    for (std::uint32_t price = 0; price <= 1000; ++price) {
+      identical &= book.volumeAtPrice(price) == legacyBook.volumeAtPrice(price);
+    }
+    CHECK(identical);
+    CHECK(book.__invariantsCheck(0) == 0);
+  }
+}
+
+TEST_CASE("testing resynchronization of FIXsocketHandler") {
+  using msgClassVariant = std::variant<FIXmsgClasses::addLimitOrder,
+                                       FIXmsgClasses::withdrawLimitOrder,
+                                       FIXmsgClasses::marketOrder>;
+  using lineTuple = std::tuple<std::uint8_t, std::int32_t, std::uint32_t>;
+  using msgTuple = std::tuple<std::size_t, std::int32_t>;
+  auto contents = [](const msgClassVariant& msg) {
+    return msgTuple{msg.index(),
+                    std::visit([](const auto& m) { return m.orderVolume; },
+                               msg)};
+  };
+  // valid messages interspersed with garbage, truncated and oversized
+  // messages, every valid message is expected to be recovered
+  std::srand(42);
+  std::vector<lineTuple> msgTuples;
+  std::vector<msgTuple> expected;
+  std::uint64_t expectedDiscarded = 0;
+  bool corrupted = false;
+  for (int i = 0; i < 3000; ++i) {
+    const std::uint8_t type = i < 2999 && std::rand() % 5 == 0
+                                  ? 3 + std::rand() % 3
+                                  : std::rand() % 3;
+    const std::int32_t volume = 1 + std::rand() % 1000;
+    msgTuples.emplace_back(type, volume, std::rand() % 2000);
+    type < 3 ? void(expected.emplace_back(type, volume)) : void();
+    // oversized messages are only counted if searched for a valid header
+    expectedDiscarded += type == 3   ? 20
+                         : type == 5 ? 12
+                         : type == 4 && corrupted ? 40
+                                                  : 0;
+    corrupted = type == 3 || type == 5 || (type == 4 && corrupted);
+  }
+
+  SUBCASE("testing header with a length too short for any message") {
+    // header is searched past like an invalid one rather than read from
+    const std::vector<lineTuple> tuples{
+        {0, 10, 100}, {10, 0, 0}, {1, 20, 200}, {2, 30, 0}};
+    const std::vector<msgTuple> expectedShort{{0, 10}, {1, 20}, {2, 30}};
+    auto mockSocket = FIXmockSocket::fixMockSocket(tuples);
+    auto sockHandler =
+        FIXSocketHandler::fixSocketHandler<msgClassVariant,
+                                           FIXmockSocket::fixMockSocket>(
+            &mockSocket);
+    std::vector<msgTuple> read;
+    for (std::size_t i = 0;
+         i < tuples.size() && read.size() < expectedShort.size(); ++i) {
+      const auto msg = sockHandler.readNextMessage();
+      msg.has_value() ? read.push_back(contents(msg.value())) : void();
+    }
+    CHECK(read == expectedShort);
+    CHECK(sockHandler.discardedBytes() == 12);
+    auto streamSocket = FIXmockSocket::fixMockSocket(tuples);
+    auto streamHandler =
+        FIXSocketHandler::fixSocketHandler<msgClassVariant,
+                                           FIXmockSocket::fixMockSocket, 64>(
+            &streamSocket);
+    std::array<msgClassVariant, 8> msgs;
+    read.clear();
+    for (std::size_t n = streamHandler.readMessages(msgs); n > 0;
+         n = streamHandler.readMessages(msgs)) {
+      for (std::size_t i = 0; i < n; ++i) {
+        read.push_back(contents(msgs[i]));
+      }
+    }
+    CHECK(read == expectedShort);
+    CHECK(streamHandler.discardedBytes() == 12);
+  }
+
+  SUBCASE("testing readNextMessage") {
+    auto mockSocket = FIXmockSocket::fixMockSocket(msgTuples);
+    auto sockHandler =
+        FIXSocketHandler::fixSocketHandler<msgClassVariant,
+                                           FIXmockSocket::fixMockSocket>(
+            &mockSocket);
+    std::vector<msgTuple> read;
+    for (std::size_t i = 0;
+         i < msgTuples.size() && read.size() < expected.size(); ++i) {
+      const auto msg = sockHandler.readNextMessage();
+      msg.has_value() ? read.push_back(contents(msg.value())) : void();
+    }
+    CHECK(read == expected);
+    CHECK(sockHandler.discardedBytes() == expectedDiscarded);
+  }
+
+  SUBCASE("testing readMessages") {
+    for (std::uint32_t maxLen : {3u, 16u, 1000u}) {
+      auto mockSocket = FIXmockSocket::fixMockSocket(msgTuples);
+      mockSocket.limitRecvLength(maxLen);
+      auto sockHandler =
+          FIXSocketHandler::fixSocketHandler<msgClassVariant,
+                                             FIXmockSocket::fixMockSocket, 64>(
+              &mockSocket);
+      std::array<msgClassVariant, 8> msgs;
+      std::vector<msgTuple> read;
+      for (std::size_t n = sockHandler.readMessages(msgs); n > 0;
+           n = sockHandler.readMessages(msgs)) {
+        for (std::size_t i = 0; i < n; ++i) {
+          read.push_back(contents(msgs[i]));
+        }
+      }
+      CHECK(read == expected);
+      CHECK(sockHandler.discardedBytes() == expectedDiscarded);
+    }
+  }
+}
+
+TEST_CASE("testing SBE message header dispatch of FIXsocketHandler") {
+  using FIXmsgClasses::sbeMsg;
+  using sbeAdd = sbeMsg<FIXmsgClasses::addLimitOrder, 1>;
+  using sbeWithdraw = sbeMsg<FIXmsgClasses::withdrawLimitOrder, 2>;
+  using sbeMarket = sbeMsg<FIXmsgClasses::marketOrder, 3>;
+  // same length as sbeAdd, told apart by template ID only
+  using sbeReplace = sbeMsg<FIXmsgClasses::addLimitOrder, 4>;
+  using msgClassVariant =
+      std::variant<sbeAdd, sbeWithdraw, sbeMarket, sbeReplace>;
+  using lineTuple = std::tuple<std::uint8_t, std::int32_t, std::uint32_t>;
+  using msgTuple = std::tuple<std::size_t, std::int32_t, std::uint32_t>;
+  auto contents = [](const auto& msg) {
+    return msgTuple{msg.index(),
+                    std::visit([](const auto& m) { return m.orderVolume; },
+                               msg),
+                    std::visit(
+                        [](const auto& m) -> std::uint32_t {
+                          if constexpr (requires { m.orderPrice; }) {
+                            return m.orderPrice;
+                          } else {
+                            return 0;
+                          }
+                        },
+                        msg)};
+  };
+
+  SUBCASE("testing compile time checks") {
+    using MsgTypeChecks::consistencyChecksAcrossMsgTypes;
+    using instrumentMarket =
+        FIXmsgClasses::instrumentMsg<FIXmsgClasses::marketOrder>;
+    CHECK(sbeAdd::msgLength == 25);
+    CHECK(sbeAdd::blockLength == 8);
+    CHECK(sbeAdd::priceOffset == 18);
+    CHECK(sbeMsg<instrumentMarket, 5>::instrumentIDOffset == 18);
+    CHECK(consistencyChecksAcrossMsgTypes<msgClassVariant>::value);
+    // message types of equal length only with SBE message header
+    CHECK(!consistencyChecksAcrossMsgTypes<
+          std::variant<FIXmsgClasses::addLimitOrder, instrumentMarket>>::value);
+    CHECK(consistencyChecksAcrossMsgTypes<
+          std::variant<sbeAdd, sbeMsg<instrumentMarket, 5>>>::value);
+    // template IDs have to be unique, schema ID and version the same
+    CHECK(!consistencyChecksAcrossMsgTypes<
+          std::variant<sbeAdd, sbeMsg<FIXmsgClasses::marketOrder, 1>>>::value);
+    CHECK(!consistencyChecksAcrossMsgTypes<
+          std::variant<sbeAdd,
+                       sbeMsg<FIXmsgClasses::marketOrder, 3, 2>>>::value);
+    CHECK(!consistencyChecksAcrossMsgTypes<
+          std::variant<sbeAdd,
+                       sbeMsg<FIXmsgClasses::marketOrder, 3, 1, 1>>>::value);
+    // SBE and plain message types can't be mixed
+    CHECK(!consistencyChecksAcrossMsgTypes<
+          std::variant<sbeAdd, FIXmsgClasses::marketOrder>>::value);
+  }
+
+  // messages of all four types interspersed with garbage
+  std::srand(42);
+  std::vector<lineTuple> msgTuples;
+  std::vector<msgTuple> expected;
+  std::uint64_t expectedDiscarded = 0;
+  for (int i = 0; i < 2000; ++i) {
+    const std::uint8_t type =
+        i < 1999 && std::rand() % 8 == 0 ? 3 : 6 + std::rand() % 4;
+    const std::int32_t volume = 1 + std::rand() % 1000;
+    const std::uint32_t price = std::rand() % 2000;
+    msgTuples.emplace_back(type, volume, price);
+    type != 3 ? void(expected.emplace_back(type - 6, volume,
+                                           type == 8 ? 0 : price))
+              : void();
+    expectedDiscarded += type == 3 ? 20 : 0;
+  }
+
+  SUBCASE("testing readNextMessage") {
+    auto mockSocket = FIXmockSocket::fixMockSocket(msgTuples);
+    auto sockHandler =
+        FIXSocketHandler::fixSocketHandler<msgClassVariant,
+                                           FIXmockSocket::fixMockSocket>(
+            &mockSocket);
+    std::vector<msgTuple> read;
+    for (std::size_t i = 0;
+         i < msgTuples.size() && read.size() < expected.size(); ++i) {
+      const auto msg = sockHandler.readNextMessage();
+      msg.has_value() ? read.push_back(contents(msg.value())) : void();
+    }
+    CHECK(read == expected);
+    CHECK(sockHandler.discardedBytes() == expectedDiscarded);
+  }
+
+  SUBCASE("testing readMessages") {
+    for (std::uint32_t maxLen : {5u, 1000u}) {
+      auto mockSocket = FIXmockSocket::fixMockSocket(msgTuples);
+      mockSocket.limitRecvLength(maxLen);
+      auto sockHandler =
+          FIXSocketHandler::fixSocketHandler<msgClassVariant,
+                                             FIXmockSocket::fixMockSocket, 64>(
+              &mockSocket);
+      std::array<msgClassVariant, 8> msgs;
+      std::vector<msgTuple> read;
+      for (std::size_t n = sockHandler.readMessages(msgs); n > 0;
+           n = sockHandler.readMessages(msgs)) {
+        for (std::size_t i = 0; i < n; ++i) {
+          read.push_back(contents(msgs[i]));
+        }
+      }
+      CHECK(read == expected);
+      CHECK(sockHandler.discardedBytes() == expectedDiscarded);
+    }
+  }
+
+  SUBCASE("testing template IDs and schemas not matching") {
+    const std::vector<lineTuple> tuples{
+        {6, 10, 100}, {9, 20, 200}, {8, 30, 0}, {7, 40, 400}};
+    // template ID 4 belongs to no message type, neither skipped bytes nor a
+    // reason to resynchronize
+    using partialVariant = std::variant<sbeAdd, sbeWithdraw, sbeMarket>;
+    auto mockSocket = FIXmockSocket::fixMockSocket(tuples);
+    auto sockHandler =
+        FIXSocketHandler::fixSocketHandler<partialVariant,
+                                           FIXmockSocket::fixMockSocket>(
+            &mockSocket);
+    std::vector<bool> received;
+    for (int i = 0; i < 4; ++i) {
+      received.push_back(sockHandler.readNextMessage().has_value());
+    }
+    CHECK(received == std::vector<bool>{true, false, true, true});
+    CHECK(sockHandler.discardedBytes() == 0);
+    // messages encoded under an older version of the schema are accepted
+    using newerVariant =
+        std::variant<sbeMsg<FIXmsgClasses::addLimitOrder, 1, 1, 3>,
+                     sbeMsg<FIXmsgClasses::marketOrder, 3, 1, 3>>;
+    auto newerSocket = FIXmockSocket::fixMockSocket(tuples);
+    auto newerHandler = FIXSocketHandler::fixSocketHandler<
+        newerVariant, FIXmockSocket::fixMockSocket, 64>(&newerSocket);
+    std::array<newerVariant, 4> msgs;
+    std::vector<msgTuple> read;
+    for (std::size_t n = newerHandler.readMessages(msgs); n > 0;
+         n = newerHandler.readMessages(msgs)) {
+      for (std::size_t i = 0; i < n; ++i) {
+        read.push_back(contents(msgs[i]));
+      }
+    }
+    CHECK(read == std::vector<msgTuple>{{0, 10, 100}, {1, 30, 0}});
+    CHECK(newerHandler.discardedBytes() == 0);
+    // messages of another schema are not
+    using otherSchemaVariant =
+        std::variant<sbeMsg<FIXmsgClasses::addLimitOrder, 1, 2>,
+                     sbeMsg<FIXmsgClasses::marketOrder, 3, 2>>;
+    auto otherSocket = FIXmockSocket::fixMockSocket(tuples);
+    auto otherHandler = FIXSocketHandler::fixSocketHandler<
+        otherSchemaVariant, FIXmockSocket::fixMockSocket>(&otherSocket);
+    std::size_t nReceived = 0;
+    for (int i = 0; i < 4; ++i) {
+      nReceived += otherHandler.readNextMessage().has_value();
+    }
+    CHECK(nReceived == 0);
+  }
+
+  SUBCASE("testing views processed by order book") {
+    // book fed via views of SBE messages ends up in the same state as one fed
+    // the same orders without SBE message header
+    using plainVariant = std::variant<FIXmsgClasses::addLimitOrder,
+                                      FIXmsgClasses::withdrawLimitOrder,
+                                      FIXmsgClasses::marketOrder>;
+    using sbeBookVariant = std::variant<sbeAdd, sbeWithdraw, sbeMarket>;
+    std::vector<lineTuple> plainTuples;
+    std::vector<lineTuple> sbeTuples;
+    for (int i = 0; i < 3000; ++i) {
+      const bool bid = std::rand() % 2;
+      const std::int32_t volume = (1 + std::rand() % 20) * (bid ? -1 : 1);
+      const std::uint32_t price = 500 + (bid ? -1 : 1) * (1 + std::rand() % 50);
+      const std::uint8_t type = std::rand() % 10 == 0 ? 2 : std::rand() % 2;
+      plainTuples.emplace_back(type, type == 2 ? -volume : volume, price);
+      sbeTuples.emplace_back(type + 6, type == 2 ? -volume : volume, price);
+    }
+    auto plainSocket = FIXmockSocket::fixMockSocket(plainTuples);
+    auto plainHandler = FIXSocketHandler::fixSocketHandler<
+        plainVariant, FIXmockSocket::fixMockSocket, 64>(&plainSocket);
+    auto plainBook =
+        OrderBook::orderBook<plainVariant, std::int64_t, 1000, false, 0, 1, 2>{
+            0};
+    while (plainHandler.poll(plainBook) > 0) {
+    }
+    auto sbeSocket = FIXmockSocket::fixMockSocket(sbeTuples);
+    auto sbeHandler = FIXSocketHandler::fixSocketHandler<
+        sbeBookVariant, FIXmockSocket::fixMockSocket, 64>(&sbeSocket);
+    auto sbeBook = OrderBook::orderBook<sbeBookVariant, std::int64_t, 1000,
+                                        false, 0, 1, 2>{0};
+    std::size_t nPolled = 0;
+    for (std::size_t n = sbeHandler.poll(sbeBook); n > 0;
+         n = sbeHandler.poll(sbeBook)) {
+      nPolled += n;
+    }
+    CHECK(nPolled == sbeTuples.size());
+    CHECK(sbeBook.bestBidAsk() == plainBook.bestBidAsk());
+    bool identical = true;
+    for (std::uint32_t price = 0; price <= 1000; ++price) {
+      identical &= sbeBook.volumeAtPrice(price) == plainBook.volumeAtPrice(price);
+    }
+    CHECK(identical);
+    CHECK(sbeBook.__invariantsCheck(0) == 0);
+  }
+}
+
 TEST_CASE("testing OrderBookBucket::orderBookBucket") {
   using testBucketClass = OrderBookBucket::orderBookBucket<std::int32_t, 8>;
   testBucketClass testBucket{};
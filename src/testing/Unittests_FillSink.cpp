@@ -0,0 +1,150 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include "Unittest_Includes.hpp"
+
+using msgClassVariant = std::variant<FIXmsgClasses::addLimitOrder,
+                                     FIXmsgClasses::withdrawLimitOrder,
+                                     FIXmsgClasses::marketOrder>;
+using recordType = FillSink::fillRecord<std::int64_t>;
+
+// stores every record enqueued
+struct mockQueue {
+  std::vector<recordType> records;
+  void enqueue(recordType record) { records.push_back(record); };
+};
+
+using bufferSinkType = FillSink::bufferSink<std::int64_t>;
+using queueSinkType = FillSink::queueSink<std::int64_t, mockQueue>;
+template <template <typename, std::uint32_t> class storage, typename sink>
+using testOrderBookTemplate =
+    OrderBook::orderBook<msgClassVariant, std::int64_t, 1000, false, 0, 1, 2,
+                         true, storage, RecenterPolicy::noRecentering, 0,
+                         DispatchPolicy::runAll, false, sink>;
+
+TEST_CASE("testing FillSink::bufferSink") {
+  std::vector<recordType> buffer(3);
+  auto sink = bufferSinkType(buffer);
+  sink.fill(100, 5, FillSink::buy);
+  sink.fill(101, 7, FillSink::sell);
+  CHECK(sink.records().size() == 2);
+  // records are written in place
+  CHECK(sink.records().data() == buffer.data());
+  CHECK(buffer[1].sequence == 2);
+  CHECK(buffer[1].price == 101);
+  CHECK(buffer[1].volume == 7);
+  CHECK(buffer[1].aggressorSide == FillSink::sell);
+  sink.fill(102, 1, FillSink::buy);
+  sink.fill(103, 1, FillSink::buy);
+  // fourth record does not fit
+  CHECK(sink.records().size() == 3);
+  CHECK(sink.droppedCount() == 1);
+  CHECK(sink.lastSequence() == 4);
+  sink.clear();
+  CHECK(sink.records().empty());
+  sink.fill(104, 1, FillSink::buy);
+  CHECK(buffer[0].sequence == 5);
+  CHECK(buffer[0].price == 104);
+}
+
+TEST_CASE_TEMPLATE(
+    "testing fills reported by OrderBook::orderBook", testOrderBookClass,
+    testOrderBookTemplate<OrderBookStorage::denseStorage, bufferSinkType>,
+    testOrderBookTemplate<OrderBookStorage::ringStorage, bufferSinkType>) {
+  auto testOrderBook = testOrderBookClass(0);
+  std::vector<recordType> buffer(1024);
+  auto sink = bufferSinkType(buffer);
+
+  SUBCASE("testing records of single orders") {
+    testOrderBook.processOrder(FIXmsgClasses::addLimitOrder(10, 500));
+    testOrderBook.processOrder(FIXmsgClasses::addLimitOrder(20, 503));
+    testOrderBook.processOrder(FIXmsgClasses::addLimitOrder(-30, 490));
+    // fills before subscribing are not reported
+    testOrderBook.processOrder(FIXmsgClasses::marketOrder(-1));
+    testOrderBook.subscribeFills(&sink);
+    // buy sweeping two offer levels
+    const auto response =
+        testOrderBook.processOrder(FIXmsgClasses::marketOrder(-25));
+    CHECK(sink.records().size() == 2);
+    CHECK(buffer[0].sequence == 1);
+    CHECK(buffer[0].price == 500);
+    CHECK(buffer[0].volume == 9);
+    CHECK(buffer[0].aggressorSide == FillSink::buy);
+    CHECK(buffer[1].sequence == 2);
+    CHECK(buffer[1].price == 503);
+    CHECK(buffer[1].volume == 16);
+    CHECK(std::get<2>(response) == -(9 * 500 + 16 * 503));
+    // crossing sell limit order, remainder rests in the book
+    testOrderBook.processOrder(FIXmsgClasses::addLimitOrder(40, 480));
+    CHECK(sink.records().size() == 3);
+    CHECK(buffer[2].price == 490);
+    CHECK(buffer[2].volume == 30);
+    CHECK(buffer[2].aggressorSide == FillSink::sell);
+    // orders not trading produce no records
+    testOrderBook.processOrder(FIXmsgClasses::addLimitOrder(-10, 470));
+    testOrderBook.processOrder(FIXmsgClasses::withdrawLimitOrder(-10, 470));
+    testOrderBook.processOrder(FIXmsgClasses::addLimitOrder(-10, 5000));
+    CHECK(sink.records().size() == 3);
+    testOrderBook.subscribeFills(nullptr);
+    testOrderBook.processOrder(FIXmsgClasses::marketOrder(-4));
+    CHECK(sink.lastSequence() == 3);
+  }
+
+  SUBCASE("testing records against responses of random orders") {
+    testOrderBook.subscribeFills(&sink);
+    std::srand(42);
+    bool allMatch = true;
+    std::uint64_t expectedSequence = 0;
+    for (int i = 0; i < 20000; ++i) {
+      const std::int32_t volume = std::rand() % 201 - 100;
+      const std::uint32_t price = std::rand() % 1001;
+      msgClassVariant msg;
+      std::rand() % 10 == 0 ? void(msg.emplace<2>(volume * 20))
+                            : void(msg.emplace<0>(volume, price));
+      sink.clear();
+      const auto [marginal, filled, revenue, err] =
+          testOrderBook.processOrder(msg);
+      // records add up to the aggregate response
+      std::int64_t volumeSum{0}, revenueSum{0};
+      for (const auto& record : sink.records()) {
+        allMatch = allMatch && record.sequence == ++expectedSequence &&
+                   record.volume > 0 &&
+                   record.aggressorSide ==
+                       (filled < 0 ? FillSink::buy : FillSink::sell);
+        volumeSum += record.volume;
+        revenueSum += record.volume * record.price;
+      }
+      allMatch = allMatch && volumeSum == std::abs(filled) &&
+                 revenueSum == std::abs(revenue) &&
+                 (sink.records().empty() ||
+                  sink.records().back().price == marginal);
+    }
+    CHECK(allMatch);
+    CHECK(sink.droppedCount() == 0);
+    CHECK(testOrderBook.__invariantsCheck(0) == 0);
+  }
+}
+
+TEST_CASE("testing FillSink::queueSink") {
+  auto testOrderBook =
+      testOrderBookTemplate<OrderBookStorage::denseStorage, queueSinkType>(0);
+  mockQueue queue;
+  auto sink = queueSinkType(&queue);
+  testOrderBook.subscribeFills(&sink);
+  testOrderBook.processOrder(FIXmsgClasses::addLimitOrder(-10, 300));
+  testOrderBook.processOrder(FIXmsgClasses::addLimitOrder(-10, 299));
+  testOrderBook.processOrder(FIXmsgClasses::marketOrder(15));
+  CHECK(queue.records.size() == 2);
+  CHECK(queue.records[0].sequence == 1);
+  CHECK(queue.records[0].price == 300);
+  CHECK(queue.records[0].volume == 10);
+  CHECK(queue.records[0].aggressorSide == FillSink::sell);
+  CHECK(queue.records[1].sequence == 2);
+  CHECK(queue.records[1].price == 299);
+  CHECK(queue.records[1].volume == 5);
+  CHECK(sink.lastSequence() == 2);
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}
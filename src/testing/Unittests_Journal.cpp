@@ -0,0 +1,123 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include <filesystem>
+#include <string>
+
+#include "Unittest_Includes.hpp"
+
+using msgClassVariant = std::variant<FIXmsgClasses::addLimitOrder,
+                                     FIXmsgClasses::withdrawLimitOrder,
+                                     FIXmsgClasses::marketOrder>;
+using sockHandlerClass =
+    FIXSocketHandler::fixSocketHandler<msgClassVariant,
+                                       FIXmockSocket::fixMockSocket>;
+using lineTuple = std::tuple<std::uint8_t, std::int32_t, std::uint32_t>;
+using testOrderBookClass =
+    OrderBook::orderBook<msgClassVariant, std::int64_t, 1000, false, 0, 1, 2>;
+
+// reads all records of journal in directory
+std::vector<std::vector<std::uint8_t>> readJournal(const std::string& dir) {
+  std::vector<std::vector<std::uint8_t>> ret;
+  auto reader = Journal::journalReader(dir.c_str());
+  while (const auto record = reader.next()) {
+    ret.emplace_back(record->bytes.begin(), record->bytes.end());
+  }
+  return ret;
+};
+
+TEST_CASE("testing Journal") {
+  const std::string dir =
+      (std::filesystem::temp_directory_path() / "unittest_journal").string();
+  std::filesystem::remove_all(dir);
+
+  SUBCASE("testing records across segments and restarts") {
+    std::srand(42);
+    std::vector<std::vector<std::uint8_t>> expected;
+    const auto appendRandom = [&](Journal::journalWriter& writer, int n) {
+      bool allAppended = true;
+      for (int i = 0; i < n; ++i) {
+        std::vector<std::uint8_t> bytes(1 + std::rand() % 40);
+        for (auto& byte : bytes) {
+          byte = std::rand();
+        }
+        allAppended =
+            allAppended && writer.append(bytes) == expected.size() + 1;
+        expected.push_back(bytes);
+      }
+      return allAppended;
+    };
+    {
+      // single page segments force frequent rollovers
+      auto writer = Journal::journalWriter(dir.c_str(), 4096,
+                                           std::chrono::milliseconds(1));
+      REQUIRE(writer.valid());
+      CHECK(appendRandom(writer, 2000));
+      // records larger than a segment are rejected
+      CHECK(writer.append(std::vector<std::uint8_t>(5000)) == 0);
+      CHECK(writer.lastSequence() == 2000);
+    }
+    CHECK(std::filesystem::exists(Journal::segmentPath(dir, 10)));
+    CHECK(readJournal(dir) == expected);
+    {
+      // numbering continues after the records of the first run
+      auto writer = Journal::journalWriter(dir.c_str(), 4096,
+                                           std::chrono::milliseconds(1));
+      CHECK(writer.lastSequence() == 2000);
+      CHECK(appendRandom(writer, 500));
+    }
+    CHECK(readJournal(dir) == expected);
+    auto reader = Journal::journalReader(dir.c_str());
+    std::uint64_t previousTimestamp = 0;
+    bool ordered = true;
+    while (const auto record = reader.next()) {
+      ordered = ordered && record->timestamp >= previousTimestamp;
+      previousTimestamp = record->timestamp;
+    }
+    CHECK(ordered);
+    CHECK(reader.lastSequence() == 2500);
+  }
+
+  SUBCASE("testing journaling stage and replay into a book") {
+    std::srand(42);
+    std::vector<lineTuple> msgTuples;
+    for (int i = 0; i < 20000; ++i) {
+      const std::int32_t volume = std::rand() % 201 - 100;
+      const std::uint32_t price = std::rand() % 1001;
+      const int msgType = std::rand() % 100;
+      // oversized messages are discarded and not journaled
+      msgTuples.emplace_back(msgType < 60   ? 0
+                             : msgType < 85 ? 1
+                             : msgType < 99 ? 2
+                                            : 4,
+                             volume, price);
+    }
+    auto mockSocket = FIXmockSocket::fixMockSocket(msgTuples);
+    auto sockHandler = sockHandlerClass(&mockSocket);
+    auto book = testOrderBookClass(0);
+    std::uint64_t accepted = 0;
+    {
+      auto writer = Journal::journalWriter(dir.c_str(), 64 * 1024);
+      auto stage = Journal::journalingStage(&sockHandler, &writer);
+      for (std::size_t i = 0; i < msgTuples.size(); ++i) {
+        const auto msg = stage.readNextMessage();
+        msg.has_value() ? void(book.processOrder(msg.value())) : void();
+        accepted += msg.has_value();
+      }
+      CHECK(writer.lastSequence() == accepted);
+    }
+    CHECK(accepted < msgTuples.size());
+    auto replayedBook = testOrderBookClass(0);
+    CHECK(Journal::replay(dir.c_str(), replayedBook) == accepted);
+    bool match = book.bestBidAsk() == replayedBook.bestBidAsk();
+    for (std::uint32_t p = 0; p <= 1000; ++p) {
+      match = match && book.volumeAtPrice(p) == replayedBook.volumeAtPrice(p);
+    }
+    CHECK(match);
+  }
+  std::filesystem::remove_all(dir);
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}
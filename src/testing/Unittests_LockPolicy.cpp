@@ -0,0 +1,100 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include "Unittest_Includes.hpp"
+
+using msgClassVariant = std::variant<FIXmsgClasses::addLimitOrder,
+                                     FIXmsgClasses::withdrawLimitOrder,
+                                     FIXmsgClasses::marketOrder>;
+template <typename lockPolicy>
+using testOrderBookTemplate =
+    OrderBook::orderBook<msgClassVariant, std::int64_t, 1000, false, 0, 1, 2,
+                         true, OrderBookStorage::denseStorage,
+                         RecenterPolicy::noRecentering, 0,
+                         DispatchPolicy::runAll, false, FillSink::noFills,
+                         lockPolicy>;
+// readers only protected by the lock are not available without one
+template <typename bookType>
+constexpr bool copyStateAvailable =
+    requires(bookType& book, std::span<std::byte> dest) {
+  book.copyState(dest);
+};
+static constexpr int nThreads = 4;
+static constexpr int nIncrements = 20000;
+
+TEST_CASE_TEMPLATE("testing mutual exclusion of lock policies", lockType,
+                   LockPolicy::flagSpin, LockPolicy::ticketLock,
+                   LockPolicy::backoffLock<>, LockPolicy::backoffLock<4>) {
+  lockType lock;
+  // non-atomic counter, increments get lost unless the lock excludes
+  std::int64_t counter = 0;
+  std::vector<std::jthread> threads;
+  for (int i = 0; i < nThreads; ++i) {
+    threads.emplace_back([&] {
+      for (int j = 0; j < nIncrements; ++j) {
+        lock.lock();
+        counter = counter + 1;
+        lock.unlock();
+      }
+    });
+  }
+  threads.clear();
+  CHECK(counter == nThreads * nIncrements);
+  CHECK(lockType::enabled);
+}
+
+TEST_CASE_TEMPLATE("testing OrderBook::orderBook with concurrent writers",
+                   testOrderBookClass,
+                   testOrderBookTemplate<LockPolicy::flagSpin>,
+                   testOrderBookTemplate<LockPolicy::ticketLock>,
+                   testOrderBookTemplate<LockPolicy::backoffLock<>>) {
+  auto testOrderBook = testOrderBookClass{0};
+  std::vector<std::jthread> threads;
+  for (int i = 0; i < nThreads; ++i) {
+    threads.emplace_back([&, i] {
+      for (int j = 0; j < 1000; ++j) {
+        testOrderBook.processOrder(
+            FIXmsgClasses::addLimitOrder(-1, 400 + i));
+        testOrderBook.processOrder(FIXmsgClasses::addLimitOrder(1, 600 + i));
+      }
+    });
+  }
+  threads.clear();
+  for (int i = 0; i < nThreads; ++i) {
+    CHECK(testOrderBook.volumeAtPrice(400 + i) == -1000);
+    CHECK(testOrderBook.volumeAtPrice(600 + i) == 1000);
+  }
+  CHECK(testOrderBook.bestBidAsk() ==
+        std::make_tuple(std::make_optional(400u + nThreads - 1),
+                        std::make_optional(600u)));
+  CHECK(testOrderBook.__invariantsCheck(0) == 0);
+}
+
+TEST_CASE("testing OrderBook::orderBook without lock") {
+  using noLockBook = testOrderBookTemplate<LockPolicy::noLock>;
+  using flagSpinBook = testOrderBookTemplate<LockPolicy::flagSpin>;
+  CHECK(!noLockBook::lockPolicy::enabled);
+  CHECK(!copyStateAvailable<noLockBook>);
+  CHECK(copyStateAvailable<flagSpinBook>);
+  // single writer, identical results with and without lock
+  auto unlocked = noLockBook{0};
+  auto locked = flagSpinBook{0};
+  std::srand(42);
+  for (int i = 0; i < 10000; ++i) {
+    const bool bid = std::rand() % 2;
+    const std::int32_t volume = (1 + std::rand() % 20) * (bid ? -1 : 1);
+    const std::uint32_t price = 500 + (bid ? -1 : 1) * (1 + std::rand() % 50);
+    const msgClassVariant msg =
+        std::rand() % 5 == 0
+            ? msgClassVariant(FIXmsgClasses::marketOrder(-volume))
+            : msgClassVariant(FIXmsgClasses::addLimitOrder(volume, price));
+    CHECK(unlocked.processOrder(msg) == locked.processOrder(msg));
+  }
+  CHECK(unlocked.shiftBook(10) == locked.shiftBook(10));
+  CHECK(unlocked.bestBidAsk() == locked.bestBidAsk());
+  CHECK(unlocked.__invariantsCheck(0) == 0);
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}
@@ -0,0 +1,162 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include <map>
+
+#include "Unittest_Includes.hpp"
+
+using msgClassVariant = std::variant<FIXmsgClasses::addLimitOrder,
+                                     FIXmsgClasses::withdrawLimitOrder,
+                                     FIXmsgClasses::marketOrder>;
+template <template <typename, std::uint32_t> class storage>
+using testOrderBookTemplate =
+    OrderBook::orderBook<msgClassVariant, std::int64_t, 1000, false, 0, 1, 2,
+                         true, storage, RecenterPolicy::edgeDistance<100, 50>,
+                         0, DispatchPolicy::runAll, true>;
+using deltaType = MBPPublisher::mbpDelta<std::int64_t>;
+
+// stores every record enqueued
+struct mockQueue {
+  std::vector<deltaType> records;
+  void enqueue(deltaType delta) { records.push_back(delta); };
+};
+
+// consumer side, applies delta records to a price to volume map, ignores
+// records until the first reset record if not synced
+struct mirrorBook {
+  std::map<std::uint32_t, std::int64_t> levels;
+  std::uint64_t lastSequence = 0;
+  bool synced = false;
+  bool gapFree = true;
+  void apply(const deltaType& delta) {
+    synced = synced || delta.side == MBPPublisher::reset;
+    if (!synced) {
+      return;
+    }
+    gapFree = gapFree &&
+              (lastSequence == 0 || delta.sequence == lastSequence + 1);
+    lastSequence = delta.sequence;
+    delta.side == MBPPublisher::reset ? levels.clear() : void();
+    delta.side == MBPPublisher::emptied ? void(levels.erase(delta.price))
+                                        : void();
+    const bool hasVolume =
+        delta.side == MBPPublisher::bid || delta.side == MBPPublisher::offer;
+    hasVolume ? void(levels[delta.price] = delta.volume) : void();
+  };
+};
+
+// compares mirror to all levels of the book as copied by depthSnapshot
+template <typename bookType>
+bool mirrorMatchesBook(const mirrorBook& mirror, const bookType& book) {
+  using level = typename bookType::level;
+  std::vector<level> bids(bookType::bookLength + 1),
+      asks(bookType::bookLength + 1);
+  const auto [nBids, nAsks, retries] = book.depthSnapshot(bids, asks);
+  std::map<std::uint32_t, std::int64_t> expected;
+  for (std::uint32_t i = 0; i < nBids; ++i) {
+    expected[bids[i].price] = bids[i].volume;
+  }
+  for (std::uint32_t i = 0; i < nAsks; ++i) {
+    expected[asks[i].price] = asks[i].volume;
+  }
+  return expected == mirror.levels;
+};
+
+TEST_CASE_TEMPLATE("testing MBPPublisher::mbpPublisher", testOrderBookClass,
+                   testOrderBookTemplate<OrderBookStorage::ringStorage>,
+                   testOrderBookTemplate<OrderBookStorage::soaStorage>) {
+  auto testOrderBook = testOrderBookClass(0);
+  mockQueue queue;
+  auto publisher =
+      MBPPublisher::mbpPublisher<testOrderBookClass, mockQueue>(&testOrderBook,
+                                                                &queue);
+
+  SUBCASE("testing records of single orders") {
+    // first call sends a snapshot of the empty book
+    CHECK(publisher.publish() == 1);
+    CHECK(queue.records[0].side == MBPPublisher::reset);
+    CHECK(publisher.publish() == 0);
+    testOrderBook.processOrder(FIXmsgClasses::addLimitOrder(-10, 400));
+    testOrderBook.processOrder(FIXmsgClasses::addLimitOrder(-5, 400));
+    testOrderBook.processOrder(FIXmsgClasses::addLimitOrder(20, 410));
+    // changes of the same level are combined
+    CHECK(publisher.publish() == 2);
+    CHECK(queue.records[1].sequence == 2);
+    CHECK(queue.records[1].price == 400);
+    CHECK(queue.records[1].volume == -15);
+    CHECK(queue.records[1].side == MBPPublisher::bid);
+    CHECK(queue.records[2].sequence == 3);
+    CHECK(queue.records[2].price == 410);
+    CHECK(queue.records[2].side == MBPPublisher::offer);
+    // market order empties bid level
+    testOrderBook.processOrder(FIXmsgClasses::marketOrder(15));
+    CHECK(publisher.publish() == 1);
+    CHECK(queue.records[3].price == 400);
+    CHECK(queue.records[3].volume == 0);
+    CHECK(queue.records[3].side == MBPPublisher::emptied);
+    // orders not changing any level produce no records
+    testOrderBook.processOrder(FIXmsgClasses::addLimitOrder(-10, 5000));
+    testOrderBook.processOrder(FIXmsgClasses::withdrawLimitOrder(-10, 300));
+    CHECK(publisher.publish() == 0);
+    CHECK(publisher.lastSequence() == 4);
+  }
+
+  SUBCASE("testing levels emptied before shifting an empty book") {
+    mirrorBook mirror;
+    publisher.publish();
+    mirror.apply(queue.records[0]);
+    testOrderBook.processOrder(FIXmsgClasses::addLimitOrder(10, 500));
+    publisher.publish();
+    mirror.apply(queue.records[1]);
+    testOrderBook.processOrder(FIXmsgClasses::withdrawLimitOrder(10, 500));
+    // book is empty, basePrice moves without moving any bucket
+    CHECK(testOrderBook.shiftBook(200));
+    const std::size_t first = queue.records.size();
+    publisher.publish();
+    for (std::size_t r = first; r < queue.records.size(); ++r) {
+      mirror.apply(queue.records[r]);
+    }
+    CHECK(mirror.levels.empty());
+    CHECK(mirrorMatchesBook(mirror, testOrderBook));
+  }
+
+  SUBCASE("testing mirror books rebuilt from snapshot and deltas") {
+    std::srand(42);
+    mirrorBook mirror, lateMirror;
+    std::uint32_t mid = 500;
+    bool mirrorsMatch = true;
+    for (int i = 0; i < 20000; ++i) {
+      // mid price drifts upwards to trigger shifts of the price range
+      mid += std::rand() % 5 - 1;
+      const bool bid = std::rand() % 2;
+      const std::int32_t volume = (1 + std::rand() % 50) * (bid ? -1 : 1);
+      const std::uint32_t distance = 1 + std::rand() % 20;
+      const std::uint32_t price = bid ? mid - distance : mid + distance;
+      const int msgType = std::rand() % 100;
+      msgClassVariant msg;
+      msgType < 55   ? void(msg.emplace<0>(volume, price))
+      : msgType < 85 ? void(msg.emplace<1>(volume, price))
+                     : void(msg.emplace<2>(-volume));
+      testOrderBook.processOrder(msg);
+      // second consumer joins late and asks for a snapshot
+      i == 10000 ? publisher.requestSnapshot() : void();
+      const std::size_t first = queue.records.size();
+      publisher.publish();
+      for (std::size_t r = first; r < queue.records.size(); ++r) {
+        mirror.apply(queue.records[r]);
+        i >= 10000 ? lateMirror.apply(queue.records[r]) : void();
+      }
+      mirrorsMatch = mirrorsMatch && mirrorMatchesBook(mirror, testOrderBook);
+    }
+    CHECK(testOrderBook.shiftCount() > 0);
+    CHECK(mirrorsMatch);
+    CHECK(mirror.gapFree);
+    CHECK(lateMirror.gapFree);
+    CHECK(lateMirror.levels == mirror.levels);
+    CHECK(testOrderBook.__invariantsCheck(0) == 0);
+  }
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}
@@ -0,0 +1,98 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include "Unittest_Includes.hpp"
+
+TEST_CASE("testing OccupancyBitmap::occupancyBitmap") {
+  SUBCASE("testing setting, clearing and querying single bits") {
+    OccupancyBitmap::occupancyBitmap<6000> testBitmap{};
+    CHECK(!testBitmap.test(100));
+    testBitmap.assign(100, true);
+    CHECK(testBitmap.test(100));
+    testBitmap.assign(100, false);
+    CHECK(!testBitmap.test(100));
+    CHECK(!testBitmap.findNext(0, 5999).has_value());
+    CHECK(!testBitmap.findPrev(5999, 0).has_value());
+  }
+
+  SUBCASE("testing search within a single word and across levels") {
+    OccupancyBitmap::occupancyBitmap<6000> testBitmap{};
+    testBitmap.assign(3, true);
+    testBitmap.assign(10, true);
+    testBitmap.assign(5990, true);
+    CHECK(testBitmap.findNext(0, 5999).value() == 3);
+    CHECK(testBitmap.findNext(4, 5999).value() == 10);
+    CHECK(testBitmap.findNext(11, 5999).value() == 5990);
+    CHECK(!testBitmap.findNext(11, 5000).has_value());
+    CHECK(testBitmap.findPrev(5999, 0).value() == 5990);
+    CHECK(testBitmap.findPrev(5989, 0).value() == 10);
+    CHECK(testBitmap.findPrev(9, 0).value() == 3);
+    CHECK(!testBitmap.findPrev(9, 4).has_value());
+    testBitmap.assign(10, false);
+    CHECK(testBitmap.findNext(4, 5999).value() == 5990);
+    testBitmap.clear();
+    CHECK(!testBitmap.findNext(0, 5999).has_value());
+  }
+
+  SUBCASE("testing clearing ranges of bits") {
+    OccupancyBitmap::occupancyBitmap<6000> testBitmap{};
+    for (std::uint32_t i = 0; i < 6000; i += 7) {
+      testBitmap.assign(i, true);
+    }
+    testBitmap.clearRange(10, 4500);
+    CHECK(testBitmap.test(7));
+    CHECK(!testBitmap.test(14));
+    CHECK(!testBitmap.test(4494));
+    CHECK(testBitmap.test(4501));
+    CHECK(testBitmap.findNext(8, 5999).value() == 4501);
+    CHECK(testBitmap.findPrev(4500, 0).value() == 7);
+    // range within a single word
+    testBitmap.clearRange(4501, 4501);
+    CHECK(testBitmap.findNext(8, 5999).value() == 4508);
+    testBitmap.clearRange(0, 5999);
+    CHECK(!testBitmap.findNext(0, 5999).has_value());
+  }
+
+  SUBCASE("testing search spanning more than one top level word") {
+    OccupancyBitmap::occupancyBitmap<1000000> testBitmap{};
+    testBitmap.assign(17, true);
+    testBitmap.assign(999999, true);
+    CHECK(testBitmap.findNext(18, 999999).value() == 999999);
+    CHECK(testBitmap.findPrev(999998, 0).value() == 17);
+    testBitmap.assign(600000, true);
+    CHECK(testBitmap.findNext(18, 999999).value() == 600000);
+    CHECK(testBitmap.findPrev(999998, 0).value() == 600000);
+  }
+
+  SUBCASE("testing against linear search with random bit patterns") {
+    static constexpr std::uint32_t length = 300000;
+    OccupancyBitmap::occupancyBitmap<length> testBitmap{};
+    std::vector<bool> reference(length, false);
+    std::srand(42);
+    for (int i = 0; i < 2000; ++i) {
+      const std::uint32_t index = std::rand() % length;
+      const bool set = std::rand() % 4 != 0;
+      testBitmap.assign(index, set);
+      reference[index] = set;
+    }
+    bool allMatch = true;
+    for (int i = 0; i < 2000; ++i) {
+      const std::uint32_t from = std::rand() % length;
+      std::optional<std::uint32_t> expectNext, expectPrev;
+      for (std::uint32_t j = from; j < length && !expectNext; ++j) {
+        expectNext = reference[j] ? std::make_optional(j) : std::nullopt;
+      }
+      for (std::int64_t j = from; j >= 0 && !expectPrev; --j) {
+        expectPrev = reference[j] ? std::make_optional(j) : std::nullopt;
+      }
+      allMatch = allMatch &&
+                 testBitmap.findNext(from, length - 1) == expectNext &&
+                 testBitmap.findPrev(from, 0) == expectPrev;
+    }
+    CHECK(allMatch);
+  }
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}
@@ -2,13 +2,34 @@
 
 #include "Unittest_Includes.hpp"
 
-TEST_CASE("testing OrderBook::orderBook") {
-  using msgClassVariant = std::variant<FIXmsgClasses::addLimitOrder,
-                                       FIXmsgClasses::withdrawLimitOrder,
-                                       FIXmsgClasses::marketOrder>;
-  using testOrderBookClass =
-      OrderBook::orderBook<msgClassVariant, std::int64_t, 1000, false, 0, 1, 2>;
+using msgClassVariant = std::variant<FIXmsgClasses::addLimitOrder,
+                                     FIXmsgClasses::withdrawLimitOrder,
+                                     FIXmsgClasses::marketOrder>;
+template <template <typename, std::uint32_t> class storage>
+using testOrderBookTemplate =
+    OrderBook::orderBook<msgClassVariant, std::int64_t, 1000, false, 0, 1, 2,
+                         true, storage>;
+// pages smaller than default to have books of 1000 buckets span many pages
+template <typename bucketType, std::uint32_t length>
+using smallPagedStorage =
+    OrderBookStorage::pagedStorage<bucketType, length, 64>;
 
+// hands out messages like a queue reader, runs empty after every chunk
+struct mockQueueReader {
+  std::vector<msgClassVariant> msgs;
+  std::size_t readIndex = 0, chunkEnd = 0;
+  std::optional<msgClassVariant> read_next_entry() {
+    return readIndex < chunkEnd ? std::make_optional(msgs[readIndex++])
+                                : std::nullopt;
+  };
+};
+
+// run all test cases for every storage policy
+TEST_CASE_TEMPLATE("testing OrderBook::orderBook", testOrderBookClass,
+                   testOrderBookTemplate<OrderBookStorage::denseStorage>,
+                   testOrderBookTemplate<OrderBookStorage::ringStorage>,
+                   testOrderBookTemplate<smallPagedStorage>,
+                   testOrderBookTemplate<OrderBookStorage::soaStorage>) {
   SUBCASE("testing for correct behavior of bestBidAsk") {
     auto testOrderBook = testOrderBookClass{0};
     auto bestBidAsk = testOrderBook.bestBidAsk();
@@ -199,6 +220,33 @@ TEST_CASE("testing OrderBook::orderBook") {
     CHECK(!testOrderBook.shiftBook(1));
   }
 
+  SUBCASE(
+      "testing stats after liquidity at the touch of a sparse book is "
+      "exhausted") {
+    auto testOrderBook = testOrderBookClass{0};
+    msgClassVariant testMsgClassVar;
+    testMsgClassVar.emplace<0>(-10, 900);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(-10, 2);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(10, 901);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(10, 999);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<1>(-10, 900);
+    testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<0>(testOrderBook.bestBidAsk()).value() == 2);
+    testMsgClassVar.emplace<1>(10, 999);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<2>(-10);
+    testOrderBook.processOrder(testMsgClassVar);
+    CHECK(!std::get<1>(testOrderBook.bestBidAsk()).has_value());
+    testMsgClassVar.emplace<2>(10);
+    testOrderBook.processOrder(testMsgClassVar);
+    CHECK(!std::get<0>(testOrderBook.bestBidAsk()).has_value());
+    CHECK(testOrderBook.__invariantsCheck(0) == 0);
+  }
+
   SUBCASE("testing concurrent writes to orderbook") {
     auto testOrderBook = testOrderBookClass(0);
     msgClassVariant testMsgClassVar_0;
@@ -226,6 +274,244 @@ TEST_CASE("testing OrderBook::orderBook") {
     CHECK(testOrderBook.volumeAtPrice(100) == -20000000);
   }
 
+  SUBCASE("testing batched processing against processing order by order") {
+    auto batchBook = testOrderBookClass{0};
+    auto singleBook = testOrderBookClass{0};
+    std::srand(42);
+    std::vector<msgClassVariant> msgs(10000);
+    for (auto& msg : msgs) {
+      const std::int32_t volume = std::rand() % 201 - 100;
+      const std::uint32_t price = std::rand() % 1100;
+      const int msgType = std::rand() % 3;
+      msgType == 0   ? void(msg.emplace<0>(volume, price))
+      : msgType == 1 ? void(msg.emplace<1>(volume, price))
+                     : void(msg.emplace<2>(volume));
+    }
+    using orderResponse = typename testOrderBookClass::orderResponseType;
+    std::vector<orderResponse> batchResponses(msgs.size());
+    bool responsesMatch = true;
+    std::size_t nProcessed = 0;
+    // batches of varying size
+    for (std::size_t batchSize = 1; nProcessed < msgs.size(); ++batchSize) {
+      const std::size_t count = std::min(batchSize, msgs.size() - nProcessed);
+      nProcessed += batchBook.processOrders(
+          std::span<const msgClassVariant>{msgs}.subspan(nProcessed, count),
+          std::span<orderResponse>{batchResponses}.subspan(nProcessed));
+    }
+    CHECK(nProcessed == msgs.size());
+    for (std::size_t i = 0; i < msgs.size(); ++i) {
+      const auto singleResponse = singleBook.processOrder(msgs[i]);
+      responsesMatch = responsesMatch && singleResponse == batchResponses[i];
+    }
+    CHECK(responsesMatch);
+    bool volumesMatch = true;
+    for (std::uint32_t price = 0; price <= 1000; ++price) {
+      volumesMatch = volumesMatch && batchBook.volumeAtPrice(price) ==
+                                         singleBook.volumeAtPrice(price);
+    }
+    CHECK(volumesMatch);
+    CHECK(batchBook.bestBidAsk() == singleBook.bestBidAsk());
+    CHECK(batchBook.__invariantsCheck(0) == 0);
+    // number of orders processed is limited by shorter span
+    CHECK(batchBook.processOrders(msgs, std::span{batchResponses}.first(3)) ==
+          3);
+  }
+
+  SUBCASE("testing draining a queue reader in adaptive batches") {
+    auto testOrderBook = testOrderBookClass{0};
+    using orderResponse = typename testOrderBookClass::orderResponseType;
+    mockQueueReader reader;
+    for (int i = 0; i < 100; ++i) {
+      reader.msgs.push_back(FIXmsgClasses::addLimitOrder(-1, 100));
+    }
+    std::vector<msgClassVariant> buffer(16);
+    std::vector<orderResponse> responses(16);
+    // empty queue
+    CHECK(testOrderBook.drainQueue(reader, buffer, responses) == 0);
+    // fewer entries queued than fit into buffer
+    reader.chunkEnd = 5;
+    CHECK(testOrderBook.drainQueue(reader, buffer, responses) == 5);
+    CHECK(testOrderBook.volumeAtPrice(100) == -5);
+    // backlog exceeds buffer
+    reader.chunkEnd = 100;
+    CHECK(testOrderBook.drainQueue(reader, buffer, responses) == 16);
+    CHECK(testOrderBook.volumeAtPrice(100) == -21);
+    while (testOrderBook.drainQueue(reader, buffer, responses) > 0) {
+    };
+    CHECK(testOrderBook.volumeAtPrice(100) == -100);
+  }
+
+  SUBCASE("testing best bid and offer read concurrently to writes") {
+    auto testOrderBook = testOrderBookClass(0);
+    std::vector<msgClassVariant> msgs(1000000);
+    std::srand(42);
+    for (auto& msg : msgs) {
+      const std::int32_t volume = std::rand() % 201 - 100;
+      const std::uint32_t price = std::rand() % 1001;
+      const int msgType = std::rand() % 3;
+      msgType == 0   ? void(msg.emplace<0>(volume, price))
+      : msgType == 1 ? void(msg.emplace<1>(volume, price))
+                     : void(msg.emplace<2>(volume));
+    }
+    std::atomic<bool> startSignal{false}, writerDone{false};
+    std::thread writer([&]() {
+      while (!startSignal.load(std::memory_order_acquire)) {
+      };
+      for (const auto& msg : msgs) {
+        testOrderBook.processOrder(msg);
+      }
+      writerDone.store(true, std::memory_order_release);
+    });
+    bool neverCrossed = true;
+    std::thread reader([&]() {
+      while (!startSignal.load(std::memory_order_acquire)) {
+      };
+      // a torn read could combine prices of different states into a crossed
+      // top of book
+      while (!writerDone.load(std::memory_order_acquire)) {
+        const auto [bestBid, bestOffer] = testOrderBook.bestBidAsk();
+        neverCrossed = neverCrossed &&
+                       !(bestBid.has_value() && bestOffer.has_value() &&
+                         bestBid.value() >= bestOffer.value());
+      }
+    });
+    startSignal.store(true, std::memory_order_release);
+    writer.join();
+    reader.join();
+    CHECK(neverCrossed);
+    CHECK(testOrderBook.packedBestBidAsk() ==
+          TopOfBook::pack(std::get<0>(testOrderBook.bestBidAsk()),
+                          std::get<1>(testOrderBook.bestBidAsk())));
+    CHECK(testOrderBook.__invariantsCheck(0) == 0);
+  }
+
+  SUBCASE("testing depth snapshot against volumes of single prices") {
+    auto testOrderBook = testOrderBookClass(0);
+    using level = typename testOrderBookClass::level;
+    std::array<level, 10> bids, asks;
+    auto [nBids, nAsks, retries] = testOrderBook.depthSnapshot(bids, asks);
+    CHECK(nBids == 0);
+    CHECK(nAsks == 0);
+    CHECK(retries == 0);
+    std::srand(42);
+    bool snapshotsMatch = true;
+    for (int i = 0; i < 10000; ++i) {
+      const std::int32_t volume = std::rand() % 201 - 100;
+      const std::uint32_t price = std::rand() % 1001;
+      msgClassVariant msg;
+      std::rand() % 4 == 0 ? void(msg.emplace<2>(volume))
+                           : void(msg.emplace<0>(volume, price));
+      testOrderBook.processOrder(msg);
+      std::tie(nBids, nAsks, retries) = testOrderBook.depthSnapshot(bids, asks);
+      // expected levels by walking away from the touch price by price
+      std::vector<level> expectedBids, expectedAsks;
+      const auto [bestBid, bestOffer] = testOrderBook.bestBidAsk();
+      const std::int64_t bidStart =
+          bestBid.has_value() ? static_cast<std::int64_t>(bestBid.value()) : -1;
+      for (std::int64_t p = bidStart;
+           p >= 0 && expectedBids.size() < bids.size(); --p) {
+        const auto vol = testOrderBook.volumeAtPrice(p);
+        vol != 0 ? expectedBids.push_back(level{static_cast<std::uint32_t>(p),
+                                                vol})
+                 : void();
+      }
+      for (std::uint32_t p = bestOffer.value_or(1001);
+           p <= 1000 && expectedAsks.size() < asks.size(); ++p) {
+        const auto vol = testOrderBook.volumeAtPrice(p);
+        vol != 0 ? expectedAsks.push_back(level{p, vol}) : void();
+      }
+      snapshotsMatch = snapshotsMatch && retries == 0 &&
+                       nBids == expectedBids.size() &&
+                       nAsks == expectedAsks.size();
+      for (std::uint32_t j = 0; snapshotsMatch && j < nBids; ++j) {
+        snapshotsMatch = bids[j].price == expectedBids[j].price &&
+                         bids[j].volume == expectedBids[j].volume;
+      }
+      for (std::uint32_t j = 0; snapshotsMatch && j < nAsks; ++j) {
+        snapshotsMatch = asks[j].price == expectedAsks[j].price &&
+                         asks[j].volume == expectedAsks[j].volume;
+      }
+    }
+    CHECK(snapshotsMatch);
+    // number of levels copied is limited by span passed
+    std::tie(nBids, nAsks, retries) = testOrderBook.depthSnapshot(
+        std::span{bids}.first(2), std::span<level>{});
+    CHECK(nBids <= 2);
+    CHECK(nAsks == 0);
+  }
+
+  SUBCASE("testing depth snapshot read concurrently to writes") {
+    auto testOrderBook = testOrderBookClass(0);
+    using level = typename testOrderBookClass::level;
+    std::vector<msgClassVariant> msgs(1000000);
+    std::srand(42);
+    for (auto& msg : msgs) {
+      const std::int32_t volume = std::rand() % 201 - 100;
+      const std::uint32_t price = std::rand() % 1001;
+      const int msgType = std::rand() % 3;
+      msgType == 0   ? void(msg.emplace<0>(volume, price))
+      : msgType == 1 ? void(msg.emplace<1>(volume, price))
+                     : void(msg.emplace<2>(volume));
+    }
+    std::atomic<bool> startSignal{false}, writerDone{false};
+    std::thread writer([&]() {
+      while (!startSignal.load(std::memory_order_acquire)) {
+      };
+      for (const auto& msg : msgs) {
+        testOrderBook.processOrder(msg);
+      }
+      writerDone.store(true, std::memory_order_release);
+    });
+    bool consistent = true;
+    std::thread reader([&]() {
+      std::array<level, 10> bids, asks;
+      while (!startSignal.load(std::memory_order_acquire)) {
+      };
+      // levels need to be sorted away from the touch, carry the volume sign
+      // of their side and never cross
+      while (!writerDone.load(std::memory_order_acquire)) {
+        const auto [nBids, nAsks, retries] =
+            testOrderBook.depthSnapshot(bids, asks);
+        for (std::uint32_t j = 0; j < nBids; ++j) {
+          consistent = consistent && bids[j].volume < 0 &&
+                       (j == 0 || bids[j].price < bids[j - 1].price);
+        }
+        for (std::uint32_t j = 0; j < nAsks; ++j) {
+          consistent = consistent && asks[j].volume > 0 &&
+                       (j == 0 || asks[j].price > asks[j - 1].price);
+        }
+        consistent = consistent && (nBids == 0 || nAsks == 0 ||
+                                    bids[0].price < asks[0].price);
+      }
+    });
+    startSignal.store(true, std::memory_order_release);
+    writer.join();
+    reader.join();
+    CHECK(consistent);
+  }
+
+  SUBCASE("testing concurrent batched writes to orderbook") {
+    auto testOrderBook = testOrderBookClass(0);
+    using orderResponse = typename testOrderBookClass::orderResponseType;
+    std::atomic<bool> startSignal{false};
+    auto writeBatches = [&]() {
+      const std::vector<msgClassVariant> msgs(
+          64, FIXmsgClasses::addLimitOrder(-1, 100));
+      std::vector<orderResponse> responses(64);
+      while (!startSignal.load(std::memory_order_acquire)) {
+      };
+      for (int i = 0; i < 100000; ++i) {
+        testOrderBook.processOrders(msgs, responses);
+      }
+    };
+    std::thread thread_0(writeBatches);
+    std::thread thread_1(writeBatches);
+    startSignal.store(true);
+    thread_0.join();
+    thread_1.join();
+    CHECK(testOrderBook.volumeAtPrice(100) == -12800000);
+  }
+
   SUBCASE(
       "brute-force-testing order book invariants using 1 million randomly "
       "generated erratic yet valid messages") {
@@ -251,6 +537,622 @@ TEST_CASE("testing OrderBook::orderBook") {
   }
 }
 
+TEST_CASE("testing OrderBook::orderBook with ring buffer storage") {
+  using testOrderBookClass =
+      testOrderBookTemplate<OrderBookStorage::ringStorage>;
+
+  SUBCASE("testing repeated shifts wrapping around the ring buffer") {
+    auto testOrderBook = testOrderBookClass{100};
+    msgClassVariant testMsgClassVar;
+    testMsgClassVar.emplace<0>(-10, 600);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(10, 650);
+    testOrderBook.processOrder(testMsgClassVar);
+    std::uint64_t errCodeSum{0};
+    for (int i = 0; i < 40; ++i) {
+      CHECK(testOrderBook.shiftBook(100));
+      CHECK(testOrderBook.shiftBook(-100));
+      // move liquidity along to keep shifting possible
+      const std::uint32_t bid = 600 + 10 * i;
+      testMsgClassVar.emplace<1>(-10, bid);
+      testOrderBook.processOrder(testMsgClassVar);
+      testMsgClassVar.emplace<0>(-10, bid + 10);
+      testOrderBook.processOrder(testMsgClassVar);
+      testMsgClassVar.emplace<1>(10, bid + 50);
+      testOrderBook.processOrder(testMsgClassVar);
+      testMsgClassVar.emplace<0>(10, bid + 60);
+      testOrderBook.processOrder(testMsgClassVar);
+      CHECK(testOrderBook.shiftBook(10));
+      errCodeSum += testOrderBook.__invariantsCheck(i);
+    }
+    CHECK(errCodeSum == 0);
+    CHECK(testOrderBook.volumeAtPrice(1000) == -10);
+    CHECK(testOrderBook.volumeAtPrice(1050) == 10);
+    CHECK(testOrderBook.volumeAtPrice(990) == 0);
+    auto bestBidAsk = testOrderBook.bestBidAsk();
+    CHECK(std::get<0>(bestBidAsk).value() == 1000);
+    CHECK(std::get<1>(bestBidAsk).value() == 1050);
+    testMsgClassVar.emplace<2>(-20);
+    auto orderResp = testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<1>(orderResp) == -10);
+    CHECK(!std::get<1>(testOrderBook.bestBidAsk()).has_value());
+  }
+}
+
+// pool of four pages of 64 buckets
+template <typename bucketType, std::uint32_t length>
+using tinyPoolStorage =
+    OrderBookStorage::pagedStorage<bucketType, length, 64, 4>;
+
+TEST_CASE("testing OrderBook::orderBook with paged storage") {
+  SUBCASE("testing rejection of orders while the page pool is exhausted") {
+    auto testOrderBook = testOrderBookTemplate<tinyPoolStorage>{0};
+    msgClassVariant testMsgClassVar;
+    // one order per page takes all pages of the pool
+    for (std::uint32_t page = 0; page < 4; ++page) {
+      testMsgClassVar.emplace<0>(-10, 64 * page + 10);
+      CHECK(std::get<3>(testOrderBook.processOrder(testMsgClassVar)) == 0);
+    }
+    // page already taken can still be used
+    testMsgClassVar.emplace<0>(-10, 200);
+    CHECK(std::get<3>(testOrderBook.processOrder(testMsgClassVar)) == 0);
+    testMsgClassVar.emplace<0>(10, 500);
+    CHECK(std::get<3>(testOrderBook.processOrder(testMsgClassVar)) == 2);
+    CHECK(testOrderBook.volumeAtPrice(500) == 0);
+    // order filled entirely against existing volume needs no page
+    testMsgClassVar.emplace<0>(5, 100);
+    auto orderResp = testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<3>(orderResp) == 0);
+    CHECK(std::get<1>(orderResp) == 5);
+    // withdrawing all volume of a page returns it to the pool
+    testMsgClassVar.emplace<1>(-10, 10);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(10, 500);
+    CHECK(std::get<3>(testOrderBook.processOrder(testMsgClassVar)) == 0);
+    CHECK(testOrderBook.volumeAtPrice(500) == 10);
+    // market order emptying pages returns them as well
+    testMsgClassVar.emplace<2>(100);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(-10, 900);
+    CHECK(std::get<3>(testOrderBook.processOrder(testMsgClassVar)) == 0);
+    testMsgClassVar.emplace<0>(-10, 960);
+    CHECK(std::get<3>(testOrderBook.processOrder(testMsgClassVar)) == 0);
+    CHECK(testOrderBook.__invariantsCheck(0) == 0);
+  }
+
+  SUBCASE("testing remainder rejected after matching") {
+    auto testOrderBook = testOrderBookTemplate<tinyPoolStorage>{0};
+    msgClassVariant testMsgClassVar;
+    // page of the only bid also holds an offer, stays taken when the bid is
+    // filled
+    testMsgClassVar.emplace<0>(-10, 300);
+    testOrderBook.processOrder(testMsgClassVar);
+    for (std::uint32_t price : {310, 400, 500, 600}) {
+      testMsgClassVar.emplace<0>(10, price);
+      testOrderBook.processOrder(testMsgClassVar);
+    }
+    // volume is filled, remainder would need a page
+    testMsgClassVar.emplace<0>(15, 200);
+    auto orderResp = testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<3>(orderResp) == 2);
+    CHECK(std::get<1>(orderResp) == 10);
+    CHECK(testOrderBook.volumeAtPrice(300) == 0);
+    CHECK(testOrderBook.volumeAtPrice(200) == 0);
+    CHECK(!std::get<0>(testOrderBook.bestBidAsk()).has_value());
+    CHECK(std::get<1>(testOrderBook.bestBidAsk()).value() == 310);
+    CHECK(testOrderBook.__invariantsCheck(0) == 0);
+  }
+
+  SUBCASE("testing wide price range") {
+    using wideOrderBookClass =
+        OrderBook::orderBook<msgClassVariant, std::int64_t, 1000000, false, 0,
+                             1, 2, true, OrderBookStorage::pagedStorage>;
+    // default pool capped instead of covering all 4096 pages of the range
+    using wideStorage = OrderBookStorage::pagedStorage<
+        OrderBookBucket::orderBookBucket<std::int64_t, 8>, 1000001>;
+    CHECK(wideStorage::poolPages == 64);
+    CHECK(OrderBookStorage::pagedStorage<
+              OrderBookBucket::orderBookBucket<std::int64_t, 8>,
+              1001>::poolPages == 4);
+    auto testOrderBook = wideOrderBookClass{0};
+    msgClassVariant testMsgClassVar;
+    testMsgClassVar.emplace<0>(-10, 1000);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(-10, 500000);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(10, 999999);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(10, 600000);
+    testOrderBook.processOrder(testMsgClassVar);
+    CHECK(testOrderBook.volumeAtPrice(500000) == -10);
+    CHECK(testOrderBook.volumeAtPrice(500001) == 0);
+    testMsgClassVar.emplace<2>(20);
+    auto orderResp = testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<1>(orderResp) == 20);
+    CHECK(std::get<2>(orderResp) == 10 * 500000 + 10 * 1000);
+    CHECK(!std::get<0>(testOrderBook.bestBidAsk()).has_value());
+    CHECK(testOrderBook.shiftBook(500000));
+    CHECK(testOrderBook.volumeAtPrice(600000) == 10);
+    CHECK(testOrderBook.volumeAtPrice(999999) == 10);
+    CHECK(testOrderBook.__invariantsCheck(0) == 0);
+  }
+}
+
+// 16 bit volumes and two overflow entries, overflow is easily provoked
+template <typename bucketType, std::uint32_t length>
+using narrowSoaStorage =
+    OrderBookStorage::soaStorage<bucketType, length, std::int16_t, 2>;
+
+TEST_CASE("testing OrderBook::orderBook with SoA storage") {
+  SUBCASE("testing remainder rejected after matching") {
+    auto testOrderBook = testOrderBookTemplate<narrowSoaStorage>{0};
+    msgClassVariant testMsgClassVar;
+    testMsgClassVar.emplace<0>(-100, 400);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(40000, 500);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(40000, 510);
+    testOrderBook.processOrder(testMsgClassVar);
+    // crossing order is filled, remainder that might not fit is rejected
+    testMsgClassVar.emplace<0>(40100, 300);
+    auto orderResp = testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<3>(orderResp) == 2);
+    CHECK(std::get<1>(orderResp) == 100);
+    CHECK(testOrderBook.volumeAtPrice(400) == 0);
+    CHECK(testOrderBook.volumeAtPrice(300) == 0);
+    CHECK(testOrderBook.__invariantsCheck(0) == 0);
+  }
+
+  SUBCASE("testing volumes exceeding the narrow volume type") {
+    auto testOrderBook = testOrderBookTemplate<narrowSoaStorage>{0};
+    msgClassVariant testMsgClassVar;
+    testMsgClassVar.emplace<0>(30000, 500);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(30000, 500);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(-40000, 100);
+    testOrderBook.processOrder(testMsgClassVar);
+    CHECK(testOrderBook.volumeAtPrice(500) == 60000);
+    CHECK(testOrderBook.volumeAtPrice(100) == -40000);
+    // overflow table full, order that might not fit is rejected, order that
+    // fits and order adding to a level already overflowing are accepted
+    testMsgClassVar.emplace<0>(40000, 600);
+    CHECK(std::get<3>(testOrderBook.processOrder(testMsgClassVar)) == 2);
+    CHECK(testOrderBook.volumeAtPrice(600) == 0);
+    testMsgClassVar.emplace<0>(100, 600);
+    CHECK(std::get<3>(testOrderBook.processOrder(testMsgClassVar)) == 0);
+    testMsgClassVar.emplace<0>(-1000, 100);
+    CHECK(std::get<3>(testOrderBook.processOrder(testMsgClassVar)) == 0);
+    CHECK(testOrderBook.volumeAtPrice(100) == -41000);
+    // level shrinking back into the narrow range frees its entry
+    testMsgClassVar.emplace<1>(-30000, 100);
+    testOrderBook.processOrder(testMsgClassVar);
+    CHECK(testOrderBook.volumeAtPrice(100) == -11000);
+    testMsgClassVar.emplace<0>(40000, 600);
+    CHECK(std::get<3>(testOrderBook.processOrder(testMsgClassVar)) == 0);
+    CHECK(testOrderBook.volumeAtPrice(600) == 40100);
+    // market order sweeping overflowing levels
+    testMsgClassVar.emplace<2>(-70000);
+    auto orderResp = testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<1>(orderResp) == -70000);
+    CHECK(std::get<2>(orderResp) == -(60000 * 500 + 10000 * 600));
+    CHECK(testOrderBook.volumeAtPrice(500) == 0);
+    CHECK(testOrderBook.volumeAtPrice(600) == 30100);
+    CHECK(testOrderBook.__invariantsCheck(0) == 0);
+  }
+
+  SUBCASE("testing order counts and update sequence numbers") {
+    auto testOrderBook =
+        testOrderBookTemplate<OrderBookStorage::soaStorage>{0};
+    msgClassVariant testMsgClassVar;
+    CHECK(testOrderBook.levelMetadata(500) == std::make_tuple(0u, 0ul));
+    testMsgClassVar.emplace<0>(10, 500);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(20, 500);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(-20, 400);
+    testOrderBook.processOrder(testMsgClassVar);
+    auto [count500, update500] = testOrderBook.levelMetadata(500);
+    auto [count400, update400] = testOrderBook.levelMetadata(400);
+    CHECK(count500 == 2);
+    CHECK(count400 == 1);
+    CHECK(update400 > update500);
+    // partially filled level keeps its count, emptied level is reset
+    testMsgClassVar.emplace<2>(-15);
+    testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<0>(testOrderBook.levelMetadata(500)) == 2);
+    CHECK(std::get<1>(testOrderBook.levelMetadata(500)) > update400);
+    testMsgClassVar.emplace<1>(-20, 400);
+    testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<0>(testOrderBook.levelMetadata(400)) == 0);
+    CHECK(std::get<0>(testOrderBook.levelMetadata(2000)) == 0);
+    // metadata moves along with levels when shifting
+    CHECK(testOrderBook.shiftBook(100));
+    CHECK(std::get<0>(testOrderBook.levelMetadata(500)) == 2);
+    CHECK(testOrderBook.volumeAtPrice(500) == 15);
+  }
+
+  SUBCASE("testing metadata when shifting an empty book") {
+    auto testOrderBook =
+        testOrderBookTemplate<OrderBookStorage::soaStorage>{0};
+    msgClassVariant testMsgClassVar;
+    testMsgClassVar.emplace<0>(10, 500);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<1>(10, 500);
+    testOrderBook.processOrder(testMsgClassVar);
+    const auto metadata500 = testOrderBook.levelMetadata(500);
+    CHECK(std::get<1>(metadata500) > 0);
+    // metadata stays with its price, levels dropping out of range are reset
+    CHECK(testOrderBook.shiftBook(300));
+    CHECK(testOrderBook.levelMetadata(500) == metadata500);
+    CHECK(testOrderBook.levelMetadata(800) == std::make_tuple(0u, 0ul));
+    CHECK(testOrderBook.shiftBook(300));
+    CHECK(testOrderBook.shiftBook(-600));
+    CHECK(testOrderBook.levelMetadata(500) == std::make_tuple(0u, 0ul));
+  }
+}
+
+template <template <typename, std::uint32_t> class storage>
+using jumpTableOrderBookTemplate =
+    OrderBook::orderBook<msgClassVariant, std::int64_t, 1000, false, 0, 1, 2,
+                         true, storage, RecenterPolicy::noRecentering, 0,
+                         DispatchPolicy::jumpTable>;
+
+// pairs of books differing only in dispatch policy, for every storage policy
+TEST_CASE_TEMPLATE(
+    "testing OrderBook::orderBook dispatch policies and typed entry points",
+    bookPair,
+    std::pair<testOrderBookTemplate<OrderBookStorage::denseStorage>,
+              jumpTableOrderBookTemplate<OrderBookStorage::denseStorage>>,
+    std::pair<testOrderBookTemplate<OrderBookStorage::ringStorage>,
+              jumpTableOrderBookTemplate<OrderBookStorage::ringStorage>>,
+    std::pair<testOrderBookTemplate<smallPagedStorage>,
+              jumpTableOrderBookTemplate<smallPagedStorage>>,
+    std::pair<testOrderBookTemplate<OrderBookStorage::soaStorage>,
+              jumpTableOrderBookTemplate<OrderBookStorage::soaStorage>>) {
+  using runAllBookClass = typename bookPair::first_type;
+  using jumpTableBookClass = typename bookPair::second_type;
+  auto runAllBook = runAllBookClass{0};
+  auto jumpTableBook = jumpTableBookClass{0};
+  auto typedBook = runAllBookClass{0};
+  std::srand(42);
+  bool responsesMatch = true;
+  std::uint64_t errCodeSum{0};
+  for (int i = 0; i < 100000; ++i) {
+    const std::int32_t volume = std::rand() % 201 - 100;
+    const std::uint32_t price = std::rand() % 1100;
+    msgClassVariant msg;
+    const int msgType = std::rand() % 3;
+    msgType == 0   ? void(msg.emplace<0>(volume, price))
+    : msgType == 1 ? void(msg.emplace<1>(volume, price))
+                   : void(msg.emplace<2>(volume));
+    const auto runAllResponse = runAllBook.processOrder(msg);
+    const auto jumpTableResponse = jumpTableBook.processOrder(msg);
+    const auto typedResponse =
+        msgType == 0   ? typedBook.addLimit(std::get<0>(msg))
+        : msgType == 1 ? typedBook.withdrawLimit(std::get<1>(msg))
+                       : typedBook.marketOrder(std::get<2>(msg));
+    responsesMatch = responsesMatch && runAllResponse == jumpTableResponse &&
+                     runAllResponse == typedResponse;
+    errCodeSum += jumpTableBook.__invariantsCheck(i);
+  }
+  CHECK(responsesMatch);
+  CHECK(errCodeSum == 0);
+  bool volumesMatch = true;
+  for (std::uint32_t price = 0; price <= 1000; ++price) {
+    volumesMatch = volumesMatch &&
+                   runAllBook.volumeAtPrice(price) ==
+                       jumpTableBook.volumeAtPrice(price) &&
+                   runAllBook.volumeAtPrice(price) ==
+                       typedBook.volumeAtPrice(price);
+  }
+  CHECK(volumesMatch);
+}
+
+template <template <typename, std::uint32_t> class storage>
+using recenteringOrderBookTemplate =
+    OrderBook::orderBook<msgClassVariant, std::int64_t, 1000, false, 0, 1, 2,
+                         true, storage, RecenterPolicy::edgeDistance<100, 50>>;
+
+TEST_CASE_TEMPLATE(
+    "testing OrderBook::orderBook with recentering policy", testOrderBookClass,
+    recenteringOrderBookTemplate<OrderBookStorage::ringStorage>,
+    recenteringOrderBookTemplate<smallPagedStorage>,
+    recenteringOrderBookTemplate<OrderBookStorage::soaStorage>) {
+  SUBCASE("testing book following trending prices") {
+    auto testOrderBook = testOrderBookClass{0};
+    auto fixedOrderBook =
+        testOrderBookTemplate<OrderBookStorage::ringStorage>{0};
+    msgClassVariant testMsgClassVar;
+    std::uint64_t errCodeSum{0};
+    // quotes around a price drifting upwards and back down again, previous
+    // quotes withdrawn with each step
+    auto requote = [&](std::uint32_t prev, std::uint32_t next) {
+      testMsgClassVar.emplace<1>(-10, prev - 2);
+      testOrderBook.processOrder(testMsgClassVar);
+      fixedOrderBook.processOrder(testMsgClassVar);
+      testMsgClassVar.emplace<1>(10, prev + 2);
+      testOrderBook.processOrder(testMsgClassVar);
+      fixedOrderBook.processOrder(testMsgClassVar);
+      testMsgClassVar.emplace<0>(-10, next - 2);
+      testOrderBook.processOrder(testMsgClassVar);
+      fixedOrderBook.processOrder(testMsgClassVar);
+      testMsgClassVar.emplace<0>(10, next + 2);
+      testOrderBook.processOrder(testMsgClassVar);
+      fixedOrderBook.processOrder(testMsgClassVar);
+    };
+    testMsgClassVar.emplace<0>(-10, 498);
+    testOrderBook.processOrder(testMsgClassVar);
+    fixedOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(10, 502);
+    testOrderBook.processOrder(testMsgClassVar);
+    fixedOrderBook.processOrder(testMsgClassVar);
+    std::uint32_t price = 500;
+    for (; price < 5000; price += 5) {
+      requote(price, price + 5);
+      errCodeSum += testOrderBook.__invariantsCheck(price);
+    }
+    for (; price > 500; price -= 5) {
+      requote(price, price - 5);
+      errCodeSum += testOrderBook.__invariantsCheck(price);
+    }
+    CHECK(errCodeSum == 0);
+    CHECK(testOrderBook.outOfRangeCount() == 0);
+    CHECK(testOrderBook.shiftCount() > 0);
+    CHECK(testOrderBook.volumeAtPrice(498) == -10);
+    CHECK(testOrderBook.volumeAtPrice(502) == 10);
+    auto bestBidAsk = testOrderBook.bestBidAsk();
+    CHECK(std::get<0>(bestBidAsk).value() == 498);
+    CHECK(std::get<1>(bestBidAsk).value() == 502);
+    // book without recentering rejects orders once prices leave its range
+    CHECK(fixedOrderBook.outOfRangeCount() > 0);
+    CHECK(fixedOrderBook.shiftCount() == 0);
+  }
+
+  SUBCASE("testing counters for manual shifts and rejected orders") {
+    auto testOrderBook = testOrderBookClass{1000};
+    msgClassVariant testMsgClassVar;
+    testMsgClassVar.emplace<0>(-10, 3000);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<1>(-10, 500);
+    testOrderBook.processOrder(testMsgClassVar);
+    CHECK(testOrderBook.outOfRangeCount() == 2);
+    // shifts by zero and failed shifts are not counted
+    CHECK(testOrderBook.shiftBook(-500));
+    CHECK(testOrderBook.shiftBook(0));
+    CHECK(!testOrderBook.shiftBook(-1000));
+    CHECK(testOrderBook.shiftCount() == 1);
+  }
+}
+
+using l3MsgClassVariant = std::variant<FIXmsgClasses::addLimitOrderL3,
+                                       FIXmsgClasses::withdrawLimitOrderL3,
+                                       FIXmsgClasses::marketOrder>;
+template <template <typename, std::uint32_t> class storage>
+using l3OrderBookTemplate =
+    OrderBook::orderBook<l3MsgClassVariant, std::int64_t, 1000, false, 0, 1, 2,
+                         true, storage, RecenterPolicy::noRecentering, 1024>;
+
+TEST_CASE_TEMPLATE("testing OrderBook::orderBook in order level mode",
+                   testOrderBookClass,
+                   l3OrderBookTemplate<OrderBookStorage::denseStorage>,
+                   l3OrderBookTemplate<OrderBookStorage::ringStorage>,
+                   l3OrderBookTemplate<smallPagedStorage>) {
+  SUBCASE("testing price-time priority when filling orders") {
+    auto testOrderBook = testOrderBookClass{0};
+    l3MsgClassVariant testMsgClassVar;
+    testMsgClassVar.emplace<0>(10, 100, 1);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(20, 100, 2);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(5, 100, 3);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(7, 99, 4);
+    testOrderBook.processOrder(testMsgClassVar);
+    // better price first, then oldest order at price
+    testMsgClassVar.emplace<2>(-22);
+    auto orderResp = testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<1>(orderResp) == -22);
+    CHECK(testOrderBook.volumeAtPrice(99) == 0);
+    CHECK(testOrderBook.volumeAtPrice(100) == 20);
+    // order 1 has been filled entirely, order 2 partially
+    testMsgClassVar.emplace<1>(10, 100, 1);
+    orderResp = testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<1>(orderResp) == 0);
+    CHECK(std::get<3>(orderResp) == 2);
+    testMsgClassVar.emplace<1>(100, 100, 2);
+    orderResp = testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<1>(orderResp) == 15);
+    CHECK(std::get<3>(orderResp) == 0);
+    CHECK(testOrderBook.volumeAtPrice(100) == 5);
+    // crossing limit order fills order 3, rests remainder as new order
+    testMsgClassVar.emplace<0>(-8, 100, 5);
+    orderResp = testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<1>(orderResp) == -5);
+    CHECK(testOrderBook.volumeAtPrice(100) == -3);
+    testMsgClassVar.emplace<1>(-3, 0, 5);
+    orderResp = testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<1>(orderResp) == -3);
+    CHECK(testOrderBook.__invariantsCheck(0) == 0);
+    auto bestBidAsk = testOrderBook.bestBidAsk();
+    CHECK(!std::get<0>(bestBidAsk).has_value());
+    CHECK(!std::get<1>(bestBidAsk).has_value());
+  }
+
+  SUBCASE("testing withdrawel restricted to the order identified") {
+    auto testOrderBook = testOrderBookClass{0};
+    l3MsgClassVariant testMsgClassVar;
+    testMsgClassVar.emplace<0>(10, 100, 1);
+    testOrderBook.processOrder(testMsgClassVar);
+    testMsgClassVar.emplace<0>(-10, 90, 2);
+    testOrderBook.processOrder(testMsgClassVar);
+    // unknown ID, wrong side
+    testMsgClassVar.emplace<1>(10, 100, 3);
+    auto orderResp = testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<1>(orderResp) == 0);
+    CHECK(std::get<3>(orderResp) == 2);
+    testMsgClassVar.emplace<1>(-10, 100, 1);
+    orderResp = testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<1>(orderResp) == 0);
+    CHECK(std::get<3>(orderResp) == 2);
+    CHECK(testOrderBook.volumeAtPrice(100) == 10);
+    // partial withdrawel, price is taken from the resting order
+    testMsgClassVar.emplace<1>(-4, 0, 2);
+    orderResp = testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<1>(orderResp) == -4);
+    CHECK(std::get<3>(orderResp) == 0);
+    CHECK(testOrderBook.volumeAtPrice(90) == -6);
+    // duplicate ID
+    testMsgClassVar.emplace<0>(-10, 80, 2);
+    orderResp = testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<3>(orderResp) == 2);
+    CHECK(testOrderBook.volumeAtPrice(80) == 0);
+    CHECK(testOrderBook.__invariantsCheck(0) == 0);
+  }
+
+  SUBCASE("testing rejection of orders once all nodes are in use") {
+    auto testOrderBook = testOrderBookClass{0};
+    l3MsgClassVariant testMsgClassVar;
+    static constexpr std::uint32_t maxOrders = testOrderBookClass::maxOrders;
+    std::uint64_t errCodeSum{0};
+    for (std::uint64_t id = 0; id < maxOrders; ++id) {
+      testMsgClassVar.emplace<0>(1, 500 + id % 8, id);
+      errCodeSum += std::get<3>(testOrderBook.processOrder(testMsgClassVar));
+    }
+    CHECK(errCodeSum == 0);
+    testMsgClassVar.emplace<0>(1, 500, maxOrders);
+    CHECK(std::get<3>(testOrderBook.processOrder(testMsgClassVar)) == 2);
+    CHECK(testOrderBook.volumeAtPrice(500) == maxOrders / 8);
+    // limit order filled entirely needs no node, frees the node of the order
+    // it fills
+    testMsgClassVar.emplace<0>(-1, 500, maxOrders + 1);
+    auto orderResp = testOrderBook.processOrder(testMsgClassVar);
+    CHECK(std::get<3>(orderResp) == 0);
+    CHECK(std::get<1>(orderResp) == -1);
+    testMsgClassVar.emplace<0>(1, 500, maxOrders);
+    CHECK(std::get<3>(testOrderBook.processOrder(testMsgClassVar)) == 0);
+    CHECK(testOrderBook.volumeAtPrice(500) == maxOrders / 8);
+    CHECK(testOrderBook.shiftBook(400));
+    CHECK(testOrderBook.volumeAtPrice(500) == maxOrders / 8);
+    CHECK(testOrderBook.__invariantsCheck(0) == 0);
+  }
+
+  SUBCASE("testing aggregate volume against book without order level") {
+    auto testOrderBook = testOrderBookClass{0};
+    auto l2OrderBook = testOrderBookTemplate<OrderBookStorage::denseStorage>{0};
+    l3MsgClassVariant testMsgClassVar;
+    msgClassVariant l2MsgClassVar;
+    std::srand(42);
+    bool allMatch = true;
+    std::uint64_t id = 0;
+    // fills need to be identical as long as no volume is withdrawn
+    for (; id < 10000; ++id) {
+      const std::int32_t volume = std::rand() % 21 - 10;
+      const std::uint32_t price = 450 + std::rand() % 100;
+      const bool marketOrder = std::rand() % 4 == 0;
+      marketOrder ? void(testMsgClassVar.emplace<2>(volume))
+                  : void(testMsgClassVar.emplace<0>(volume, price, id));
+      marketOrder ? void(l2MsgClassVar.emplace<2>(volume))
+                  : void(l2MsgClassVar.emplace<0>(volume, price));
+      allMatch = allMatch && testOrderBook.processOrder(testMsgClassVar) ==
+                                 l2OrderBook.processOrder(l2MsgClassVar);
+    }
+    for (std::uint32_t price = 0; price <= 1000; ++price) {
+      allMatch = allMatch && testOrderBook.volumeAtPrice(price) ==
+                                 l2OrderBook.volumeAtPrice(price);
+    }
+    CHECK(allMatch);
+    // withdraw random orders by ID, most of them long filled
+    std::uint64_t errCodeSum{0};
+    for (; id < 20000; ++id) {
+      const std::int32_t volume = std::rand() % 21 - 10;
+      const std::uint32_t price = 450 + std::rand() % 100;
+      const bool withdrawel = std::rand() % 2 == 0;
+      withdrawel
+          ? void(testMsgClassVar.emplace<1>(volume, 0, std::rand() % id))
+          : void(testMsgClassVar.emplace<0>(volume, price, id));
+      testOrderBook.processOrder(testMsgClassVar);
+      errCodeSum += testOrderBook.__invariantsCheck(id);
+    }
+    CHECK(errCodeSum == 0);
+  }
+}
+
+TEST_CASE_TEMPLATE("testing seqlock of OrderBook::orderBook",
+                   testOrderBookClass,
+                   testOrderBookTemplate<OrderBookStorage::denseStorage>,
+                   testOrderBookTemplate<OrderBookStorage::ringStorage>) {
+  auto testOrderBook = testOrderBookClass{0};
+
+  SUBCASE("testing version advanced by two per write access") {
+    CHECK(testOrderBook.version() == 0);
+    testOrderBook.processOrder(FIXmsgClasses::addLimitOrder(-10, 400));
+    CHECK(testOrderBook.version() == 2);
+    const msgClassVariant batch[2]{FIXmsgClasses::addLimitOrder(10, 600),
+                                   FIXmsgClasses::marketOrder(-5)};
+    std::tuple<std::uint32_t, std::int64_t, std::int64_t, std::uint8_t>
+        responses[2];
+    testOrderBook.processOrders(batch, responses);
+    CHECK(testOrderBook.version() == 4);
+    CHECK(testOrderBook.shiftBook(100));
+    CHECK(testOrderBook.version() == 6);
+    // failed shift still takes write access
+    CHECK(!testOrderBook.shiftBook(-200));
+    CHECK(testOrderBook.version() == 8);
+  }
+
+  SUBCASE("testing multi-field reads") {
+    testOrderBook.processOrder(FIXmsgClasses::addLimitOrder(-10, 400));
+    testOrderBook.processOrder(FIXmsgClasses::addLimitOrder(-20, 300));
+    testOrderBook.processOrder(FIXmsgClasses::addLimitOrder(30, 700));
+    const OrderBook::bookStats stats = testOrderBook.stats();
+    CHECK(stats.basePrice == 0);
+    CHECK(stats.bestBid == 400);
+    CHECK(stats.lowestBid == 300);
+    CHECK(stats.bestOffer == 700);
+    CHECK(stats.highestOffer == 700);
+    const std::uint32_t prices[4]{300, 400, 700, 2000};
+    std::int64_t volumes[3];
+    CHECK(testOrderBook.volumesAtPrices(prices, volumes) == 3);
+    CHECK(volumes[0] == -20);
+    CHECK(volumes[1] == -10);
+    CHECK(volumes[2] == 30);
+    // no write took place during any read
+    for (std::uint32_t i = 0; i < OrderBook::nReadAPIs; ++i) {
+      CHECK(testOrderBook.readRetryCounts(i) == std::make_tuple(0, 0));
+    }
+  }
+
+  SUBCASE("testing consistent reads concurrent to writer") {
+    // every batch adds the same volume as bid and offer, both volumes read at
+    // a single version always cancel out
+    std::atomic_flag done = false;
+    auto writer = std::jthread([&] {
+      const msgClassVariant batch[2]{FIXmsgClasses::addLimitOrder(-1, 400),
+                                     FIXmsgClasses::addLimitOrder(1, 600)};
+      std::tuple<std::uint32_t, std::int64_t, std::int64_t, std::uint8_t>
+          responses[2];
+      while (!done.test()) {
+        testOrderBook.processOrders(batch, responses);
+      }
+    });
+    const std::uint32_t prices[2]{400, 600};
+    std::int64_t volumes[2];
+    bool consistent = true;
+    for (int i = 0; i < 200000; ++i) {
+      testOrderBook.volumesAtPrices(prices, volumes);
+      consistent = consistent && volumes[0] == -volumes[1];
+    }
+    done.test_and_set();
+    writer.join();
+    CHECK(consistent);
+    const auto [collisions, retries] =
+        testOrderBook.readRetryCounts(OrderBook::volumesRead);
+    CHECK(retries >= collisions);
+    CHECK(testOrderBook.version() % 2 == 0);
+  }
+}
+
 int main() {
   doctest::Context context;
   context.run();
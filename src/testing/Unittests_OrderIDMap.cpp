@@ -0,0 +1,69 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include <unordered_map>
+
+#include "Unittest_Includes.hpp"
+
+TEST_CASE("testing OrderIDMap::orderIDMap") {
+  SUBCASE("testing insertion, lookup and erasure") {
+    OrderIDMap::orderIDMap<100> testMap{};
+    CHECK(!testMap.find(42).has_value());
+    CHECK(testMap.insert(42, 7));
+    CHECK(!testMap.insert(42, 8));
+    CHECK(testMap.find(42).value() == 7);
+    CHECK(testMap.insert(0, 1));
+    CHECK(testMap.find(0).value() == 1);
+    CHECK(testMap.size() == 2);
+    CHECK(testMap.erase(42));
+    CHECK(!testMap.erase(42));
+    CHECK(!testMap.find(42).has_value());
+    CHECK(testMap.find(0).value() == 1);
+    CHECK(testMap.size() == 1);
+  }
+
+  SUBCASE("testing map refusing insertions beyond capacity") {
+    OrderIDMap::orderIDMap<4> testMap{};
+    for (std::uint64_t i = 0; i < 4; ++i) {
+      CHECK(testMap.insert(i * 1000, i));
+    }
+    CHECK(!testMap.insert(5000, 5));
+    CHECK(testMap.erase(0));
+    CHECK(testMap.insert(5000, 5));
+    CHECK(testMap.find(5000).value() == 5);
+  }
+
+  SUBCASE("testing against std::unordered_map with random operations") {
+    static constexpr std::uint32_t capacity = 1000;
+    OrderIDMap::orderIDMap<capacity> testMap{};
+    std::unordered_map<std::uint64_t, std::uint32_t> reference;
+    std::srand(42);
+    bool allMatch = true;
+    for (std::uint32_t i = 0; i < 100000; ++i) {
+      // small key range to provoke collisions and erasure within clusters
+      const std::uint64_t key = std::rand() % 3000;
+      const bool insert = std::rand() % 2 == 0;
+      if (insert) {
+        const bool expectInsert =
+            !reference.contains(key) && reference.size() < capacity;
+        allMatch = allMatch && testMap.insert(key, i) == expectInsert;
+        expectInsert ? void(reference.emplace(key, i)) : void();
+      } else {
+        allMatch =
+            allMatch && testMap.erase(key) == (reference.erase(key) == 1);
+      }
+      const std::uint64_t probeKey = std::rand() % 3000;
+      const auto it = reference.find(probeKey);
+      allMatch = allMatch &&
+                 testMap.find(probeKey) ==
+                     (it != reference.end() ? std::make_optional(it->second)
+                                            : std::nullopt);
+    }
+    CHECK(allMatch);
+    CHECK(testMap.size() == reference.size());
+  }
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}
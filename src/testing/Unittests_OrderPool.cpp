@@ -0,0 +1,58 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include "Unittest_Includes.hpp"
+
+TEST_CASE("testing OrderPool::orderPool") {
+  using nodeType = OrderBookBucket::orderNode<std::int64_t>;
+  OrderPool::orderPool<nodeType, 3> testPool{};
+  CHECK(testPool.available() == 3);
+  const auto first = testPool.allocate();
+  const auto second = testPool.allocate();
+  const auto third = testPool.allocate();
+  CHECK(first.value() == 0);
+  CHECK(second.value() == 1);
+  CHECK(third.value() == 2);
+  CHECK(!testPool.allocate().has_value());
+  testPool[1].volume = 100;
+  testPool.release(1);
+  CHECK(testPool.available() == 1);
+  const auto reused = testPool.allocate();
+  CHECK(reused.value() == 1);
+  CHECK(testPool[1].volume == 0);
+}
+
+TEST_CASE("testing OrderBookBucket::orderQueueBucket") {
+  using testBucketClass = OrderBookBucket::orderQueueBucket<std::int64_t, 16>;
+  using nodeType = testBucketClass::nodeType;
+  OrderPool::orderPool<nodeType, 8> testPool{};
+  testBucketClass testBucket{};
+  CHECK(testBucket.front() == OrderBookBucket::noNode);
+  for (std::uint32_t i = 0; i < 4; ++i) {
+    testBucket.pushBack(testPool.allocate().value(), testPool.nodeSpan());
+  }
+  // unlink from the middle, the front and the back of the queue
+  testBucket.unlink(2, testPool.nodeSpan());
+  CHECK(testBucket.front() == 0);
+  CHECK(testPool[1].next == 3);
+  CHECK(testPool[3].prev == 1);
+  testBucket.unlink(0, testPool.nodeSpan());
+  CHECK(testBucket.front() == 1);
+  CHECK(testPool[1].prev == OrderBookBucket::noNode);
+  testBucket.unlink(3, testPool.nodeSpan());
+  CHECK(testPool[1].next == OrderBookBucket::noNode);
+  testBucket.pushBack(2, testPool.nodeSpan());
+  CHECK(testPool[1].next == 2);
+  testBucket.unlink(1, testPool.nodeSpan());
+  testBucket.unlink(2, testPool.nodeSpan());
+  CHECK(testBucket.front() == OrderBookBucket::noNode);
+  // aggregate volume behaves like a regular bucket
+  testBucket.addLiquidity(-500);
+  CHECK(testBucket.consumeLiquidity(100) == 0);
+  CHECK(testBucket.consumeLiquidity(-1000) == -500);
+  CHECK(testBucket.getVolume() == 0);
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}
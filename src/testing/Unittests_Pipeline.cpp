@@ -0,0 +1,182 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include "Unittest_Includes.hpp"
+
+using addLimitOrder =
+    FIXmsgClasses::instrumentMsg<FIXmsgClasses::addLimitOrder>;
+using withdrawLimitOrder =
+    FIXmsgClasses::instrumentMsg<FIXmsgClasses::withdrawLimitOrder>;
+using marketOrder = FIXmsgClasses::instrumentMsg<FIXmsgClasses::marketOrder>;
+using instrumentMsgVariant =
+    std::variant<addLimitOrder, withdrawLimitOrder, marketOrder>;
+using bookType =
+    OrderBook::orderBook<instrumentMsgVariant, std::int64_t, 1000, false, 0, 1,
+                         2, true, OrderBookStorage::ringStorage>;
+using queueType =
+    Queue::SeqLockQueue<Pipeline::routedMsg<instrumentMsgVariant>, 4096, true,
+                        false>;
+
+// hands out messages of a vector, then nothing
+struct mockHandler {
+  std::vector<instrumentMsgVariant> msgs;
+  std::size_t index = 0;
+  std::optional<instrumentMsgVariant> readNextMessage() noexcept {
+    return index < msgs.size() ? std::make_optional(msgs[index++])
+                               : std::nullopt;
+  };
+};
+
+// counts orders processed by its shard and checks they were timestamped
+struct countingObserver {
+  static constexpr bool enabled = true;
+  std::uint64_t nProcessed = 0;
+  bool timestamped = true;
+  template <typename responseType>
+  void processed(std::uint64_t enqueued, const responseType&) noexcept {
+    ++nProcessed;
+    timestamped = timestamped && enqueued != 0 && enqueued <= Pipeline::now();
+  };
+};
+
+using pipelineType =
+    Pipeline::shardedPipeline<mockHandler, bookType, queueType,
+                              countingObserver>;
+
+TEST_CASE("testing Pipeline::routingTable") {
+  const auto roundRobin = Pipeline::routingTable::roundRobin(7, 3);
+  CHECK(roundRobin.valid());
+  CHECK(roundRobin.size() == 7);
+  CHECK(roundRobin.shards() == 3);
+  CHECK(roundRobin.shard(4) == 1);
+  CHECK(roundRobin.localID(4) == 1);
+  CHECK(roundRobin.instruments(0) == std::vector<std::uint32_t>{0, 3, 6});
+  CHECK(roundRobin.shard(7) == Pipeline::unrouted);
+  // explicit assignment, local IDs follow instrument IDs within a shard
+  const std::vector<std::uint32_t> shardOf{1, 1, 0, 1};
+  const auto explicitTable = Pipeline::routingTable(shardOf, 2);
+  CHECK(explicitTable.valid());
+  CHECK(explicitTable.localID(2) == 0);
+  CHECK(explicitTable.localID(3) == 2);
+  // shard index out of range
+  const std::vector<std::uint32_t> outOfRange{0, 2};
+  CHECK(!Pipeline::routingTable(outOfRange, 2).valid());
+  // shard without instruments
+  CHECK(!Pipeline::routingTable::roundRobin(2, 3).valid());
+}
+
+TEST_CASE("testing Pipeline::shardedPipeline") {
+  static constexpr std::uint32_t nInstruments = 6;
+  static constexpr std::uint32_t nMsgs = 3000;
+  const std::vector<std::uint32_t> basePrices(nInstruments, 0);
+
+  SUBCASE("testing pipeline against single book manager") {
+    // every instrument is fed by one handler only, its orders arrive in
+    // sequence
+    std::srand(42);
+    mockHandler handlers[2];
+    auto reference = BookManager::bookManager<bookType>(basePrices);
+    for (std::uint32_t i = 0; i < nMsgs; ++i) {
+      const std::uint32_t instrument = std::rand() % nInstruments;
+      const bool bid = std::rand() % 2;
+      const std::int32_t volume = (1 + std::rand() % 20) * (bid ? -1 : 1);
+      const std::uint32_t price =
+          500 + (bid ? -1 : 1) * (1 + std::rand() % 10);
+      const int msgType = std::rand() % 10;
+      const instrumentMsgVariant msg =
+          msgType < 6 ? instrumentMsgVariant(addLimitOrder(
+                            FIXmsgClasses::addLimitOrder(volume, price),
+                            instrument))
+          : msgType < 8
+              ? instrumentMsgVariant(withdrawLimitOrder(
+                    FIXmsgClasses::withdrawLimitOrder(volume, price),
+                    instrument))
+              : instrumentMsgVariant(marketOrder(
+                    FIXmsgClasses::marketOrder(-volume), instrument));
+      reference.processOrder(msg);
+      handlers[instrument % 2].msgs.push_back(msg);
+    }
+    // unknown instrument
+    handlers[0].msgs.push_back(
+        marketOrder(FIXmsgClasses::marketOrder(-4), nInstruments));
+    mockHandler* handlerPtrs[2]{&handlers[0], &handlers[1]};
+    auto pipeline = pipelineType(
+        handlerPtrs, basePrices,
+        Pipeline::routingTable::roundRobin(nInstruments, 3),
+        Pipeline::pipelineConfig{{-1, -1}, {-1, -1, -1}});
+    CHECK(pipeline.valid());
+    CHECK(pipeline.handlers() == 2);
+    CHECK(pipeline.shards() == 3);
+    CHECK(pipeline.start());
+    // starting twice is refused
+    CHECK(!pipeline.start());
+    std::uint64_t nProcessed = 0;
+    while (nProcessed < nMsgs) {
+      std::this_thread::yield();
+      nProcessed = pipeline.processedCount(0) + pipeline.processedCount(1) +
+                   pipeline.processedCount(2);
+    }
+    while (pipeline.unroutedCount(0) == 0) {
+      std::this_thread::yield();
+    }
+    // top of book can be read while running
+    CHECK(pipeline.bestBidAsk(5) == reference.bestBidAsk(5));
+    pipeline.stop();
+    CHECK(pipeline.enqueuedCount(0) + pipeline.enqueuedCount(1) == nMsgs);
+    CHECK(pipeline.unroutedCount(0) == 1);
+    std::uint64_t nObserved = 0;
+    for (std::uint32_t i = 0; i < 3; ++i) {
+      CHECK(pipeline.observer(i).nProcessed == pipeline.processedCount(i));
+      CHECK(pipeline.observer(i).timestamped);
+      nObserved += pipeline.observer(i).nProcessed;
+    }
+    CHECK(nObserved == nMsgs);
+    for (std::uint32_t i = 0; i < nInstruments; ++i) {
+      CHECK(pipeline.bestBidAsk(i) == reference.bestBidAsk(i));
+      for (std::uint32_t price = 490; price <= 510; ++price) {
+        CHECK(pipeline.book(i).volumeAtPrice(price) ==
+              reference.book(i).volumeAtPrice(price));
+      }
+    }
+  }
+
+  SUBCASE("testing pinned stages") {
+    mockHandler handler;
+    handler.msgs.push_back(
+        addLimitOrder(FIXmsgClasses::addLimitOrder(-10, 400), 1));
+    mockHandler* handlerPtrs[1]{&handler};
+    auto pipeline = pipelineType(
+        handlerPtrs, basePrices,
+        Pipeline::routingTable::roundRobin(nInstruments, 2),
+        Pipeline::pipelineConfig{{0}, {0, 0}});
+    CHECK(pipeline.start());
+    while (pipeline.processedCount(1) == 0) {
+      std::this_thread::yield();
+    }
+    pipeline.stop();
+    CHECK(pipeline.book(1).volumeAtPrice(400) == -10);
+    CHECK(pipeline.processedCount(0) == 0);
+  }
+
+  SUBCASE("testing invalid configurations") {
+    mockHandler handler;
+    mockHandler* handlerPtrs[1]{&handler};
+    // routing table for two shards, config with three
+    auto mismatched = pipelineType(
+        handlerPtrs, basePrices,
+        Pipeline::routingTable::roundRobin(nInstruments, 2),
+        Pipeline::pipelineConfig{{-1}, {-1, -1, -1}});
+    CHECK(!mismatched.valid());
+    CHECK(!mismatched.start());
+    // two handler cores, one handler
+    auto missingHandler = pipelineType(
+        handlerPtrs, basePrices,
+        Pipeline::routingTable::roundRobin(nInstruments, 2),
+        Pipeline::pipelineConfig{{-1, -1}, {-1, -1}});
+    CHECK(!missingHandler.valid());
+  }
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}
@@ -0,0 +1,130 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include "Unittest_Includes.hpp"
+
+using msgClassVariant = std::variant<FIXmsgClasses::addLimitOrder,
+                                     FIXmsgClasses::withdrawLimitOrder,
+                                     FIXmsgClasses::marketOrder>;
+// dense book of 64 bit volumes uses the kernel, ring buffer book does not
+template <template <typename, std::uint32_t> class storage>
+using testOrderBookTemplate =
+    OrderBook::orderBook<msgClassVariant, std::int64_t, 1000, false, 0, 1, 2,
+                         true, storage>;
+
+// runs sweep on a copy of the buckets, returns result and buckets afterwards
+auto runSweep(SweepKernel::sweepFunc func, std::vector<std::int64_t> buckets,
+              std::uint32_t start, std::uint32_t count, bool up,
+              std::int64_t open) {
+  const auto result =
+      func(buckets.data() + start, count, up, open, 100 + start);
+  return std::make_tuple(result, buckets);
+}
+
+TEST_CASE("testing SweepKernel::sweep") {
+  std::vector<SweepKernel::sweepFunc> variants{SweepKernel::sweepScalar};
+#if defined(__x86_64__)
+  __builtin_cpu_supports("avx2") ? variants.push_back(SweepKernel::sweepAVX2)
+                                 : void();
+  __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")
+      ? variants.push_back(SweepKernel::sweepAVX512)
+      : void();
+#endif
+
+  SUBCASE("testing sweep of fixed buckets in both directions") {
+    std::vector<std::int64_t> offers(20, 10);
+    offers[3] = 0;
+    for (auto func : variants) {
+      // 12 full buckets covered by 125 (one of them empty)
+      auto [result, after] = runSweep(func, offers, 0, 20, true, 125);
+      CHECK(result.consumed == 13);
+      CHECK(result.liquidity == 120);
+      CHECK(result.lastFilled == 12);
+      std::int64_t revenue = 0;
+      for (std::int64_t i = 0; i < 13; ++i) {
+        revenue += offers[i] * (100 + i);
+      }
+      CHECK(result.revenue == revenue);
+      CHECK(std::all_of(after.begin(), after.begin() + 13,
+                        [](std::int64_t v) { return v == 0; }));
+      CHECK(after[13] == 10);
+    }
+    std::vector<std::int64_t> bids(20, -10);
+    for (auto func : variants) {
+      // downwards from index 19, open volume smaller than the first bucket
+      auto [result, after] = runSweep(func, bids, 19, 20, false, 5);
+      CHECK(result.consumed == 0);
+      CHECK(result.lastFilled == -1);
+      CHECK(after == bids);
+      std::tie(result, after) = runSweep(func, bids, 19, 20, false, 1000);
+      CHECK(result.consumed == 20);
+      CHECK(result.liquidity == 200);
+      CHECK(result.lastFilled == 19);
+      // prices 119 down to 100
+      CHECK(result.revenue == 10 * (100 + 119) * 10);
+    }
+  }
+
+  SUBCASE("testing all versions against each other with random buckets") {
+    std::srand(42);
+    bool allMatch = true;
+    for (int i = 0; i < 5000; ++i) {
+      const bool up = std::rand() % 2;
+      std::vector<std::int64_t> buckets(600);
+      for (auto& bucket : buckets) {
+        // many empty buckets, volume beyond 32 bits now and then
+        const std::int64_t volume =
+            std::rand() % 3 == 0
+                ? 0
+                : 1 + std::rand() % 100 +
+                      (std::rand() % 50 == 0) * (std::int64_t{1} << 33);
+        bucket = up ? volume : -volume;
+      }
+      const std::uint32_t count = 1 + std::rand() % 550;
+      const std::uint32_t start = up ? std::rand() % (600 - count)
+                                     : count - 1 + std::rand() % (600 - count);
+      const std::int64_t open = std::rand() % (60 * count + 1);
+      const auto [expected, expectedAfter] =
+          runSweep(SweepKernel::sweepScalar, buckets, start, count, up, open);
+      for (auto func : variants) {
+        const auto [result, after] =
+            runSweep(func, buckets, start, count, up, open);
+        allMatch = allMatch && result.consumed == expected.consumed &&
+                   result.liquidity == expected.liquidity &&
+                   result.revenue == expected.revenue &&
+                   result.lastFilled == expected.lastFilled &&
+                   after == expectedAfter;
+      }
+    }
+    CHECK(allMatch);
+  }
+
+  SUBCASE("testing order book sweeping via kernel against scalar book") {
+    auto kernelBook = testOrderBookTemplate<OrderBookStorage::denseStorage>(0);
+    auto scalarBook = testOrderBookTemplate<OrderBookStorage::ringStorage>(0);
+    std::srand(42);
+    bool allMatch = true;
+    for (int i = 0; i < 20000; ++i) {
+      const std::int32_t volume = std::rand() % 201 - 100;
+      const std::uint32_t price = std::rand() % 1001;
+      msgClassVariant msg;
+      // occasional large market orders sweeping hundreds of levels
+      std::rand() % 20 == 0
+          ? void(msg.emplace<2>(volume * 200))
+          : void(msg.emplace<0>(volume, price));
+      allMatch = allMatch &&
+                 kernelBook.processOrder(msg) == scalarBook.processOrder(msg) &&
+                 kernelBook.bestBidAsk() == scalarBook.bestBidAsk();
+    }
+    for (std::uint32_t p = 0; p <= 1000; ++p) {
+      allMatch = allMatch &&
+                 kernelBook.volumeAtPrice(p) == scalarBook.volumeAtPrice(p);
+    }
+    CHECK(allMatch);
+    CHECK(kernelBook.__invariantsCheck(0) == 0);
+  }
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}